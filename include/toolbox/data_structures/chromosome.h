@@ -32,8 +32,8 @@
  * @section ChromosomeStructDetails Detailed Structure Members
  * This section provides a detailed description of each member of the `Chromosome` struct.
  *
- * @var size_t Chromosome::fit
- * The current fit value for the Chromosome based on last training run.
+ * @var float Chromosome::fit
+ * The current fit value for the Chromosome based on last training run, the lower is the better.
  *
  * @var Array* Chromosome::weights
  * Array type holder of the weights
@@ -54,6 +54,13 @@ typedef struct Chromosome Chromosome;
  */
 Chromosome* Chromosome_Create(const size_t numberOfElements);
 
+/**
+ * @ingroup ChromosomeLifecycle
+ * @brief The function to destroy the Chromosome type object with its weights.
+ * @param chromosome - the chromosome to be destroyed.
+ */
+void Chromosome_Destroy(Chromosome *chromosome);
+
 
 
 //=============================================================================
@@ -66,9 +73,9 @@ Chromosome* Chromosome_Create(const size_t numberOfElements);
  * @ingroup ChromosomeQuery
  * @brief The function to return the fit value of the desired chromosome.
  * @param chromosome - the desired chromosome.
- * @return size_t type fit value.
+ * @return float type fit value.
  */
-size_t Chromosome_GetFit(const Chromosome *chromosome);
+float Chromosome_GetFit(const Chromosome *chromosome);
 
 /**
  * @ingroup ChromosomeQuery
@@ -90,7 +97,7 @@ ArrayFloat* Chromosome_GetWeights(const Chromosome *chromosome);
  * @param chromosome - the desired chromosome.
  * @param fit - new fit value.
  */
-void Chromosome_SetFit(Chromosome *chromosome, const size_t fit);
+void Chromosome_SetFit(Chromosome *chromosome, const float fit);
 
 /**
  * @ingroup ChromosomeManipulation
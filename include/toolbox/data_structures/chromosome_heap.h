@@ -0,0 +1,170 @@
+/**
+ * @file chromosome_heap.h
+ * @brief Fit ordered Chromosome Heap data structure public interface.
+ *
+ * This header defines the public interface for the Chromosome Heap, the storage of the chromosomes of one
+ * population ordered by fit. The heap is the min-max heap saved in the Array: the even levels of the tree
+ * are ordered from the lowest fit, the odd levels from the highest, so both the best and the worst chromosome
+ * are at the top. The fit of each chromosome is saved next to its pointer, so the ordering does not touch the
+ * chromosomes themselves.
+ *
+ * Copyright (C) 2025 Egor Demianov
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHROMOSOME_HEAP_H
+#define CHROMOSOME_HEAP_H
+#include <stddef.h>
+
+#include "chromosome.h"
+
+/**
+ * @struct ChromosomeHeap
+ * @brief Internal definition of the Chromosome Heap structure.
+ * @ingroup ChromosomeHeap
+ * @details
+ * This structure holds the Array of the heap items, each is the fit and the pointer to the chromosome.
+ * The heap does not own the chromosomes, they are destroyed by the caller.
+ *
+ * @section ChromosomeHeapStructDetails Detailed Structure Members
+ * This section provides a detailed description of each member of the `ChromosomeHeap` struct.
+ *
+ * @var Array* ChromosomeHeap::items
+ * Array type holder of the fit and chromosome pairs in the min-max heap order.
+ */
+typedef struct ChromosomeHeap ChromosomeHeap;
+
+//=============================================================================
+//
+//                     Chromosome Heap Lifecycle Management Functions
+//
+//=============================================================================
+
+/**
+ * @ingroup ChromosomeHeapLifecycle
+ * @brief The function to create a new empty Chromosome Heap type object.
+ * @param capacity - the expected number of chromosomes, the heap grows if more are inserted.
+ * @return the new ChromosomeHeap type object.
+ */
+ChromosomeHeap* ChromosomeHeap_Create(const size_t capacity);
+
+/**
+ * @ingroup ChromosomeHeapLifecycle
+ * @brief The function to destroy the heap, the chromosomes in it are not destroyed.
+ * @param heap - the heap to be destroyed.
+ */
+void ChromosomeHeap_Destroy(ChromosomeHeap *heap);
+
+
+
+//=============================================================================
+//
+//                     Chromosome Heap Query Functions
+//
+//=============================================================================
+
+/**
+ * @ingroup ChromosomeHeapQuery
+ * @brief The function to return the number of chromosomes in the heap.
+ * @param heap - the desired heap.
+ * @return size_t type number of chromosomes.
+ */
+size_t ChromosomeHeap_GetSize(const ChromosomeHeap *heap);
+
+/**
+ * @ingroup ChromosomeHeapQuery
+ * @brief The function to return the chromosome with the lowest fit in O(1).
+ * @param heap - the desired heap, should not be empty.
+ * @return Chromosome* type best chromosome.
+ */
+Chromosome* ChromosomeHeap_PeekBest(const ChromosomeHeap *heap);
+
+/**
+ * @ingroup ChromosomeHeapQuery
+ * @brief The function to return the chromosome with the highest fit in O(1).
+ * @param heap - the desired heap, should not be empty.
+ * @return Chromosome* type worst chromosome.
+ */
+Chromosome* ChromosomeHeap_PeekWorst(const ChromosomeHeap *heap);
+
+/**
+ * @ingroup ChromosomeHeapQuery
+ * @brief The function to return the chromosome at the position in the heap, used for the random selection.
+ * @param heap - the desired heap.
+ * @param index - the position, less than the size.
+ * @return Chromosome* type chromosome.
+ */
+Chromosome* ChromosomeHeap_GetChromosome(const ChromosomeHeap *heap, const size_t index);
+
+/**
+ * @ingroup ChromosomeHeapQuery
+ * @brief The function to return the fit of the chromosome at the position in the heap without reading the chromosome.
+ * @param heap - the desired heap.
+ * @param index - the position, less than the size.
+ * @return float type fit.
+ */
+float ChromosomeHeap_GetFit(const ChromosomeHeap *heap, const size_t index);
+
+
+
+//=============================================================================
+//
+//                     Chromosome Heap Manipulation Functions
+//
+//=============================================================================
+
+/**
+ * @ingroup ChromosomeHeapManipulation
+ * @brief The function to insert the chromosome with its current fit in O(log n).
+ * @param heap - the desired heap.
+ * @param chromosome - the chromosome to be inserted.
+ */
+void ChromosomeHeap_Insert(ChromosomeHeap *heap, Chromosome *chromosome);
+
+/**
+ * @ingroup ChromosomeHeapManipulation
+ * @brief The function to replace the worst chromosome with the new one in O(log n).
+ * @param heap - the desired heap, should not be empty.
+ * @param chromosome - the chromosome to be inserted with its current fit.
+ * @return Chromosome* type removed worst chromosome, it can be reused by the caller.
+ */
+Chromosome* ChromosomeHeap_ReplaceWorst(ChromosomeHeap *heap, Chromosome *chromosome);
+
+#endif //CHROMOSOME_HEAP_H
+
+/**
+* @defgroup ChromosomeHeap Chromosome Heap
+* @ingroup DataStructures
+* @brief Functions of the Data Structure Chromosome Heap.
+*/
+
+/**
+* @defgroup ChromosomeHeapLifecycle Chromosome Heap Lifecycle
+* @ingroup ChromosomeHeap
+* @brief Lifecycle functions of the Chromosome Heap.
+*
+* This functions create/destroy Chromosome Heap
+*/
+
+/**
+* @defgroup ChromosomeHeapQuery Chromosome Heap Query
+* @ingroup ChromosomeHeap
+* @brief Query of the Data Structure Chromosome Heap.
+*
+* This functions make read-only operations on data
+*/
+
+/**
+* @defgroup ChromosomeHeapManipulation Chromosome Heap Manipulation
+* @ingroup ChromosomeHeap
+* @brief Manipulation of the Data Structure Chromosome Heap.
+*
+* This functions make write operations on data
+*/
@@ -0,0 +1,190 @@
+/**
+ * @file control_metrics.h
+ * @brief Streaming control quality metrics public interface.
+ *
+ * This header defines the public interface for the control quality metrics computed in one pass of the
+ * closed loop simulation. Each sample updates the O(1) state of the selected metrics, no trajectory is stored.
+ * The step metrics (overshoot, rise time, settling time) are measured for each constant segment of the
+ * reference and the worst segment is kept.
+ */
+
+#ifndef CONTROL_METRICS_H
+#define CONTROL_METRICS_H
+
+#include <stddef.h>
+
+/**
+ * @enum ControlMetric
+ * @brief The index of the metric in the values, weights and the mask.
+ * @ingroup ControlMetrics
+ */
+typedef enum ControlMetric {
+    CONTROL_METRIC_IAE       = 0, // integral of |e| dt
+    CONTROL_METRIC_ISE       = 1, // integral of e^2 dt
+    CONTROL_METRIC_ITAE      = 2, // integral of t |e| dt
+    CONTROL_METRIC_OVERSHOOT = 3, // the biggest overshoot relative to the step size
+    CONTROL_METRIC_SETTLING  = 4, // the longest time to stay within the band around the reference
+    CONTROL_METRIC_RISE      = 5, // the longest time from 10 % to 90 % of the step
+    CONTROL_METRIC_EFFORT    = 6, // integral of u^2 dt
+    CONTROL_METRIC_COUNT     = 7
+} ControlMetric;
+
+/*!
+ * @ingroup ControlMetrics
+ * @brief The mask bit of the metric.
+ */
+#define CONTROL_METRIC_BIT(metric) (1u << (metric))
+
+/*!
+ * @ingroup ControlMetrics
+ * @brief The mask of all the metrics.
+ */
+#define CONTROL_METRIC_ALL ((1u << CONTROL_METRIC_COUNT) - 1u)
+
+/**
+ * @struct ControlMetrics
+ * @brief Definition of the Control Metrics structure.
+ * @ingroup ControlMetrics
+ * @details
+ * The structure has no pointers, so it can be embedded into the controller and copied with it to the worker threads.
+ * The mask 0 means the metrics are not used.
+ *
+ * @section ControlMetricsStructDetails Detailed Structure Members
+ *
+ * @var unsigned ControlMetrics::mask
+ * The selected metrics, made from CONTROL_METRIC_BIT.
+ *
+ * @var float ControlMetrics::weights
+ * The weight of each metric in the fitness.
+ *
+ * @var float ControlMetrics::values
+ * The value of each selected metric, final after ControlMetrics_Finish.
+ */
+typedef struct ControlMetrics {
+    unsigned mask;
+    float weights[CONTROL_METRIC_COUNT];
+    float values[CONTROL_METRIC_COUNT];
+
+    float dt;           // the sampling time
+    float settlingBand; // the band around the reference relative to the step size
+    size_t step;        // the number of samples seen
+
+    // the state of the current reference segment
+    float reference;     // the reference of the segment
+    float initialOutput; // the output at the segment start
+    float segmentStart;  // the time of the segment start
+    float peak;          // the biggest relative overshoot in the segment
+    float riseLow;       // the time the output crossed 10 % of the step, negative if not yet
+    float riseHigh;      // the time the output crossed 90 % of the step, negative if not yet
+    float lastOutside;   // the last time the output was out of the settling band
+    float lastOutput;    // the output of the last sample
+} ControlMetrics;
+
+
+
+//=============================================================================
+//
+//                     Control Metrics Lifecycle Management Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup ControlMetricsLifecycle
+ * @brief Set the metrics selection and weights.
+ * @param metrics the metrics to be set.
+ * @param mask the selected metrics, 0 disables the metrics.
+ * @param weights the CONTROL_METRIC_COUNT weights, NULL means all weights are 1.
+ * @param dt the sampling time.
+ */
+void ControlMetrics_Init(ControlMetrics *metrics, const unsigned mask, const float *weights, const float dt);
+
+/*!
+ * @ingroup ControlMetricsLifecycle
+ * @brief Clear the state before the new simulation, the selection and weights are kept.
+ * @param metrics the metrics.
+ */
+void ControlMetrics_Reset(ControlMetrics *metrics);
+
+
+
+//=============================================================================
+//
+//                     Control Metrics Manipulation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup ControlMetricsManipulation
+ * @brief Add one sample of the closed loop.
+ * @param metrics the metrics.
+ * @param reference the reference w.
+ * @param output the plant output y.
+ * @param control the controller output u.
+ */
+void ControlMetrics_Update(ControlMetrics *metrics, const float reference, const float output, const float control);
+
+/*!
+ * @ingroup ControlMetricsManipulation
+ * @brief Add count identical samples at once, used by the steady state fast forward.
+ * @param metrics the metrics.
+ * @param reference the reference w.
+ * @param output the plant output y.
+ * @param control the controller output u.
+ * @param count the number of samples.
+ */
+void ControlMetrics_UpdateConstant(ControlMetrics *metrics, const float reference, const float output, const float control, const size_t count);
+
+/*!
+ * @ingroup ControlMetricsManipulation
+ * @brief Close the last reference segment, the values are final after it.
+ * @param metrics the metrics.
+ */
+void ControlMetrics_Finish(ControlMetrics *metrics);
+
+
+
+//=============================================================================
+//
+//                     Control Metrics Query Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup ControlMetricsQuery
+ * @brief Get the weighted sum of the selected metrics.
+ * @param metrics the finished metrics.
+ * @return The fitness, smaller is better.
+ */
+float ControlMetrics_Fitness(const ControlMetrics *metrics);
+
+#endif
+
+/**
+* @defgroup ControlMetrics Control Metrics
+* @ingroup General
+* @brief Streaming control quality metrics of the closed loop.
+*/
+
+/**
+* @defgroup ControlMetricsLifecycle Control Metrics Lifecycle
+* @ingroup ControlMetrics
+* @brief Lifecycle functions of the Control Metrics.
+*
+* This functions set up/clear the Control Metrics
+*/
+
+/**
+* @defgroup ControlMetricsQuery Control Metrics Query
+* @ingroup ControlMetrics
+* @brief Query of the Control Metrics.
+*
+* This functions read the results
+*/
+
+/**
+* @defgroup ControlMetricsManipulation Control Metrics Manipulation
+* @ingroup ControlMetrics
+* @brief Manipulation of the Control Metrics.
+*
+* This functions feed the samples
+*/
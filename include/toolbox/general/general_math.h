@@ -1,7 +1,15 @@
 #ifndef GENERAL_MATH_H
 #define GENERAL_MATH_H
 
+#include <stdint.h>
+
+// function to set the seed of the shared random stream used by the functions below
+void setRandomSeed(const uint64_t seed);
+
 // function to create float in range
 float createRandomFloat(const float min, const float max);
 
-#endif
\ No newline at end of file
+// function to create the unbiased index in [0, count)
+int createRandomIndex(const int count);
+
+#endif
@@ -0,0 +1,157 @@
+/**
+ * @file ode_integrator.h
+ * @brief Adaptive step ODE integrator public interface.
+ *
+ * This header defines the public interface for the embedded Runge-Kutta Dormand-Prince 4(5)
+ * integrator with error control. It is used by the nonlinear plants to integrate between two
+ * controller samples with as few internal steps as the dynamics allow.
+ */
+
+#ifndef ODE_INTEGRATOR_H
+#define ODE_INTEGRATOR_H
+
+#include <stddef.h>
+
+/*!
+ * @ingroup OdeIntegrator
+ * @brief The number of state sized buffers the integrator needs: 7 stages, stage argument and new state.
+ */
+#define ODE_INTEGRATOR_BUFFERS 9
+
+/*!
+ * @ingroup OdeIntegrator
+ * @brief The right side of the ODE dx = f(t, x, u).
+ * @param t the current time from the start of the interval.
+ * @param x the current state.
+ * @param u the input hold constant over the interval.
+ * @param dx the output derivative of the state.
+ * @param context the user pointer given to the integrator.
+ */
+typedef void (*OdeFunction)(const float t, const float *x, const float u, float *dx, void *context);
+
+/**
+ * @struct OdeStats
+ * @brief The cost counters of the integration.
+ * @ingroup OdeIntegrator
+ */
+typedef struct OdeStats {
+    size_t acceptedSteps; // steps with error under tolerance
+    size_t rejectedSteps; // steps which were repeated with smaller step
+    size_t functionCalls; // calls of the OdeFunction
+    size_t intervals;     // calls of the integration (controller samples)
+} OdeStats;
+
+/**
+ * @struct OdeIntegrator
+ * @brief Definition of the Dormand-Prince integrator.
+ * @ingroup OdeIntegrator
+ * @details
+ * All stage buffers are preallocated in the workspace, so the integration makes no allocation.
+ * The workspace is either owned (OdeIntegrator_Create) or provided by the caller, which allows
+ * the plants to keep it in their data memory and stay reentrant.
+ *
+ * @var float* OdeIntegrator::workspace
+ * The ODE_INTEGRATOR_BUFFERS * states floats used for the stages.
+ *
+ * @var float OdeIntegrator::step
+ * The last accepted step size, used as the first try of the next interval. 0 means unknown.
+ */
+typedef struct OdeIntegrator {
+    OdeFunction function; // the right side of the ODE
+    void *context;        // user data for the function
+    size_t states;        // the size of the state vector
+
+    float relTol;  // relative tolerance
+    float absTol;  // absolute tolerance
+    float minStep; // the smallest allowed step
+    float maxStep; // the biggest allowed step, 0 means interval length
+
+    float *workspace; // stage buffers
+    float step;       // the step for the next try
+
+    OdeStats stats; // the cost counters
+} OdeIntegrator;
+
+
+
+//=============================================================================
+//
+//                     Ode Integrator Lifecycle Management Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup OdeIntegratorLifecycle
+ * @brief Creates a new integrator with own workspace.
+ * @param function the right side of the ODE.
+ * @param context the user pointer passed to the function.
+ * @param states the size of the state vector.
+ * @param relTol the relative tolerance.
+ * @param absTol the absolute tolerance.
+ * @return A pointer to the new OdeIntegrator instance.
+ */
+OdeIntegrator* OdeIntegrator_Create(OdeFunction function, void *context, const size_t states, const float relTol, const float absTol);
+
+/*!
+ * @ingroup OdeIntegratorLifecycle
+ * @brief Destroy the integrator and its workspace.
+ * @param integrator the integrator to be destroyed.
+ */
+void OdeIntegrator_Destroy(OdeIntegrator *integrator);
+
+/*!
+ * @ingroup OdeIntegratorLifecycle
+ * @brief Reset the counters and the step memory. The workspace stays.
+ * @param integrator the integrator to be reset.
+ */
+void OdeIntegrator_Reset(OdeIntegrator *integrator);
+
+
+
+//=============================================================================
+//
+//                     Ode Integrator Manipulation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup OdeIntegratorManipulation
+ * @brief Integrate the state over the interval with the input hold constant (zero-order hold).
+ * @param integrator the integrator.
+ * @param x the state, updated in place.
+ * @param u the input for the whole interval.
+ * @param interval the length of the integration (the controller sampling time).
+ */
+void OdeIntegrator_Integrate(OdeIntegrator *integrator, float *x, const float u, const float interval);
+
+/*!
+ * @ingroup OdeIntegratorManipulation
+ * @brief Print the cost of the integration compared to the fixed Euler with one step per interval.
+ * @param stats the counters to print.
+ * @param eulerStepsPerInterval the number of Euler steps the same accuracy would need per interval.
+ */
+void OdeIntegrator_PrintStats(const OdeStats *stats, const size_t eulerStepsPerInterval);
+
+#endif
+
+/**
+* @defgroup OdeIntegrator Ode Integrator
+* @ingroup General
+* @brief Embedded Runge-Kutta integrator for the nonlinear plants.
+*/
+
+/**
+* @defgroup OdeIntegratorLifecycle Ode Integrator Lifecycle
+* @ingroup OdeIntegrator
+* @brief Lifecycle functions of the Ode Integrator.
+*
+* This functions create/destroy/reset Ode Integrator
+*/
+
+/**
+* @defgroup OdeIntegratorManipulation Ode Integrator Manipulation
+* @ingroup OdeIntegrator
+* @brief Manipulation of the Ode Integrator.
+*
+* This functions integrate the state and report the cost
+*/
@@ -0,0 +1,48 @@
+/**
+ * @file parallel.h
+ * @brief Parallel loop helper public interface.
+ *
+ * This header defines the minimal fork-join interface over POSIX threads used by the toolbox
+ * to spread independent simulations (calibration candidates, individuals, scenarios) over the cores.
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>
+
+/*!
+ * @ingroup Parallel
+ * @brief The task of one loop index.
+ * @param index the index of the loop item.
+ * @param thread the index of the worker thread in the range [0, threads), used to select per thread buffers.
+ * @param context the user pointer given to the loop.
+ */
+typedef void (*ParallelTask)(const size_t index, const size_t thread, void *context);
+
+/*!
+ * @ingroup Parallel
+ * @brief Return the number of online cores, at least 1.
+ * @return The number of threads worth of starting.
+ */
+size_t Parallel_GetThreadCount(void);
+
+/*!
+ * @ingroup Parallel
+ * @brief Run the task for all indexes [0, count) on the threads and wait for all of them.
+ * @param count the number of loop items.
+ * @param threads the number of threads, 0 means Parallel_GetThreadCount. The caller thread is one of them.
+ * @param task the task to be run.
+ * @param context the user pointer passed to the task.
+ *
+ * @note The indexes are claimed through an atomic counter, so the order of execution is not defined.
+ */
+void Parallel_For(const size_t count, size_t threads, ParallelTask task, void *context);
+
+#endif
+
+/**
+* @defgroup Parallel Parallel
+* @ingroup General
+* @brief Fork-join helper for independent simulations.
+*/
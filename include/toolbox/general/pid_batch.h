@@ -0,0 +1,149 @@
+/**
+ * @file pid_batch.h
+ * @brief Batched PID closed loop simulation public interface.
+ *
+ * This header defines the public interface for the simulation of many PID genomes (Kp, Ki, Kd, tauD) at once.
+ * All the individuals share the reference signal, the plant and the limits, so PID_BATCH_WIDTH of them are
+ * stepped together with the lane index as the innermost loop. The limits are applied with selects instead of
+ * branches, so the compiler can keep the whole lane group in the vector registers. The state space plants are
+ * stepped for the whole group at once, the other plants are called for each lane with own memory.
+ * The fits are bit identical to makeSimulationOfSignal.
+ */
+
+#ifndef PID_BATCH_H
+#define PID_BATCH_H
+
+#include "general/pid_controller.h"
+#include "general/state_space.h"
+
+#include <stddef.h>
+
+/*!
+ * @ingroup PidBatch
+ * @brief The number of individuals simulated together, two AVX registers of floats.
+ */
+#define PID_BATCH_WIDTH 16
+
+/**
+ * @struct PidBatchLanes
+ * @brief Definition of the state of one lane group.
+ * @ingroup PidBatch
+ * @details
+ * Each member holds one value per lane, so the loops over the lanes are plain contiguous array loops.
+ */
+typedef struct PidBatchLanes {
+    float Kp[PID_BATCH_WIDTH];
+    float Ki[PID_BATCH_WIDTH];
+    float Kd[PID_BATCH_WIDTH];
+    float tauD[PID_BATCH_WIDTH];
+
+    float integral[PID_BATCH_WIDTH];     // the I part
+    float differential[PID_BATCH_WIDTH]; // the D part
+    float prevError[PID_BATCH_WIDTH];    // e[t-1]
+    float y1[PID_BATCH_WIDTH];           // y[t-1]
+    float y2[PID_BATCH_WIDTH];           // y[t-2]
+    float u[PID_BATCH_WIDTH];            // the plant input of the step
+    float y[PID_BATCH_WIDTH];            // the plant output of the step
+
+    float fit[PID_BATCH_WIDTH];          // the sum of |e|
+    int maxCounter[PID_BATCH_WIDTH];     // number of the clamped outputs
+    int steadyRise[PID_BATCH_WIDTH];     // 1 while the output never fell
+} PidBatchLanes;
+
+/**
+ * @struct PidBatch
+ * @brief Definition of the Pid Batch structure.
+ * @ingroup PidBatch
+ * @details
+ * The batch keeps the copy of the shared part of the PID and the scratch of each thread, so no allocation
+ * is made by PidBatch_Evaluate.
+ *
+ * @section PidBatchStructDetails Detailed Structure Members
+ *
+ * @var PID PidBatch::pid
+ * The copy of the template PID: signal, plant, limits, plant gain and metrics selection.
+ *
+ * @var StateSpace* PidBatch::plant
+ * The discretized state space model of the plant or NULL if the plant is stepped by each lane.
+ *
+ * @var float* PidBatch::memory
+ * The plant memory of each thread, the state space states are [state][lane], the other plants have the
+ * sizeDataSystem floats for each lane.
+ */
+typedef struct PidBatch {
+    PID pid;
+    const StateSpace *plant;
+
+    size_t threads;      // the number of threads, each has own scratch
+    size_t memoryStride; // floats of the plant memory of one thread
+
+    PidBatchLanes *lanes;    // the lane group of each thread
+    float *memory;           // the plant memory of each thread
+    ControlMetrics *metrics; // PID_BATCH_WIDTH metrics of each thread, used only with the metrics mask
+} PidBatch;
+
+
+
+//=============================================================================
+//
+//                     Pid Batch Lifecycle Management Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup PidBatchLifecycle
+ * @brief Create the batch for the signal, plant and limits of the PID.
+ * @param pid the template PID, prepareSystem should be already called for its plant.
+ * @param threads the number of threads, 0 means Parallel_GetThreadCount.
+ * @return A pointer to the new PidBatch instance.
+ */
+PidBatch* PidBatch_Create(const PID *pid, size_t threads);
+
+/*!
+ * @ingroup PidBatchLifecycle
+ * @brief Destroy the batch. The signal of the template PID is not touched.
+ * @param batch the batch to be destroyed.
+ */
+void PidBatch_Destroy(PidBatch *batch);
+
+
+
+//=============================================================================
+//
+//                     Pid Batch Manipulation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup PidBatchManipulation
+ * @brief Simulate the genomes and write their fits, the lane groups run in parallel.
+ * @param batch the batch.
+ * @param genomes the rows with Kp, Ki, Kd, tauD.
+ * @param count the number of genomes.
+ * @param fit the output fits, the same values as makeSimulationOfSignal gives.
+ */
+void PidBatch_Evaluate(PidBatch *batch, float *const *genomes, const size_t count, float *fit);
+
+#endif
+
+/**
+* @defgroup PidBatch Pid Batch
+* @ingroup General
+* @brief Batched simulation of the PID population.
+*/
+
+/**
+* @defgroup PidBatchLifecycle Pid Batch Lifecycle
+* @ingroup PidBatch
+* @brief Lifecycle functions of the Pid Batch.
+*
+* This functions create/destroy the Pid Batch
+*/
+
+/**
+* @defgroup PidBatchManipulation Pid Batch Manipulation
+* @ingroup PidBatch
+* @brief Manipulation of the Pid Batch.
+*
+* This functions simulate the genomes
+*/
@@ -1,7 +1,9 @@
 #ifndef PID_CONTROLLER_H
 #define PID_CONTROLLER_H
 
+#include "general/control_metrics.h"
 #include "general/signal_designer.h"
+#include "general/trace_writer.h"
 
 #include <stdio.h>
 
@@ -38,6 +40,9 @@ typedef struct PID {
   float limMax;
   float limMin;
 
+  // the actuator gain of the plant variant, 1 is the nominal plant
+  float plantGain;
+
   // the fit value of pid run
   float fit;
 
@@ -46,17 +51,32 @@ typedef struct PID {
 
   // the maxCounter is used to determine signals that are too oscillating and as such have too much over the limit value (>1%)
   int maxCounter;
+
+  // the streaming quality metrics, with the mask 0 the fit stays the sum of |e|
+  ControlMetrics metrics;
+
+  // the binary trace used instead of the csv file when set, owned by the pid
+  TraceWriter *trace;
 }PID;
 
 void createNewPidController(PID *pid);
 
+// create the pid with the signal and system given by the CLI choice numbers, no prompt is made, returns 0 for unknown choice
+int createPidControllerByChoice(PID *pid, int signalChoice, int systemChoice);
+
 void deletePid(PID *pid);
 
 void makeSimulationOfSignal(PID *pid, FILE *csvFile, int csv);
 
-// make macro for the file input
+// open the binary trace with the columns P, I, D, y, w, the csv can be made later with TraceWriter_TranscodeToCsv
+void openPidTrace(PID *pid, const char *path);
+
+// make macro for the file input, the trace takes only memcpy of the record
 #define WRITE_TO_FILE(csv, csvFile, pid, i) do {                                                                                                      \
-  if (csv == 0) {                                                                                                                                     \
+  if (csv == 1 && pid->trace != NULL) {                                                                                                               \
+    const float record[5] = {pid->proportiError, pid->integralError, pid->differenError, pid->output->signal[i], pid->signal->signal[i]};              \
+    TraceWriter_Append(pid->trace, record);                                                                                                           \
+  } else if (csv == 1) {                                                                                                                              \
     fprintf(csvFile, "%f,%f,%f,%f,%f\n", pid->proportiError, pid->integralError, pid->differenError, pid->output->signal[i], pid->signal->signal[i]); \
   }                                                                                                                                                   \
 } while (0)
@@ -0,0 +1,178 @@
+/**
+ * @file process_pool.h
+ * @brief Multi process master/worker evaluation public interface.
+ *
+ * This header defines the public interface for the evaluation of the population by the forked worker processes.
+ * The genomes and the fit array live in one POSIX shared memory segment. Each worker builds its own evaluator
+ * after the fork, e.g. its own SystemNN or PidBatch, then for each round it claims the ranges of rows through the
+ * atomic counter of the segment and writes the fits in place. The master starts the round and waits for its end
+ * over the UNIX socket of each worker, the same small messages could later go over the network to the other
+ * machines. The crash of the worker does not stop the run: its unfinished rows get FLT_MAX and the worker is forked
+ * again before the next round.
+ *
+ * @note The forked worker has only the thread which created the pool, so the init function should not rely on
+ * the other threads of the master, e.g. it should build its own batch instead of using the shared one. The worker
+ * also keeps only the stdio and its own channel of the inherited descriptors, so the files it needs are opened by
+ * the init function. The segment is unlinked right after it is mapped, so it is never left in /dev/shm.
+ */
+
+#ifndef PROCESS_POOL_H
+#define PROCESS_POOL_H
+
+#include <stddef.h>
+
+/*!
+ * @ingroup ProcessPool
+ * @brief Build the evaluator of the worker, called in the worker process right after the fork.
+ * @param worker the index of the worker.
+ * @param context the user data given to the pool, the copy made by the fork.
+ * @return The state of the worker passed to the evaluate and release functions.
+ */
+typedef void* (*ProcessPoolInit)(const size_t worker, void *context);
+
+/*!
+ * @ingroup ProcessPool
+ * @brief Evaluate the claimed rows in the worker process, the lower fit is the better.
+ * @param genomes the claimed rows of the shared memory.
+ * @param count the number of rows.
+ * @param fit the output fit of each row, in the shared memory.
+ * @param state the state made by the init function.
+ */
+typedef void (*ProcessPoolEvaluate)(float *const *genomes, const size_t count, float *fit, void *state);
+
+/*!
+ * @ingroup ProcessPool
+ * @brief Release the state of the worker before the worker process exits.
+ * @param state the state made by the init function.
+ */
+typedef void (*ProcessPoolRelease)(void *state);
+
+/**
+ * @struct ProcessPool
+ * @brief Definition of the Process Pool structure.
+ * @ingroup ProcessPool
+ */
+typedef struct ProcessPool ProcessPool;
+
+
+
+//=============================================================================
+//
+//                     Process Pool Lifecycle Management Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup ProcessPoolLifecycle
+ * @brief Create the shared memory segment and fork the workers.
+ * @param rows the biggest number of rows of one round.
+ * @param genes the number of genes of one row.
+ * @param workers the number of worker processes, 0 means one per core.
+ * @param chunk the number of rows claimed at once, 0 means 1.
+ * @param init the function building the evaluator of each worker, may be NULL.
+ * @param evaluate the fit function of the rows.
+ * @param release the function releasing the evaluator of each worker, may be NULL.
+ * @param context the user data passed to init.
+ * @return A pointer to the new ProcessPool instance.
+ */
+ProcessPool* ProcessPool_Create(const size_t rows, const size_t genes, size_t workers, const size_t chunk,
+                                ProcessPoolInit init, ProcessPoolEvaluate evaluate, ProcessPoolRelease release, void *context);
+
+/*!
+ * @ingroup ProcessPoolLifecycle
+ * @brief Stop the workers, wait for them and remove the shared memory segment.
+ * @param pool the pool to be destroyed.
+ */
+void ProcessPool_Destroy(ProcessPool *pool);
+
+
+
+//=============================================================================
+//
+//                     Process Pool Manipulation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup ProcessPoolManipulation
+ * @brief Evaluate the first count rows of the shared memory in place.
+ * @param pool the pool.
+ * @param count the number of rows, at most the rows of the pool.
+ * @return The number of rows which were not evaluated because of the crashed worker, their fit is FLT_MAX.
+ */
+size_t ProcessPool_EvaluateShared(ProcessPool *pool, const size_t count);
+
+/*!
+ * @ingroup ProcessPoolManipulation
+ * @brief Copy the genomes into the shared memory, evaluate them and copy the fits out, the same as PidBatch_Evaluate.
+ * @param pool the pool.
+ * @param genomes the rows to be evaluated.
+ * @param count the number of rows, at most the rows of the pool.
+ * @param fit the output fit of each row.
+ * @return The number of rows which were not evaluated because of the crashed worker, their fit is FLT_MAX.
+ */
+size_t ProcessPool_Evaluate(ProcessPool *pool, float *const *genomes, const size_t count, float *fit);
+
+
+
+//=============================================================================
+//
+//                     Process Pool Query Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup ProcessPoolQuery
+ * @brief Get the shared rows, the row i starts at i * genes.
+ * @param pool the pool.
+ * @return The pointer to the genomes of the shared memory.
+ */
+float* ProcessPool_GetGenomes(const ProcessPool *pool);
+
+/*!
+ * @ingroup ProcessPoolQuery
+ * @brief Get the shared fit array.
+ * @param pool the pool.
+ * @return The pointer to the fits of the shared memory.
+ */
+float* ProcessPool_GetFit(const ProcessPool *pool);
+
+/*!
+ * @ingroup ProcessPoolQuery
+ * @brief Get the number of worker processes.
+ * @param pool the pool.
+ * @return The number of workers.
+ */
+size_t ProcessPool_GetWorkers(const ProcessPool *pool);
+
+#endif
+
+/**
+* @defgroup ProcessPool Process Pool
+* @ingroup General
+* @brief Master/worker evaluation by the forked processes over the shared memory.
+*/
+
+/**
+* @defgroup ProcessPoolLifecycle Process Pool Lifecycle
+* @ingroup ProcessPool
+* @brief Lifecycle functions of the Process Pool.
+*
+* This functions create/destroy the pool and its workers
+*/
+
+/**
+* @defgroup ProcessPoolManipulation Process Pool Manipulation
+* @ingroup ProcessPool
+* @brief Manipulation of the Process Pool.
+*
+* This functions run the evaluation rounds
+*/
+
+/**
+* @defgroup ProcessPoolQuery Process Pool Query
+* @ingroup ProcessPool
+* @brief Query of the Process Pool.
+*
+* This functions read the state of the pool
+*/
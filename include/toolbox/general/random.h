@@ -0,0 +1,153 @@
+/**
+ * @file random.h
+ * @brief Reproducible random numbers public interface.
+ *
+ * This header defines the public interface for the xoshiro256++ generator used by the GA instead of rand().
+ * The generator state is owned by the caller, so each thread, island or individual has its own stream without
+ * any lock. The streams are made from one seed and the stream index, e.g. the index of the row, so the run gives
+ * the same numbers for the same seed regardless of the number of threads which processed the rows.
+ */
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @struct Random
+ * @brief Definition of the state of one stream of random numbers.
+ * @ingroup Random
+ */
+typedef struct Random {
+    uint64_t state[4]; // the xoshiro256++ state, never all zero
+} Random;
+
+
+
+//=============================================================================
+//
+//                     Random Lifecycle Management Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup RandomLifecycle
+ * @brief Set the state from the seed, the state is expanded by SplitMix64.
+ * @param random the stream to be set.
+ * @param seed the seed, any value incl. 0 is valid.
+ */
+void Random_Seed(Random *random, const uint64_t seed);
+
+/*!
+ * @ingroup RandomLifecycle
+ * @brief Set the state of the stream with the index, the streams of one seed are independent of each other.
+ * @param random the stream to be set.
+ * @param seed the seed of the run.
+ * @param stream the index of the stream, e.g. of the thread, the island or the individual.
+ */
+void Random_Stream(Random *random, const uint64_t seed, const uint64_t stream);
+
+/*!
+ * @ingroup RandomLifecycle
+ * @brief Move the stream by 2^128 numbers, the same as 2^128 calls of Random_Next.
+ * @param random the stream to be moved, e.g. the copy of the other thread stream.
+ */
+void Random_Jump(Random *random);
+
+
+
+//=============================================================================
+//
+//                     Random Manipulation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup RandomManipulation
+ * @brief Get the next 64 random bits.
+ * @param random the stream.
+ * @return The random bits.
+ */
+uint64_t Random_Next(Random *random);
+
+/*!
+ * @ingroup RandomManipulation
+ * @brief Get the uniform float in [0, 1) with the 24 bits of the mantissa.
+ * @param random the stream.
+ * @return The random float.
+ */
+float Random_Float(Random *random);
+
+/*!
+ * @ingroup RandomManipulation
+ * @brief Get the uniform float in [low, high).
+ * @param random the stream.
+ * @param low the lower bound.
+ * @param high the upper bound.
+ * @return The random float.
+ */
+float Random_Uniform(Random *random, const float low, const float high);
+
+/*!
+ * @ingroup RandomManipulation
+ * @brief Get the unbiased integer in [0, bound) by the Lemire multiply and reject method, no division in most calls.
+ * @param random the stream.
+ * @param bound the number of values, should be at least 1.
+ * @return The random index.
+ */
+uint32_t Random_Bounded(Random *random, const uint32_t bound);
+
+/*!
+ * @ingroup RandomManipulation
+ * @brief Get the float of the standard normal distribution by the Box-Muller transform.
+ * @param random the stream.
+ * @return The random float with the mean 0 and the deviation 1.
+ */
+float Random_Normal(Random *random);
+
+/*!
+ * @ingroup RandomManipulation
+ * @brief Fill the buffer with the uniform floats in [low, high).
+ * @param random the stream.
+ * @param buffer the output, count floats.
+ * @param count the number of floats.
+ * @param low the lower bound.
+ * @param high the upper bound.
+ */
+void Random_FillUniform(Random *random, float *buffer, const size_t count, const float low, const float high);
+
+/*!
+ * @ingroup RandomManipulation
+ * @brief Fill the buffer with the normal floats, both values of each Box-Muller pair are used.
+ * @param random the stream.
+ * @param buffer the output, count floats.
+ * @param count the number of floats.
+ * @param mean the mean of the distribution.
+ * @param deviation the standard deviation of the distribution.
+ */
+void Random_FillNormal(Random *random, float *buffer, const size_t count, const float mean, const float deviation);
+
+#endif
+
+/**
+* @defgroup Random Random
+* @ingroup General
+* @brief Reproducible streams of random numbers.
+*/
+
+/**
+* @defgroup RandomLifecycle Random Lifecycle
+* @ingroup Random
+* @brief Lifecycle functions of the Random.
+*
+* This functions seed the streams
+*/
+
+/**
+* @defgroup RandomManipulation Random Manipulation
+* @ingroup Random
+* @brief Manipulation of the Random.
+*
+* This functions draw the random numbers from the stream
+*/
@@ -10,6 +10,9 @@ typedef struct Signal {
 // the function to clean the signal
 void deleteSignal(Signal *signal);
 
+// the function to make the signal by the CLI choice number without the prompt, returns 0 for unknown choice
+int makeSignalByChoice(Signal *signal, int choice);
+
 // the function to select signal with CLI
 void cliSignalSelector(Signal *signal);
 
@@ -0,0 +1,225 @@
+/**
+ * @file signal_generator.h
+ * @brief Procedural reference signal generators public interface.
+ *
+ * This header defines the public interface for the streaming signal generators. The generator is a small
+ * value type holding only the parameters and the position, the samples are produced one by one or in chunks,
+ * so the whole horizon is never allocated. The random generators are seeded and rewinding gives the same samples.
+ */
+
+#ifndef SIGNAL_GENERATOR_H
+#define SIGNAL_GENERATOR_H
+
+#include "general/signal_designer.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ * @ingroup SignalGenerator
+ * @brief The biggest number of segments in the piecewise steps generator.
+ */
+#define SIGNAL_GENERATOR_MAX_SEGMENTS 16
+
+/**
+ * @enum SignalShape
+ * @brief The kind of the generated signal.
+ * @ingroup SignalGenerator
+ */
+typedef enum SignalShape {
+    SIGNAL_STEPS        = 0, // piecewise constant segments, the same map as in the signal designer
+    SIGNAL_RAMP         = 1, // linear change between two values, constant before and after
+    SIGNAL_CHIRP        = 2, // sine with linearly rising frequency
+    SIGNAL_PRBS         = 3, // pseudo random binary sequence from the linear feedback shift register
+    SIGNAL_RANDOM_STEPS = 4  // uniform random levels held for random number of samples
+} SignalShape;
+
+/**
+ * @struct SignalGenerator
+ * @brief Definition of the Signal Generator structure.
+ * @ingroup SignalGenerator
+ * @details
+ * The structure has no pointers, it can be copied, kept on the stack or in the array of scenarios.
+ *
+ * @section SignalGeneratorStructDetails Detailed Structure Members
+ *
+ * @var SignalShape SignalGenerator::shape
+ * The kind of the signal, selects the used parameters.
+ *
+ * @var size_t SignalGenerator::length
+ * The number of samples in the horizon.
+ *
+ * @var size_t SignalGenerator::index
+ * The index of the next sample.
+ *
+ * @var uint64_t SignalGenerator::seed
+ * The seed of the random shapes, used to rewind.
+ *
+ * @var uint64_t SignalGenerator::state
+ * The current state of the random shapes (the RNG state or the shift register).
+ */
+typedef struct SignalGenerator {
+    SignalShape shape;
+    float dt;      // the sampling time
+    size_t length; // number of samples
+    size_t index;  // the next sample
+
+    uint64_t seed;
+    uint64_t state;
+
+    // SIGNAL_STEPS
+    size_t segments;                             // number of segments
+    size_t ends[SIGNAL_GENERATOR_MAX_SEGMENTS];  // the first sample after each segment
+    float values[SIGNAL_GENERATOR_MAX_SEGMENTS]; // the value of each segment
+    size_t segment;                              // the current segment
+
+    // SIGNAL_RAMP, SIGNAL_CHIRP, SIGNAL_PRBS, SIGNAL_RANDOM_STEPS
+    float low;       // ramp start value, chirp offset, prbs/random low level
+    float high;      // ramp end value, chirp amplitude, prbs/random high level
+    float start;     // ramp start time, chirp start frequency
+    float end;       // ramp end time, chirp end frequency
+    size_t period;   // prbs samples per bit, random steps minimal hold
+    size_t periodMax;// random steps maximal hold
+    size_t hold;     // samples left with the current level
+    float level;     // the current level of the prbs/random steps
+} SignalGenerator;
+
+
+
+//=============================================================================
+//
+//                     Signal Generator Lifecycle Management Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup SignalGeneratorLifecycle
+ * @brief Init the piecewise constant signal from the map of rows {start time, end time, value}.
+ * @param generator the generator to be set.
+ * @param map the segments, the time is in seconds.
+ * @param segments the number of rows, up to SIGNAL_GENERATOR_MAX_SEGMENTS.
+ * @param dt the sampling time.
+ */
+void SignalGenerator_InitSteps(SignalGenerator *generator, const float map[][3], const size_t segments, const float dt);
+
+/*!
+ * @ingroup SignalGeneratorLifecycle
+ * @brief Init the ramp from the value low at the startTime to the value high at the endTime.
+ * @param generator the generator to be set.
+ * @param low the value before the ramp.
+ * @param high the value after the ramp.
+ * @param startTime the start of the ramp in seconds.
+ * @param endTime the end of the ramp in seconds.
+ * @param duration the horizon in seconds.
+ * @param dt the sampling time.
+ */
+void SignalGenerator_InitRamp(SignalGenerator *generator, const float low, const float high, const float startTime,
+                              const float endTime, const float duration, const float dt);
+
+/*!
+ * @ingroup SignalGeneratorLifecycle
+ * @brief Init the linear chirp offset + amplitude * sin(2 pi (f0 t + (f1 - f0) t^2 / (2 T))).
+ * @param generator the generator to be set.
+ * @param offset the middle value.
+ * @param amplitude the amplitude of the sine.
+ * @param startFrequency the frequency f0 at the start in Hz.
+ * @param endFrequency the frequency f1 at the end of the horizon in Hz.
+ * @param duration the horizon T in seconds.
+ * @param dt the sampling time.
+ */
+void SignalGenerator_InitChirp(SignalGenerator *generator, const float offset, const float amplitude, const float startFrequency,
+                               const float endFrequency, const float duration, const float dt);
+
+/*!
+ * @ingroup SignalGeneratorLifecycle
+ * @brief Init the PRBS from the 15 bit maximal length shift register, each bit is held for the bit time.
+ * @param generator the generator to be set.
+ * @param low the level of the bit 0.
+ * @param high the level of the bit 1.
+ * @param bitTime the time of one bit in seconds.
+ * @param duration the horizon in seconds.
+ * @param dt the sampling time.
+ * @param seed the start of the register, 0 is replaced by 1.
+ */
+void SignalGenerator_InitPrbs(SignalGenerator *generator, const float low, const float high, const float bitTime,
+                              const float duration, const float dt, const uint64_t seed);
+
+/*!
+ * @ingroup SignalGeneratorLifecycle
+ * @brief Init the random steps, the uniform level from [low, high] is held for uniform time from [minHold, maxHold].
+ * @param generator the generator to be set.
+ * @param low the lowest level.
+ * @param high the highest level.
+ * @param minHold the shortest hold in seconds.
+ * @param maxHold the longest hold in seconds.
+ * @param duration the horizon in seconds.
+ * @param dt the sampling time.
+ * @param seed the seed of the sequence.
+ */
+void SignalGenerator_InitRandomSteps(SignalGenerator *generator, const float low, const float high, const float minHold,
+                                     const float maxHold, const float duration, const float dt, const uint64_t seed);
+
+/*!
+ * @ingroup SignalGeneratorLifecycle
+ * @brief Rewind the generator to the first sample, the random shapes repeat the same samples.
+ * @param generator the generator.
+ */
+void SignalGenerator_Reset(SignalGenerator *generator);
+
+
+
+//=============================================================================
+//
+//                     Signal Generator Manipulation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup SignalGeneratorManipulation
+ * @brief Produce the next sample.
+ * @param generator the generator, should not be at the end.
+ * @return The value of the sample.
+ */
+float SignalGenerator_Next(SignalGenerator *generator);
+
+/*!
+ * @ingroup SignalGeneratorManipulation
+ * @brief Produce the next chunk of samples.
+ * @param generator the generator.
+ * @param chunk the output array.
+ * @param count the size of the chunk.
+ * @return The number of samples written, smaller than count at the end of the horizon, 0 after it.
+ */
+size_t SignalGenerator_Fill(SignalGenerator *generator, float *chunk, const size_t count);
+
+/*!
+ * @ingroup SignalGeneratorManipulation
+ * @brief Write the whole horizon into the Signal for the code which needs the array. The generator is rewound first.
+ * @param generator the generator.
+ * @param signal the signal, its array is allocated here and freed with deleteSignal.
+ */
+void SignalGenerator_Materialize(SignalGenerator *generator, Signal *signal);
+
+#endif
+
+/**
+* @defgroup SignalGenerator Signal Generator
+* @ingroup General
+* @brief Procedural reference signals produced on demand.
+*/
+
+/**
+* @defgroup SignalGeneratorLifecycle Signal Generator Lifecycle
+* @ingroup SignalGenerator
+* @brief Lifecycle functions of the Signal Generator.
+*
+* This functions set up/rewind the Signal Generator
+*/
+
+/**
+* @defgroup SignalGeneratorManipulation Signal Generator Manipulation
+* @ingroup SignalGenerator
+* @brief Manipulation of the Signal Generator.
+*
+* This functions produce the samples
+*/
@@ -3,6 +3,14 @@
 
 #include <stddef.h>
 
-// function to sort and return indexes of values from max to min
+// function to sort the indexes in result by fit from min to max, in place and without any allocation (introsort)
 void quickSort(float *fit, int *result, int length);
-#endif
\ No newline at end of file
+
+// function to sort the indexes in result by fit from min to max by the radix of the float bits, the equal fits keep
+// their order. The scratch is the caller array of length ints, the best choice for the big populations
+void radixArgSort(const float *fit, int *result, int length, int *scratch);
+
+// function to move the indexes of the k lowest fits to the front of result sorted from min to max, the rest is in any
+// order. The average cost is O(length + k log k), without any allocation (introselect)
+void selectTopK(const float *fit, int *result, int length, int k);
+#endif
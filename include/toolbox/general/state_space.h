@@ -0,0 +1,176 @@
+/**
+ * @file state_space.h
+ * @brief Linear State Space plant public interface.
+ *
+ * This header defines the public interface for the linear time invariant plants described by
+ * continuous (A, B, C, D) matrices. The plant is discretized once with the matrix exponential
+ * (zero-order hold on the input) and then stepped with two small matrix-vector products.
+ */
+
+#ifndef STATE_SPACE_H
+#define STATE_SPACE_H
+
+#include <stddef.h>
+
+/*!
+ * @ingroup StateSpace
+ * @brief The biggest number of states/inputs/outputs supported. Used for stack scratch in the step.
+ */
+#define STATE_SPACE_MAX_SIZE 16
+
+/**
+ * @struct StateSpace
+ * @brief Definition of the State Space plant structure.
+ * @ingroup StateSpace
+ * @details
+ * The structure holds the continuous model as well as its exact discrete equivalent.
+ * All matrices are saved row-major in the 1D arrays, the same index formula as in the Matrix is used.
+ *
+ * @section StateSpaceStructDetails Detailed Structure Members
+ *
+ * @var float* StateSpace::A
+ * Continuous state matrix [states x states].
+ *
+ * @var float* StateSpace::B
+ * Continuous input matrix [states x inputs].
+ *
+ * @var float* StateSpace::C
+ * Output matrix [outputs x states]. Same in the continuous and discrete form.
+ *
+ * @var float* StateSpace::D
+ * Feed through matrix [outputs x inputs]. Same in the continuous and discrete form.
+ *
+ * @var float* StateSpace::Ad
+ * Discrete state matrix e^(A*dt).
+ *
+ * @var float* StateSpace::Bd
+ * Discrete input matrix (integral of e^(A*s) ds from 0 to dt) * B.
+ *
+ * @var float StateSpace::dt
+ * The step the discrete matrices are valid for. 0 means the plant is not discretized yet.
+ */
+typedef struct StateSpace {
+    float *A;
+    float *B;
+    float *C;
+    float *D;
+
+    float *Ad;
+    float *Bd;
+
+    size_t states;  // the number of states
+    size_t inputs;  // the number of inputs
+    size_t outputs; // the number of outputs
+
+    float dt; // the step of discretization
+} StateSpace;
+
+
+
+//=============================================================================
+//
+//                     State Space Lifecycle Management Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup StateSpaceLifecycle
+ * @brief Creates a new continuous State Space plant. The matrices are copied.
+ * @param A the row-major state matrix [states x states].
+ * @param B the row-major input matrix [states x inputs].
+ * @param C the row-major output matrix [outputs x states].
+ * @param D the row-major feed through matrix [outputs x inputs], NULL means zero matrix.
+ * @param states the number of states.
+ * @param inputs the number of inputs.
+ * @param outputs the number of outputs.
+ * @return A pointer to the new StateSpace instance.
+ */
+StateSpace* StateSpace_Create(const float *A, const float *B, const float *C, const float *D,
+                              const size_t states, const size_t inputs, const size_t outputs);
+
+/*!
+ * @ingroup StateSpaceLifecycle
+ * @brief Destroy the State Space plant.
+ * @param stateSpace the plant to be destroyed.
+ */
+void StateSpace_Destroy(StateSpace *stateSpace);
+
+
+
+//=============================================================================
+//
+//                     State Space Manipulation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup StateSpaceManipulation
+ * @brief Compute the exact zero-order hold discretization of the plant for the step dt.
+ * @param stateSpace the plant to be discretized.
+ * @param dt the sampling time.
+ *
+ * @note The exponential of the augmented matrix [[A, B], [0, 0]] * dt is computed in double with
+ * scaling and squaring of the Taylor series. Its top blocks are the Ad and Bd matrices.
+ */
+void StateSpace_Discretize(StateSpace *stateSpace, const float dt);
+
+/*!
+ * @ingroup StateSpaceManipulation
+ * @brief Make one discrete step x = Ad*x + Bd*u and return the output of the new state y = C*x + D*u.
+ * @param stateSpace the discretized plant.
+ * @param x the state vector of the size states, updated in place.
+ * @param u the input vector of the size inputs.
+ * @param y the output vector of the size outputs.
+ *
+ * @note No allocation is made, the step is reentrant, so one plant can be shared by threads with own x.
+ */
+void StateSpace_Step(const StateSpace *stateSpace, float *x, const float *u, float *y);
+
+
+
+//=============================================================================
+//
+//                     State Space Query Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup StateSpaceQuery
+ * @brief Compute the steady state gain of the continuous plant G(0) = D - C * A^-1 * B.
+ * @param stateSpace the plant.
+ * @param gain the output matrix [outputs x inputs] row-major.
+ * @return 1 if the gain exists, 0 if the A matrix is singular (the plant has an integrator).
+ */
+int StateSpace_DcGain(const StateSpace *stateSpace, float *gain);
+
+#endif
+
+/**
+* @defgroup StateSpace State Space
+* @ingroup General
+* @brief Linear plants described by the (A, B, C, D) matrices.
+*/
+
+/**
+* @defgroup StateSpaceLifecycle State Space Lifecycle
+* @ingroup StateSpace
+* @brief Lifecycle functions of the State Space.
+*
+* This functions create/destroy State Space
+*/
+
+/**
+* @defgroup StateSpaceQuery State Space Query
+* @ingroup StateSpace
+* @brief Query of the State Space.
+*
+* This functions make read-only analysis of the plant
+*/
+
+/**
+* @defgroup StateSpaceManipulation State Space Manipulation
+* @ingroup StateSpace
+* @brief Manipulation of the State Space.
+*
+* This functions discretize and simulate the plant
+*/
@@ -1,6 +1,39 @@
 #ifndef SYSTEM_BUILDER_H
 #define SYSTEM_BUILDER_H
 
+#include "general/state_space.h"
+#include "general/ode_integrator.h"
+
 int selectSystem(float (**func_ptr)(float*));
 
-#endif
\ No newline at end of file
+// function to select the system by the CLI choice number without the prompt, returns the data size or 0 for unknown choice
+int selectSystemByChoice(float (**func_ptr)(float*), int choice);
+
+// state space version of complexYDddot, data is [u, dt, y, dot_y, ddot_y]
+float complexYDddotStateSpace(float *data);
+
+// nonlinear damped pendulum integrated by adaptive RK45 between the samples, data is [u, dt, theta, dot_theta, ...]
+float nonlinearPendulum(float *data);
+
+// function to read the integrator cost counters from the data memory, returns 0 if the system has none
+int getSystemStepStats(float (*func_ptr)(float*), const float *data, OdeStats *stats);
+
+// function to return the number of the states after u and dt in the data memory, the counters and buffers of the
+// system are not states, the unknown system has all its memory as states
+int getSystemStateCount(float (*func_ptr)(float*), const int sizeDataSystem);
+
+// function to make the selected system ready for the sampling time dt (discretization of state space plants),
+// each dt gets its own model, the function is not thread safe and should be called before the threads start
+void prepareSystem(float (*func_ptr)(float*), const float dt);
+
+// function to return the state space model of the system discretized for dt or NULL if the system is not state space
+// or prepareSystem was not called for the dt
+StateSpace* getSystemStateSpace(float (*func_ptr)(float*), const float dt);
+
+// function to return the stable id of the system (same as in selectSystem), 0 for unknown system
+int getSystemId(float (*func_ptr)(float*));
+
+// function to free the models created by prepareSystem
+void releaseSystems(void);
+
+#endif
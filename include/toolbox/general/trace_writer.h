@@ -0,0 +1,112 @@
+/**
+ * @file trace_writer.h
+ * @brief Buffered binary trace sink public interface.
+ *
+ * This header defines the public interface for the simulation trace writer. The simulation appends
+ * one float record per step (a memcpy into the active buffer), full buffers are handed over to the
+ * background thread which writes them as columnar blocks. The CSV is made afterward by the transcoder.
+ *
+ * File layout:
+ * - header: magic "NNTRACE1", uint32 version, uint32 column count, column names as uint32 length + bytes;
+ * - blocks: uint32 record count, then for each column record count float32 values.
+ */
+
+#ifndef TRACE_WRITER_H
+#define TRACE_WRITER_H
+
+#include <stddef.h>
+
+/*!
+ * @ingroup TraceWriter
+ * @brief The default number of records in one buffer.
+ */
+#define TRACE_WRITER_DEFAULT_RECORDS 65536
+
+/**
+ * @struct TraceWriter
+ * @brief Opaque definition of the trace writer, holding the file, two buffers and the flushing thread.
+ * @ingroup TraceWriter
+ */
+typedef struct TraceWriter TraceWriter;
+
+
+
+//=============================================================================
+//
+//                     Trace Writer Lifecycle Management Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup TraceWriterLifecycle
+ * @brief Open the trace file, write the header and start the flushing thread.
+ * @param path the binary trace file.
+ * @param columns the names of the columns.
+ * @param columnCount the number of floats in one record.
+ * @param bufferRecords the number of records in one buffer, 0 means TRACE_WRITER_DEFAULT_RECORDS.
+ * @return A pointer to the new TraceWriter instance, NULL if the file can't be opened.
+ */
+TraceWriter* TraceWriter_Create(const char *path, const char *const *columns, const size_t columnCount, size_t bufferRecords);
+
+/*!
+ * @ingroup TraceWriterLifecycle
+ * @brief Write all buffered records, stop the thread and close the file.
+ * @param writer the writer to be destroyed.
+ */
+void TraceWriter_Destroy(TraceWriter *writer);
+
+
+
+//=============================================================================
+//
+//                     Trace Writer Manipulation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup TraceWriterManipulation
+ * @brief Append one record. The cost is a memcpy, the caller waits only if both buffers are full.
+ * @param writer the writer.
+ * @param record the columnCount floats of the record.
+ */
+void TraceWriter_Append(TraceWriter *writer, const float *record);
+
+/*!
+ * @ingroup TraceWriterManipulation
+ * @brief Hand over the partially filled buffer and wait until everything is on the disk.
+ * @param writer the writer.
+ */
+void TraceWriter_Flush(TraceWriter *writer);
+
+/*!
+ * @ingroup TraceWriterManipulation
+ * @brief Convert the binary trace into the CSV with the column names as header.
+ * @param binaryPath the trace file.
+ * @param csvPath the output CSV file.
+ * @return The number of records converted, -1 if the trace can't be read or the CSV written.
+ */
+long TraceWriter_TranscodeToCsv(const char *binaryPath, const char *csvPath);
+
+#endif
+
+/**
+* @defgroup TraceWriter Trace Writer
+* @ingroup General
+* @brief Binary simulation trace with background flushing.
+*/
+
+/**
+* @defgroup TraceWriterLifecycle Trace Writer Lifecycle
+* @ingroup TraceWriter
+* @brief Lifecycle functions of the Trace Writer.
+*
+* This functions open/close the Trace Writer
+*/
+
+/**
+* @defgroup TraceWriterManipulation Trace Writer Manipulation
+* @ingroup TraceWriter
+* @brief Manipulation of the Trace Writer.
+*
+* This functions write and convert the trace
+*/
@@ -0,0 +1,196 @@
+/**
+ * @file trajectory_dataset.h
+ * @brief Memory mapped recorded trajectory dataset public interface.
+ *
+ * This header defines the public interface for the recorded runs (reference, measured output, applied u, ...).
+ * The CSV is converted once into the columnar binary file, which is then mapped into the memory. Each column
+ * is one contiguous float array in the file, so the columns are given to the simulation as Signal views
+ * without any parsing or copy, and only the touched pages are read from the disk.
+ *
+ * File layout:
+ * - header: magic "NNTRAJ01", uint32 version, uint32 column count, uint64 row count, float32 dt, uint32 reserved;
+ * - column names: TRAJECTORY_DATASET_NAME_SIZE bytes each, zero padded;
+ * - columns: from the first 64 byte aligned offset, each column has the row count rounded up to
+ *   TRAJECTORY_DATASET_ALIGNMENT floats, so every column starts at the 64 byte boundary.
+ */
+
+#ifndef TRAJECTORY_DATASET_H
+#define TRAJECTORY_DATASET_H
+
+#include "general/signal_designer.h"
+
+#include <stddef.h>
+
+/*!
+ * @ingroup TrajectoryDataset
+ * @brief The size of one column name in the file incl. the terminating zero.
+ */
+#define TRAJECTORY_DATASET_NAME_SIZE 32
+
+/*!
+ * @ingroup TrajectoryDataset
+ * @brief The number of floats each column is padded to, one 64 byte cache line.
+ */
+#define TRAJECTORY_DATASET_ALIGNMENT 16
+
+/**
+ * @struct TrajectoryDataset
+ * @brief Opaque definition of the mapped dataset, holding the mapping and the parsed header.
+ * @ingroup TrajectoryDataset
+ */
+typedef struct TrajectoryDataset TrajectoryDataset;
+
+
+
+//=============================================================================
+//
+//                     Trajectory Dataset Lifecycle Management Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup TrajectoryDatasetLifecycle
+ * @brief Convert the CSV with the header line of column names into the binary dataset.
+ * @param csvPath the input CSV, one row per sample, the values separated by commas.
+ * @param binaryPath the output binary dataset.
+ * @param dt the sampling time, 0 means it is taken from the column named "t" or "time".
+ * @return The number of rows converted, -1 if the CSV can't be read, is malformed or the file can't be written.
+ *
+ * @note The CSV is read twice (count, then fill the mapped output), so only one line is held in the memory.
+ */
+long TrajectoryDataset_ConvertCsv(const char *csvPath, const char *binaryPath, float dt);
+
+/*!
+ * @ingroup TrajectoryDatasetLifecycle
+ * @brief Map the binary dataset read only.
+ * @param path the binary dataset.
+ * @return A pointer to the new TrajectoryDataset instance, NULL if the file can't be opened or is not valid.
+ */
+TrajectoryDataset* TrajectoryDataset_Open(const char *path);
+
+/*!
+ * @ingroup TrajectoryDatasetLifecycle
+ * @brief Unmap the dataset, all the views of it are invalid after it.
+ * @param dataset the dataset to be closed.
+ */
+void TrajectoryDataset_Close(TrajectoryDataset *dataset);
+
+
+
+//=============================================================================
+//
+//                     Trajectory Dataset Query Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup TrajectoryDatasetQuery
+ * @brief Get the number of rows (samples) of each column.
+ */
+size_t TrajectoryDataset_GetRows(const TrajectoryDataset *dataset);
+
+/*!
+ * @ingroup TrajectoryDatasetQuery
+ * @brief Get the number of columns.
+ */
+size_t TrajectoryDataset_GetColumnCount(const TrajectoryDataset *dataset);
+
+/*!
+ * @ingroup TrajectoryDatasetQuery
+ * @brief Get the sampling time.
+ */
+float TrajectoryDataset_GetDt(const TrajectoryDataset *dataset);
+
+/*!
+ * @ingroup TrajectoryDatasetQuery
+ * @brief Get the name of the column.
+ * @param dataset the dataset.
+ * @param column the index of the column.
+ * @return The zero terminated name inside the mapping.
+ */
+const char* TrajectoryDataset_GetColumnName(const TrajectoryDataset *dataset, const size_t column);
+
+/*!
+ * @ingroup TrajectoryDatasetQuery
+ * @brief Find the column by its name.
+ * @param dataset the dataset.
+ * @param name the name of the column.
+ * @return The index of the column, -1 if there is no such column.
+ */
+int TrajectoryDataset_FindColumn(const TrajectoryDataset *dataset, const char *name);
+
+/*!
+ * @ingroup TrajectoryDatasetQuery
+ * @brief Get the values of the column.
+ * @param dataset the dataset.
+ * @param column the index of the column.
+ * @return The pointer to the first value inside the mapping, 64 byte aligned.
+ */
+const float* TrajectoryDataset_GetColumn(const TrajectoryDataset *dataset, const size_t column);
+
+/*!
+ * @ingroup TrajectoryDatasetQuery
+ * @brief Get the window of the column as the Signal, no value is copied.
+ * @param dataset the dataset.
+ * @param column the index of the column.
+ * @param first the first row of the window.
+ * @param length the number of rows, 0 means up to the last row.
+ * @return The Signal view of the window.
+ *
+ * @note The view points into the read only mapping, it should not be written nor passed to deleteSignal.
+ */
+Signal TrajectoryDataset_GetSignal(const TrajectoryDataset *dataset, const size_t column, const size_t first, size_t length);
+
+
+
+//=============================================================================
+//
+//                     Trajectory Dataset Evaluation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup TrajectoryDatasetEvaluation
+ * @brief Score the controller open loop: the recorded w and y are fed in, its u is compared with the recorded u.
+ * @param dataset the dataset.
+ * @param wColumn the index of the reference column.
+ * @param yColumn the index of the measured output column.
+ * @param uColumn the index of the applied control column.
+ * @param controller the controller called once for each row in order, it keeps its state in the context.
+ * @param context the context of the controller.
+ * @return The sum of |u - recorded u| over all the rows.
+ */
+float TrajectoryDataset_ScoreOpenLoop(const TrajectoryDataset *dataset, const size_t wColumn, const size_t yColumn,
+                                      const size_t uColumn, float (*controller)(void*, float, float), void *context);
+
+#endif
+
+/**
+* @defgroup TrajectoryDataset Trajectory Dataset
+* @ingroup General
+* @brief Memory mapped datasets of the recorded runs.
+*/
+
+/**
+* @defgroup TrajectoryDatasetLifecycle Trajectory Dataset Lifecycle
+* @ingroup TrajectoryDataset
+* @brief Lifecycle functions of the Trajectory Dataset.
+*
+* This functions convert/open/close the Trajectory Dataset
+*/
+
+/**
+* @defgroup TrajectoryDatasetQuery Trajectory Dataset Query
+* @ingroup TrajectoryDataset
+* @brief Query of the Trajectory Dataset.
+*
+* This functions read the header and give the column views
+*/
+
+/**
+* @defgroup TrajectoryDatasetEvaluation Trajectory Dataset Evaluation
+* @ingroup TrajectoryDataset
+* @brief Evaluation of the controllers on the Trajectory Dataset.
+*
+* This functions replay the recorded runs through the controllers
+*/
@@ -0,0 +1,209 @@
+/**
+ * @file cma_es.h
+ * @brief Covariance matrix adaptation evolution strategy public interface.
+ *
+ * This header defines the public interface for the CMA-ES engine. The engine samples the rows of the population
+ * from the normal distribution around the mean, the caller evaluates them in the same way as the rows of the
+ * Generation Engine, e.g. by PidBatch_Evaluate or ProcessPool_Evaluate, and the step moves the mean to the better
+ * rows and adapts the step size and the covariance to the successful steps.
+ *
+ * The full covariance keeps the matrix and its Cholesky factor, 2 * genes^2 floats, so the memory grows with
+ * genes^2 and the factor is made again only every few generations, which keeps the genomes of a few thousand
+ * weights feasible. The diagonal covariance keeps only genes floats and learns faster, but it does not learn
+ * the correlations of the genes.
+ */
+
+#ifndef CMA_ES_H
+#define CMA_ES_H
+
+#include "general/random.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @enum CmaCovariance
+ * @brief The model of the covariance of the sampled steps.
+ * @ingroup CmaEs
+ */
+typedef enum CmaCovariance {
+    CMA_FULL     = 0, // the full matrix and its Cholesky factor, O(genes^2) memory and O(genes^2) per row
+    CMA_DIAGONAL = 1  // the separable variant, O(genes) memory and O(genes) per row
+} CmaCovariance;
+
+/**
+ * @struct CmaConfig
+ * @brief Definition of the CMA-ES run.
+ * @ingroup CmaEs
+ */
+typedef struct CmaConfig {
+    size_t genes; // the number of genes of one individual
+    size_t rows;  // the number of sampled rows of one generation, 0 means 4 + 3 ln(genes)
+
+    CmaCovariance covariance;
+
+    const float *mean; // the first mean, NULL means the middle of the bounds or 0 without the bounds
+    float sigma;       // the first step size, relative to the range of the gene with the bounds
+    const float *min;  // the lower bound of each gene, the rows are clipped to it, may be NULL
+    const float *max;  // the upper bound of each gene, may be NULL
+
+    size_t threads; // the threads of the sampling and of the covariance update, 0 means one per core
+    uint64_t seed;  // the seed of the random numbers, the same seed gives the same run
+} CmaConfig;
+
+/**
+ * @struct CmaEs
+ * @brief Definition of the CMA-ES structure.
+ * @ingroup CmaEs
+ * @details
+ * The rows are the row pointers into one block, the same layout as the rows of the Generation Engine.
+ *
+ * @section CmaEsStructDetails Detailed Structure Members
+ *
+ * @var float** CmaEs::current
+ * The sampled rows to be evaluated, clipped to the bounds.
+ *
+ * @var float* CmaEs::steps
+ * The steps y = (x - mean) / (sigma * scale) of the clipped rows, the normals z stay unclipped for the step size path.
+ *
+ * @var float* CmaEs::factor
+ * CMA_FULL: the lower triangle of the Cholesky factor L of the covariance, the steps are L z.
+ */
+typedef struct CmaEs {
+    size_t rows;  // the number of sampled rows, lambda
+    size_t genes; // the number of genes of one individual
+    size_t mu;    // the number of the best rows which move the mean
+
+    CmaCovariance covariance;
+    size_t threads;
+
+    float *memory;   // the rows, rows * genes floats
+    float **current;
+    float *fit;      // the fit of each current row, written by the caller
+    int *order;      // the ranking of the current rows
+
+    float *normals; // the standard normal samples z of each row, rows * genes floats
+    float *steps;   // the steps y of each row, rows * genes floats
+
+    float *mean;  // the centre of the distribution
+    float *scale; // the range of each gene, 1 without the bounds
+    float *min;   // the lower bound of each gene, NULL without the bounds
+    float *max;   // the upper bound of each gene, NULL without the bounds
+    float *pathC; // the evolution path of the covariance
+    float *pathS; // the evolution path of the step size
+    float *work;  // the weighted means of the steps and of the normals, 2 * genes floats
+
+    float *matrix; // CMA_FULL: the covariance, genes^2 floats, CMA_DIAGONAL: its diagonal, genes floats
+    float *factor; // CMA_FULL: the Cholesky factor, genes^2 floats, CMA_DIAGONAL: the square root of the diagonal
+
+    double sigma;   // the step size
+    double *weights; // the recombination weights of the mu best rows
+    double mueff;   // the variance effective selection mass
+    double cc;      // the learning rate of the covariance path
+    double cs;      // the learning rate of the step size path
+    double c1;      // the learning rate of the rank one update
+    double cmu;     // the learning rate of the rank mu update
+    double damps;   // the damping of the step size
+    double chiN;    // the expected length of the standard normal vector
+
+    size_t decompose; // CMA_FULL: the generations between the Cholesky factorizations
+    size_t pending;   // the generations since the last factorization
+
+    Random *streams;   // the random stream of each row
+    uint64_t seed;     // the seed of the run
+    size_t generation; // the number of steps made
+} CmaEs;
+
+
+
+//=============================================================================
+//
+//                     CMA-ES Lifecycle Management Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup CmaEsLifecycle
+ * @brief Create the engine and sample the first rows.
+ * @param config the set up of the run.
+ * @return A pointer to the new CmaEs instance.
+ */
+CmaEs* CmaEs_Create(const CmaConfig *config);
+
+/*!
+ * @ingroup CmaEsLifecycle
+ * @brief Destroy the engine.
+ * @param es the engine to be destroyed.
+ */
+void CmaEs_Destroy(CmaEs *es);
+
+
+
+//=============================================================================
+//
+//                     CMA-ES Manipulation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup CmaEsManipulation
+ * @brief Update the distribution from the current rows and their fit, then sample the next rows into current.
+ * @param es the engine, the fit of all current rows should be set.
+ */
+void CmaEs_Step(CmaEs *es);
+
+
+
+//=============================================================================
+//
+//                     CMA-ES Query Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup CmaEsQuery
+ * @brief Get the index of the current row with the lowest fit.
+ * @param es the engine, the fit of all current rows should be set.
+ * @return The index of the best row.
+ */
+size_t CmaEs_GetBest(const CmaEs *es);
+
+/*!
+ * @ingroup CmaEsQuery
+ * @brief Get the step size, relative to the range of the gene with the bounds.
+ * @param es the engine.
+ * @return The step size sigma.
+ */
+double CmaEs_GetSigma(const CmaEs *es);
+
+#endif
+
+/**
+* @defgroup CmaEs CMA-ES
+* @ingroup Genetic
+* @brief Covariance matrix adaptation evolution strategy.
+*/
+
+/**
+* @defgroup CmaEsLifecycle CMA-ES Lifecycle
+* @ingroup CmaEs
+* @brief Lifecycle functions of the CMA-ES.
+*
+* This functions create/destroy the engine
+*/
+
+/**
+* @defgroup CmaEsManipulation CMA-ES Manipulation
+* @ingroup CmaEs
+* @brief Manipulation of the CMA-ES.
+*
+* This functions adapt the distribution and sample the next rows
+*/
+
+/**
+* @defgroup CmaEsQuery CMA-ES Query
+* @ingroup CmaEs
+* @brief Query of the CMA-ES.
+*
+* This functions read the state of the engine
+*/
@@ -0,0 +1,114 @@
+/**
+ * @file crossover.h
+ * @brief In place crossover of the flat genome rows public interface.
+ *
+ * This header defines the public interface for the crossover of the pairs of rows. The operators change the two
+ * rows in place without any allocation, the segments are swapped by the block copies through the small stack scratch
+ * and the uniform and arithmetic kinds are the plain loops over the genes which the compiler turns into the vector
+ * blends. Each pair uses only its own random stream, so the pairs may be crossed on any number of threads with the
+ * same result.
+ */
+
+#ifndef CROSSOVER_H
+#define CROSSOVER_H
+
+#include "general/random.h"
+
+#include <stddef.h>
+
+/*!
+ * @ingroup Crossover
+ * @brief The biggest number of the crossover points.
+ */
+#define CROSSOVER_MAX_POINTS 16
+
+/**
+ * @enum CrossoverKind
+ * @brief The way the genes of the two parents are mixed.
+ * @ingroup Crossover
+ */
+typedef enum CrossoverKind {
+    CROSSOVER_POINTS        = 0, // the segments between the fixed points are swapped, the same as crossover
+    CROSSOVER_RANDOM_POINTS = 1, // the same with pointsCount random points of each pair
+    CROSSOVER_UNIFORM       = 2, // each gene is swapped with the chance 1/2
+    CROSSOVER_ARITHMETIC    = 3, // the children are the two mixes l * a + (1 - l) * b of one random l of the pair
+    CROSSOVER_BLX           = 4  // each gene is uniform in [low - alpha * d, high + alpha * d] of the parents, clipped to the bounds
+} CrossoverKind;
+
+/**
+ * @struct Crossover
+ * @brief Definition of the crossover operator.
+ * @ingroup Crossover
+ */
+typedef struct Crossover {
+    CrossoverKind kind;
+
+    int points[CROSSOVER_MAX_POINTS]; // CROSSOVER_POINTS: the ascending points, the odd count is closed by the genes
+    size_t pointsCount;               // CROSSOVER_POINTS and CROSSOVER_RANDOM_POINTS: the number of points
+
+    float alpha; // CROSSOVER_BLX: the extension of the parents interval, 0.5 is the usual one
+} Crossover;
+
+
+
+//=============================================================================
+//
+//                     Crossover Manipulation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup CrossoverManipulation
+ * @brief Swap the segments [points[0], points[1]), [points[2], points[3]), ... of the two rows.
+ * @param first the first row, genes floats.
+ * @param second the second row, genes floats.
+ * @param points the ascending points in [0, genes].
+ * @param count the number of points, the odd count is closed by the genes.
+ * @param genes the number of genes of one row.
+ */
+void Crossover_Segments(float *first, float *second, const int *points, const size_t count, const size_t genes);
+
+/*!
+ * @ingroup CrossoverManipulation
+ * @brief Cross one pair of rows in place.
+ * @param crossover the operator.
+ * @param random the stream of the pair.
+ * @param first the first row, genes floats.
+ * @param second the second row, genes floats.
+ * @param genes the number of genes of one row.
+ * @param min the lower bound of each gene, used only by CROSSOVER_BLX.
+ * @param max the upper bound of each gene, used only by CROSSOVER_BLX.
+ */
+void Crossover_Pair(const Crossover *crossover, Random *random, float *first, float *second, const size_t genes,
+                    const float *min, const float *max);
+
+/*!
+ * @ingroup CrossoverManipulation
+ * @brief Cross the pairs of rows (0, 1), (2, 3), ... on the threads, the last odd row is kept.
+ * @param crossover the operator.
+ * @param streams the stream of each row, the pair uses the stream of its first row.
+ * @param rows the rows to be crossed.
+ * @param count the number of rows.
+ * @param genes the number of genes of one row.
+ * @param min the lower bound of each gene, used only by CROSSOVER_BLX.
+ * @param max the upper bound of each gene, used only by CROSSOVER_BLX.
+ * @param threads the number of threads, 0 means all cores, the result is the same for any number.
+ */
+void Crossover_Rows(const Crossover *crossover, Random *streams, float **rows, const size_t count, const size_t genes,
+                    const float *min, const float *max, const size_t threads);
+
+#endif
+
+/**
+* @defgroup Crossover Crossover
+* @ingroup Genetic
+* @brief In place crossover of the flat genomes.
+*/
+
+/**
+* @defgroup CrossoverManipulation Crossover Manipulation
+* @ingroup Crossover
+* @brief Manipulation of the genomes by the Crossover.
+*
+* This functions cross the pairs of rows
+*/
@@ -0,0 +1,229 @@
+/**
+ * @file experiment_runner.h
+ * @brief Headless batch experiment runner public interface.
+ *
+ * This header defines the public interface for running the GA experiments without any prompt. The experiments
+ * are described in the config file, each [experiment] section selects the signal, the system and the GA recipe
+ * by the same numbers as the CLI selectors. All the experiments of the file run concurrently in one process,
+ * each pinned to its own set of cores, and the throughput of each is reported at the end.
+ *
+ * Config example:
+ * @code
+ * # the PID tuned on the state space plant
+ * [experiment]
+ * name        = pid_step
+ * controller  = pid
+ * mode        = generational
+ * signal      = 1
+ * system      = 4
+ * threads     = 2
+ * population  = 200
+ * generations = 100
+ * elite       = 4
+ * mutation    = 0.1
+ * seed        = 7
+ * limit       = 60
+ * min         = 0 0 0 0.01
+ * max         = 100 100 100 1
+ *
+ * # the same recipe on 4 islands of 50 with the ring migration
+ * [experiment]
+ * name        = pid_islands
+ * mode        = islands
+ * threads     = 4
+ * population  = 50
+ * islands     = 4
+ * topology    = ring
+ * interval    = 10
+ * migrants    = 2
+ *
+ * # the generational recipe with the fits made by 4 worker processes
+ * [experiment]
+ * name        = pid_processes
+ * mode        = processes
+ * threads     = 4
+ *
+ * # the CMA-ES with 12 rows per generation
+ * [experiment]
+ * name        = pid_cmaes
+ * mode        = cmaes
+ * population  = 12
+ * @endcode
+ */
+
+#ifndef EXPERIMENT_RUNNER_H
+#define EXPERIMENT_RUNNER_H
+
+#include "genetic/island_model.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*!
+ * @ingroup ExperimentRunner
+ * @brief The biggest number of genes of one individual.
+ */
+#define EXPERIMENT_MAX_GENES 8
+
+/*!
+ * @ingroup ExperimentRunner
+ * @brief The size of the experiment name incl. the terminating zero.
+ */
+#define EXPERIMENT_NAME_SIZE 64
+
+/**
+ * @enum ExperimentController
+ * @brief The controller tuned by the experiment.
+ * @ingroup ExperimentRunner
+ */
+typedef enum ExperimentController {
+    EXPERIMENT_PID = 0 // Kp, Ki, Kd, tauD evaluated by the batched PID simulation
+} ExperimentController;
+
+/**
+ * @enum ExperimentMode
+ * @brief The kind of the GA of the experiment.
+ * @ingroup ExperimentRunner
+ * @details
+ * The generational, the processes and the CMA-ES modes give the same result of the same seed on any number of
+ * threads. The steady state is repeatable only with threads = 1 and the islands only with interval = 0, otherwise
+ * their result depends on the timing of the threads.
+ */
+typedef enum ExperimentMode {
+    EXPERIMENT_GENERATIONAL = 0, // the whole population is evaluated, then the next generation is made
+    EXPERIMENT_STEADY_STATE = 1, // each child replaces the worst individual right after its evaluation, not repeatable
+    EXPERIMENT_ISLANDS      = 2, // the generational islands on their own threads with the migration, not repeatable
+    EXPERIMENT_PROCESSES    = 3, // the generational GA with the fits made by the threads worker processes
+    EXPERIMENT_CMA_ES       = 4  // the CMA-ES with population rows per generation, the elite and the mutation are not used
+} ExperimentMode;
+
+/**
+ * @struct ExperimentConfig
+ * @brief Definition of one experiment: the set up of the loop and the GA recipe.
+ * @ingroup ExperimentRunner
+ */
+typedef struct ExperimentConfig {
+    char name[EXPERIMENT_NAME_SIZE];
+    ExperimentController controller;
+    ExperimentMode mode;
+
+    int signal;     // the choice of cliSignalSelector
+    int system;     // the choice of selectSystem
+    float limit;    // the output limits are +-limit, the integral limits +-limit/2
+    unsigned metrics; // the ControlMetrics mask, 0 is the sum of |e|
+
+    size_t threads;     // the number of cores of the experiment
+    size_t population;  // the number of individuals
+    size_t generations; // the number of generations, the steady state makes population * generations evaluations
+    size_t elite;       // the best individuals copied to the next generation
+    float mutation;     // the chance of the gene to be replaced by the random value
+    uint64_t seed;      // the seed of the GA random numbers, see ExperimentMode for the repeatable modes
+
+    size_t islands;          // EXPERIMENT_ISLANDS: the number of islands of population individuals each
+    IslandTopology topology; // EXPERIMENT_ISLANDS: the island which gets the migrants
+    size_t interval;         // EXPERIMENT_ISLANDS: the generations between the migrations
+    size_t migrants;         // EXPERIMENT_ISLANDS: the number of the best individuals sent by one migration
+
+    size_t genes;                    // the number of genes, set by the controller
+    float min[EXPERIMENT_MAX_GENES]; // the lower bound of each gene
+    float max[EXPERIMENT_MAX_GENES]; // the upper bound of each gene
+} ExperimentConfig;
+
+/**
+ * @struct ExperimentResult
+ * @brief Definition of the outcome and the throughput of one experiment.
+ * @ingroup ExperimentRunner
+ */
+typedef struct ExperimentResult {
+    char name[EXPERIMENT_NAME_SIZE];
+    int valid; // 0 if the experiment could not be built
+
+    size_t firstCore; // the first core of the set
+    size_t cores;     // the size of the core set
+
+    float bestFit;                    // the best fit found
+    float best[EXPERIMENT_MAX_GENES]; // the genes of the best individual
+
+    size_t evaluations;  // the number of the fit evaluations
+    double plantSteps;   // the number of the simulated plant steps
+    double seconds;      // the wall time of the experiment
+} ExperimentResult;
+
+
+
+//=============================================================================
+//
+//                     Experiment Runner Lifecycle Management Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup ExperimentRunnerLifecycle
+ * @brief Set the config to the defaults of the controller.
+ * @param config the config to be set.
+ * @param index the index of the experiment, used in the default name.
+ */
+void ExperimentRunner_Defaults(ExperimentConfig *config, const size_t index);
+
+/*!
+ * @ingroup ExperimentRunnerLifecycle
+ * @brief Read the experiments from the config file.
+ * @param path the config file.
+ * @param configs the output configs.
+ * @param capacity the size of the configs array.
+ * @return The number of experiments, -1 if the file can't be read or has the wrong line (reported to stderr).
+ */
+int ExperimentRunner_Load(const char *path, ExperimentConfig *configs, const size_t capacity);
+
+
+
+//=============================================================================
+//
+//                     Experiment Runner Manipulation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup ExperimentRunnerManipulation
+ * @brief Run all the experiments concurrently, each in its own thread pinned to the disjoint set of cores.
+ * @param configs the experiments.
+ * @param count the number of experiments.
+ * @param results the output results, one per experiment.
+ *
+ * @note When the experiments need more cores than the machine has, the sets wrap around and share the cores.
+ */
+void ExperimentRunner_RunAll(const ExperimentConfig *configs, const size_t count, ExperimentResult *results);
+
+/*!
+ * @ingroup ExperimentRunnerManipulation
+ * @brief Print the table of the results with the throughput of each experiment.
+ * @param file the output stream.
+ * @param results the results.
+ * @param count the number of results.
+ */
+void ExperimentRunner_Report(FILE *file, const ExperimentResult *results, const size_t count);
+
+#endif
+
+/**
+* @defgroup ExperimentRunner Experiment Runner
+* @ingroup Genetic
+* @brief Headless batch runs of the GA experiments.
+*/
+
+/**
+* @defgroup ExperimentRunnerLifecycle Experiment Runner Lifecycle
+* @ingroup ExperimentRunner
+* @brief Lifecycle functions of the Experiment Runner.
+*
+* This functions make and read the configs
+*/
+
+/**
+* @defgroup ExperimentRunnerManipulation Experiment Runner Manipulation
+* @ingroup ExperimentRunner
+* @brief Manipulation of the Experiment Runner.
+*
+* This functions run the experiments and report them
+*/
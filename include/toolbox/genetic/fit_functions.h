@@ -5,6 +5,7 @@
 #include "general/pid_controller.h"
 #include "general/signal_designer.h"
 #include "neural/model_system.h"
+#include "genetic/scenario_set.h"
 
 
 #include <stdio.h>
@@ -15,4 +16,10 @@ void pidFitFunction(struct Pop *population, float *fit, struct PID *pid);
 // function to get fir values of the nn system population
 void nnFitFunction(struct Pop *population, float *fit, struct SystemNN *systemNN);
 
-#endif
\ No newline at end of file
+// function to get fit values of the pid population over all scenarios, the scenarios run in parallel
+void pidScenarioFitFunction(struct Pop *population, float *fit, struct PID *pid, ScenarioSet *set);
+
+// function to get fit values of the nn population over all scenarios, the scenarios run in parallel by the kernel
+void nnScenarioFitFunction(struct Pop *population, float *fit, struct SystemNN *systemNN, ScenarioSet *set);
+
+#endif
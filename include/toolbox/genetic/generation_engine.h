@@ -0,0 +1,200 @@
+/**
+ * @file generation_engine.h
+ * @brief Double buffered GA generation engine public interface.
+ *
+ * This header defines the public interface for the generation engine. The engine keeps two populations of the same
+ * size, the current one and the next one, allocated once. The next generation is described by the plan of slices,
+ * e.g. the best rows, two tournament blocks with the crossover and the mutation and the random block of the
+ * Sekaj recipe. Each slice writes its rows directly into its part of the next population, then the two populations
+ * are swapped, so the generation makes no allocation, no extra copy and no random numbers which are overwritten.
+ */
+
+#ifndef GENERATION_ENGINE_H
+#define GENERATION_ENGINE_H
+
+#include "genetic/crossover.h"
+#include "genetic/mutation.h"
+#include "general/random.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ * @ingroup GenerationEngine
+ * @brief The biggest number of slices of one plan.
+ */
+#define GENERATION_MAX_SLICES 8
+
+/*!
+ * @ingroup GenerationEngine
+ * @brief The biggest number of the repeats or the crossover points of one slice.
+ */
+#define GENERATION_MAX_POINTS CROSSOVER_MAX_POINTS
+
+/**
+ * @enum GenerationSource
+ * @brief The operator which makes the rows of the slice from the current population.
+ * @ingroup GenerationEngine
+ */
+typedef enum GenerationSource {
+    GENERATION_BEST         = 0, // the best rows, the same as selectBest
+    GENERATION_TOURNAMENT   = 1, // the better of the two random rows, the same as selectTournament
+    GENERATION_RANDOM       = 2, // the new random rows between the bounds
+    GENERATION_CLOSE_RANDOM = 3  // the random rows in the radius around the best row, clipped to the bounds
+} GenerationSource;
+
+/**
+ * @struct GenerationSlice
+ * @brief Definition of one block of the next population.
+ * @ingroup GenerationEngine
+ */
+typedef struct GenerationSlice {
+    GenerationSource source;
+    size_t rows; // the number of rows of the slice
+
+    int repeats[GENERATION_MAX_POINTS]; // GENERATION_BEST: the copies of the 1st, 2nd, ... best row, sum should be rows
+    size_t repeatsCount;                // 0 means each of the rows best rows once
+
+    int points[GENERATION_MAX_POINTS]; // the crossover points, the same as the selects of crossover
+    size_t pointsCount;                // 0 means no crossover, CROSSOVER_RANDOM_POINTS: the number of random points
+    CrossoverKind crossoverKind;       // the kind of the crossover, the fixed points by default
+    float alpha;                       // CROSSOVER_BLX: the extension of the parents interval
+
+    float mutation;            // the chance of the gene to be mutated, 0 means no mutation
+    MutationKind mutationKind; // the new value of the mutated gene, the uniform one by default
+    float sigma;               // MUTATION_GAUSSIAN: the deviation relative to the range of the gene
+    float radius;   // GENERATION_CLOSE_RANDOM: the distance from the best row
+} GenerationSlice;
+
+/**
+ * @struct GenerationEngine
+ * @brief Definition of the Generation Engine structure.
+ * @ingroup GenerationEngine
+ * @details
+ * The populations are the row pointers into one block, the rows of the current population are the genomes
+ * evaluated by the fit function, e.g. by PidBatch_Evaluate.
+ *
+ * @section GenerationEngineStructDetails Detailed Structure Members
+ *
+ * @var float** GenerationEngine::current
+ * The rows of the population to be evaluated, swapped with next by GenerationEngine_Step.
+ *
+ * @var int* GenerationEngine::order
+ * The indexes of the current rows, the first ranks used by the best slices are from the best, valid after the step.
+ *
+ * @var Random* GenerationEngine::streams
+ * The streams are made from the seed, the generation and the row index, so the row is the same whichever thread makes it.
+ */
+typedef struct GenerationEngine {
+    size_t rows;  // the number of individuals
+    size_t genes; // the number of genes of one individual
+
+    float *memory;  // the two populations, 2 * rows * genes floats
+    float **current;
+    float **next;
+
+    float *min; // the lower bound of each gene
+    float *max; // the upper bound of each gene
+
+    float *fit; // the fit of each current row, written by the caller
+    int *order; // the ranking of the current rows
+
+    GenerationSlice slices[GENERATION_MAX_SLICES];
+    size_t sliceCount;
+
+    Random *streams;   // the random stream of each row of the next population
+    uint64_t seed;     // the seed of the run
+    size_t generation; // the number of steps made, the streams of each generation are different
+} GenerationEngine;
+
+
+
+//=============================================================================
+//
+//                     Generation Engine Lifecycle Management Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup GenerationEngineLifecycle
+ * @brief Create the engine and fill the first population with the random rows.
+ * @param genes the number of genes of one individual.
+ * @param min the lower bound of each gene.
+ * @param max the upper bound of each gene.
+ * @param slices the plan of the next generation, the population size is the sum of the slice rows.
+ * @param sliceCount the number of slices.
+ * @param seed the seed of the random numbers, the same seed gives the same run.
+ * @return A pointer to the new GenerationEngine instance.
+ */
+GenerationEngine* GenerationEngine_Create(const size_t genes, const float *min, const float *max,
+                                          const GenerationSlice *slices, const size_t sliceCount, const uint64_t seed);
+
+/*!
+ * @ingroup GenerationEngineLifecycle
+ * @brief Destroy the engine.
+ * @param engine the engine to be destroyed.
+ */
+void GenerationEngine_Destroy(GenerationEngine *engine);
+
+
+
+//=============================================================================
+//
+//                     Generation Engine Manipulation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup GenerationEngineManipulation
+ * @brief Make the next generation from the current one and its fit, then swap the populations.
+ * @param engine the engine, the fit of all current rows should be set.
+ */
+void GenerationEngine_Step(GenerationEngine *engine);
+
+
+
+//=============================================================================
+//
+//                     Generation Engine Query Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup GenerationEngineQuery
+ * @brief Get the index of the current row with the lowest fit.
+ * @param engine the engine, the fit of all current rows should be set.
+ * @return The index of the best row.
+ */
+size_t GenerationEngine_GetBest(const GenerationEngine *engine);
+
+#endif
+
+/**
+* @defgroup GenerationEngine Generation Engine
+* @ingroup Genetic
+* @brief Double buffered generations of the GA.
+*/
+
+/**
+* @defgroup GenerationEngineLifecycle Generation Engine Lifecycle
+* @ingroup GenerationEngine
+* @brief Lifecycle functions of the Generation Engine.
+*
+* This functions create/destroy the engine
+*/
+
+/**
+* @defgroup GenerationEngineManipulation Generation Engine Manipulation
+* @ingroup GenerationEngine
+* @brief Manipulation of the Generation Engine.
+*
+* This functions make the next generation
+*/
+
+/**
+* @defgroup GenerationEngineQuery Generation Engine Query
+* @ingroup GenerationEngine
+* @brief Query of the Generation Engine.
+*
+* This functions read the state of the engine
+*/
@@ -0,0 +1,116 @@
+/**
+ * @file island_model.h
+ * @brief Island model GA across threads public interface.
+ *
+ * This header defines the public interface for the island model. The population is split into the islands, each
+ * island is the Generation Engine with its own recipe of slices and its own random streams, run on its own thread.
+ * Every interval generations each island sends the copies of its best rows to the other island by the ring or by
+ * the random choice. The migrants go through the mailbox of the receiving island, which has one slot per sender;
+ * the slot is filled by the sender and emptied by the receiver through one atomic flag, so no island ever waits
+ * for the other one. The migrants of the full slot, which was not read yet, are dropped.
+ *
+ * @note Which migrants arrive and which are dropped depends on the timing of the island threads, so the run with
+ * the migration is not repeatable; with interval 0 each island is the repeatable Generation Engine run.
+ */
+
+#ifndef ISLAND_MODEL_H
+#define ISLAND_MODEL_H
+
+#include "genetic/generation_engine.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ * @ingroup IslandModel
+ * @brief The fit function of the rows of one island, the lower is the better.
+ * @param genomes the rows to be evaluated.
+ * @param count the number of rows.
+ * @param fit the output fit of each row.
+ * @param island the index of the island, e.g. to select the per island simulation memory.
+ * @param context the user data.
+ */
+typedef void (*IslandFit)(float *const *genomes, const size_t count, float *fit, const size_t island, void *context);
+
+/**
+ * @enum IslandTopology
+ * @brief The island which gets the migrants.
+ * @ingroup IslandModel
+ */
+typedef enum IslandTopology {
+    ISLAND_RING   = 0, // the island i sends to the island i + 1, the last one to the first one
+    ISLAND_RANDOM = 1  // each migration goes to the random other island
+} IslandTopology;
+
+/**
+ * @struct IslandConfig
+ * @brief Definition of the island model run.
+ * @ingroup IslandModel
+ */
+typedef struct IslandConfig {
+    size_t islands; // the number of islands, each on its own thread
+
+    size_t genes;     // the number of genes of one individual
+    const float *min; // the lower bound of each gene
+    const float *max; // the upper bound of each gene
+
+    const GenerationSlice *slices; // the recipe of each island, the island size is the sum of the slice rows
+    size_t sliceCount;
+    size_t generations; // the number of evaluated generations of each island
+
+    IslandTopology topology;
+    size_t interval; // the generations between the migrations, 0 means no migration
+    size_t migrants; // the number of the best rows sent by one migration
+
+    uint64_t seed; // the seed of the run, each island has its own streams made from it, see the note on the migration
+} IslandConfig;
+
+/**
+ * @struct IslandResult
+ * @brief Definition of the outcome of the island model run.
+ * @ingroup IslandModel
+ */
+typedef struct IslandResult {
+    float bestFit;      // the fit of the best row of all islands
+    size_t island;      // the island of the best row
+    size_t evaluations; // the number of the fit evaluations of all islands
+    size_t sent;        // the number of the migrations put into the mailboxes
+    size_t dropped;     // the number of the migrations dropped because the slot was still full
+} IslandResult;
+
+
+
+//=============================================================================
+//
+//                     Island Model Manipulation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup IslandModelManipulation
+ * @brief Run the island model GA.
+ * @param config the set up of the run.
+ * @param fit the fit function, it is called concurrently by the islands.
+ * @param context the user data of the fit function.
+ * @param best the output genes of the best row, genes floats.
+ * @param result the output outcome of the run.
+ *
+ * @note The migrations depend on the timing of the threads, so only the run without the migration is repeatable.
+ */
+void IslandModel_Run(const IslandConfig *config, IslandFit fit, void *context, float *best, IslandResult *result);
+
+#endif
+
+/**
+* @defgroup IslandModel Island Model
+* @ingroup Genetic
+* @brief Island model GA with the migration between the threads.
+*/
+
+/**
+* @defgroup IslandModelManipulation Island Model Manipulation
+* @ingroup IslandModel
+* @brief Manipulation of the Island Model.
+*
+* This functions run the island model GA
+*/
@@ -0,0 +1,76 @@
+/**
+ * @file mutation.h
+ * @brief Skip sampling mutation of the flat genome buffers public interface.
+ *
+ * This header defines the public interface for the bounded mutation of the rows of genes stored one after the other.
+ * Instead of one random number per gene to decide if it mutates, the gap to the next mutated gene is drawn from the
+ * geometric distribution of the chance, so the cost is given by the number of mutations, not by the number of genes.
+ * The mutated gene gets the uniform value between its bounds or the Gaussian step clipped to its bounds.
+ */
+
+#ifndef MUTATION_H
+#define MUTATION_H
+
+#include "general/random.h"
+
+#include <stddef.h>
+
+/**
+ * @enum MutationKind
+ * @brief The new value of the mutated gene.
+ * @ingroup Mutation
+ */
+typedef enum MutationKind {
+    MUTATION_UNIFORM  = 0, // the uniform value between the bounds, the same as mutx
+    MUTATION_GAUSSIAN = 1  // the normal step of the deviation sigma * (max - min), clipped to the bounds
+} MutationKind;
+
+/**
+ * @struct Mutation
+ * @brief Definition of the mutation operator.
+ * @ingroup Mutation
+ */
+typedef struct Mutation {
+    MutationKind kind;
+    float chance; // the chance of one gene to be mutated
+    float sigma;  // MUTATION_GAUSSIAN: the deviation relative to the range of the gene
+} Mutation;
+
+
+
+//=============================================================================
+//
+//                     Mutation Manipulation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup MutationManipulation
+ * @brief Mutate the genes of the flat buffer, the rows of width genes are stored one after the other.
+ * @param mutation the operator.
+ * @param random the stream of the random numbers.
+ * @param genes the buffer, count floats.
+ * @param count the number of genes in the buffer, e.g. rows * width.
+ * @param width the number of genes of one row, the gene g has the bounds of g % width.
+ * @param min the lower bound of each gene of the row, width floats.
+ * @param max the upper bound of each gene of the row, width floats.
+ * @return The number of mutated genes.
+ */
+size_t Mutation_Apply(const Mutation *mutation, Random *random, float *genes, const size_t count, const size_t width,
+                      const float *min, const float *max);
+
+#endif
+
+/**
+* @defgroup Mutation Mutation
+* @ingroup Genetic
+* @brief Skip sampling mutation of the flat genomes.
+*/
+
+/**
+* @defgroup MutationManipulation Mutation Manipulation
+* @ingroup Mutation
+* @brief Manipulation of the genomes by the Mutation.
+*
+* This functions mutate the genes
+*/
@@ -0,0 +1,81 @@
+/**
+ * @file scenario_set.h
+ * @brief Evaluation of the controllers over the set of scenarios public interface.
+ *
+ * One scenario is the reference signal with the plant variant. The set evaluates each individual on all its
+ * scenarios in one parallel pass, one task is one individual on one scenario, and merges the scenario fits into
+ * the one fit of the individual. The PID runs on the copy of the pid per thread, the NN runs on the fused closed
+ * loop kernel with one layout per scenario and one state block per thread.
+ */
+
+#ifndef SCENARIO_SET_H
+#define SCENARIO_SET_H
+
+#include "general/pid_controller.h"
+#include "general/signal_designer.h"
+#include "general/signal_generator.h"
+#include "general/control_metrics.h"
+#include "neural/closed_loop_kernel.h"
+
+// the reduction used to merge the fits of all scenarios into the one fit of the individual
+typedef enum ScenarioReduction {
+  SCENARIO_SUM      = 0, // sum of the scenario fits
+  SCENARIO_MAX      = 1, // the worst scenario fit
+  SCENARIO_WEIGHTED = 2  // sum of the scenario fits multiplied by the weights
+}ScenarioReduction;
+
+// one scenario is the reference signal with the plant variant
+typedef struct Scenario {
+  Signal *signal;               // the reference signal, not owned by the set, NULL for the generated reference
+  SignalGenerator generator;    // the generated reference streamed by the kernel, used when the signal is NULL
+  float (*func_system)(float*); // the plant of the scenario
+  int sizeDataSystem;           // size of the plant memory
+  float plantGain;              // the actuator gain of the plant variant, 1 is the nominal plant
+  float weight;                 // the weight used by SCENARIO_WEIGHTED
+}Scenario;
+
+// the set of scenarios evaluated for each individual in one pass
+typedef struct ScenarioSet {
+  Scenario *scenarios; // the array of scenarios
+  int count;           // number of scenarios
+  int capacity;        // allocated scenarios
+
+  ScenarioReduction reduction; // how the scenario fits are merged
+  int threads;                 // the number of threads, 0 means all cores
+
+  // the buffers are allocated once and reused by all the generations
+  float *fits;          // the fit of each individual and scenario [individual * count + scenario]
+  int fitsSize;         // allocated fits
+  float *workerMemory;  // the output signal and the plant memory of each worker
+  int workerMemorySize; // allocated worker memory
+  ClosedLoopState **kernelStates; // the kernel state block of each worker
+  int kernelStatesCount;          // allocated kernel states
+  size_t kernelStateSize;         // the floats of each kernel state
+  ControlMetrics *kernelMetrics;  // the copy of the metrics of each worker
+  int kernelMetricsCount;         // allocated metrics copies
+}ScenarioSet;
+
+// functions to create and remove the scenario set
+ScenarioSet* createScenarioSet(ScenarioReduction reduction);
+void deleteScenarioSet(ScenarioSet *set);
+
+// function to add the scenario, all the signals of the set should have the same dt (the plants are discretized for it)
+void addScenario(ScenarioSet *set, Signal *signal, float (*func_system)(float*), int sizeDataSystem, float plantGain, float weight);
+
+// function to add the scenario with the generated reference, the kernel pulls it in chunks and the horizon is never
+// allocated, the pid needs the signal array and can not evaluate it
+void addGeneratedScenario(ScenarioSet *set, const SignalGenerator *generator, float (*func_system)(float*),
+                          int sizeDataSystem, float plantGain, float weight);
+
+// function to merge the scenario fits of one individual
+float reduceScenarioFits(const ScenarioSet *set, const float *fits);
+
+// function to get fit values of the pid rows [Kp, Ki, Kd, tauD] over all scenarios, the pid gives the limits
+void evaluatePidScenarios(ScenarioSet *set, PID *pid, float **rows, const int individuals, float *fit);
+
+// function to get fit values of the NN weight rows over all scenarios, layouts[s] is the kernel of the scenario s,
+// the metrics are copied for each thread, NULL keeps the sum of |e|
+void evaluateKernelScenarios(ScenarioSet *set, ClosedLoopLayout *const *layouts, const ControlMetrics *metrics,
+                             float **rows, const int individuals, float *fit);
+
+#endif
@@ -0,0 +1,190 @@
+/**
+ * @file seed_population.h
+ * @brief Seed compressed population public interface.
+ *
+ * This header defines the public interface for the population of the seed compressed genomes. The individual is
+ * not stored as its weights but as the list of the perturbations which made it: the first step is the random
+ * initialization and each generation adds one step to the child of the selected parent. Each step is only the seed
+ * and the scale of the normal noise, so the weights are made again on demand directly into the caller buffer, e.g.
+ * the weight buffer of the network, and the population takes rows * (generations + 1) steps instead of
+ * rows * genes floats.
+ *
+ * The child differs from its parent by its last step only, so the caller which keeps the weights of the parent
+ * makes the child by one SeedPopulation_Perturb instead of the whole decoding.
+ */
+
+#ifndef SEED_POPULATION_H
+#define SEED_POPULATION_H
+
+#include "general/random.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @struct SeedStep
+ * @brief One perturbation of the genome: the weights get scale times the normal noise of the seed.
+ * @ingroup SeedPopulation
+ */
+typedef struct SeedStep {
+    uint64_t seed;
+    float scale;
+} SeedStep;
+
+/**
+ * @struct SeedPopulation
+ * @brief Definition of the Seed Population structure.
+ * @ingroup SeedPopulation
+ * @details
+ * The steps of the row i are current[i * capacity], ..., current[i * capacity + lengths[i] - 1].
+ *
+ * @section SeedPopulationStructDetails Detailed Structure Members
+ *
+ * @var int* SeedPopulation::parents
+ * The row of the previous generation which is the parent of each current row, the row itself after the creation.
+ */
+typedef struct SeedPopulation {
+    size_t rows;     // the number of individuals
+    size_t genes;    // the number of the decoded weights of one individual
+    size_t capacity; // the longest list of steps, generations + 1
+
+    SeedStep *memory; // the two populations of the steps, 2 * rows * capacity steps
+    SeedStep *current;
+    SeedStep *next;
+    size_t *lengths;     // the number of steps of each current row
+    size_t *nextLengths; // the number of steps of each next row
+
+    float *fit;   // the fit of each current row, written by the caller
+    int *order;   // the ranking of the current rows
+    int *parents; // the parent of each current row
+
+    size_t elite;      // the best rows copied without the new step
+    size_t truncation; // the number of the best rows which may be the parents
+    float initial;     // the deviation of the first step
+    float sigma;       // the scale of the step of each child
+
+    Random random;     // the stream of the parents and of the new seeds
+    size_t generation; // the number of steps made
+} SeedPopulation;
+
+
+
+//=============================================================================
+//
+//                     Seed Population Lifecycle Management Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup SeedPopulationLifecycle
+ * @brief Create the population, each row has only its random first step.
+ * @param rows the number of individuals.
+ * @param genes the number of the decoded weights of one individual.
+ * @param generations the most steps of the population, the lists are allocated once for them.
+ * @param initial the deviation of the first step, the weights start as the normal noise of this deviation.
+ * @param sigma the scale of the step of each child.
+ * @param truncation the number of the best rows which may be the parents.
+ * @param elite the best rows copied to the next generation without the new step.
+ * @param seed the seed of the random numbers, the same seed gives the same run.
+ * @return A pointer to the new SeedPopulation instance.
+ */
+SeedPopulation* SeedPopulation_Create(const size_t rows, const size_t genes, const size_t generations, const float initial,
+                                      const float sigma, const size_t truncation, const size_t elite, const uint64_t seed);
+
+/*!
+ * @ingroup SeedPopulationLifecycle
+ * @brief Destroy the population.
+ * @param population the population to be destroyed.
+ */
+void SeedPopulation_Destroy(SeedPopulation *population);
+
+
+
+//=============================================================================
+//
+//                     Seed Population Manipulation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup SeedPopulationManipulation
+ * @brief Make the next generation: the elite rows are copied, the other rows are the children of the random rows of the
+ * truncation best with one new step.
+ * @param population the population, the fit of all current rows should be set.
+ */
+void SeedPopulation_Step(SeedPopulation *population);
+
+/*!
+ * @ingroup SeedPopulationManipulation
+ * @brief Make the weights of the row by all its steps.
+ * @param population the population.
+ * @param row the index of the current row.
+ * @param weights the output buffer, genes floats.
+ */
+void SeedPopulation_Decode(const SeedPopulation *population, const size_t row, float *weights);
+
+/*!
+ * @ingroup SeedPopulationManipulation
+ * @brief Add the noise of one step to the weights.
+ * @param step the step.
+ * @param weights the weights, genes floats.
+ * @param genes the number of weights.
+ */
+void SeedPopulation_Perturb(const SeedStep *step, float *weights, const size_t genes);
+
+
+
+//=============================================================================
+//
+//                     Seed Population Query Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup SeedPopulationQuery
+ * @brief Get the index of the current row with the lowest fit.
+ * @param population the population, the fit of all current rows should be set.
+ * @return The index of the best row.
+ */
+size_t SeedPopulation_GetBest(const SeedPopulation *population);
+
+/*!
+ * @ingroup SeedPopulationQuery
+ * @brief Get the last step of the row, the only one which its parent does not have unless the row is the elite copy.
+ * @param population the population.
+ * @param row the index of the current row.
+ * @return The pointer to the last step.
+ */
+const SeedStep* SeedPopulation_GetLastStep(const SeedPopulation *population, const size_t row);
+
+#endif
+
+/**
+* @defgroup SeedPopulation Seed Population
+* @ingroup Genetic
+* @brief Population of the seed compressed genomes.
+*/
+
+/**
+* @defgroup SeedPopulationLifecycle Seed Population Lifecycle
+* @ingroup SeedPopulation
+* @brief Lifecycle functions of the Seed Population.
+*
+* This functions create/destroy the population
+*/
+
+/**
+* @defgroup SeedPopulationManipulation Seed Population Manipulation
+* @ingroup SeedPopulation
+* @brief Manipulation of the Seed Population.
+*
+* This functions make the next generation and decode the rows
+*/
+
+/**
+* @defgroup SeedPopulationQuery Seed Population Query
+* @ingroup SeedPopulation
+* @brief Query of the Seed Population.
+*
+* This functions read the state of the population
+*/
@@ -0,0 +1,95 @@
+/**
+ * @file steady_state.h
+ * @brief Steady state GA on the Chromosome Heap public interface.
+ *
+ * This header defines the public interface for the steady state GA. The population is kept in the Chromosome Heap,
+ * each worker thread takes two parents by the tournament, makes one child by the crossover and the mutation,
+ * evaluates it and, if the child is better than the worst chromosome, the worst is replaced right away. There is
+ * no generation barrier, so the slow evaluation of one child never stops the other cores.
+ *
+ * @note Each child has its own random stream, but its parents and the worst chromosome it replaces depend on the
+ * order in which the threads take the lock, so only the run with one thread is repeatable. The Generation Engine
+ * is the mode which gives the same run on any number of threads.
+ */
+
+#ifndef STEADY_STATE_H
+#define STEADY_STATE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ * @ingroup SteadyState
+ * @brief The fit function of one genome, the lower is the better.
+ * @param genome the genes of the individual.
+ * @param thread the index of the worker thread, e.g. to select the per thread simulation memory.
+ * @param context the user data.
+ */
+typedef float (*SteadyStateFit)(float *genome, const size_t thread, void *context);
+
+/**
+ * @struct SteadyStateConfig
+ * @brief Definition of the steady state run.
+ * @ingroup SteadyState
+ */
+typedef struct SteadyStateConfig {
+    size_t genes;     // the number of genes of one individual
+    const float *min; // the lower bound of each gene
+    const float *max; // the upper bound of each gene
+
+    size_t population;  // the number of chromosomes in the heap
+    size_t evaluations; // the number of children evaluated after the first population
+    size_t threads;     // the number of worker threads, 0 for all cores
+
+    size_t point;   // the crossover point, the genes before it are from the first parent, 0 means no crossover
+    float mutation; // the chance of the gene to be replaced by the random value
+    uint64_t seed;  // the seed of the random numbers, only the run with one thread is repeatable
+} SteadyStateConfig;
+
+/**
+ * @struct SteadyStateResult
+ * @brief Definition of the outcome of the steady state run.
+ * @ingroup SteadyState
+ */
+typedef struct SteadyStateResult {
+    float bestFit;       // the fit of the best chromosome
+    size_t evaluations;  // the number of the fit evaluations incl. the first population
+    size_t replacements; // the number of the children which replaced the worst chromosome
+} SteadyStateResult;
+
+
+
+//=============================================================================
+//
+//                     Steady State Manipulation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup SteadyStateManipulation
+ * @brief Run the steady state GA.
+ * @param config the set up of the run.
+ * @param fit the fit function, it is called concurrently by the worker threads.
+ * @param context the user data of the fit function.
+ * @param best the output genes of the best chromosome, genes floats.
+ * @param result the output outcome of the run.
+ *
+ * @note The run with more threads is not repeatable, the order of the replacements depends on their timing.
+ */
+void SteadyState_Run(const SteadyStateConfig *config, SteadyStateFit fit, void *context, float *best, SteadyStateResult *result);
+
+#endif
+
+/**
+* @defgroup SteadyState Steady State
+* @ingroup Genetic
+* @brief Steady state GA without the generation barrier.
+*/
+
+/**
+* @defgroup SteadyStateManipulation Steady State Manipulation
+* @ingroup SteadyState
+* @brief Manipulation of the Steady State.
+*
+* This functions run the steady state GA
+*/
@@ -4,6 +4,9 @@
 // function to select activation function for pointer
 void selectActivationFunction(float (**func_ptr)(float));
 
+// function to select activation function by the CLI choice number without the prompt, returns 0 for unknown choice
+int selectActivationFunctionByChoice(float (**func_ptr)(float), int choice);
+
 // for tests
 void selectTangActivationFunction(float (**func_ptr)(float));
 void selectSigmActivationFunction(float (**func_ptr)(float));
@@ -0,0 +1,248 @@
+/**
+ * @file closed_loop_kernel.h
+ * @brief Fused closed loop step of the NN controller public interface.
+ *
+ * This header defines the public interface for the fused closed loop kernel. The shared read-only layout
+ * describes the network, the input features and the plant. All the changing values of one individual
+ * (plant memory, features, activations, SD memory) live in one contiguous state block, and one function
+ * advances the whole loop by one step without any allocation. The weights are read directly from the
+ * population row in the same order as fillMatrixesNN uses.
+ */
+
+#ifndef CLOSED_LOOP_KERNEL_H
+#define CLOSED_LOOP_KERNEL_H
+
+#include "general/control_metrics.h"
+#include "general/signal_generator.h"
+
+#include <stddef.h>
+
+/*!
+ * @ingroup ClosedLoopKernel
+ * @brief The biggest number of layers incl. input and output.
+ */
+#define CLOSED_LOOP_MAX_LAYERS 16
+
+/*!
+ * @ingroup ClosedLoopKernel
+ * @brief The number of the consecutive converged steps needed before the fast forward.
+ */
+#define CLOSED_LOOP_STEADY_STEPS 20
+
+/*!
+ * @ingroup ClosedLoopKernel
+ * @brief The number of the reference samples pulled from the generator at once.
+ */
+#define CLOSED_LOOP_CHUNK 256
+
+/**
+ * @struct ClosedLoopConfig
+ * @brief Definition of the set up used to create the layout.
+ * @ingroup ClosedLoopKernel
+ * @details
+ * The arrays are copied by ClosedLoopKernel_CreateLayout, the config can be on the stack.
+ */
+typedef struct ClosedLoopConfig {
+    size_t layers;          // number of layers incl. input and output
+    const int *neurons;     // neurons of each layer
+    const int *layerTypes;  // type of each layer 0 - FF, 1 - SD
+
+    const float *inputMin;  // the normalization minimum of each NN input
+    const float *inputMax;  // the normalization maximum of each NN input
+    float outputMin;        // the de-normalization minimum of the NN output
+    float outputMax;        // the de-normalization maximum of the NN output
+    float (*activation)(float);
+
+    void (*features)(float*, const void*); // the input system, data[0] - dt, data[1..3] - e, u, y
+    const void *featureContext;            // the read only data of the input system, e.g. its feature engine
+    size_t featureSize;       // size of the input system memory
+    size_t featureStart;      // the first feature passed to the NN
+
+    float (*plant)(float*); // the plant, data[0] - u, data[1] - dt
+    size_t plantSize;       // size of the plant memory
+    size_t plantStates;     // the states data[2 .. 2 + plantStates) compared by the fast forward
+    float plantGain;        // the actuator gain of the plant variant
+    float minOutput;        // the lower limit of the plant output
+    float maxOutput;        // the upper limit of the plant output
+
+    float dt;       // the plant step
+    int decimation; // the NN runs each decimation plant steps
+
+    int fastForward;       // 1 - skip to the next reference change once the loop is converged, 0 - run all steps
+    float steadyTolerance; // the relative change of the plant states, NN inputs and SD memory seen as converged
+} ClosedLoopConfig;
+
+/**
+ * @struct ClosedLoopLayout
+ * @brief Definition of the shared read-only part of the kernel.
+ * @ingroup ClosedLoopKernel
+ * @details
+ * The layout holds the copy of the config and the offsets of the weights in the population row and of
+ * the parts of the state block. One layout is shared by all the individuals and threads.
+ */
+typedef struct ClosedLoopLayout {
+    ClosedLoopConfig config;
+
+    size_t neurons[CLOSED_LOOP_MAX_LAYERS];      // neurons of each layer
+    int sdLayer[CLOSED_LOOP_MAX_LAYERS];         // 1 if the layer is SD
+    size_t sdOffset[CLOSED_LOOP_MAX_LAYERS];     // offset of the SD layer in the SD memory and types
+    size_t weightOffset[CLOSED_LOOP_MAX_LAYERS]; // offset of the weights into the layer in the row
+    size_t biasOffset[CLOSED_LOOP_MAX_LAYERS];   // offset of the biases into the layer in the row
+    size_t weightCount;                          // the length of the population row
+    size_t maxNeurons;                           // the widest layer
+
+    unsigned char *sdTypes; // 0 - straight, 1 - S, 2 - D for each neuron of the SD layers
+    float *inputMin;        // copy of the normalization minimums
+    float *inputMax;        // copy of the normalization maximums
+
+    size_t featureOffset;  // the features in the state data
+    size_t bufferOffset;   // two activation buffers of maxNeurons in the state data
+    size_t memoryOffset;   // the SD memory in the state data
+    size_t steadyOffset;   // the snapshot of the plant states, NN inputs and SD memory of the previous step, fast forward only
+    size_t stateSize;      // the number of floats in the state data
+} ClosedLoopLayout;
+
+/**
+ * @struct ClosedLoopState
+ * @brief Definition of the per individual state block.
+ * @ingroup ClosedLoopKernel
+ * @details
+ * The data member is the flexible array with the plant memory first, then the features, the activations,
+ * the SD memory and with the fast forward the snapshot of the previous step, so the whole loop of one individual
+ * is in one allocation.
+ */
+typedef struct ClosedLoopState {
+    const float *weights; // the population row of the individual, not owned
+    size_t step;          // the number of plant steps made, the skipped steps included
+    size_t skipped;       // the number of steps skipped by the fast forward
+    float u;              // the last NN output
+    float y;              // the last plant output
+
+    float fit;           // the sum of |e|
+    int maxCounter;      // number of the clamped outputs
+    int steadyRiseCheck; // number of the falling outputs
+
+    float data[];
+} ClosedLoopState;
+
+
+
+//=============================================================================
+//
+//                     Closed Loop Kernel Lifecycle Management Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup ClosedLoopKernelLifecycle
+ * @brief Create the shared layout. The SD neurons get the same types as in createNeuralNetwork.
+ * @param config the set up of the loop.
+ * @return A pointer to the new ClosedLoopLayout instance.
+ */
+ClosedLoopLayout* ClosedLoopKernel_CreateLayout(const ClosedLoopConfig *config);
+
+/*!
+ * @ingroup ClosedLoopKernelLifecycle
+ * @brief Destroy the layout.
+ * @param layout the layout to be destroyed.
+ */
+void ClosedLoopKernel_DestroyLayout(ClosedLoopLayout *layout);
+
+/*!
+ * @ingroup ClosedLoopKernelLifecycle
+ * @brief Create the state block of one individual.
+ * @param layout the layout.
+ * @return A pointer to the new ClosedLoopState instance.
+ */
+ClosedLoopState* ClosedLoopKernel_CreateState(const ClosedLoopLayout *layout);
+
+/*!
+ * @ingroup ClosedLoopKernelLifecycle
+ * @brief Destroy the state block.
+ * @param state the state to be destroyed.
+ */
+void ClosedLoopKernel_DestroyState(ClosedLoopState *state);
+
+/*!
+ * @ingroup ClosedLoopKernelLifecycle
+ * @brief Clear the state for the new run of the individual.
+ * @param layout the layout.
+ * @param state the state.
+ * @param weights the population row of the individual.
+ */
+void ClosedLoopKernel_Reset(const ClosedLoopLayout *layout, ClosedLoopState *state, const float *weights);
+
+
+
+//=============================================================================
+//
+//                     Closed Loop Kernel Manipulation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup ClosedLoopKernelManipulation
+ * @brief Advance the loop by one plant step: features, NN (each decimation step), plant, limits and fit.
+ * @param layout the layout.
+ * @param state the state.
+ * @param reference the reference w of the step.
+ * @return The plant output y of the step.
+ */
+float ClosedLoopKernel_Step(const ClosedLoopLayout *layout, ClosedLoopState *state, const float reference);
+
+/*!
+ * @ingroup ClosedLoopKernelManipulation
+ * @brief Run the whole reference from the sample 1, the same way as makeSimulationOfSignalNN.
+ * @details With the fast forward the loop, which is unclamped and has the plant u and states, the NN inputs and the
+ * SD memory converged for CLOSED_LOOP_STEADY_STEPS steps of the constant reference, repeats its last step up to the
+ * next reference change. The constant error of the skipped steps is added at once, so the fit differs from the full run only
+ * by the remaining change below the tolerance.
+ * @param layout the layout.
+ * @param state the state.
+ * @param weights the population row of the individual.
+ * @param reference the reference samples.
+ * @param length the number of samples.
+ * @param metrics the streaming metrics fed with each step, NULL or the mask 0 skips them.
+ * @return The fit, the weighted metrics if used or the sum of |e|.
+ */
+float ClosedLoopKernel_Simulate(const ClosedLoopLayout *layout, ClosedLoopState *state, const float *weights,
+                                const float *reference, const size_t length, ControlMetrics *metrics);
+
+/*!
+ * @ingroup ClosedLoopKernelManipulation
+ * @brief Run the whole horizon of the generator the same way as ClosedLoopKernel_Simulate.
+ * @details The generator is rewound and the reference is pulled in chunks of CLOSED_LOOP_CHUNK samples on the stack,
+ * so the horizon is never allocated. The fit is the same as of the materialized reference.
+ * @param layout the layout.
+ * @param state the state.
+ * @param weights the population row of the individual.
+ * @param generator the reference generator, each thread needs its own copy.
+ * @param metrics the streaming metrics fed with each step, NULL or the mask 0 skips them.
+ * @return The fit, the weighted metrics if used or the sum of |e|.
+ */
+float ClosedLoopKernel_SimulateStream(const ClosedLoopLayout *layout, ClosedLoopState *state, const float *weights,
+                                      SignalGenerator *generator, ControlMetrics *metrics);
+
+#endif
+
+/**
+* @defgroup ClosedLoopKernel Closed Loop Kernel
+* @ingroup Neural
+* @brief Fused allocation free closed loop of the NN controller.
+*/
+
+/**
+* @defgroup ClosedLoopKernelLifecycle Closed Loop Kernel Lifecycle
+* @ingroup ClosedLoopKernel
+* @brief Lifecycle functions of the Closed Loop Kernel.
+*
+* This functions create/destroy/reset the layout and the states
+*/
+
+/**
+* @defgroup ClosedLoopKernelManipulation Closed Loop Kernel Manipulation
+* @ingroup ClosedLoopKernel
+* @brief Manipulation of the Closed Loop Kernel.
+*
+* This functions advance the loop
+*/
@@ -0,0 +1,190 @@
+/**
+ * @file feature_engine.h
+ * @brief Ring buffer feature pipeline of the NN inputs public interface.
+ *
+ * This header defines the public interface for the feature engine. The engine gets the list of the features
+ * the network needs (values with any lag, derivatives, integrals of e, u, y) and computes only them.
+ * The past samples are kept in the ring buffers with the power of two capacity, so one step is O(1) for any lag.
+ * The history is the plain float block owned by the caller (e.g. the tail of the input data of the system),
+ * and each value in it has batch lanes, so the features of many individuals are computed in one call.
+ */
+
+#ifndef FEATURE_ENGINE_H
+#define FEATURE_ENGINE_H
+
+#include <stddef.h>
+
+/*!
+ * @ingroup FeatureEngine
+ * @brief The biggest number of features of one engine.
+ */
+#define FEATURE_ENGINE_MAX_FEATURES 64
+
+/**
+ * @enum FeatureSource
+ * @brief The signal the feature is made from, the same order as the input data e, u, y.
+ * @ingroup FeatureEngine
+ */
+typedef enum FeatureSource {
+    FEATURE_E       = 0, // the control error
+    FEATURE_U       = 1, // the previous controller output
+    FEATURE_Y       = 2, // the plant output
+    FEATURE_SOURCES = 3
+} FeatureSource;
+
+/**
+ * @enum FeatureKind
+ * @brief The operation made on the source.
+ * @ingroup FeatureEngine
+ */
+typedef enum FeatureKind {
+    FEATURE_VALUE             = 0, // x[t - lag]
+    FEATURE_DERIVATIVE        = 1, // (x[t] - x[t-1]) / dt
+    FEATURE_SECOND_DERIVATIVE = 2, // the difference of the two last derivatives / dt
+    FEATURE_INTEGRAL          = 3  // the sum of all x, the same as ie of typeOne
+} FeatureKind;
+
+/**
+ * @struct FeatureSpec
+ * @brief Definition of one feature.
+ * @ingroup FeatureEngine
+ */
+typedef struct FeatureSpec {
+    FeatureSource source;
+    FeatureKind kind;
+    int lag; // the delay in the controller steps, used only by FEATURE_VALUE
+} FeatureSpec;
+
+/**
+ * @struct FeatureEngine
+ * @brief Definition of the Feature Engine structure.
+ * @ingroup FeatureEngine
+ * @details
+ * The engine is read only after the creation, so it can be shared by the threads, each with own history.
+ *
+ * @section FeatureEngineStructDetails Detailed Structure Members
+ *
+ * @var size_t FeatureEngine::capacity
+ * The ring buffer capacity, the power of two bigger than the deepest needed sample.
+ *
+ * @var size_t FeatureEngine::historySize
+ * The floats of the history: the ring head, the rings of the used sources, the integrals of the used sources.
+ */
+typedef struct FeatureEngine {
+    FeatureSpec specs[FEATURE_ENGINE_MAX_FEATURES];
+    size_t count; // the number of features
+    size_t batch; // the number of lanes of each value
+
+    size_t capacity; // the ring capacity
+    size_t mask;     // capacity - 1
+
+    int ringIndex[FEATURE_SOURCES];     // the index of the ring of the source, -1 if not needed
+    int integralIndex[FEATURE_SOURCES]; // the index of the integral of the source, -1 if not needed
+
+    size_t ringOffset;     // the first ring in the history
+    size_t integralOffset; // the first integral in the history
+    size_t historySize;    // the floats of the history
+} FeatureEngine;
+
+
+
+//=============================================================================
+//
+//                     Feature Engine Lifecycle Management Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup FeatureEngineLifecycle
+ * @brief Create the engine for the features.
+ * @param specs the features in the order of the NN inputs.
+ * @param count the number of features.
+ * @param batch the number of lanes, 1 for one individual.
+ * @return A pointer to the new FeatureEngine instance.
+ */
+FeatureEngine* FeatureEngine_Create(const FeatureSpec *specs, const size_t count, const size_t batch);
+
+/*!
+ * @ingroup FeatureEngineLifecycle
+ * @brief Destroy the engine.
+ * @param engine the engine to be destroyed.
+ */
+void FeatureEngine_Destroy(FeatureEngine *engine);
+
+/*!
+ * @ingroup FeatureEngineLifecycle
+ * @brief Clear the history, all the past samples are 0. The zeroed float block is also a valid clear history.
+ * @param engine the engine.
+ * @param history the history of historySize floats.
+ */
+void FeatureEngine_Reset(const FeatureEngine *engine, float *history);
+
+
+
+//=============================================================================
+//
+//                     Feature Engine Manipulation Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup FeatureEngineManipulation
+ * @brief Push the samples of the controller step and compute the features.
+ * @param engine the engine.
+ * @param history the history of historySize floats.
+ * @param dt the controller step.
+ * @param e the batch errors.
+ * @param u the batch controller outputs.
+ * @param y the batch plant outputs.
+ * @param features the output [feature][lane], count * batch floats.
+ */
+void FeatureEngine_Push(const FeatureEngine *engine, float *history, const float dt,
+                        const float *e, const float *u, const float *y, float *features);
+
+
+
+//=============================================================================
+//
+//                     Feature Engine Query Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup FeatureEngineQuery
+ * @brief Get the index of the generic normalization of the feature (see SystemNN::inputTypes).
+ * @param spec the feature.
+ * @return The normalization type, the lagged value has the same type as the value.
+ */
+int FeatureEngine_NormalizationType(const FeatureSpec *spec);
+
+#endif
+
+/**
+* @defgroup FeatureEngine Feature Engine
+* @ingroup Neural
+* @brief Ring buffer pipeline of the NN input features.
+*/
+
+/**
+* @defgroup FeatureEngineLifecycle Feature Engine Lifecycle
+* @ingroup FeatureEngine
+* @brief Lifecycle functions of the Feature Engine.
+*
+* This functions create/destroy the engine and clear the history
+*/
+
+/**
+* @defgroup FeatureEngineQuery Feature Engine Query
+* @ingroup FeatureEngine
+* @brief Query of the Feature Engine.
+*
+* This functions describe the features
+*/
+
+/**
+* @defgroup FeatureEngineManipulation Feature Engine Manipulation
+* @ingroup FeatureEngine
+* @brief Manipulation of the Feature Engine.
+*
+* This functions compute the features
+*/
@@ -4,6 +4,14 @@
 #include "neural/model_system.h"
 
 // function to select activation function for pointer
-void selectInputNNFunction(void (**func_ptr)(float*), struct SystemNN *systemInput);
+void selectInputNNFunction(void (**func_ptr)(float*, const void*), struct SystemNN *systemInput);
+
+// function to select the input system by the CLI choice number without the prompt, lags is used by the choice 3
+// returns 0 for unknown choice or wrong lags
+int selectInputNNFunctionByChoice(void (**func_ptr)(float*, const void*), struct SystemNN *systemInput, int choice, int lags);
+
+// the input system with e[t-k] and y[t-k] features of any depth computed by the ring buffer feature engine,
+// the context is the SystemNN::featureEngine made by selectInputNNFunction and freed by clearNNSystem
+void typeLags(float *data, const void *context);
 
 #endif
\ No newline at end of file
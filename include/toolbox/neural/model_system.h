@@ -2,9 +2,13 @@
 #define MODEL_SYSTEM_H
 
 #include "neural/neural_network.h"
+#include "neural/closed_loop_kernel.h"
+#include "neural/feature_engine.h"
 #include "general/matrix_math.h"
+#include "general/control_metrics.h"
 #include "general/signal_designer.h"
 #include "general/systems_builder.h"
+#include "general/trace_writer.h"
 
 #include <stdio.h>
 
@@ -22,7 +26,8 @@ typedef struct SystemNN {
   float *dataSystem;     // memory used by the system
   int sizeDataSystem;    // size of data_system saving point
 
-  float (*input_sys)(float*); // function pointer to the input system
+  void (*input_sys)(float*, const void*); // function pointer to the input system, gets the featureEngine
+  FeatureEngine *featureEngine; // the engine of the input system, NULL for the fixed input systems, owned by the system
   float  *inputData;     // memory for the input system
   int    *inputDataSize; // the vector containing all nececary information about data [start, end, full]
   int    *inputTypes;  // the array containing the types of the generic normalization toolbox config
@@ -35,6 +40,19 @@ typedef struct SystemNN {
   float maxSys;
   float minSys;
 
+  float plantGain; // the actuator gain of the plant variant, 1 is the nominal plant
+  int decimation;  // the NN runs every decimation plant steps with the u held between, 1 - every step
+
+  int recalibrate; // 1 - ignore the normalization cache and run the calibration again
+
+  TraceWriter *trace; // the binary trace used instead of the csv file when set, owned by the system
+
+  // steady state fast forward of the constant reference segments, made by the kernel of nnFitFunction,
+  // makeSimulationOfSignalNN runs all the steps for the trace
+  int fastForward;        // 1 - skip to the next reference change once the loop is converged
+  float steadyTolerance;  // the relative change of the plant states, NN inputs and SD memory seen as converged
+
+  ControlMetrics metrics; // the streaming quality metrics, with the mask 0 the fit stays the sum of |e|
   float fit; // fit value of the run
 
   // checks
@@ -46,7 +64,16 @@ typedef struct SystemNN {
 void createNNSystem(struct SystemNN *systemNN, struct NNInput *input);
 void clearNNSystem(struct SystemNN *systemNN);
 
-// function to simulate one close loop run of the system
-void makeSimulationOfSignalNN(struct SystemNN *systemNN, FILE *csvFile, int csv);
+// function to find the normalization of the NN inputs for the system and signal (cached on disk)
+void createDeNormalization(struct SystemNN *systemNN);
+
+// function to describe the system for the fused closed loop kernel, the normalization should be made before
+ClosedLoopLayout* createClosedLoopLayout(struct SystemNN *systemNN);
+
+// function to simulate one close loop run of the system with the weights of the population row, made by the kernel
+void makeSimulationOfSignalNN(struct SystemNN *systemNN, const float *weights, FILE *csvFile, int csv);
+
+// open the binary trace with the columns y, w, u, y_corrected, the csv can be made later with TraceWriter_TranscodeToCsv
+void openNNSystemTrace(struct SystemNN *systemNN, const char *path);
 
 #endif
\ No newline at end of file
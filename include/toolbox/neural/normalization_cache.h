@@ -0,0 +1,101 @@
+/**
+ * @file normalization_cache.h
+ * @brief On-disk cache of the normalization calibration public interface.
+ *
+ * The normalization ranges found by the calibration depend only on the plant, the signal and
+ * the output limits. This interface saves the calibration table keyed by the hash of those inputs,
+ * so later runs with the same set up skip the calibration.
+ */
+
+#ifndef NORMALIZATION_CACHE_H
+#define NORMALIZATION_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*!
+ * @ingroup NormalizationCache
+ * @brief The number of the generic inputs in the calibration table (e, u, y and their d/dd/i).
+ */
+#define NORMALIZATION_CACHE_ENTRIES 12
+
+/*!
+ * @ingroup NormalizationCache
+ * @brief The default file of the cache, relative to the working directory.
+ */
+#define NORMALIZATION_CACHE_FILE "normalization_cache.bin"
+
+
+
+//=============================================================================
+//
+//                     Normalization Cache Key Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup NormalizationCacheKey
+ * @brief Return the starting value of the key hash (FNV-1a 64 bit offset basis).
+ * @return The empty hash.
+ */
+uint64_t NormalizationCache_HashStart(void);
+
+/*!
+ * @ingroup NormalizationCacheKey
+ * @brief Add the bytes to the key hash.
+ * @param hash the current hash.
+ * @param data the bytes to be added.
+ * @param size the number of bytes.
+ * @return The updated hash.
+ */
+uint64_t NormalizationCache_HashBytes(uint64_t hash, const void *data, const size_t size);
+
+
+
+//=============================================================================
+//
+//                     Normalization Cache Storage Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup NormalizationCacheStorage
+ * @brief Find the table of the key in the cache file.
+ * @param path the cache file.
+ * @param key the hash of the calibration set up.
+ * @param table the output table of NORMALIZATION_CACHE_ENTRIES floats.
+ * @return 1 if the table was found, 0 if the file is missing, corrupted or has no such key.
+ */
+int NormalizationCache_Load(const char *path, const uint64_t key, float *table);
+
+/*!
+ * @ingroup NormalizationCacheStorage
+ * @brief Save the table of the key into the cache file. Existing record of the key is replaced.
+ * @details The runs saving into the same file are serialized by the lock on the side file path.lock, so the records
+ * of the concurrent runs are merged, not lost.
+ * @param path the cache file.
+ * @param key the hash of the calibration set up.
+ * @param table the table of NORMALIZATION_CACHE_ENTRIES floats.
+ * @return 1 if the table was saved, 0 if the file can't be written (the cache is optional, so it is not fatal).
+ */
+int NormalizationCache_Save(const char *path, const uint64_t key, const float *table);
+
+#endif
+
+/**
+* @defgroup NormalizationCache Normalization Cache
+* @ingroup Neural
+* @brief Persistent calibration results of the NN normalization.
+*/
+
+/**
+* @defgroup NormalizationCacheKey Normalization Cache Key
+* @ingroup NormalizationCache
+* @brief Hash of the calibration set up.
+*/
+
+/**
+* @defgroup NormalizationCacheStorage Normalization Cache Storage
+* @ingroup NormalizationCache
+* @brief Reading and writing of the cache file.
+*/
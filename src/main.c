@@ -1,13 +1,34 @@
 #include "genetic/population.h"
+#include "genetic/experiment_runner.h"
 #include "general/matrix_math.h"
 #include "general/sort.h"
+#include "general/general_math.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 
+// the biggest number of experiments of one config file
+#define MAX_EXPERIMENTS 64
 
 
-int main(){
-  srand(time(0));
-}
\ No newline at end of file
+
+int main(int argc, char **argv){
+  setRandomSeed((uint64_t)time(0));
+
+  // with the config file the experiments are run without any prompt
+  if (argc > 1){
+    ExperimentConfig configs[MAX_EXPERIMENTS];
+    ExperimentResult results[MAX_EXPERIMENTS];
+
+    const int count = ExperimentRunner_Load(argv[1], configs, MAX_EXPERIMENTS);
+    if (count < 0){
+      fprintf(stderr, "Failed to load experiments from %s\n", argv[1]);
+      return EXIT_FAILURE;
+    }
+
+    ExperimentRunner_RunAll(configs, (size_t)count, results);
+    ExperimentRunner_Report(stdout, results, (size_t)count);
+  }
+  return EXIT_SUCCESS;
+}
@@ -5,12 +5,12 @@
 #include "chromosome.h"
 
 #include <assert.h>
-#include <stdint.h>
+#include <float.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 struct Chromosome {
-  size_t fit; // the value of the fit applied to the chromosome
+  float fit; // the value of the fit applied to the chromosome
   ArrayFloat *weights; // the actual weight array
 };
 
@@ -28,11 +28,18 @@ Chromosome* Chromosome_Create(const size_t numberOfElements){
   if (chromosome == NULL) { perror("Failed to allocate chromosome"); return NULL; }
 
   Chromosome_SetWeights(chromosome, ArrayFloat_Create(numberOfElements)); // by default is set to 0.0 all values
-  Chromosome_SetFit(chromosome, SIZE_MAX);
+  Chromosome_SetFit(chromosome, FLT_MAX);
 
   return chromosome;
 }
 
+void Chromosome_Destroy(Chromosome *chromosome){
+  if (chromosome == NULL) { return; }
+
+  ArrayFloat_Destroy(Chromosome_GetWeights(chromosome));
+  free(chromosome);
+}
+
 
 
 //=============================================================================
@@ -41,7 +48,7 @@ Chromosome* Chromosome_Create(const size_t numberOfElements){
 //
 //=============================================================================
 
-size_t Chromosome_GetFit(const Chromosome *chromosome) { return chromosome->fit; }
+float Chromosome_GetFit(const Chromosome *chromosome) { return chromosome->fit; }
 ArrayFloat* Chromosome_GetWeights(const Chromosome *chromosome) { return chromosome->weights; }
 
 
@@ -52,10 +59,11 @@ ArrayFloat* Chromosome_GetWeights(const Chromosome *chromosome) { return chromos
 //
 //=============================================================================
 
-void Chromosome_SetFit(Chromosome *chromosome, const size_t fit) { assert(fit >= 0  && "fit must be positive!"); chromosome->fit = fit; }
+void Chromosome_SetFit(Chromosome *chromosome, const float fit) { assert(fit >= 0  && "fit must be positive!"); chromosome->fit = fit; }
 void Chromosome_SetWeights(Chromosome *chromosome, ArrayFloat *weights) { chromosome->weights = weights; }
 
 void Chromosome_SetWeightsFloat(const Chromosome *chromosome, const float *weights){
-  const size_t size = Array_GetIndex(Chromosome_GetWeights(chromosome));
+  // the weights are created with the capacity of the elements and the index 0, so the capacity is the size
+  const size_t size = ArrayFloat_GetCapacity(Chromosome_GetWeights(chromosome));
   ArrayFloat_SetDataFromTo(Chromosome_GetWeights(chromosome), 0, size, weights);
 }
\ No newline at end of file
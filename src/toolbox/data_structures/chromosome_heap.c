@@ -0,0 +1,234 @@
+/**
+ * @file chromosome_heap.c
+ * @brief Fit ordered Chromosome Heap data structure public interface implementation.
+ *
+ * This file defines all implementations of the Chromosome Heap public interface
+ *
+ * Copyright (C) 2025 Egor Demianov
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "chromosome_heap.h"
+
+#include "array.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @struct ChromosomeHeapItem
+ * @brief One item of the heap: the fit is saved next to the pointer, so the compare is made in the Array memory.
+ * @ingroup ChromosomeHeap
+ */
+typedef struct ChromosomeHeapItem {
+  float fit;
+  Chromosome *chromosome;
+} ChromosomeHeapItem;
+
+struct ChromosomeHeap {
+  Array *items; // the heap items in the min-max order
+};
+
+static ChromosomeHeapItem* ChromosomeHeap_GetItems(const ChromosomeHeap *heap);
+static int ChromosomeHeap_IsMinLevel(size_t index);
+static int ChromosomeHeap_IsBefore(const ChromosomeHeapItem *items, const size_t first, const size_t second, const int minLevel);
+static void ChromosomeHeap_Swap(ChromosomeHeapItem *items, const size_t first, const size_t second);
+static void ChromosomeHeap_PushUp(ChromosomeHeapItem *items, size_t index, const int minLevel);
+static void ChromosomeHeap_TrickleDown(ChromosomeHeapItem *items, const size_t size, size_t index, const int minLevel);
+
+//=============================================================================
+//
+//                     Chromosome Heap Lifecycle Management Functions
+//
+//=============================================================================
+
+ChromosomeHeap* ChromosomeHeap_Create(const size_t capacity){
+  ChromosomeHeap *heap = NULL;
+  heap = malloc(sizeof(ChromosomeHeap));
+  if (heap == NULL) { perror("Failed to allocate Chromosome Heap"); exit(EXIT_FAILURE); }
+
+  // one more item, so the capacity chromosomes are inserted without the Array growth
+  heap->items = Array_Create(capacity + 1, sizeof(ChromosomeHeapItem));
+
+  return heap;
+}
+
+void ChromosomeHeap_Destroy(ChromosomeHeap *heap){
+  if (heap == NULL) { return; }
+
+  Array_Destroy(heap->items);
+  free(heap);
+}
+
+
+
+//=============================================================================
+//
+//                     Chromosome Heap Query Functions
+//
+//=============================================================================
+
+size_t ChromosomeHeap_GetSize(const ChromosomeHeap *heap) { return Array_GetIndex(heap->items); }
+
+Chromosome* ChromosomeHeap_PeekBest(const ChromosomeHeap *heap){
+  assert(ChromosomeHeap_GetSize(heap) > 0 && "heap should not be empty!");
+  return ChromosomeHeap_GetItems(heap)[0].chromosome;
+}
+
+Chromosome* ChromosomeHeap_PeekWorst(const ChromosomeHeap *heap){
+  const size_t size = ChromosomeHeap_GetSize(heap);
+  const ChromosomeHeapItem *items = ChromosomeHeap_GetItems(heap);
+  assert(size > 0 && "heap should not be empty!");
+
+  // the worst is the root for one item, otherwise the bigger of the two max level items
+  if (size == 1) { return items[0].chromosome; }
+  if (size == 2 || items[1].fit >= items[2].fit) { return items[1].chromosome; }
+  return items[2].chromosome;
+}
+
+Chromosome* ChromosomeHeap_GetChromosome(const ChromosomeHeap *heap, const size_t index){
+  assert(index < ChromosomeHeap_GetSize(heap) && "index out of range!");
+  return ChromosomeHeap_GetItems(heap)[index].chromosome;
+}
+
+float ChromosomeHeap_GetFit(const ChromosomeHeap *heap, const size_t index){
+  assert(index < ChromosomeHeap_GetSize(heap) && "index out of range!");
+  return ChromosomeHeap_GetItems(heap)[index].fit;
+}
+
+
+
+//=============================================================================
+//
+//                     Chromosome Heap Manipulation Functions
+//
+//=============================================================================
+
+void ChromosomeHeap_Insert(ChromosomeHeap *heap, Chromosome *chromosome){
+  assert(heap != NULL && chromosome != NULL && "heap and chromosome can not be NULL!");
+
+  const ChromosomeHeapItem item = {Chromosome_GetFit(chromosome), chromosome};
+  Array_Append(heap->items, &item);
+
+  // the new item is compared with the parent, then it goes up by the levels of the same kind
+  ChromosomeHeapItem *items = ChromosomeHeap_GetItems(heap);
+  const size_t index = ChromosomeHeap_GetSize(heap) - 1;
+  if (index == 0) { return; }
+
+  // the parent is on the other kind of level, e.g. the item on the min level should not be above its max parent
+  const size_t parent = (index - 1) / 2;
+  const int minLevel = ChromosomeHeap_IsMinLevel(index);
+  if (ChromosomeHeap_IsBefore(items, index, parent, !minLevel)){
+    ChromosomeHeap_Swap(items, index, parent);
+    ChromosomeHeap_PushUp(items, parent, !minLevel);
+  } else{
+    ChromosomeHeap_PushUp(items, index, minLevel);
+  }
+}
+
+Chromosome* ChromosomeHeap_ReplaceWorst(ChromosomeHeap *heap, Chromosome *chromosome){
+  assert(heap != NULL && chromosome != NULL && "heap and chromosome can not be NULL!");
+
+  const size_t size = ChromosomeHeap_GetSize(heap);
+  ChromosomeHeapItem *items = ChromosomeHeap_GetItems(heap);
+  assert(size > 0 && "heap should not be empty!");
+
+  size_t worst = 0;
+  if (size > 1) { worst = (size == 2 || items[1].fit >= items[2].fit) ? 1 : 2; }
+
+  Chromosome *removed = items[worst].chromosome;
+  items[worst].fit = Chromosome_GetFit(chromosome);
+  items[worst].chromosome = chromosome;
+  if (worst == 0) { return removed; }
+
+  // the parent of the max level item is the root, the new item may be the new best
+  if (items[worst].fit < items[0].fit) { ChromosomeHeap_Swap(items, worst, 0); }
+  ChromosomeHeap_TrickleDown(items, size, worst, 0);
+
+  return removed;
+}
+
+
+
+//=============================================================================
+//
+//                     Chromosome Heap Utility Helper Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup ChromosomeHeap
+ * @brief The raw items of the Array, the pointer is valid until the next insert.
+ */
+static ChromosomeHeapItem* ChromosomeHeap_GetItems(const ChromosomeHeap *heap) { return (ChromosomeHeapItem*)Array_GetArray(heap->items); }
+
+/*!
+ * @ingroup ChromosomeHeap
+ * @brief The level of the root is the min level, then the levels alternate.
+ */
+static int ChromosomeHeap_IsMinLevel(size_t index){
+  int level = 0;
+  for (index++; index > 1; index >>= 1) { level++; }
+  return level % 2 == 0;
+}
+
+/*!
+ * @ingroup ChromosomeHeap
+ * @brief Check if the first item should be above the second one on the level of the kind.
+ */
+static int ChromosomeHeap_IsBefore(const ChromosomeHeapItem *items, const size_t first, const size_t second, const int minLevel){
+  return minLevel ? items[first].fit < items[second].fit : items[first].fit > items[second].fit;
+}
+
+static void ChromosomeHeap_Swap(ChromosomeHeapItem *items, const size_t first, const size_t second){
+  const ChromosomeHeapItem swap = items[first];
+  items[first] = items[second];
+  items[second] = swap;
+}
+
+/*!
+ * @ingroup ChromosomeHeap
+ * @brief Move the item up by the grandparents while it should be above them.
+ */
+static void ChromosomeHeap_PushUp(ChromosomeHeapItem *items, size_t index, const int minLevel){
+  while (index > 2){
+    const size_t grandparent = ((index - 1) / 2 - 1) / 2;
+    if (!ChromosomeHeap_IsBefore(items, index, grandparent, minLevel)) { return; }
+
+    ChromosomeHeap_Swap(items, index, grandparent);
+    index = grandparent;
+  }
+}
+
+/*!
+ * @ingroup ChromosomeHeap
+ * @brief Move the item down to the best of its children and grandchildren on the level of the kind.
+ */
+static void ChromosomeHeap_TrickleDown(ChromosomeHeapItem *items, const size_t size, size_t index, const int minLevel){
+  while (2 * index + 1 < size){
+    // the children are 2i+1, 2i+2 and the grandchildren 4i+3 ... 4i+6
+    size_t best = 2 * index + 1;
+    const size_t candidates[] = {2 * index + 2, 4 * index + 3, 4 * index + 4, 4 * index + 5, 4 * index + 6};
+    for (size_t c = 0; c < 5 && candidates[c] < size; c++){
+      if (ChromosomeHeap_IsBefore(items, candidates[c], best, minLevel)) { best = candidates[c]; }
+    }
+
+    if (!ChromosomeHeap_IsBefore(items, best, index, minLevel)) { return; }
+    ChromosomeHeap_Swap(items, best, index);
+
+    // the child is on the other kind of level, so it is the final place
+    if (best <= 2 * index + 2) { return; }
+
+    const size_t parent = (best - 1) / 2;
+    if (ChromosomeHeap_IsBefore(items, parent, best, minLevel)) { ChromosomeHeap_Swap(items, best, parent); }
+    index = best;
+  }
+}
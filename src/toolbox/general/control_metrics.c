@@ -0,0 +1,204 @@
+/**
+ * @file control_metrics.c
+ * @brief Streaming control quality metrics public interface implementation.
+ *
+ * This file defines all implementations of the Control Metrics public interface
+ */
+
+#include "general/control_metrics.h"
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+// the default band of the settling time, 2 % of the step
+#define CONTROL_METRICS_SETTLING_BAND 0.02f
+
+// the rise time is measured between these parts of the step
+#define CONTROL_METRICS_RISE_LOW  0.1f
+#define CONTROL_METRICS_RISE_HIGH 0.9f
+
+// the smaller reference change is not a step, the step metrics are not measured for it
+#define CONTROL_METRICS_MIN_STEP 1e-6f
+
+//=============================================================================
+//
+//                     Control Metrics Utility Helper Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup ControlMetrics
+ * @brief Check if the current segment is a step, the segments without the change of the reference are skipped.
+ */
+static int ControlMetrics_IsStep(const ControlMetrics *metrics){
+  return fabsf(metrics->reference - metrics->initialOutput) > CONTROL_METRICS_MIN_STEP;
+}
+
+/*!
+ * @ingroup ControlMetrics
+ * @brief Move the step metrics of the finished segment into the values, the worst segment is kept.
+ */
+static void ControlMetrics_CloseSegment(ControlMetrics *metrics){
+  if (!ControlMetrics_IsStep(metrics)) { return; }
+
+  const float end = (float)metrics->step * metrics->dt;
+  const float duration = end - metrics->segmentStart;
+
+  // the output which never reached the 90 % or never settled gets the whole segment
+  const float rise = metrics->riseHigh >= 0.0f ? metrics->riseHigh - metrics->riseLow : duration;
+  const float settling = fminf(metrics->lastOutside + metrics->dt - metrics->segmentStart, duration);
+
+  float *values = metrics->values;
+  values[CONTROL_METRIC_OVERSHOOT] = fmaxf(values[CONTROL_METRIC_OVERSHOOT], metrics->peak);
+  values[CONTROL_METRIC_RISE]      = fmaxf(values[CONTROL_METRIC_RISE], rise);
+  values[CONTROL_METRIC_SETTLING]  = fmaxf(values[CONTROL_METRIC_SETTLING], settling);
+}
+
+/*!
+ * @ingroup ControlMetrics
+ * @brief Start the new segment at the current sample, the output before it is the start of the step.
+ */
+static void ControlMetrics_OpenSegment(ControlMetrics *metrics, const float reference){
+  const float t = (float)metrics->step * metrics->dt;
+
+  metrics->reference     = reference;
+  metrics->initialOutput = metrics->lastOutput;
+  metrics->segmentStart  = t;
+  metrics->peak          = 0.0f;
+  metrics->riseLow       = -1.0f;
+  metrics->riseHigh      = -1.0f;
+  metrics->lastOutside   = t - metrics->dt;
+}
+
+/*!
+ * @ingroup ControlMetrics
+ * @brief Update the step metrics of the segment with the output at the time t.
+ */
+static void ControlMetrics_UpdateStep(ControlMetrics *metrics, const float output, const float t){
+  if (!ControlMetrics_IsStep(metrics)) { return; }
+
+  // the progress of the step, 0 at the start and 1 at the reference
+  const float progress = (output - metrics->initialOutput) / (metrics->reference - metrics->initialOutput);
+
+  if (progress - 1.0f > metrics->peak) { metrics->peak = progress - 1.0f; }
+
+  if (metrics->riseLow  < 0.0f && progress >= CONTROL_METRICS_RISE_LOW)  { metrics->riseLow  = t; }
+  if (metrics->riseHigh < 0.0f && progress >= CONTROL_METRICS_RISE_HIGH) { metrics->riseHigh = t; }
+
+  if (fabsf(1.0f - progress) > metrics->settlingBand) { metrics->lastOutside = t; }
+}
+
+
+
+//=============================================================================
+//
+//                     Control Metrics Lifecycle Management Functions
+//
+//=============================================================================
+
+void ControlMetrics_Init(ControlMetrics *metrics, const unsigned mask, const float *weights, const float dt){
+  assert(metrics != NULL && "metrics pointer should not be NULL!");
+  assert(dt > 0.0f && "dt should be positive!");
+
+  metrics->mask = mask & CONTROL_METRIC_ALL;
+  for (int i = 0; i < CONTROL_METRIC_COUNT; i++){ metrics->weights[i] = weights != NULL ? weights[i] : 1.0f; }
+
+  metrics->dt = dt;
+  metrics->settlingBand = CONTROL_METRICS_SETTLING_BAND;
+
+  ControlMetrics_Reset(metrics);
+}
+
+void ControlMetrics_Reset(ControlMetrics *metrics){
+  assert(metrics != NULL && "metrics pointer should not be NULL!");
+
+  memset(metrics->values, 0, sizeof(metrics->values));
+  metrics->step = 0;
+  metrics->lastOutput = 0.0f;
+  metrics->reference = 0.0f;
+  metrics->initialOutput = 0.0f;
+}
+
+
+
+//=============================================================================
+//
+//                     Control Metrics Manipulation Functions
+//
+//=============================================================================
+
+void ControlMetrics_Update(ControlMetrics *metrics, const float reference, const float output, const float control){
+  assert(metrics != NULL && "metrics pointer should not be NULL!");
+
+  if (metrics->step == 0 || reference != metrics->reference){
+    if (metrics->step > 0) { ControlMetrics_CloseSegment(metrics); }
+    ControlMetrics_OpenSegment(metrics, reference);
+  }
+
+  const float t = (float)metrics->step * metrics->dt;
+  const float error = fabsf(reference - output);
+
+  float *values = metrics->values;
+  values[CONTROL_METRIC_IAE]    += error * metrics->dt;
+  values[CONTROL_METRIC_ISE]    += error * error * metrics->dt;
+  values[CONTROL_METRIC_ITAE]   += t * error * metrics->dt;
+  values[CONTROL_METRIC_EFFORT] += control * control * metrics->dt;
+
+  ControlMetrics_UpdateStep(metrics, output, t);
+
+  metrics->lastOutput = output;
+  metrics->step++;
+}
+
+void ControlMetrics_UpdateConstant(ControlMetrics *metrics, const float reference, const float output, const float control, const size_t count){
+  assert(metrics != NULL && "metrics pointer should not be NULL!");
+  if (count == 0) { return; }
+
+  // the first sample can open the segment, the rest only repeats it
+  ControlMetrics_Update(metrics, reference, output, control);
+
+  const size_t rest = count - 1;
+  if (rest == 0) { return; }
+
+  const float dt = metrics->dt;
+  const float error = fabsf(reference - output);
+
+  // the sum of the times of the rest samples: dt * (rest * step + rest * (rest - 1) / 2)
+  const double times = (double)dt * ((double)rest * (double)metrics->step + (double)rest * (double)(rest - 1) / 2.0);
+
+  float *values = metrics->values;
+  values[CONTROL_METRIC_IAE]    += error * dt * (float)rest;
+  values[CONTROL_METRIC_ISE]    += error * error * dt * (float)rest;
+  values[CONTROL_METRIC_ITAE]   += (float)(times * error * dt);
+  values[CONTROL_METRIC_EFFORT] += control * control * dt * (float)rest;
+
+  // the same output does not change the peak nor the rise, only the settling can move to the last sample
+  ControlMetrics_UpdateStep(metrics, output, (float)(metrics->step + rest - 1) * dt);
+
+  metrics->step += rest;
+}
+
+void ControlMetrics_Finish(ControlMetrics *metrics){
+  assert(metrics != NULL && "metrics pointer should not be NULL!");
+
+  if (metrics->step > 0) { ControlMetrics_CloseSegment(metrics); }
+}
+
+
+
+//=============================================================================
+//
+//                     Control Metrics Query Functions
+//
+//=============================================================================
+
+float ControlMetrics_Fitness(const ControlMetrics *metrics){
+  assert(metrics != NULL && "metrics pointer should not be NULL!");
+
+  float fitness = 0.0f;
+  for (int i = 0; i < CONTROL_METRIC_COUNT; i++){
+    if (metrics->mask & CONTROL_METRIC_BIT(i)) { fitness += metrics->weights[i] * metrics->values[i]; }
+  }
+  return fitness;
+}
@@ -1,11 +1,31 @@
 #include "general/general_math.h"
+#include "general/random.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <stddef.h>
 
+// the shared stream of the single thread operators, the threaded code should own its Random
+static Random generalRandom;
+static int generalRandomSeeded = 0;
+
+static Random* getGeneralRandom(void){
+  if(!generalRandomSeeded){
+    setRandomSeed(0);
+  }
+  return &generalRandom;
+}
+
+void setRandomSeed(const uint64_t seed){
+  Random_Seed(&generalRandom, seed);
+  generalRandomSeeded = 1;
+}
+
 float createRandomFloat(const float min, const float max){
-  const float random = ((float) rand()) / (float) RAND_MAX;
-  return min + (random * (max - min));
-}
\ No newline at end of file
+  return Random_Uniform(getGeneralRandom(), min, max);
+}
+
+int createRandomIndex(const int count){
+  return (int)Random_Bounded(getGeneralRandom(), (uint32_t)count);
+}
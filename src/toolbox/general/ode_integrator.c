@@ -0,0 +1,185 @@
+/**
+ * @file ode_integrator.c
+ * @brief Adaptive step ODE integrator public interface implementation.
+ *
+ * This file defines all implementations of the Ode Integrator public interface.
+ * The coefficients are the Dormand-Prince 5(4) pair with the first same as last property.
+ */
+
+#include "general/ode_integrator.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// the nodes of the stages
+static const float C2 = 1.0f / 5.0f, C3 = 3.0f / 10.0f, C4 = 4.0f / 5.0f, C5 = 8.0f / 9.0f;
+
+// the Butcher tableau rows
+static const float A21 = 1.0f / 5.0f;
+static const float A31 = 3.0f / 40.0f,        A32 = 9.0f / 40.0f;
+static const float A41 = 44.0f / 45.0f,       A42 = -56.0f / 15.0f,      A43 = 32.0f / 9.0f;
+static const float A51 = 19372.0f / 6561.0f,  A52 = -25360.0f / 2187.0f, A53 = 64448.0f / 6561.0f, A54 = -212.0f / 729.0f;
+static const float A61 = 9017.0f / 3168.0f,   A62 = -355.0f / 33.0f,     A63 = 46732.0f / 5247.0f, A64 = 49.0f / 176.0f,  A65 = -5103.0f / 18656.0f;
+static const float A71 = 35.0f / 384.0f,      A73 = 500.0f / 1113.0f,    A74 = 125.0f / 192.0f,    A75 = -2187.0f / 6784.0f, A76 = 11.0f / 84.0f;
+
+// the difference between the 5th and the 4th order solution
+static const float E1 = 71.0f / 57600.0f, E3 = -71.0f / 16695.0f, E4 = 71.0f / 1920.0f, E5 = -17253.0f / 339200.0f, E6 = 22.0f / 525.0f, E7 = -1.0f / 40.0f;
+
+// the limits of the step change
+static const float SAFETY = 0.9f;
+static const float MIN_FACTOR = 0.2f;
+static const float MAX_FACTOR = 5.0f;
+
+
+
+//=============================================================================
+//
+//                     Ode Integrator Lifecycle Management Functions
+//
+//=============================================================================
+
+OdeIntegrator* OdeIntegrator_Create(OdeFunction function, void *context, const size_t states, const float relTol, const float absTol){
+  assert(function != NULL && "ODE function should not be NULL!");
+  assert(states > 0 && "states count should be positive!");
+  assert(relTol > 0.0f && absTol > 0.0f && "tolerances should be positive!");
+
+  OdeIntegrator *integrator = NULL;
+  integrator = malloc(sizeof(OdeIntegrator));
+  if (integrator == NULL){ perror("Failed to allocate Ode Integrator"); exit(EXIT_FAILURE); }
+
+  integrator->function = function;
+  integrator->context  = context;
+  integrator->states   = states;
+
+  integrator->relTol  = relTol;
+  integrator->absTol  = absTol;
+  integrator->minStep = 1e-6f;
+  integrator->maxStep = 0.0f;
+
+  integrator->workspace = calloc(ODE_INTEGRATOR_BUFFERS * states, sizeof(float));
+  if (integrator->workspace == NULL){ perror("Failed to allocate Ode Integrator workspace"); free(integrator); exit(EXIT_FAILURE); }
+
+  OdeIntegrator_Reset(integrator);
+  return integrator;
+}
+
+void OdeIntegrator_Destroy(OdeIntegrator *integrator){
+  if (integrator == NULL) { return; }
+
+  free(integrator->workspace);
+  free(integrator);
+}
+
+void OdeIntegrator_Reset(OdeIntegrator *integrator){
+  assert(integrator != NULL && "integrator pointer should not be NULL!");
+
+  integrator->step = 0.0f;
+  memset(&integrator->stats, 0, sizeof(OdeStats));
+}
+
+
+
+//=============================================================================
+//
+//                     Ode Integrator Manipulation Functions
+//
+//=============================================================================
+
+void OdeIntegrator_Integrate(OdeIntegrator *integrator, float *x, const float u, const float interval){
+  assert(integrator != NULL && "integrator pointer should not be NULL!");
+  assert(integrator->workspace != NULL && "integrator workspace should not be NULL!");
+  assert(x != NULL && "state pointer should not be NULL!");
+  assert(interval > 0.0f && "interval should be positive!");
+
+  const size_t n = integrator->states;
+  OdeStats *stats = &integrator->stats;
+
+  float *k1 = integrator->workspace;
+  float *k2 = k1 + n;
+  float *k3 = k2 + n;
+  float *k4 = k3 + n;
+  float *k5 = k4 + n;
+  float *k6 = k5 + n;
+  float *k7 = k6 + n;
+  float *argument = k7 + n;
+  float *xNew     = argument + n;
+
+  const float maxStep = (integrator->maxStep > 0.0f && integrator->maxStep < interval) ? integrator->maxStep : interval;
+  float step = (integrator->step > 0.0f) ? fminf(integrator->step, maxStep) : maxStep;
+
+  stats->intervals++;
+
+  // the input changes at each interval, so the first stage is evaluated again
+  float t = 0.0f;
+  integrator->function(t, x, u, k1, integrator->context);
+  stats->functionCalls++;
+
+  while (interval - t > 1e-6f * interval){
+    const float remaining = interval - t;
+    const int truncated = step >= remaining;
+    const float h = truncated ? remaining : step;
+
+    for (size_t i = 0; i < n; i++){ argument[i] = x[i] + h * A21 * k1[i]; }
+    integrator->function(t + C2 * h, argument, u, k2, integrator->context);
+
+    for (size_t i = 0; i < n; i++){ argument[i] = x[i] + h * (A31 * k1[i] + A32 * k2[i]); }
+    integrator->function(t + C3 * h, argument, u, k3, integrator->context);
+
+    for (size_t i = 0; i < n; i++){ argument[i] = x[i] + h * (A41 * k1[i] + A42 * k2[i] + A43 * k3[i]); }
+    integrator->function(t + C4 * h, argument, u, k4, integrator->context);
+
+    for (size_t i = 0; i < n; i++){ argument[i] = x[i] + h * (A51 * k1[i] + A52 * k2[i] + A53 * k3[i] + A54 * k4[i]); }
+    integrator->function(t + C5 * h, argument, u, k5, integrator->context);
+
+    for (size_t i = 0; i < n; i++){ argument[i] = x[i] + h * (A61 * k1[i] + A62 * k2[i] + A63 * k3[i] + A64 * k4[i] + A65 * k5[i]); }
+    integrator->function(t + h, argument, u, k6, integrator->context);
+
+    for (size_t i = 0; i < n; i++){ xNew[i] = x[i] + h * (A71 * k1[i] + A73 * k3[i] + A74 * k4[i] + A75 * k5[i] + A76 * k6[i]); }
+    integrator->function(t + h, xNew, u, k7, integrator->context);
+
+    stats->functionCalls += 6;
+
+    // the scaled RMS norm of the local error
+    float error = 0.0f;
+    for (size_t i = 0; i < n; i++){
+      const float localError = h * (E1 * k1[i] + E3 * k3[i] + E4 * k4[i] + E5 * k5[i] + E6 * k6[i] + E7 * k7[i]);
+      const float scale = integrator->absTol + integrator->relTol * fmaxf(fabsf(x[i]), fabsf(xNew[i]));
+      error += (localError / scale) * (localError / scale);
+    }
+    error = sqrtf(error / (float)n);
+
+    float factor = (error > 0.0f) ? SAFETY * powf(error, -0.2f) : MAX_FACTOR;
+    factor = fminf(MAX_FACTOR, fmaxf(MIN_FACTOR, factor));
+
+    if (error <= 1.0f || h <= integrator->minStep){
+      // accepted, the last stage is the first stage of the next step
+      t += h;
+      memcpy(x, xNew, n * sizeof(float));
+      memcpy(k1, k7, n * sizeof(float));
+      stats->acceptedSteps++;
+
+      // the cut step at the end of interval should not shrink the memory of the step
+      step = truncated ? fmaxf(step, h * factor) : h * factor;
+    } else {
+      stats->rejectedSteps++;
+      step = h * factor;
+    }
+    step = fminf(maxStep, fmaxf(integrator->minStep, step));
+  }
+
+  integrator->step = step;
+}
+
+void OdeIntegrator_PrintStats(const OdeStats *stats, const size_t eulerStepsPerInterval){
+  assert(stats != NULL && "stats pointer should not be NULL!");
+
+  const size_t eulerSteps = stats->intervals * eulerStepsPerInterval;
+  const float perInterval = stats->intervals > 0 ? (float)stats->acceptedSteps / (float)stats->intervals : 0.0f;
+
+  printf("RK45 - intervals: %zu accepted: %zu rejected: %zu f calls: %zu (%.2f steps/interval)\n",
+         stats->intervals, stats->acceptedSteps, stats->rejectedSteps, stats->functionCalls, perInterval);
+  printf("Euler - steps: %zu f calls: %zu\n", eulerSteps, eulerSteps);
+}
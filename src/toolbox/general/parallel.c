@@ -0,0 +1,100 @@
+/**
+ * @file parallel.c
+ * @brief Parallel loop helper public interface implementation.
+ *
+ * This file defines all implementations of the Parallel public interface
+ */
+
+#include "general/parallel.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+/**
+ * @struct ParallelLoop
+ * @brief The shared state of one Parallel_For call.
+ * @ingroup Parallel
+ */
+typedef struct ParallelLoop {
+  atomic_size_t next; // the next index to be claimed
+  size_t count;       // the number of loop items
+
+  ParallelTask task;  // the task of one index
+  void *context;      // user data
+} ParallelLoop;
+
+/**
+ * @struct ParallelWorker
+ * @brief The argument of one worker thread.
+ * @ingroup Parallel
+ */
+typedef struct ParallelWorker {
+  ParallelLoop *loop; // the shared loop
+  size_t thread;      // the index of the thread
+} ParallelWorker;
+
+/*!
+ * @ingroup Parallel
+ * @brief Claim indexes until the loop is exhausted.
+ * @param argument the ParallelWorker of the thread.
+ * @return NULL.
+ */
+static void* Parallel_Worker(void *argument){
+  const ParallelWorker *worker = argument;
+  ParallelLoop *loop = worker->loop;
+
+  for (size_t index = atomic_fetch_add(&loop->next, 1); index < loop->count; index = atomic_fetch_add(&loop->next, 1)){
+    loop->task(index, worker->thread, loop->context);
+  }
+  return NULL;
+}
+
+size_t Parallel_GetThreadCount(void){
+  const long online = sysconf(_SC_NPROCESSORS_ONLN);
+  return online > 0 ? (size_t)online : 1;
+}
+
+void Parallel_For(const size_t count, size_t threads, ParallelTask task, void *context){
+  assert(task != NULL && "task should not be NULL!");
+
+  if (count == 0) { return; }
+  if (threads == 0) { threads = Parallel_GetThreadCount(); }
+  if (threads > count) { threads = count; }
+
+  ParallelLoop loop;
+  atomic_init(&loop.next, 0);
+  loop.count   = count;
+  loop.task    = task;
+  loop.context = context;
+
+  // the single thread loop needs no threads at all
+  if (threads == 1){
+    const ParallelWorker worker = {&loop, 0};
+    Parallel_Worker((void*)&worker);
+    return;
+  }
+
+  pthread_t *handles = malloc((threads - 1) * sizeof(pthread_t));
+  ParallelWorker *workers = malloc(threads * sizeof(ParallelWorker));
+  if (handles == NULL || workers == NULL){ perror("Failed to allocate Parallel workers"); exit(EXIT_FAILURE); }
+
+  for (size_t i = 0; i < threads; i++){
+    workers[i].loop   = &loop;
+    workers[i].thread = i;
+  }
+
+  // the caller is the worker 0, the rest is started
+  for (size_t i = 1; i < threads; i++){
+    if (pthread_create(&handles[i - 1], NULL, Parallel_Worker, &workers[i]) != 0){ perror("Failed to start Parallel worker"); exit(EXIT_FAILURE); }
+  }
+  Parallel_Worker(&workers[0]);
+
+  for (size_t i = 1; i < threads; i++){ pthread_join(handles[i - 1], NULL); }
+
+  free(handles);
+  free(workers);
+}
@@ -0,0 +1,271 @@
+/**
+ * @file pid_batch.c
+ * @brief Batched PID closed loop simulation public interface implementation.
+ *
+ * This file defines all implementations of the Pid Batch public interface
+ */
+
+#include "general/pid_batch.h"
+
+#include "general/parallel.h"
+#include "general/systems_builder.h"
+
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// the loop over all lanes of the group, the body should have no branches to be vectorized
+#define PID_BATCH_LANES(l) for (size_t l = 0; l < PID_BATCH_WIDTH; l++)
+
+/**
+ * @struct PidBatchContext
+ * @brief The context of the parallel evaluation, one task is one lane group.
+ * @ingroup PidBatch
+ */
+typedef struct PidBatchContext {
+  PidBatch *batch;
+  float *const *genomes;
+  size_t count;
+  float *fit;
+} PidBatchContext;
+
+//=============================================================================
+//
+//                     Pid Batch Utility Helper Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup PidBatch
+ * @brief Load the genomes into the lanes and clear the loop state. The unused lanes repeat the first genome.
+ */
+static void PidBatch_Load(PidBatchLanes *lanes, float *const *genomes, const size_t active){
+  PID_BATCH_LANES(l){
+    const float *genome = genomes[l < active ? l : 0];
+    lanes->Kp[l]   = genome[0];
+    lanes->Ki[l]   = genome[1];
+    lanes->Kd[l]   = genome[2];
+    lanes->tauD[l] = genome[3];
+
+    lanes->integral[l]     = 0.0f;
+    lanes->differential[l] = 0.0f;
+    lanes->prevError[l]    = 0.0f;
+    lanes->y1[l] = 0.0f;
+    lanes->y2[l] = 0.0f;
+
+    lanes->fit[l]        = 0.0f;
+    lanes->maxCounter[l] = 0;
+    lanes->steadyRise[l] = 1;
+  }
+}
+
+/*!
+ * @ingroup PidBatch
+ * @brief Step the state space plant of all lanes, the sums have the same order as StateSpace_Step.
+ */
+static void PidBatch_StepStateSpace(const StateSpace *plant, float *x, const float *u, float *y){
+  const size_t n = plant->states;
+  float next[STATE_SPACE_MAX_SIZE][PID_BATCH_WIDTH];
+
+  // x[k+1] = Ad * x[k] + Bd * u[k]
+  for (size_t i = 0; i < n; i++){
+    const float *rowA = plant->Ad + i * n;
+    const float bd = plant->Bd[i];
+
+    PID_BATCH_LANES(l){ next[i][l] = 0.0f; }
+    for (size_t j = 0; j < n; j++){
+      const float a = rowA[j];
+      const float *xj = x + j * PID_BATCH_WIDTH;
+      PID_BATCH_LANES(l){ next[i][l] += a * xj[l]; }
+    }
+    PID_BATCH_LANES(l){ next[i][l] += bd * u[l]; }
+  }
+  memcpy(x, next, n * PID_BATCH_WIDTH * sizeof(float));
+
+  // y[k+1] = C * x[k+1] + D * u[k], only the first output is the y of the loop
+  PID_BATCH_LANES(l){ y[l] = 0.0f; }
+  for (size_t j = 0; j < n; j++){
+    const float c = plant->C[j];
+    const float *xj = x + j * PID_BATCH_WIDTH;
+    PID_BATCH_LANES(l){ y[l] += c * xj[l]; }
+  }
+  const float d = plant->D[0];
+  PID_BATCH_LANES(l){ y[l] += d * u[l]; }
+}
+
+/*!
+ * @ingroup PidBatch
+ * @brief Simulate one lane group over the whole signal, the same loop as makeSimulationOfSignal.
+ */
+static void PidBatch_SimulateGroup(const PidBatch *batch, PidBatchLanes *lanes, float *memory, ControlMetrics *metrics, const size_t active){
+  const PID *pid = &batch->pid;
+  const float *signal = pid->signal->signal;
+  const int length = pid->signal->length;
+  const float dt = pid->signal->dt;
+  const int useMetrics = pid->metrics.mask != 0;
+
+  memset(memory, 0, batch->memoryStride * sizeof(float));
+  if (batch->plant == NULL){
+    PID_BATCH_LANES(l){ memory[l * (size_t)pid->sizeDataSystem + 1] = dt; }
+  }
+  if (useMetrics){
+    for (size_t l = 0; l < active; l++){ ControlMetrics_Reset(&metrics[l]); }
+  }
+
+  for (int i = 2; i < length; i++){
+    const float w = signal[i];
+
+    PID_BATCH_LANES(l){
+      const float error = w - lanes->y1[l];
+      const float proportional = lanes->Kp[l] * error;
+
+      float integral = lanes->integral[l] + 0.5f * lanes->Ki[l] * (error - lanes->prevError[l]) * dt;
+      const float differential = -(2.0f * lanes->Kd[l] * (lanes->y1[l] - lanes->y2[l]) + (2.0f * lanes->tauD[l] - dt) * lanes->differential[l])
+                                 / (2.0f * lanes->tauD[l] + dt);
+
+      integral = integral > pid->limMaxInt ? pid->limMaxInt : integral;
+      integral = integral < pid->limMinInt ? pid->limMinInt : integral;
+
+      lanes->integral[l]     = integral;
+      lanes->differential[l] = differential;
+      lanes->prevError[l]    = error;
+      lanes->u[l] = pid->plantGain * (proportional + integral + differential);
+    }
+
+    if (batch->plant != NULL){
+      PidBatch_StepStateSpace(batch->plant, memory, lanes->u, lanes->y);
+    } else {
+      PID_BATCH_LANES(l){
+        float *data = memory + l * (size_t)pid->sizeDataSystem;
+        data[0] = lanes->u[l];
+        lanes->y[l] = pid->func_system(data);
+      }
+    }
+
+    PID_BATCH_LANES(l){
+      float y = lanes->y[l];
+      const int over  = y > pid->limMax;
+      const int under = y < pid->limMin;
+      y = over  ? pid->limMax : y;
+      y = under ? pid->limMin : y;
+
+      lanes->maxCounter[l] += over | under;
+      lanes->fit[l] += fabsf(w - y);
+      lanes->steadyRise[l] &= !(lanes->y1[l] > y);
+
+      lanes->y2[l] = lanes->y1[l];
+      lanes->y1[l] = y;
+    }
+
+    if (useMetrics){
+      for (size_t l = 0; l < active; l++){ ControlMetrics_Update(&metrics[l], w, lanes->y1[l], lanes->u[l]); }
+    }
+  }
+
+  for (size_t l = 0; l < active; l++){
+    if (useMetrics){
+      ControlMetrics_Finish(&metrics[l]);
+      lanes->fit[l] = ControlMetrics_Fitness(&metrics[l]);
+    }
+    if (lanes->steadyRise[l] == 1 || lanes->maxCounter[l] > length * 1 / 100){
+      lanes->fit[l] = FLT_MAX; // the same rejection of the steady rise and oscillating solutions as the PID
+    }
+  }
+}
+
+/*!
+ * @ingroup PidBatch
+ * @brief The parallel task of one lane group.
+ */
+static void PidBatch_Task(const size_t index, const size_t thread, void *context){
+  PidBatchContext *data = context;
+  PidBatch *batch = data->batch;
+
+  const size_t first = index * PID_BATCH_WIDTH;
+  const size_t left = data->count - first;
+  const size_t active = left < PID_BATCH_WIDTH ? left : PID_BATCH_WIDTH;
+
+  PidBatchLanes *lanes = &batch->lanes[thread];
+  PidBatch_Load(lanes, data->genomes + first, active);
+  PidBatch_SimulateGroup(batch, lanes, batch->memory + thread * batch->memoryStride,
+                         batch->metrics + thread * PID_BATCH_WIDTH, active);
+
+  memcpy(data->fit + first, lanes->fit, active * sizeof(float));
+}
+
+
+
+//=============================================================================
+//
+//                     Pid Batch Lifecycle Management Functions
+//
+//=============================================================================
+
+PidBatch* PidBatch_Create(const PID *pid, size_t threads){
+  assert(pid != NULL && "pid pointer should not be NULL!");
+  assert(pid->signal != NULL && pid->func_system != NULL && "pid should have the signal and the system!");
+
+  if (threads == 0) { threads = Parallel_GetThreadCount(); }
+
+  PidBatch *batch = NULL;
+  batch = malloc(sizeof(PidBatch));
+  if (batch == NULL){ perror("Failed to allocate Pid Batch"); exit(EXIT_FAILURE); }
+
+  batch->pid = *pid;
+  batch->pid.output = NULL;
+  batch->pid.dataSystem = NULL;
+  batch->pid.trace = NULL;
+  batch->threads = threads;
+
+  // the single input state space plant discretized for the signal is stepped for the whole group at once
+  const StateSpace *plant = getSystemStateSpace(pid->func_system, pid->signal->dt);
+  if (plant != NULL && plant->inputs == 1){
+    batch->plant = plant;
+    batch->memoryStride = plant->states * PID_BATCH_WIDTH;
+  } else {
+    batch->plant = NULL;
+    batch->memoryStride = (size_t)pid->sizeDataSystem * PID_BATCH_WIDTH;
+  }
+
+  batch->lanes   = malloc(threads * sizeof(PidBatchLanes));
+  batch->memory  = malloc(threads * batch->memoryStride * sizeof(float));
+  batch->metrics = malloc(threads * PID_BATCH_WIDTH * sizeof(ControlMetrics));
+  if (batch->lanes == NULL || batch->memory == NULL || batch->metrics == NULL){
+    perror("Failed to allocate Pid Batch scratch");
+    exit(EXIT_FAILURE);
+  }
+
+  for (size_t i = 0; i < threads * PID_BATCH_WIDTH; i++){ batch->metrics[i] = pid->metrics; }
+
+  return batch;
+}
+
+void PidBatch_Destroy(PidBatch *batch){
+  if (batch == NULL) { return; }
+
+  free(batch->lanes);
+  free(batch->memory);
+  free(batch->metrics);
+  free(batch);
+}
+
+
+
+//=============================================================================
+//
+//                     Pid Batch Manipulation Functions
+//
+//=============================================================================
+
+void PidBatch_Evaluate(PidBatch *batch, float *const *genomes, const size_t count, float *fit){
+  assert(batch != NULL && "batch pointer should not be NULL!");
+  assert(genomes != NULL && fit != NULL && "genomes and fit should not be NULL!");
+
+  const size_t groups = (count + PID_BATCH_WIDTH - 1) / PID_BATCH_WIDTH;
+
+  PidBatchContext context = {batch, genomes, count, fit};
+  Parallel_For(groups, batch->threads, PidBatch_Task, &context);
+}
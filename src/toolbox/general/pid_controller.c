@@ -28,7 +28,8 @@ static void resetOutputMemoryPid(PID *pid){
     pid->maxCounter = 0;
 }
 
-void createNewPidController(PID *pid){
+// the part of the creation shared by the CLI and the choice versions, the signal and system are selected before
+static void finishPidController(PID *pid){
     // first, the coefficients are set to 0 for start
     pid->Kp = 0;
     pid->Ki = 0;
@@ -38,11 +39,7 @@ void createNewPidController(PID *pid){
     pid->tauD = 1;
     pid->tauI = 1;
 
-    // select signal and system
-    pid->signal = malloc(sizeof(Signal));
-    cliSignalSelector(pid->signal);
-
-    pid->sizeDataSystem = selectSystem(&pid->func_system);
+    prepareSystem(pid->func_system, pid->signal->dt);
     pid->dataSystem = malloc(pid->sizeDataSystem * sizeof(float));
     for(int i=0; i<pid->sizeDataSystem; i++){
         pid->dataSystem[i] = 0;
@@ -53,6 +50,34 @@ void createNewPidController(PID *pid){
     pid->output->length = pid->signal->length;
     pid->output->dt = pid->signal->dt;
     pid->output->signal = malloc(pid->signal->length * sizeof(float));
+
+    pid->plantGain = 1;
+    pid->trace = NULL;
+
+    ControlMetrics_Init(&pid->metrics, 0, NULL, pid->signal->dt);
+}
+
+void createNewPidController(PID *pid){
+    // select signal and system
+    pid->signal = malloc(sizeof(Signal));
+    cliSignalSelector(pid->signal);
+
+    pid->sizeDataSystem = selectSystem(&pid->func_system);
+
+    finishPidController(pid);
+}
+
+int createPidControllerByChoice(PID *pid, int signalChoice, int systemChoice){
+    pid->signal = malloc(sizeof(Signal));
+    pid->sizeDataSystem = selectSystemByChoice(&pid->func_system, systemChoice);
+
+    if(pid->sizeDataSystem == 0 || makeSignalByChoice(pid->signal, signalChoice) == 0){
+        free(pid->signal);
+        return 0;
+    }
+
+    finishPidController(pid);
+    return 1;
 }
 
 void deletePid(PID *pid){
@@ -61,12 +86,23 @@ void deletePid(PID *pid){
 
     free(pid->dataSystem);
 
+    // the rest of the buffered records is written here
+    TraceWriter_Destroy(pid->trace);
+
     free(pid);
 }
 
+void openPidTrace(PID *pid, const char *path){
+    static const char *const columns[] = {"P", "I", "D", "y", "w"};
+
+    TraceWriter_Destroy(pid->trace);
+    pid->trace = TraceWriter_Create(path, columns, 5, 0);
+}
+
 void makeSimulationOfSignal(struct PID *pid, FILE *csvFile, int csv){
     resetOutputMemoryPid(pid);
     pid->fit = 0;
+    ControlMetrics_Reset(&pid->metrics);
 
     WRITE_TO_FILE(csv, csvFile, pid, 0);
 
@@ -99,7 +135,7 @@ void makeSimulationOfSignal(struct PID *pid, FILE *csvFile, int csv){
         }
 
         // set data and pass to a system
-        pid->dataSystem[0] = pid->proportiError + pid->integralError + pid->differenError;
+        pid->dataSystem[0] = pid->plantGain * (pid->proportiError + pid->integralError + pid->differenError);
         
         pid->output->signal[i] = pid->func_system(pid->dataSystem);
 
@@ -119,11 +155,19 @@ void makeSimulationOfSignal(struct PID *pid, FILE *csvFile, int csv){
         const float diff = pid->signal->signal[i] - pid->output->signal[i];
         pid->fit += diff > 0 ? diff : diff * (-1);
 
+        if(pid->metrics.mask != 0){
+            ControlMetrics_Update(&pid->metrics, pid->signal->signal[i], pid->output->signal[i], pid->dataSystem[0]);
+        }
+
         if(pid->output->signal[i-1] > pid->output->signal[i]){
             pid->steadyRiseCheck = 0;
         }
     }
 
+    if(pid->metrics.mask != 0){
+        ControlMetrics_Finish(&pid->metrics);
+        pid->fit = ControlMetrics_Fitness(&pid->metrics);
+    }
     
     if(pid->steadyRiseCheck == 1 || pid->maxCounter > pid->signal->length * 1 / 100){
         pid->fit =  FLT_MAX; // make fit max value to not consider the steady rise solutions
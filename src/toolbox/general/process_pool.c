@@ -0,0 +1,381 @@
+/**
+ * @file process_pool.c
+ * @brief Multi process master/worker evaluation public interface implementation.
+ *
+ * This file defines all implementations of the Process Pool public interface
+ */
+
+// the shared memory, the fork and the sockets are not in C99
+#define _GNU_SOURCE
+
+#include "general/process_pool.h"
+
+#include "general/parallel.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <float.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// the size of the name of the shared memory segment
+#define PROCESS_POOL_NAME_SIZE 64
+
+// the header of the segment takes one cache line, so the counter does not share it with the fits
+#define PROCESS_POOL_HEADER 64
+
+// the master checks the worker which did not answer in this time is still alive, the long rounds are waited for
+#define PROCESS_POOL_TIMEOUT_MS 200
+
+/**
+ * @enum ProcessPoolCommand
+ * @brief The command of the control channel.
+ * @ingroup ProcessPool
+ */
+typedef enum ProcessPoolCommand {
+  PROCESS_POOL_EVALUATE = 1, // master: claim and evaluate the rows of the round
+  PROCESS_POOL_STOP     = 2, // master: release the evaluator and exit
+  PROCESS_POOL_DONE     = 3  // worker: no more rows to claim, rows is the number evaluated by the worker
+} ProcessPoolCommand;
+
+/**
+ * @struct ProcessPoolMessage
+ * @brief One message of the control channel, the same size in both directions.
+ * @ingroup ProcessPool
+ */
+typedef struct ProcessPoolMessage {
+  uint32_t command;
+  uint32_t rows;
+} ProcessPoolMessage;
+
+/**
+ * @struct ProcessPoolShared
+ * @brief The header of the shared memory segment.
+ * @ingroup ProcessPool
+ */
+typedef struct ProcessPoolShared {
+  atomic_size_t next; // the first row not claimed yet
+  size_t count;       // the number of rows of the round
+} ProcessPoolShared;
+
+struct ProcessPool {
+  char name[PROCESS_POOL_NAME_SIZE]; // the name of the shared memory segment
+  size_t rows;    // the biggest number of rows of one round
+  size_t genes;   // the number of genes of one row
+  size_t workers; // the number of worker processes
+  size_t chunk;   // the number of rows claimed at once
+
+  void *memory;             // the mapping of the segment
+  size_t size;              // the size of the segment
+  ProcessPoolShared *shared;
+  float *fit;               // rows floats after the header
+  float *genomes;           // rows * genes floats after the fits
+
+  pid_t *pids;  // the process of each worker, -1 after its crash
+  int *sockets; // the master end of the control channel of each worker, -1 after its crash
+
+  ProcessPoolInit init;
+  ProcessPoolEvaluate evaluate;
+  ProcessPoolRelease release;
+  void *context;
+};
+
+static void ProcessPool_Spawn(ProcessPool *pool, const size_t worker);
+static void ProcessPool_Reap(ProcessPool *pool, const size_t worker);
+
+//=============================================================================
+//
+//                     Process Pool Utility Helper Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup ProcessPool
+ * @brief Send the whole message, the closed socket of the dead worker gives the error instead of SIGPIPE.
+ * @return 1 if the message was sent, 0 otherwise.
+ */
+static int ProcessPool_Send(const int socket, const ProcessPoolCommand command, const size_t rows){
+  const ProcessPoolMessage message = {(uint32_t)command, (uint32_t)rows};
+  const char *data = (const char*)&message;
+  size_t sent = 0;
+
+  while (sent < sizeof(message)){
+    const ssize_t result = send(socket, data + sent, sizeof(message) - sent, MSG_NOSIGNAL);
+    if (result <= 0) { return 0; }
+    sent += (size_t)result;
+  }
+  return 1;
+}
+
+/*!
+ * @ingroup ProcessPool
+ * @brief Receive the whole message, on the timeout of the master channel the worker process is checked.
+ * @param pid the worker process or NULL in the worker, it is set to -1 once the exited worker is waited for.
+ * @return 1 if the message was received, 0 if the other end is closed or the worker exited.
+ */
+static int ProcessPool_Receive(const int socket, ProcessPoolMessage *message, pid_t *pid){
+  char *data = (char*)message;
+  size_t received = 0;
+
+  while (received < sizeof(ProcessPoolMessage)){
+    const ssize_t result = recv(socket, data + received, sizeof(ProcessPoolMessage) - received, 0);
+    if (result > 0){
+      received += (size_t)result;
+      continue;
+    }
+
+    // the dead worker is found even if some other process still holds its end of the channel
+    const int waiting = result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+    if (waiting && (pid == NULL || *pid <= 0 || waitpid(*pid, NULL, WNOHANG) == 0)) { continue; }
+    if (waiting && pid != NULL) { *pid = -1; }
+    return 0;
+  }
+  return 1;
+}
+
+/*!
+ * @ingroup ProcessPool
+ * @brief Close all the descriptors of the worker except the stdio and its channel, e.g. the channels of the other pools
+ * which were just being made by the other threads during the fork.
+ */
+static void ProcessPool_CloseInherited(const int keep){
+#ifdef SYS_close_range
+  const int below = keep <= 3 || syscall(SYS_close_range, 3u, (unsigned)keep - 1u, 0u) == 0;
+  if (below && syscall(SYS_close_range, (unsigned)keep + 1u, ~0u, 0u) == 0) { return; }
+#endif
+  const long limit = sysconf(_SC_OPEN_MAX);
+  for (int descriptor = 3; descriptor < (limit > 0 ? limit : 1024); descriptor++){
+    if (descriptor != keep) { close(descriptor); }
+  }
+}
+
+/*!
+ * @ingroup ProcessPool
+ * @brief The loop of the worker process, it never returns.
+ */
+static void ProcessPool_Worker(const ProcessPool *pool, const size_t worker, const int socket){
+  void *state = pool->init != NULL ? pool->init(worker, pool->context) : NULL;
+
+  float **rows = malloc(pool->chunk * sizeof(float*));
+  if (rows == NULL){ perror("Failed to allocate Process Pool worker rows"); _exit(EXIT_FAILURE); }
+
+  ProcessPoolMessage message;
+  while (ProcessPool_Receive(socket, &message, NULL) && message.command == PROCESS_POOL_EVALUATE){
+    ProcessPoolShared *shared = pool->shared;
+    size_t evaluated = 0;
+
+    for (size_t start = atomic_fetch_add(&shared->next, pool->chunk); start < shared->count;
+         start = atomic_fetch_add(&shared->next, pool->chunk)){
+      const size_t end = start + pool->chunk < shared->count ? start + pool->chunk : shared->count;
+      for (size_t i = start; i < end; i++){ rows[i - start] = pool->genomes + i * pool->genes; }
+
+      pool->evaluate(rows, end - start, pool->fit + start, state);
+      evaluated += end - start;
+    }
+
+    if (!ProcessPool_Send(socket, PROCESS_POOL_DONE, evaluated)) { break; }
+  }
+
+  if (pool->release != NULL) { pool->release(state); }
+  free(rows);
+  close(socket);
+  _exit(EXIT_SUCCESS);
+}
+
+/*!
+ * @ingroup ProcessPool
+ * @brief Fork the worker with the new control channel.
+ */
+static void ProcessPool_Spawn(ProcessPool *pool, const size_t worker){
+  int pair[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0){ perror("Failed to create Process Pool control channel"); exit(EXIT_FAILURE); }
+
+  fflush(NULL);
+  const pid_t pid = fork();
+  if (pid < 0){ perror("Failed to fork Process Pool worker"); exit(EXIT_FAILURE); }
+
+  if (pid == 0){
+    // the worker keeps only its own end, so the master sees the closed channel when the worker dies
+    ProcessPool_CloseInherited(pair[1]);
+    ProcessPool_Worker(pool, worker, pair[1]);
+  }
+
+  close(pair[1]);
+
+  const struct timeval timeout = {PROCESS_POOL_TIMEOUT_MS / 1000, (PROCESS_POOL_TIMEOUT_MS % 1000) * 1000};
+  if (setsockopt(pair[0], SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0){
+    perror("Failed to set Process Pool control channel timeout");
+    exit(EXIT_FAILURE);
+  }
+  pool->pids[worker] = pid;
+  pool->sockets[worker] = pair[0];
+}
+
+/*!
+ * @ingroup ProcessPool
+ * @brief Close the channel of the dead or stopped worker and wait for its process.
+ */
+static void ProcessPool_Reap(ProcessPool *pool, const size_t worker){
+  if (pool->sockets[worker] >= 0) { close(pool->sockets[worker]); }
+  if (pool->pids[worker] > 0)     { waitpid(pool->pids[worker], NULL, 0); }
+
+  pool->sockets[worker] = -1;
+  pool->pids[worker] = -1;
+}
+
+
+
+//=============================================================================
+//
+//                     Process Pool Lifecycle Management Functions
+//
+//=============================================================================
+
+ProcessPool* ProcessPool_Create(const size_t rows, const size_t genes, size_t workers, const size_t chunk,
+                                ProcessPoolInit init, ProcessPoolEvaluate evaluate, ProcessPoolRelease release, void *context){
+  assert(rows > 0 && genes > 0 && "rows and genes should be at least 1!");
+  assert(rows <= UINT32_MAX && "rows should fit the control message!");
+  assert(evaluate != NULL && "evaluate should not be NULL!");
+
+  if (workers == 0) { workers = Parallel_GetThreadCount(); }
+
+  ProcessPool *pool = NULL;
+  pool = malloc(sizeof(ProcessPool));
+  if (pool == NULL){ perror("Failed to allocate Process Pool"); exit(EXIT_FAILURE); }
+
+  pool->rows     = rows;
+  pool->genes    = genes;
+  pool->workers  = workers;
+  pool->chunk    = chunk > 0 ? chunk : 1;
+  pool->init     = init;
+  pool->evaluate = evaluate;
+  pool->release  = release;
+  pool->context  = context;
+
+  // the segment: the header, the fits rounded to the cache line, the genomes
+  static atomic_uint segments = 0;
+  snprintf(pool->name, PROCESS_POOL_NAME_SIZE, "/ga_toolbox_%ld_%u", (long)getpid(), atomic_fetch_add(&segments, 1));
+
+  const size_t fitSize = (rows * sizeof(float) + PROCESS_POOL_HEADER - 1) / PROCESS_POOL_HEADER * PROCESS_POOL_HEADER;
+  pool->size = PROCESS_POOL_HEADER + fitSize + rows * genes * sizeof(float);
+
+  const int descriptor = shm_open(pool->name, O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (descriptor < 0){ perror("Failed to create Process Pool shared memory"); exit(EXIT_FAILURE); }
+  if (ftruncate(descriptor, (off_t)pool->size) != 0){ perror("Failed to size Process Pool shared memory"); exit(EXIT_FAILURE); }
+
+  pool->memory = mmap(NULL, pool->size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+  close(descriptor);
+
+  // the workers get the mapping by the fork, so the name is not needed and the crashed master leaks no segment
+  shm_unlink(pool->name);
+  if (pool->memory == MAP_FAILED){ perror("Failed to map Process Pool shared memory"); exit(EXIT_FAILURE); }
+
+  pool->shared  = pool->memory;
+  pool->fit     = (float*)((char*)pool->memory + PROCESS_POOL_HEADER);
+  pool->genomes = (float*)((char*)pool->memory + PROCESS_POOL_HEADER + fitSize);
+
+  atomic_init(&pool->shared->next, 0);
+  pool->shared->count = 0;
+  assert(atomic_is_lock_free(&pool->shared->next) && "the counter should be lock free to be shared by the processes!");
+
+  pool->pids    = malloc(workers * sizeof(pid_t));
+  pool->sockets = malloc(workers * sizeof(int));
+  if (pool->pids == NULL || pool->sockets == NULL){ perror("Failed to allocate Process Pool workers"); exit(EXIT_FAILURE); }
+
+  for (size_t w = 0; w < workers; w++){ pool->sockets[w] = -1; }
+  for (size_t w = 0; w < workers; w++){ ProcessPool_Spawn(pool, w); }
+
+  return pool;
+}
+
+void ProcessPool_Destroy(ProcessPool *pool){
+  if (pool == NULL) { return; }
+
+  for (size_t w = 0; w < pool->workers; w++){
+    if (pool->sockets[w] >= 0) { ProcessPool_Send(pool->sockets[w], PROCESS_POOL_STOP, 0); }
+    ProcessPool_Reap(pool, w);
+  }
+
+  munmap(pool->memory, pool->size);
+  free(pool->pids);
+  free(pool->sockets);
+  free(pool);
+}
+
+
+
+//=============================================================================
+//
+//                     Process Pool Manipulation Functions
+//
+//=============================================================================
+
+size_t ProcessPool_EvaluateShared(ProcessPool *pool, const size_t count){
+  assert(pool != NULL && "pool should not be NULL!");
+  assert(count <= pool->rows && "count is bigger than the rows of the pool!");
+
+  // the workers which crashed in the last round are forked again
+  for (size_t w = 0; w < pool->workers; w++){
+    if (pool->sockets[w] < 0) { ProcessPool_Spawn(pool, w); }
+  }
+
+  // the rows which keep NAN after the round were claimed by the crashed worker
+  for (size_t i = 0; i < count; i++){ pool->fit[i] = NAN; }
+  pool->shared->count = count;
+  atomic_store(&pool->shared->next, 0);
+
+  for (size_t w = 0; w < pool->workers; w++){
+    if (!ProcessPool_Send(pool->sockets[w], PROCESS_POOL_EVALUATE, count)) { ProcessPool_Reap(pool, w); }
+  }
+
+  ProcessPoolMessage message;
+  for (size_t w = 0; w < pool->workers; w++){
+    if (pool->sockets[w] < 0) { continue; }
+    if (!ProcessPool_Receive(pool->sockets[w], &message, &pool->pids[w]) || message.command != PROCESS_POOL_DONE){ ProcessPool_Reap(pool, w); }
+  }
+
+  size_t failed = 0;
+  for (size_t i = 0; i < count; i++){
+    if (isnan(pool->fit[i])){
+      pool->fit[i] = FLT_MAX;
+      failed++;
+    }
+  }
+  return failed;
+}
+
+size_t ProcessPool_Evaluate(ProcessPool *pool, float *const *genomes, const size_t count, float *fit){
+  assert(pool != NULL && genomes != NULL && fit != NULL && "pool, genomes and fit should not be NULL!");
+  assert(count <= pool->rows && "count is bigger than the rows of the pool!");
+
+  for (size_t i = 0; i < count; i++){ memcpy(pool->genomes + i * pool->genes, genomes[i], pool->genes * sizeof(float)); }
+  const size_t failed = ProcessPool_EvaluateShared(pool, count);
+  memcpy(fit, pool->fit, count * sizeof(float));
+
+  return failed;
+}
+
+
+
+//=============================================================================
+//
+//                     Process Pool Query Functions
+//
+//=============================================================================
+
+float* ProcessPool_GetGenomes(const ProcessPool *pool) { return pool->genomes; }
+
+float* ProcessPool_GetFit(const ProcessPool *pool) { return pool->fit; }
+
+size_t ProcessPool_GetWorkers(const ProcessPool *pool) { return pool->workers; }
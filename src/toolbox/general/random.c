@@ -0,0 +1,154 @@
+/**
+ * @file random.c
+ * @brief Reproducible random numbers public interface implementation.
+ *
+ * This file defines all implementations of the Random public interface
+ */
+
+#include "general/random.h"
+
+#include <assert.h>
+#include <math.h>
+
+// 2^-24, the step of the 24 bit floats in [0, 1)
+#define RANDOM_FLOAT_STEP (1.0f / 16777216.0f)
+
+//=============================================================================
+//
+//                     Random Utility Helper Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup Random
+ * @brief The SplitMix64 step, used only to expand the seed into the state.
+ */
+static uint64_t Random_SplitMix(uint64_t *state){
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+static uint64_t Random_Rotate(const uint64_t x, const int k) { return (x << k) | (x >> (64 - k)); }
+
+/*!
+ * @ingroup Random
+ * @brief The pair of the normal floats from two uniform numbers, the first uniform is in (0, 1] for the log.
+ */
+static void Random_NormalPair(Random *random, float *first, float *second){
+  const float radius = sqrtf(-2.0f * logf((float)((Random_Next(random) >> 40) + 1) * RANDOM_FLOAT_STEP));
+  const float angle = 6.28318530718f * Random_Float(random);
+  *first = radius * cosf(angle);
+  *second = radius * sinf(angle);
+}
+
+
+
+//=============================================================================
+//
+//                     Random Lifecycle Management Functions
+//
+//=============================================================================
+
+void Random_Seed(Random *random, const uint64_t seed){
+  assert(random != NULL && "random should not be NULL!");
+
+  uint64_t state = seed;
+  for (int i = 0; i < 4; i++){ random->state[i] = Random_SplitMix(&state); }
+
+  // the all zero state is the only one which never leaves itself
+  if ((random->state[0] | random->state[1] | random->state[2] | random->state[3]) == 0){ random->state[0] = 1; }
+}
+
+void Random_Stream(Random *random, const uint64_t seed, const uint64_t stream){
+  // the hashed seed gets the stream with its own odd constant and the second round mixes both, so the seed and
+  // the stream are not interchangeable and the close indexes do not give the close states
+  uint64_t key = seed;
+  uint64_t mixed = Random_SplitMix(&key) + stream * 0xD1B54A32D192ED03ULL;
+  Random_Seed(random, Random_SplitMix(&mixed));
+}
+
+void Random_Jump(Random *random){
+  static const uint64_t jump[] = {0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL};
+
+  uint64_t state[4] = {0, 0, 0, 0};
+  for (int i = 0; i < 4; i++){
+    for (int bit = 0; bit < 64; bit++){
+      if (jump[i] & (1ULL << bit)){
+        for (int s = 0; s < 4; s++){ state[s] ^= random->state[s]; }
+      }
+      Random_Next(random);
+    }
+  }
+  for (int s = 0; s < 4; s++){ random->state[s] = state[s]; }
+}
+
+
+
+//=============================================================================
+//
+//                     Random Manipulation Functions
+//
+//=============================================================================
+
+uint64_t Random_Next(Random *random){
+  uint64_t *s = random->state;
+  const uint64_t result = Random_Rotate(s[0] + s[3], 23) + s[0];
+  const uint64_t t = s[1] << 17;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = Random_Rotate(s[3], 45);
+
+  return result;
+}
+
+float Random_Float(Random *random) { return (float)(Random_Next(random) >> 40) * RANDOM_FLOAT_STEP; }
+
+float Random_Uniform(Random *random, const float low, const float high) { return low + (high - low) * Random_Float(random); }
+
+uint32_t Random_Bounded(Random *random, const uint32_t bound){
+  assert(bound > 0 && "bound should be at least 1!");
+
+  // the high 32 bits of the product are the index, the low ones below the threshold are the biased part
+  uint64_t product = (Random_Next(random) >> 32) * (uint64_t)bound;
+  uint32_t low = (uint32_t)product;
+  if (low < bound){
+    const uint32_t threshold = (uint32_t)(-bound) % bound;
+    while (low < threshold){
+      product = (Random_Next(random) >> 32) * (uint64_t)bound;
+      low = (uint32_t)product;
+    }
+  }
+  return (uint32_t)(product >> 32);
+}
+
+float Random_Normal(Random *random){
+  float first, second;
+  Random_NormalPair(random, &first, &second);
+  return first;
+}
+
+void Random_FillUniform(Random *random, float *buffer, const size_t count, const float low, const float high){
+  assert(buffer != NULL && "buffer should not be NULL!");
+
+  const float range = high - low;
+  for (size_t i = 0; i < count; i++){ buffer[i] = low + range * Random_Float(random); }
+}
+
+void Random_FillNormal(Random *random, float *buffer, const size_t count, const float mean, const float deviation){
+  assert(buffer != NULL && "buffer should not be NULL!");
+
+  float first, second;
+  size_t i = 0;
+  for (; i + 1 < count; i += 2){
+    Random_NormalPair(random, &first, &second);
+    buffer[i] = mean + deviation * first;
+    buffer[i + 1] = mean + deviation * second;
+  }
+  if (i < count){ buffer[i] = mean + deviation * Random_Normal(random); }
+}
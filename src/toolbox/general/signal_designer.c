@@ -1,51 +1,26 @@
 #include "general/signal_designer.h"
+#include "general/signal_generator.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
 
 // the time step constant
-#define DT001 0.001; 
-#define DT01  0.01;
-
-static void buildFromMap(Signal *signal, const float map[][3], const int size){
-    assert(signal != NULL);
-    assert(signal->signal != NULL);
-
-    int globalIndex = 0;
-    for (int i = 0; i < size; i++){
-        const int start = (int)(map[i][0] / signal->dt);
-        const int end   = (int)(map[i][1] / signal->dt);
-
-        for  (int j = start; j < end; j++){
-            signal->signal[globalIndex] = map[i][2];
-            globalIndex++;
-        }
-    }
-
-    signal->length = globalIndex;
-}
+#define DT001 0.001f
+#define DT01  0.01f
 
 static void selectStepSignal(Signal *signal){
-    signal->length = 1000;
-    signal->dt     = DT01;
-
-    signal->signal = (float*)malloc(signal->length * sizeof(float));
-
     const float map[2][3] = {
         {0,  1, 0},
         {1, 10, 1}};
     const int size = 2;
 
-    buildFromMap(signal, map, size);
+    SignalGenerator generator;
+    SignalGenerator_InitSteps(&generator, map, size, DT01);
+    SignalGenerator_Materialize(&generator, signal);
 }
 
 static void selectCustomASignal(Signal *signal){
-    signal->length = 1002;
-    signal->dt     = DT01;
-
-    signal->signal = (float*)malloc(signal->length * sizeof(float));
-
     const float map[6][3] = {
         {0,  1,  0},
         {1,  3, 30},
@@ -55,7 +30,28 @@ static void selectCustomASignal(Signal *signal){
         {9, 10,  0}};
     const int size = 6;
 
-    buildFromMap(signal, map, size);
+    SignalGenerator generator;
+    SignalGenerator_InitSteps(&generator, map, size, DT01);
+    SignalGenerator_Materialize(&generator, signal);
+}
+
+// the randomized signals use the fixed seed, so the normalization cache and the runs can be repeated
+static void selectRandomStepsSignal(Signal *signal){
+    SignalGenerator generator;
+    SignalGenerator_InitRandomSteps(&generator, 0, 1, 0.5, 2, 10, DT01, 2024);
+    SignalGenerator_Materialize(&generator, signal);
+}
+
+static void selectChirpSignal(Signal *signal){
+    SignalGenerator generator;
+    SignalGenerator_InitChirp(&generator, 0.5, 0.5, 0.05, 1, 10, DT01);
+    SignalGenerator_Materialize(&generator, signal);
+}
+
+static void selectPrbsSignal(Signal *signal){
+    SignalGenerator generator;
+    SignalGenerator_InitPrbs(&generator, 0, 1, 0.5, 10, DT01, 1);
+    SignalGenerator_Materialize(&generator, signal);
 }
 
 
@@ -64,17 +60,33 @@ void deleteSignal(struct Signal *signal){
     free(signal);
 }
 
+int makeSignalByChoice(struct Signal *signal, int choice){
+    if (choice == 1) {
+        selectStepSignal(signal);
+    } else if(choice == 2){
+        selectCustomASignal(signal);
+    } else if(choice == 3){
+        selectRandomStepsSignal(signal);
+    } else if(choice == 4){
+        selectChirpSignal(signal);
+    } else if(choice == 5){
+        selectPrbsSignal(signal);
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
 void cliSignalSelector(struct Signal *signal){
     printf("Please select the Signal:\n");
     printf("1 - step\n");
     printf("2 - custom\n");
+    printf("3 - random steps\n");
+    printf("4 - chirp\n");
+    printf("5 - prbs\n");
     printf("Select: ");
     int userChoice;
     scanf("%d", &userChoice);
 
-    if (userChoice == 1) {
-        selectStepSignal(signal);
-    } else if(userChoice == 2){
-        selectCustomASignal(signal);
-    }
+    makeSignalByChoice(signal, userChoice);
 }
\ No newline at end of file
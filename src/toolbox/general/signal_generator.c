@@ -0,0 +1,226 @@
+/**
+ * @file signal_generator.c
+ * @brief Procedural reference signal generators public interface implementation.
+ *
+ * This file defines all implementations of the Signal Generator public interface
+ */
+
+#include "general/signal_generator.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIGNAL_GENERATOR_TWO_PI 6.283185307179586
+
+//=============================================================================
+//
+//                     Signal Generator Utility Helper Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup SignalGenerator
+ * @brief The SplitMix64 step, small and good enough for the levels and holds of the signals.
+ * @param state the state to be advanced.
+ * @return The next random 64 bits.
+ */
+static uint64_t SignalGenerator_Random(uint64_t *state){
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+/*!
+ * @ingroup SignalGenerator
+ * @brief Set the common part of all the generators.
+ */
+static void SignalGenerator_InitCommon(SignalGenerator *generator, const SignalShape shape, const float duration, const float dt){
+  assert(generator != NULL && "generator pointer should not be NULL!");
+  assert(dt > 0.0f && "dt should be positive!");
+  assert(duration > 0.0f && "duration should be positive!");
+
+  memset(generator, 0, sizeof(SignalGenerator));
+  generator->shape  = shape;
+  generator->dt     = dt;
+  generator->length = (size_t)(duration / dt + 0.5f);
+}
+
+/*!
+ * @ingroup SignalGenerator
+ * @brief Convert the time to the number of samples, at least one.
+ */
+static size_t SignalGenerator_Samples(const float time, const float dt){
+  const size_t samples = (size_t)(time / dt + 0.5f);
+  return samples > 0 ? samples : 1;
+}
+
+
+
+//=============================================================================
+//
+//                     Signal Generator Lifecycle Management Functions
+//
+//=============================================================================
+
+void SignalGenerator_InitSteps(SignalGenerator *generator, const float map[][3], const size_t segments, const float dt){
+  assert(map != NULL && "map should not be NULL!");
+  assert(segments > 0 && segments <= SIGNAL_GENERATOR_MAX_SEGMENTS && "segments count is out of range!");
+
+  SignalGenerator_InitCommon(generator, SIGNAL_STEPS, map[segments - 1][1], dt);
+
+  // the segment borders are truncated the same way as the signal designer map, so the samples are identical
+  size_t end = 0;
+  for (size_t i = 0; i < segments; i++){
+    const int start = (int)(map[i][0] / dt);
+    const int stop  = (int)(map[i][1] / dt);
+    assert(stop >= start && "segment should not end before its start!");
+
+    end += (size_t)(stop - start);
+    generator->ends[i]   = end;
+    generator->values[i] = map[i][2];
+  }
+  generator->segments = segments;
+  generator->length   = end;
+}
+
+void SignalGenerator_InitRamp(SignalGenerator *generator, const float low, const float high, const float startTime,
+                              const float endTime, const float duration, const float dt){
+  assert(endTime >= startTime && "ramp should not end before its start!");
+
+  SignalGenerator_InitCommon(generator, SIGNAL_RAMP, duration, dt);
+  generator->low   = low;
+  generator->high  = high;
+  generator->start = startTime;
+  generator->end   = endTime;
+}
+
+void SignalGenerator_InitChirp(SignalGenerator *generator, const float offset, const float amplitude, const float startFrequency,
+                               const float endFrequency, const float duration, const float dt){
+  SignalGenerator_InitCommon(generator, SIGNAL_CHIRP, duration, dt);
+  generator->low   = offset;
+  generator->high  = amplitude;
+  generator->start = startFrequency;
+  generator->end   = endFrequency;
+}
+
+void SignalGenerator_InitPrbs(SignalGenerator *generator, const float low, const float high, const float bitTime,
+                              const float duration, const float dt, const uint64_t seed){
+  SignalGenerator_InitCommon(generator, SIGNAL_PRBS, duration, dt);
+  generator->low    = low;
+  generator->high   = high;
+  generator->period = SignalGenerator_Samples(bitTime, dt);
+
+  // the register has 15 bits and should never be all zeros
+  generator->seed = seed & 0x7FFFu;
+  if (generator->seed == 0) { generator->seed = 1; }
+
+  SignalGenerator_Reset(generator);
+}
+
+void SignalGenerator_InitRandomSteps(SignalGenerator *generator, const float low, const float high, const float minHold,
+                                     const float maxHold, const float duration, const float dt, const uint64_t seed){
+  assert(maxHold >= minHold && "maximal hold should not be smaller than minimal!");
+
+  SignalGenerator_InitCommon(generator, SIGNAL_RANDOM_STEPS, duration, dt);
+  generator->low       = low;
+  generator->high      = high;
+  generator->period    = SignalGenerator_Samples(minHold, dt);
+  generator->periodMax = SignalGenerator_Samples(maxHold, dt);
+  generator->seed      = seed;
+
+  SignalGenerator_Reset(generator);
+}
+
+void SignalGenerator_Reset(SignalGenerator *generator){
+  assert(generator != NULL && "generator pointer should not be NULL!");
+
+  generator->index   = 0;
+  generator->segment = 0;
+  generator->hold    = 0;
+  generator->level   = generator->low;
+  generator->state   = generator->seed;
+}
+
+
+
+//=============================================================================
+//
+//                     Signal Generator Manipulation Functions
+//
+//=============================================================================
+
+float SignalGenerator_Next(SignalGenerator *generator){
+  assert(generator != NULL && "generator pointer should not be NULL!");
+  assert(generator->index < generator->length && "generator is at the end of the horizon!");
+
+  const size_t index = generator->index++;
+  const float t = (float)index * generator->dt;
+
+  switch (generator->shape){
+    case SIGNAL_STEPS:
+      while (index >= generator->ends[generator->segment] && generator->segment + 1 < generator->segments) { generator->segment++; }
+      return generator->values[generator->segment];
+
+    case SIGNAL_RAMP:
+      if (t <= generator->start) { return generator->low; }
+      if (t >= generator->end)   { return generator->high; }
+      return generator->low + (generator->high - generator->low) * (t - generator->start) / (generator->end - generator->start);
+
+    case SIGNAL_CHIRP: {
+      // the phase grows with t^2, so it is computed in double to stay exact on the long horizons
+      const double time     = (double)index * generator->dt;
+      const double duration = (double)generator->length * generator->dt;
+      const double phase    = SIGNAL_GENERATOR_TWO_PI * (generator->start * time + (generator->end - generator->start) * time * time / (2.0 * duration));
+      return generator->low + generator->high * (float)sin(phase);
+    }
+
+    case SIGNAL_PRBS:
+      if (generator->hold == 0){
+        const uint64_t bit = ((generator->state >> 14) ^ (generator->state >> 13)) & 1u;
+        generator->state = ((generator->state << 1) | bit) & 0x7FFFu;
+        generator->level = bit ? generator->high : generator->low;
+        generator->hold  = generator->period;
+      }
+      generator->hold--;
+      return generator->level;
+
+    case SIGNAL_RANDOM_STEPS:
+      if (generator->hold == 0){
+        const float unit = (float)(SignalGenerator_Random(&generator->state) >> 40) * (1.0f / 16777216.0f);
+        generator->level = generator->low + (generator->high - generator->low) * unit;
+        generator->hold  = generator->period + (size_t)(SignalGenerator_Random(&generator->state) % (generator->periodMax - generator->period + 1));
+      }
+      generator->hold--;
+      return generator->level;
+  }
+
+  return 0.0f;
+}
+
+size_t SignalGenerator_Fill(SignalGenerator *generator, float *chunk, const size_t count){
+  assert(generator != NULL && "generator pointer should not be NULL!");
+  assert(chunk != NULL && "chunk should not be NULL!");
+
+  const size_t left = generator->length - generator->index;
+  const size_t produced = count < left ? count : left;
+
+  for (size_t i = 0; i < produced; i++){ chunk[i] = SignalGenerator_Next(generator); }
+  return produced;
+}
+
+void SignalGenerator_Materialize(SignalGenerator *generator, Signal *signal){
+  assert(generator != NULL && "generator pointer should not be NULL!");
+  assert(signal != NULL && "signal pointer should not be NULL!");
+
+  signal->dt     = generator->dt;
+  signal->length = (int)generator->length;
+  signal->signal = malloc(generator->length * sizeof(float));
+  if (signal->signal == NULL){ perror("Failed to allocate signal"); exit(EXIT_FAILURE); }
+
+  SignalGenerator_Reset(generator);
+  SignalGenerator_Fill(generator, signal->signal, generator->length);
+}
@@ -1,81 +1,171 @@
 #include "general/sort.h"
 
-#include <stdio.h> 
-#include <stdlib.h> 
-#include <time.h> 
-#include <stdbool.h>
-
-static int* safe_realloc(int* ptr, const size_t new_size, const char* varname) {
-  int* tmp = realloc(ptr, new_size * sizeof(int));
-  if (tmp == NULL && new_size > 0) {
-    fprintf(stderr, "Error: realloc failed for %s\n", varname);
-    free(ptr);
-    exit(EXIT_FAILURE);
+#include <stdint.h>
+#include <string.h>
+
+// below this length the insertion sort is faster than the partitioning
+#define SORT_INSERTION_LIMIT 16
+
+// the float bits are mapped so that the unsigned order of the key is the order of the float, NaN is the last
+static uint32_t sortKey(const float value){
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+}
+
+static void swapIndex(int *result, const int i, const int j){
+  const int swap = result[i];
+  result[i] = result[j];
+  result[j] = swap;
+}
+
+static void insertionSort(const float *fit, int *result, const int first, const int last){
+  for(int i=first + 1; i<=last; i++){
+    const int index = result[i];
+    int j = i - 1;
+    while(j >= first && fit[result[j]] > fit[index]){
+      result[j + 1] = result[j];
+      j--;
+    }
+    result[j + 1] = index;
   }
-  return tmp;
 }
 
+// the max heap of the range by fit, used when the partitioning goes too deep
+static void siftDown(const float *fit, int *result, const int first, int root, const int length){
+  while(2 * root + 1 < length){
+    int child = 2 * root + 1;
+    if(child + 1 < length && fit[result[first + child + 1]] > fit[result[first + child]]){ child++; }
+    if(fit[result[first + root]] >= fit[result[first + child]]){ return; }
 
-void quickSort(float *fit, int *result, const int length)
-{
-  // in this sort the fit is only used as a datasource for the result
-  // the length is the data for the result, not fit
-  // the isea is that the list of values will be recursed so that in a result the
-  // input - the array of indexes which should be sorted based on fit
+    swapIndex(result, first + root, first + child);
+    root = child;
+  }
+}
 
-  // first, the indexes as well as arrays for a left and right are created
-  const int index = length / 2;
+static void heapSort(const float *fit, int *result, const int first, const int last){
+  const int length = last - first + 1;
+  for(int i=length / 2 - 1; i>=0; i--){ siftDown(fit, result, first, i, length); }
 
-  int indexMore = 0;
-  int indexLess = 0;
+  for(int end=length - 1; end>0; end--){
+    swapIndex(result, first, first + end);
+    siftDown(fit, result, first, 0, end);
+  }
+}
 
-  int *arrayMore = malloc(length* sizeof(int));
-  int *arrayLess = malloc(length* sizeof(int));
+// the median of the first, middle and last is moved to the last and the range is split around it
+static int partition(const float *fit, int *result, const int first, const int last){
+  const int middle = first + (last - first) / 2;
+  if(fit[result[middle]] < fit[result[first]]){ swapIndex(result, middle, first); }
+  if(fit[result[last]]   < fit[result[first]]){ swapIndex(result, last, first); }
+  if(fit[result[middle]] < fit[result[last]]) { swapIndex(result, middle, last); }
 
-  // now the check is made and arrays are filled with values
-  for(int i=0; i<length; i++){
-    if(i != index){
-      // logic is, indexes with more equal are going right and less going left
-      if(fit[result[i]] >= fit[result[index]]){
-        arrayMore[indexMore] = result[i];
-        indexMore++;
-      } else if(fit[result[i]] < fit[result[index]]){
-        arrayLess[indexLess] = result[i];
-        indexLess++;
-      }
+  const float pivot = fit[result[last]];
+  int store = first;
+  for(int i=first; i<last; i++){
+    if(fit[result[i]] < pivot){
+      swapIndex(result, i, store);
+      store++;
     }
   }
-  // now we have two lists with indexes less and more. Except for the middle one
-  if (indexMore > 0) {arrayMore = safe_realloc(arrayMore, indexMore, "arrayMore");}
-  if (indexLess > 0) {arrayLess = safe_realloc(arrayLess, indexLess, "arrayMore");}
+  swapIndex(result, store, last);
+  return store;
+}
+
+static int depthLimit(int length){
+  int depth = 0;
+  while(length > 1){ length >>= 1; depth++; }
+  return 2 * depth;
+}
+
+static void introSort(const float *fit, int *result, int first, int last, int depth){
+  while(last - first + 1 > SORT_INSERTION_LIMIT){
+    if(depth == 0){
+      heapSort(fit, result, first, last);
+      return;
+    }
+    depth--;
 
-  // now the recursion part should be made
-  if(indexMore > 1){
-    quickSort(fit, arrayMore, indexMore);
+    // the smaller side is recursed, so the stack is at most log(length) deep
+    const int pivot = partition(fit, result, first, last);
+    if(pivot - first < last - pivot){
+      introSort(fit, result, first, pivot - 1, depth);
+      first = pivot + 1;
+    } else{
+      introSort(fit, result, pivot + 1, last, depth);
+      last = pivot - 1;
+    }
   }
+  insertionSort(fit, result, first, last);
+}
+
+void quickSort(float *fit, int *result, const int length){
+  // the fit is only used as a datasource for the result, the indexes are sorted in place without any allocation
+  if(length < 2){ return; }
+  introSort(fit, result, 0, length - 1, depthLimit(length));
+}
 
-  if(indexLess > 1){
-    quickSort(fit, arrayLess, indexLess);
+void radixArgSort(const float *fit, int *result, const int length, int *scratch){
+  // the 4 passes of 8 bits, all the histograms are made in one read of the fit
+  uint32_t histogram[4][256];
+  memset(histogram, 0, sizeof(histogram));
+  for(int i=0; i<length; i++){
+    const uint32_t key = sortKey(fit[result[i]]);
+    for(int pass=0; pass<4; pass++){ histogram[pass][(key >> (8 * pass)) & 0xFF]++; }
   }
 
-  const int middle = result[index];
-  int indexGlobal = 0;
-  // the first the less part is updates
-  for(int i=0; i<indexLess; i++){
-    result[indexGlobal] = arrayLess[i];
-    indexGlobal++;
+  int *from = result;
+  int *to = scratch;
+  for(int pass=0; pass<4; pass++){
+    // the pass where all keys have the same digit changes nothing, it is skipped
+    if(histogram[pass][(sortKey(fit[from[0]]) >> (8 * pass)) & 0xFF] == (uint32_t)length){ continue; }
+
+    uint32_t offset = 0;
+    for(int digit=0; digit<256; digit++){
+      const uint32_t count = histogram[pass][digit];
+      histogram[pass][digit] = offset;
+      offset += count;
+    }
+
+    for(int i=0; i<length; i++){
+      const uint32_t digit = (sortKey(fit[from[i]]) >> (8 * pass)) & 0xFF;
+      to[histogram[pass][digit]++] = from[i];
+    }
+
+    int *swap = from;
+    from = to;
+    to = swap;
   }
 
-  // then middle added
-  result[indexGlobal] = middle;
-  indexGlobal++;
+  if(from != result){ memcpy(result, from, length * sizeof(int)); }
+}
+
+void selectTopK(const float *fit, int *result, const int length, const int k){
+  if(k <= 0 || length < 2){ return; }
+
+  // the quickselect keeps only the side with the k-th index, with the depth limit the rest is made by the heap
+  int first = 0;
+  int last = length - 1;
+  int depth = depthLimit(length);
+  int selected = 0;
+  while(last - first + 1 > SORT_INSERTION_LIMIT && first < k){
+    if(depth == 0){
+      // the many equal fits, e.g. the rejected FLT_MAX ones, the rest is sorted by the heap, the front is sorted below
+      heapSort(fit, result, first, last);
+      selected = 1;
+      break;
+    }
+    depth--;
 
-  // last the more part is updates 
-  for(int i=0; i<indexMore; i++){
-    result[indexGlobal] = arrayMore[i];
-    indexGlobal++;
+    const int pivot = partition(fit, result, first, last);
+    if(pivot >= k){
+      last = pivot - 1;
+    } else{
+      first = pivot + 1;
+    }
   }
+  if(!selected && first < k){ insertionSort(fit, result, first, last); }
 
-  free(arrayLess);
-  free(arrayMore);
+  // now the k smallest are at the front, they are sorted
+  introSort(fit, result, 0, (k < length ? k : length) - 1, depthLimit(k));
 }
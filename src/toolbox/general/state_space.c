@@ -0,0 +1,290 @@
+/**
+ * @file state_space.c
+ * @brief Linear State Space plant public interface implementation.
+ *
+ * This file defines all implementations of the State Space public interface
+ */
+
+#include "general/state_space.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//=============================================================================
+//
+//                     State Space Utility Helper Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup StateSpace
+ * @brief Allocate and copy a float matrix, NULL source gives zero matrix.
+ * @param source the values to be copied.
+ * @param size the number of elements.
+ * @return The new float pointer.
+ */
+static float* StateSpace_CopyMatrix(const float *source, const size_t size){
+  float *output = calloc(size, sizeof(float));
+  if (output == NULL){ perror("Failed to allocate State Space matrix"); exit(EXIT_FAILURE); }
+
+  if (source != NULL) { memcpy(output, source, size * sizeof(float)); }
+  return output;
+}
+
+/*!
+ * @ingroup StateSpace
+ * @brief Square matrix product output = left * right in double, output should not alias inputs.
+ */
+static void StateSpace_MultiplySquare(const double *left, const double *right, double *output, const size_t size){
+  for (size_t i = 0; i < size; i++){
+    for (size_t j = 0; j < size; j++){
+      double sum = 0.0;
+      for (size_t k = 0; k < size; k++){ sum += left[i * size + k] * right[k * size + j]; }
+      output[i * size + j] = sum;
+    }
+  }
+}
+
+/*!
+ * @ingroup StateSpace
+ * @brief Compute exp(matrix) with scaling and squaring of the Taylor series. The result is saved to matrix.
+ * @param matrix the square matrix of the size x size in double.
+ * @param size the size of the matrix.
+ */
+static void StateSpace_Exponential(double *matrix, const size_t size){
+  const size_t elements = size * size;
+
+  // the infinity norm is used to select the scaling, so that ||M / 2^s|| <= 0.5
+  double norm = 0.0;
+  for (size_t i = 0; i < size; i++){
+    double rowSum = 0.0;
+    for (size_t j = 0; j < size; j++){ rowSum += fabs(matrix[i * size + j]); }
+    if (rowSum > norm) { norm = rowSum; }
+  }
+
+  int squarings = 0;
+  if (norm > 0.5) { squarings = (int)ceil(log2(norm / 0.5)); }
+
+  const double scale = ldexp(1.0, -squarings);
+  for (size_t i = 0; i < elements; i++){ matrix[i] *= scale; }
+
+  double *result = calloc(elements, sizeof(double));
+  double *term   = calloc(elements, sizeof(double));
+  double *buffer = calloc(elements, sizeof(double));
+  if (result == NULL || term == NULL || buffer == NULL){ perror("Failed to allocate exponential buffers"); exit(EXIT_FAILURE); }
+
+  // result = I + M + M^2/2! + ... , 16 terms are enough for the norm 0.5 in double
+  for (size_t i = 0; i < size; i++){ result[i * size + i] = 1.0; term[i * size + i] = 1.0; }
+
+  for (int k = 1; k <= 16; k++){
+    StateSpace_MultiplySquare(term, matrix, buffer, size);
+    for (size_t i = 0; i < elements; i++){
+      term[i] = buffer[i] / k;
+      result[i] += term[i];
+    }
+  }
+
+  // undo the scaling with squaring
+  for (int s = 0; s < squarings; s++){
+    StateSpace_MultiplySquare(result, result, buffer, size);
+    memcpy(result, buffer, elements * sizeof(double));
+  }
+
+  memcpy(matrix, result, elements * sizeof(double));
+
+  free(result);
+  free(term);
+  free(buffer);
+}
+
+
+
+//=============================================================================
+//
+//                     State Space Lifecycle Management Functions
+//
+//=============================================================================
+
+StateSpace* StateSpace_Create(const float *A, const float *B, const float *C, const float *D,
+                              const size_t states, const size_t inputs, const size_t outputs){
+  assert(A != NULL && "A matrix should not be NULL!");
+  assert(B != NULL && "B matrix should not be NULL!");
+  assert(C != NULL && "C matrix should not be NULL!");
+
+  assert(states  > 0 && states  <= STATE_SPACE_MAX_SIZE && "states count is out of range!");
+  assert(inputs  > 0 && inputs  <= STATE_SPACE_MAX_SIZE && "inputs count is out of range!");
+  assert(outputs > 0 && outputs <= STATE_SPACE_MAX_SIZE && "outputs count is out of range!");
+
+  StateSpace *stateSpace = NULL;
+  stateSpace = malloc(sizeof(StateSpace));
+  if (stateSpace == NULL){ perror("Failed to allocate State Space"); exit(EXIT_FAILURE); }
+
+  stateSpace->states  = states;
+  stateSpace->inputs  = inputs;
+  stateSpace->outputs = outputs;
+
+  stateSpace->A = StateSpace_CopyMatrix(A, states  * states);
+  stateSpace->B = StateSpace_CopyMatrix(B, states  * inputs);
+  stateSpace->C = StateSpace_CopyMatrix(C, outputs * states);
+  stateSpace->D = StateSpace_CopyMatrix(D, outputs * inputs);
+
+  stateSpace->Ad = StateSpace_CopyMatrix(NULL, states * states);
+  stateSpace->Bd = StateSpace_CopyMatrix(NULL, states * inputs);
+
+  stateSpace->dt = 0.0f;
+
+  return stateSpace;
+}
+
+void StateSpace_Destroy(StateSpace *stateSpace){
+  if (stateSpace == NULL) { return; }
+
+  free(stateSpace->A);
+  free(stateSpace->B);
+  free(stateSpace->C);
+  free(stateSpace->D);
+  free(stateSpace->Ad);
+  free(stateSpace->Bd);
+
+  free(stateSpace);
+}
+
+
+
+//=============================================================================
+//
+//                     State Space Manipulation Functions
+//
+//=============================================================================
+
+void StateSpace_Discretize(StateSpace *stateSpace, const float dt){
+  assert(stateSpace != NULL && "state space pointer should not be NULL!");
+  assert(dt > 0.0f && "dt should be positive!");
+
+  const size_t n = stateSpace->states;
+  const size_t m = stateSpace->inputs;
+  const size_t size = n + m;
+
+  // augmented matrix [[A, B], [0, 0]] * dt, the bottom rows stay zero
+  double *augmented = calloc(size * size, sizeof(double));
+  if (augmented == NULL){ perror("Failed to allocate augmented matrix"); exit(EXIT_FAILURE); }
+
+  for (size_t i = 0; i < n; i++){
+    for (size_t j = 0; j < n; j++){ augmented[i * size + j]     = (double)stateSpace->A[i * n + j] * dt; }
+    for (size_t j = 0; j < m; j++){ augmented[i * size + n + j] = (double)stateSpace->B[i * m + j] * dt; }
+  }
+
+  StateSpace_Exponential(augmented, size);
+
+  for (size_t i = 0; i < n; i++){
+    for (size_t j = 0; j < n; j++){ stateSpace->Ad[i * n + j] = (float)augmented[i * size + j]; }
+    for (size_t j = 0; j < m; j++){ stateSpace->Bd[i * m + j] = (float)augmented[i * size + n + j]; }
+  }
+  stateSpace->dt = dt;
+
+  free(augmented);
+}
+
+void StateSpace_Step(const StateSpace *stateSpace, float *x, const float *u, float *y){
+  assert(stateSpace != NULL && "state space pointer should not be NULL!");
+  assert(stateSpace->dt > 0.0f && "state space should be discretized before the step!");
+
+  const size_t n = stateSpace->states;
+  const size_t m = stateSpace->inputs;
+  const size_t p = stateSpace->outputs;
+
+  float next[STATE_SPACE_MAX_SIZE];
+
+  // x[k+1] = Ad * x[k] + Bd * u[k]
+  for (size_t i = 0; i < n; i++){
+    const float *rowA = stateSpace->Ad + i * n;
+    const float *rowB = stateSpace->Bd + i * m;
+
+    float sum = 0.0f;
+    for (size_t j = 0; j < n; j++){ sum += rowA[j] * x[j]; }
+    for (size_t j = 0; j < m; j++){ sum += rowB[j] * u[j]; }
+    next[i] = sum;
+  }
+  memcpy(x, next, n * sizeof(float));
+
+  // y[k+1] = C * x[k+1] + D * u[k]
+  for (size_t i = 0; i < p; i++){
+    const float *rowC = stateSpace->C + i * n;
+    const float *rowD = stateSpace->D + i * m;
+
+    float sum = 0.0f;
+    for (size_t j = 0; j < n; j++){ sum += rowC[j] * x[j]; }
+    for (size_t j = 0; j < m; j++){ sum += rowD[j] * u[j]; }
+    y[i] = sum;
+  }
+}
+
+
+
+//=============================================================================
+//
+//                     State Space Query Functions
+//
+//=============================================================================
+
+int StateSpace_DcGain(const StateSpace *stateSpace, float *gain){
+  assert(stateSpace != NULL && "state space pointer should not be NULL!");
+  assert(gain != NULL && "gain pointer should not be NULL!");
+
+  const size_t n = stateSpace->states;
+  const size_t m = stateSpace->inputs;
+  const size_t p = stateSpace->outputs;
+
+  // solve A * X = B with the Gauss elimination and partial pivoting, the [A | B] is eliminated together
+  const size_t width = n + m;
+  double *system = malloc(n * width * sizeof(double));
+  if (system == NULL){ perror("Failed to allocate DC gain system"); exit(EXIT_FAILURE); }
+
+  double scale = 0.0;
+  for (size_t i = 0; i < n; i++){
+    for (size_t j = 0; j < n; j++){
+      system[i * width + j] = stateSpace->A[i * n + j];
+      if (fabs(system[i * width + j]) > scale) { scale = fabs(system[i * width + j]); }
+    }
+    for (size_t j = 0; j < m; j++){ system[i * width + n + j] = stateSpace->B[i * m + j]; }
+  }
+
+  for (size_t col = 0; col < n; col++){
+    size_t pivot = col;
+    for (size_t row = col + 1; row < n; row++){
+      if (fabs(system[row * width + col]) > fabs(system[pivot * width + col])) { pivot = row; }
+    }
+    if (fabs(system[pivot * width + col]) <= 1e-9 * scale){ free(system); return 0; }
+
+    if (pivot != col){
+      for (size_t j = 0; j < width; j++){
+        const double swap = system[col * width + j];
+        system[col * width + j] = system[pivot * width + j];
+        system[pivot * width + j] = swap;
+      }
+    }
+
+    for (size_t row = 0; row < n; row++){
+      if (row == col) { continue; }
+      const double factor = system[row * width + col] / system[col * width + col];
+      for (size_t j = col; j < width; j++){ system[row * width + j] -= factor * system[col * width + j]; }
+    }
+  }
+
+  // G = D - C * X, where X[i][j] = system[i][n + j] / system[i][i]
+  for (size_t i = 0; i < p; i++){
+    for (size_t j = 0; j < m; j++){
+      double sum = stateSpace->D[i * m + j];
+      for (size_t k = 0; k < n; k++){
+        sum -= stateSpace->C[i * n + k] * system[k * width + n + j] / system[k * width + k];
+      }
+      gain[i * m + j] = (float)sum;
+    }
+  }
+
+  free(system);
+  return 1;
+}
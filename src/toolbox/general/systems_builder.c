@@ -1,9 +1,14 @@
 #include "general/systems_builder.h"
 #include "general/pid_controller.h"
+#include "general/state_space.h"
+#include "general/ode_integrator.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
 #include <math.h>
+#include <assert.h>
 
 float linear(float *data){
     // in casse of linear data is returned as it is
@@ -41,26 +46,205 @@ float complexYDddot(float *data){
     return data[4];
 }
 
+// the same plant as complexYDddot, but kept as (A, B, C, D) and discretized exactly
+// one model is kept for each sampling time, so the systems with different dt do not change each other
+#define SYSTEM_SAMPLE_TIMES 8
+
+static StateSpace *complexYDddotPlants[SYSTEM_SAMPLE_TIMES];
+static int complexYDddotCount = 0;
+
+static StateSpace* createComplexYDddotPlant(void){
+    // dddot_y + 2 * ddot_y + 3 * dot_y + 4 * y = u with the states x = [y, dot_y, ddot_y]
+    const float A[] = { 0.0f,  1.0f,  0.0f,
+                        0.0f,  0.0f,  1.0f,
+                       -4.0f, -3.0f, -2.0f};
+    const float B[] = {0.0f, 0.0f, 1.0f};
+    const float C[] = {1.0f, 0.0f, 0.0f};
+
+    return StateSpace_Create(A, B, C, NULL, 3, 1, 1);
+}
+
+static StateSpace* findComplexYDddotPlant(const float dt){
+    for (int i = 0; i < complexYDddotCount; i++){
+        if (complexYDddotPlants[i]->dt == dt) { return complexYDddotPlants[i]; }
+    }
+    return NULL;
+}
+
+float complexYDddotStateSpace(float *data){
+    // in this case data is:
+    // 0 - u
+    // 1 - dt
+    // 2 - y
+    // 3 - dot_y
+    // 4 - ddot_y
+    // the plant is discretized once for each dt in prepareSystem, so the dt can be as big as the controller needs
+    const StateSpace *plant = findComplexYDddotPlant(data[1]);
+    assert(plant != NULL && "prepareSystem should be called for the dt of the system!");
+
+    float y;
+    StateSpace_Step(plant, &data[2], &data[0], &y);
+    return y;
+}
+
+// the indexes of the nonlinearPendulum data memory
+#define PENDULUM_STEP      4
+#define PENDULUM_INTERVALS 5
+#define PENDULUM_ACCEPTED  6
+#define PENDULUM_REJECTED  7
+#define PENDULUM_CALLS     8
+#define PENDULUM_WORKSPACE 9
+#define PENDULUM_SIZE      (PENDULUM_WORKSPACE + ODE_INTEGRATOR_BUFFERS * 2)
+
+static void pendulumDerivative(const float t, const float *x, const float u, float *dx, void *context){
+    // damped pendulum driven by torque: ddot_theta = u - g/l * sin(theta) - c * dot_theta
+    (void)t;
+    (void)context;
+
+    dx[0] = x[1];
+    dx[1] = u - 9.81f * sinf(x[0]) - 0.5f * x[1];
+}
+
+// the counters are kept as uint32_t in the float slots, the float stops counting by one above 2^24
+static void addPendulumCounter(float *slot, const size_t count){
+    uint32_t value;
+    memcpy(&value, slot, sizeof(value));
+    value += (uint32_t)count;
+    memcpy(slot, &value, sizeof(value));
+}
+
+static size_t readPendulumCounter(const float *slot){
+    uint32_t value;
+    memcpy(&value, slot, sizeof(value));
+    return (size_t)value;
+}
+
+float nonlinearPendulum(float *data){
+    // in this case data is:
+    // 0 - u
+    // 1 - dt
+    // 2 - theta (y)
+    // 3 - dot_theta
+    // 4 - the step size memory of the integrator
+    // 5..8 - the cost counters (intervals, accepted, rejected, function calls) as uint32_t
+    // 9.. - the stage buffers of the integrator, so the plant is reentrant and makes no allocation
+    OdeIntegrator integrator = {
+        .function  = pendulumDerivative,
+        .context   = NULL,
+        .states    = 2,
+        .relTol    = 1e-4f,
+        .absTol    = 1e-6f,
+        .minStep   = 1e-6f,
+        .maxStep   = 0.0f,
+        .workspace = &data[PENDULUM_WORKSPACE],
+        .step      = data[PENDULUM_STEP]
+    };
+
+    OdeIntegrator_Integrate(&integrator, &data[2], data[0], data[1]);
+
+    data[PENDULUM_STEP] = integrator.step;
+    addPendulumCounter(&data[PENDULUM_INTERVALS], integrator.stats.intervals);
+    addPendulumCounter(&data[PENDULUM_ACCEPTED], integrator.stats.acceptedSteps);
+    addPendulumCounter(&data[PENDULUM_REJECTED], integrator.stats.rejectedSteps);
+    addPendulumCounter(&data[PENDULUM_CALLS], integrator.stats.functionCalls);
+
+    return data[2];
+}
+
+int getSystemStepStats(float (*func_ptr)(float*), const float *data, OdeStats *stats){
+    if (func_ptr != nonlinearPendulum){
+        return 0;
+    }
+    stats->intervals     = readPendulumCounter(&data[PENDULUM_INTERVALS]);
+    stats->acceptedSteps = readPendulumCounter(&data[PENDULUM_ACCEPTED]);
+    stats->rejectedSteps = readPendulumCounter(&data[PENDULUM_REJECTED]);
+    stats->functionCalls = readPendulumCounter(&data[PENDULUM_CALLS]);
+    return 1;
+}
+
+int getSystemStateCount(float (*func_ptr)(float*), const int sizeDataSystem){
+    // the states follow u and dt, the rest of the memory is the work memory of the system
+    if (func_ptr == linear)                  { return 0; }
+    if (func_ptr == complexYDot)             { return 1; }
+    if (func_ptr == complexYDddot)           { return 3; }
+    if (func_ptr == complexYDddotStateSpace) { return 3; }
+    if (func_ptr == nonlinearPendulum)       { return 2; }
+    return sizeDataSystem > 2 ? sizeDataSystem - 2 : 0;
+}
+
+void prepareSystem(float (*func_ptr)(float*), const float dt){
+    // the models of the other dt stay as they are, the systems already running keep their plant
+    if (func_ptr == complexYDddotStateSpace && findComplexYDddotPlant(dt) == NULL){
+        if (complexYDddotCount == SYSTEM_SAMPLE_TIMES){
+            fprintf(stderr, "Too many sampling times of the state space plant\n");
+            exit(EXIT_FAILURE);
+        }
+        StateSpace *plant = createComplexYDddotPlant();
+        StateSpace_Discretize(plant, dt);
+        complexYDddotPlants[complexYDddotCount++] = plant;
+    }
+}
+
+StateSpace* getSystemStateSpace(float (*func_ptr)(float*), const float dt){
+    if (func_ptr == complexYDddotStateSpace){
+        return findComplexYDddotPlant(dt);
+    }
+    return NULL;
+}
+
+int getSystemId(float (*func_ptr)(float*)){
+    // the ids are the same as the CLI choices, so they are stable between runs
+    if (func_ptr == linear)                  { return 1; }
+    if (func_ptr == complexYDddot)           { return 2; }
+    if (func_ptr == complexYDot)             { return 3; }
+    if (func_ptr == complexYDddotStateSpace) { return 4; }
+    if (func_ptr == nonlinearPendulum)       { return 5; }
+    return 0;
+}
+
+void releaseSystems(void){
+    for (int i = 0; i < complexYDddotCount; i++){
+        StateSpace_Destroy(complexYDddotPlants[i]);
+        complexYDddotPlants[i] = NULL;
+    }
+    complexYDddotCount = 0;
+}
+
+int selectSystemByChoice(float (**func_ptr)(float*), int choice){
+    if (choice == 1) {
+        *func_ptr = linear;
+        return 2;
+    } else if (choice == 2){
+        *func_ptr = complexYDddot;
+        return 6;
+    } else if (choice == 3){
+        *func_ptr = complexYDot;
+        return 4;
+    } else if (choice == 4){
+        *func_ptr = complexYDddotStateSpace;
+        return 5;
+    } else if (choice == 5){
+        *func_ptr = nonlinearPendulum;
+        return PENDULUM_SIZE;
+    }
+    return 0;
+}
+
 int selectSystem(float (**func_ptr)(float*)){
     printf("Please select the system:\n");
     printf("1 - linear\n");
     printf("2 - complexYDddot\n");
     printf("3 - complexYDot\n");
+    printf("4 - complexYDddot (state space)\n");
+    printf("5 - nonlinearPendulum (RK45)\n");
     printf("Select: ");
 
     int userChoice;
     scanf("%d", &userChoice);
 
-    if (userChoice == 1) {
-        *func_ptr = linear;
-        return 2;
-    } else if (userChoice == 2){
-        *func_ptr = complexYDddot;
-        return 6;
-    } else if (userChoice == 3){
-        *func_ptr = complexYDot;
-        return 4;
-    } else{
+    const int size = selectSystemByChoice(func_ptr, userChoice);
+    if (size == 0){
         exit(0);
     }
+    return size;
 }
\ No newline at end of file
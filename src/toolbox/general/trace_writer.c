@@ -0,0 +1,288 @@
+/**
+ * @file trace_writer.c
+ * @brief Buffered binary trace sink public interface implementation.
+ *
+ * This file defines all implementations of the Trace Writer public interface
+ */
+
+#include "general/trace_writer.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACE_WRITER_VERSION 1u
+#define TRACE_WRITER_MAX_NAME 256u
+
+static const char TRACE_WRITER_MAGIC[8] = {'N', 'N', 'T', 'R', 'A', 'C', 'E', '1'};
+
+struct TraceWriter {
+  FILE *file;          // the trace file
+  size_t columnCount;  // floats in one record
+  size_t capacity;     // records in one buffer
+
+  float *buffers[2];   // row-major record buffers, one filled by the simulation, one flushed
+  float *columns;      // column-major scratch of the flushing thread
+  size_t active;       // the index of the buffer being filled
+  size_t filled;       // the records in the active buffer
+
+  float *pending;        // the buffer handed to the thread, NULL when the thread is idle
+  size_t pendingRecords; // the records in the pending buffer
+  int stop;              // 1 - the thread should end after the pending buffer
+
+  pthread_t thread;
+  pthread_mutex_t mutex;
+  pthread_cond_t condition;
+};
+
+//=============================================================================
+//
+//                     Trace Writer Utility Helper Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup TraceWriter
+ * @brief Transpose the row records into the columns and write them as one block.
+ * @param writer the writer.
+ * @param records the row-major buffer.
+ * @param count the number of records.
+ */
+static void TraceWriter_WriteBlock(TraceWriter *writer, const float *records, const size_t count){
+  const size_t columns = writer->columnCount;
+
+  for (size_t c = 0; c < columns; c++){
+    float *column = writer->columns + c * count;
+    for (size_t r = 0; r < count; r++){ column[r] = records[r * columns + c]; }
+  }
+
+  const uint32_t blockRecords = (uint32_t)count;
+  if (fwrite(&blockRecords, sizeof(blockRecords), 1, writer->file) != 1 ||
+      fwrite(writer->columns, sizeof(float), count * columns, writer->file) != count * columns){
+    perror("Failed to write trace block");
+  }
+}
+
+/*!
+ * @ingroup TraceWriter
+ * @brief The flushing thread, writes the pending buffers until stopped.
+ * @param argument the writer.
+ * @return NULL.
+ */
+static void* TraceWriter_Thread(void *argument){
+  TraceWriter *writer = argument;
+
+  pthread_mutex_lock(&writer->mutex);
+  for (;;){
+    while (writer->pending == NULL && writer->stop == 0) { pthread_cond_wait(&writer->condition, &writer->mutex); }
+    if (writer->pending == NULL && writer->stop == 1) { break; }
+
+    const float *records = writer->pending;
+    const size_t count = writer->pendingRecords;
+
+    // the disk write is made without the lock, the simulation keeps filling the other buffer
+    pthread_mutex_unlock(&writer->mutex);
+    TraceWriter_WriteBlock(writer, records, count);
+    pthread_mutex_lock(&writer->mutex);
+
+    writer->pending = NULL;
+    pthread_cond_broadcast(&writer->condition);
+  }
+  pthread_mutex_unlock(&writer->mutex);
+
+  return NULL;
+}
+
+/*!
+ * @ingroup TraceWriter
+ * @brief Hand the active buffer to the thread and switch to the other buffer.
+ * @param writer the writer.
+ */
+static void TraceWriter_Handover(TraceWriter *writer){
+  if (writer->filled == 0) { return; }
+
+  pthread_mutex_lock(&writer->mutex);
+  while (writer->pending != NULL) { pthread_cond_wait(&writer->condition, &writer->mutex); }
+
+  writer->pending = writer->buffers[writer->active];
+  writer->pendingRecords = writer->filled;
+  pthread_cond_broadcast(&writer->condition);
+  pthread_mutex_unlock(&writer->mutex);
+
+  writer->active = 1 - writer->active;
+  writer->filled = 0;
+}
+
+
+
+//=============================================================================
+//
+//                     Trace Writer Lifecycle Management Functions
+//
+//=============================================================================
+
+TraceWriter* TraceWriter_Create(const char *path, const char *const *columns, const size_t columnCount, size_t bufferRecords){
+  assert(path != NULL && "path should not be NULL!");
+  assert(columns != NULL && "columns should not be NULL!");
+  assert(columnCount > 0 && "column count should be positive!");
+
+  if (bufferRecords == 0) { bufferRecords = TRACE_WRITER_DEFAULT_RECORDS; }
+
+  FILE *file = fopen(path, "wb");
+  if (file == NULL) { perror("Failed to open trace file"); return NULL; }
+
+  TraceWriter *writer = NULL;
+  writer = malloc(sizeof(TraceWriter));
+  if (writer == NULL){ perror("Failed to allocate Trace Writer"); exit(EXIT_FAILURE); }
+
+  writer->file        = file;
+  writer->columnCount = columnCount;
+  writer->capacity    = bufferRecords;
+
+  writer->buffers[0] = malloc(bufferRecords * columnCount * sizeof(float));
+  writer->buffers[1] = malloc(bufferRecords * columnCount * sizeof(float));
+  writer->columns    = malloc(bufferRecords * columnCount * sizeof(float));
+  if (writer->buffers[0] == NULL || writer->buffers[1] == NULL || writer->columns == NULL){ perror("Failed to allocate Trace Writer buffers"); exit(EXIT_FAILURE); }
+
+  writer->active  = 0;
+  writer->filled  = 0;
+  writer->pending = NULL;
+  writer->pendingRecords = 0;
+  writer->stop    = 0;
+
+  // the header describes the columns, so the trace is readable without the code which wrote it
+  const uint32_t version = TRACE_WRITER_VERSION;
+  const uint32_t count   = (uint32_t)columnCount;
+  fwrite(TRACE_WRITER_MAGIC, sizeof(TRACE_WRITER_MAGIC), 1, file);
+  fwrite(&version, sizeof(version), 1, file);
+  fwrite(&count, sizeof(count), 1, file);
+  for (size_t i = 0; i < columnCount; i++){
+    const uint32_t length = (uint32_t)strlen(columns[i]);
+    assert(length < TRACE_WRITER_MAX_NAME && "column name is too long!");
+    fwrite(&length, sizeof(length), 1, file);
+    fwrite(columns[i], 1, length, file);
+  }
+
+  pthread_mutex_init(&writer->mutex, NULL);
+  pthread_cond_init(&writer->condition, NULL);
+  if (pthread_create(&writer->thread, NULL, TraceWriter_Thread, writer) != 0){ perror("Failed to start Trace Writer thread"); exit(EXIT_FAILURE); }
+
+  return writer;
+}
+
+void TraceWriter_Destroy(TraceWriter *writer){
+  if (writer == NULL) { return; }
+
+  TraceWriter_Handover(writer);
+
+  pthread_mutex_lock(&writer->mutex);
+  writer->stop = 1;
+  pthread_cond_broadcast(&writer->condition);
+  pthread_mutex_unlock(&writer->mutex);
+  pthread_join(writer->thread, NULL);
+
+  pthread_mutex_destroy(&writer->mutex);
+  pthread_cond_destroy(&writer->condition);
+
+  fclose(writer->file);
+
+  free(writer->buffers[0]);
+  free(writer->buffers[1]);
+  free(writer->columns);
+  free(writer);
+}
+
+
+
+//=============================================================================
+//
+//                     Trace Writer Manipulation Functions
+//
+//=============================================================================
+
+void TraceWriter_Append(TraceWriter *writer, const float *record){
+  assert(writer != NULL && "writer should not be NULL!");
+  assert(record != NULL && "record should not be NULL!");
+
+  memcpy(writer->buffers[writer->active] + writer->filled * writer->columnCount, record, writer->columnCount * sizeof(float));
+  writer->filled++;
+
+  if (writer->filled == writer->capacity) { TraceWriter_Handover(writer); }
+}
+
+void TraceWriter_Flush(TraceWriter *writer){
+  assert(writer != NULL && "writer should not be NULL!");
+
+  TraceWriter_Handover(writer);
+
+  pthread_mutex_lock(&writer->mutex);
+  while (writer->pending != NULL) { pthread_cond_wait(&writer->condition, &writer->mutex); }
+  pthread_mutex_unlock(&writer->mutex);
+
+  fflush(writer->file);
+}
+
+long TraceWriter_TranscodeToCsv(const char *binaryPath, const char *csvPath){
+  assert(binaryPath != NULL && "binary path should not be NULL!");
+  assert(csvPath != NULL && "csv path should not be NULL!");
+
+  FILE *input = fopen(binaryPath, "rb");
+  if (input == NULL) { return -1; }
+
+  char magic[8];
+  uint32_t version = 0;
+  uint32_t columns = 0;
+  if (fread(magic, sizeof(magic), 1, input) != 1 || memcmp(magic, TRACE_WRITER_MAGIC, sizeof(magic)) != 0 ||
+      fread(&version, sizeof(version), 1, input) != 1 || version != TRACE_WRITER_VERSION ||
+      fread(&columns, sizeof(columns), 1, input) != 1 || columns == 0){
+    fclose(input);
+    return -1;
+  }
+
+  FILE *output = fopen(csvPath, "w");
+  if (output == NULL) { fclose(input); return -1; }
+
+  // the header of the CSV is made from the column names
+  char name[TRACE_WRITER_MAX_NAME];
+  for (uint32_t i = 0; i < columns; i++){
+    uint32_t length = 0;
+    if (fread(&length, sizeof(length), 1, input) != 1 || length >= TRACE_WRITER_MAX_NAME || fread(name, 1, length, input) != length){
+      fclose(input);
+      fclose(output);
+      return -1;
+    }
+    name[length] = '\0';
+    fprintf(output, i + 1 < columns ? "%s," : "%s\n", name);
+  }
+
+  long total = 0;
+  float *block = NULL;
+  size_t blockCapacity = 0;
+  uint32_t records = 0;
+
+  while (fread(&records, sizeof(records), 1, input) == 1){
+    const size_t values = (size_t)records * columns;
+    if (values > blockCapacity){
+      float *resized = realloc(block, values * sizeof(float));
+      if (resized == NULL){ perror("Failed to allocate transcoder block"); exit(EXIT_FAILURE); }
+      block = resized;
+      blockCapacity = values;
+    }
+    if (fread(block, sizeof(float), values, input) != values) { break; }
+
+    for (uint32_t r = 0; r < records; r++){
+      for (uint32_t c = 0; c < columns; c++){
+        fprintf(output, c + 1 < columns ? "%f," : "%f\n", block[(size_t)c * records + r]);
+      }
+    }
+    total += records;
+  }
+
+  free(block);
+  fclose(input);
+  fclose(output);
+  return total;
+}
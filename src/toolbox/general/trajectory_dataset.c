@@ -0,0 +1,425 @@
+/**
+ * @file trajectory_dataset.c
+ * @brief Memory mapped recorded trajectory dataset public interface implementation.
+ *
+ * This file defines all implementations of the Trajectory Dataset public interface
+ */
+
+// mmap, ftruncate and getline are POSIX
+#define _POSIX_C_SOURCE 200809L
+
+#include "general/trajectory_dataset.h"
+
+#include <assert.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TRAJECTORY_DATASET_MAGIC       "NNTRAJ01"
+#define TRAJECTORY_DATASET_VERSION     1u
+#define TRAJECTORY_DATASET_HEADER_SIZE 32u
+
+// the biggest number of columns, the header line is split into the fixed array
+#define TRAJECTORY_DATASET_MAX_COLUMNS 256
+
+/**
+ * @struct TrajectoryDatasetHeader
+ * @brief The fixed part of the file header, exactly TRAJECTORY_DATASET_HEADER_SIZE bytes.
+ * @ingroup TrajectoryDataset
+ */
+typedef struct TrajectoryDatasetHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t columns;
+  uint64_t rows;
+  float dt;
+  uint32_t reserved;
+} TrajectoryDatasetHeader;
+
+struct TrajectoryDataset {
+  void *map;   // the whole mapped file
+  size_t size; // the size of the mapping
+
+  size_t columns; // the number of columns
+  size_t rows;    // the number of rows
+  size_t stride;  // the floats between the starts of two columns
+  float dt;       // the sampling time
+
+  const char *names; // the column names inside the mapping
+  const float *data; // the first column inside the mapping
+};
+
+//=============================================================================
+//
+//                     Trajectory Dataset Utility Helper Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup TrajectoryDataset
+ * @brief The floats between the starts of two columns, the rows rounded up to the alignment.
+ */
+static size_t TrajectoryDataset_Stride(const size_t rows){
+  return (rows + TRAJECTORY_DATASET_ALIGNMENT - 1) / TRAJECTORY_DATASET_ALIGNMENT * TRAJECTORY_DATASET_ALIGNMENT;
+}
+
+/*!
+ * @ingroup TrajectoryDataset
+ * @brief The offset of the first column, the header and names rounded up to 64 bytes.
+ */
+static size_t TrajectoryDataset_DataOffset(const size_t columns){
+  const size_t alignment = TRAJECTORY_DATASET_ALIGNMENT * sizeof(float);
+  const size_t header = TRAJECTORY_DATASET_HEADER_SIZE + columns * TRAJECTORY_DATASET_NAME_SIZE;
+  return (header + alignment - 1) / alignment * alignment;
+}
+
+/*!
+ * @ingroup TrajectoryDataset
+ * @brief Check that the columns of the header fit into the file, the size is computed without the overflow.
+ * @return 1 if the header offset and all the columns are inside the size.
+ */
+static int TrajectoryDataset_Fits(const size_t columns, const uint64_t rows, const size_t size){
+  // the stride rounds the rows up, so the biggest rows would wrap around before the multiplication
+  if (rows > (uint64_t)(SIZE_MAX - TRAJECTORY_DATASET_ALIGNMENT)) { return 0; }
+
+  const size_t offset = TrajectoryDataset_DataOffset(columns);
+  if (offset > size) { return 0; }
+
+  const size_t stride = TrajectoryDataset_Stride((size_t)rows);
+  const size_t floats = (size - offset) / sizeof(float);
+  return stride <= floats / columns;
+}
+
+/*!
+ * @ingroup TrajectoryDataset
+ * @brief Check if the line has only the white space.
+ */
+static int TrajectoryDataset_IsBlank(const char *line){
+  for (; *line != '\0'; line++){
+    if (*line != ' ' && *line != '\t' && *line != '\r' && *line != '\n') { return 0; }
+  }
+  return 1;
+}
+
+/*!
+ * @ingroup TrajectoryDataset
+ * @brief Split the header line into the names, the white space and quotes around the names are removed.
+ * @return The number of columns, 0 if the line is not valid.
+ */
+static size_t TrajectoryDataset_ParseNames(char *line, char names[][TRAJECTORY_DATASET_NAME_SIZE]){
+  size_t columns = 0;
+  char *field = line;
+
+  while (field != NULL){
+    if (columns == TRAJECTORY_DATASET_MAX_COLUMNS) { return 0; }
+
+    char *next = strchr(field, ',');
+    if (next != NULL) { *next++ = '\0'; }
+
+    char *end = field + strlen(field);
+    while (*field == ' ' || *field == '\t' || *field == '"') { field++; }
+    while (end > field && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r' || end[-1] == '\n' || end[-1] == '"')) { end--; }
+    if (end == field) { return 0; }
+
+    // the longer names are truncated, the last byte is always zero
+    size_t length = (size_t)(end - field);
+    if (length >= TRAJECTORY_DATASET_NAME_SIZE) { length = TRAJECTORY_DATASET_NAME_SIZE - 1; }
+    memset(names[columns], 0, TRAJECTORY_DATASET_NAME_SIZE);
+    memcpy(names[columns], field, length);
+
+    columns++;
+    field = next;
+  }
+  return columns;
+}
+
+/*!
+ * @ingroup TrajectoryDataset
+ * @brief Parse one row into the columns of the mapped output.
+ * @return 1 if the row has exactly the columns values, 0 otherwise.
+ */
+static int TrajectoryDataset_ParseRow(const char *line, float *data, const size_t columns, const size_t stride, const size_t row){
+  const char *cursor = line;
+
+  for (size_t c = 0; c < columns; c++){
+    char *end = NULL;
+    const float value = strtof(cursor, &end);
+    if (end == cursor) { return 0; }
+
+    while (*end == ' ' || *end == '\t') { end++; }
+    if (c + 1 < columns){
+      if (*end != ',') { return 0; }
+      end++;
+    } else if (*end != '\0' && *end != '\r' && *end != '\n'){
+      return 0;
+    }
+
+    data[c * stride + row] = value;
+    cursor = end;
+  }
+  return 1;
+}
+
+/*!
+ * @ingroup TrajectoryDataset
+ * @brief Find the sampling time from the first two samples of the "t" or "time" column.
+ * @return The sampling time, 0 if there is no such column or it is not increasing.
+ */
+static float TrajectoryDataset_TimeStep(const char names[][TRAJECTORY_DATASET_NAME_SIZE], const float *data,
+                                        const size_t columns, const size_t stride, const size_t rows){
+  if (rows < 2) { return 0.0f; }
+
+  for (size_t c = 0; c < columns; c++){
+    if (strcmp(names[c], "t") == 0 || strcmp(names[c], "time") == 0){
+      const float dt = data[c * stride + 1] - data[c * stride];
+      return dt > 0.0f ? dt : 0.0f;
+    }
+  }
+  return 0.0f;
+}
+
+
+
+//=============================================================================
+//
+//                     Trajectory Dataset Lifecycle Management Functions
+//
+//=============================================================================
+
+long TrajectoryDataset_ConvertCsv(const char *csvPath, const char *binaryPath, float dt){
+  assert(csvPath != NULL && binaryPath != NULL && "paths should not be NULL!");
+
+  FILE *input = fopen(csvPath, "r");
+  if (input == NULL) { return -1; }
+
+  char *line = NULL;
+  size_t capacity = 0;
+  char names[TRAJECTORY_DATASET_MAX_COLUMNS][TRAJECTORY_DATASET_NAME_SIZE];
+
+  // the first pass reads the names and counts the rows, so the output can be sized before it is filled
+  size_t columns = 0;
+  if (getline(&line, &capacity, input) > 0) { columns = TrajectoryDataset_ParseNames(line, names); }
+  if (columns == 0){
+    free(line);
+    fclose(input);
+    return -1;
+  }
+
+  size_t rows = 0;
+  while (getline(&line, &capacity, input) > 0){
+    if (!TrajectoryDataset_IsBlank(line)) { rows++; }
+  }
+
+  const size_t stride = TrajectoryDataset_Stride(rows);
+  const size_t offset = TrajectoryDataset_DataOffset(columns);
+  const size_t size = offset + columns * stride * sizeof(float);
+
+  // the output is filled through the writable mapping, the padding stays zero from ftruncate
+  const int file = open(binaryPath, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (file < 0){
+    free(line);
+    fclose(input);
+    return -1;
+  }
+
+  void *map = MAP_FAILED;
+  if (ftruncate(file, (off_t)size) == 0) { map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0); }
+  close(file);
+  if (map == MAP_FAILED){
+    free(line);
+    fclose(input);
+    unlink(binaryPath);
+    return -1;
+  }
+
+  float *data = (float*)((char*)map + offset);
+
+  // the second pass parses the rows straight into the columns
+  rewind(input);
+  int valid = getline(&line, &capacity, input) > 0;
+  size_t row = 0;
+  while (valid && row < rows && getline(&line, &capacity, input) > 0){
+    if (TrajectoryDataset_IsBlank(line)) { continue; }
+    valid = TrajectoryDataset_ParseRow(line, data, columns, stride, row);
+    row++;
+  }
+  valid = valid && row == rows;
+
+  free(line);
+  fclose(input);
+
+  if (valid && dt <= 0.0f){
+    dt = TrajectoryDataset_TimeStep((const char (*)[TRAJECTORY_DATASET_NAME_SIZE])names, data, columns, stride, rows);
+    valid = dt > 0.0f;
+  }
+
+  if (valid){
+    TrajectoryDatasetHeader header;
+    memcpy(header.magic, TRAJECTORY_DATASET_MAGIC, sizeof(header.magic));
+    header.version  = TRAJECTORY_DATASET_VERSION;
+    header.columns  = (uint32_t)columns;
+    header.rows     = (uint64_t)rows;
+    header.dt       = dt;
+    header.reserved = 0;
+
+    memcpy(map, &header, sizeof(header));
+    memcpy((char*)map + TRAJECTORY_DATASET_HEADER_SIZE, names, columns * TRAJECTORY_DATASET_NAME_SIZE);
+    valid = msync(map, size, MS_SYNC) == 0;
+  }
+
+  munmap(map, size);
+  if (!valid){
+    unlink(binaryPath);
+    return -1;
+  }
+  return (long)rows;
+}
+
+TrajectoryDataset* TrajectoryDataset_Open(const char *path){
+  assert(path != NULL && "path should not be NULL!");
+
+  const int file = open(path, O_RDONLY);
+  if (file < 0) { return NULL; }
+
+  struct stat info;
+  if (fstat(file, &info) != 0 || (size_t)info.st_size < TRAJECTORY_DATASET_HEADER_SIZE){
+    close(file);
+    return NULL;
+  }
+
+  const size_t size = (size_t)info.st_size;
+  void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+  close(file);
+  if (map == MAP_FAILED) { return NULL; }
+
+  TrajectoryDatasetHeader header;
+  memcpy(&header, map, sizeof(header));
+
+  const size_t columns = header.columns;
+  const size_t rows = (size_t)header.rows;
+  const int valid = memcmp(header.magic, TRAJECTORY_DATASET_MAGIC, sizeof(header.magic)) == 0 &&
+                    header.version == TRAJECTORY_DATASET_VERSION && columns > 0 && columns <= TRAJECTORY_DATASET_MAX_COLUMNS &&
+                    header.dt > 0.0f && TrajectoryDataset_Fits(columns, header.rows, size);
+  if (!valid){
+    munmap(map, size);
+    return NULL;
+  }
+
+  TrajectoryDataset *dataset = NULL;
+  dataset = malloc(sizeof(TrajectoryDataset));
+  if (dataset == NULL){ perror("Failed to allocate Trajectory Dataset"); exit(EXIT_FAILURE); }
+
+  dataset->map     = map;
+  dataset->size    = size;
+  dataset->columns = columns;
+  dataset->rows    = rows;
+  dataset->stride  = TrajectoryDataset_Stride(rows);
+  dataset->dt      = header.dt;
+  dataset->names   = (const char*)map + TRAJECTORY_DATASET_HEADER_SIZE;
+  dataset->data    = (const float*)((const char*)map + TrajectoryDataset_DataOffset(columns));
+
+  // the simulations read the columns front to back, the kernel can read ahead
+  posix_madvise(map, size, POSIX_MADV_SEQUENTIAL);
+
+  return dataset;
+}
+
+void TrajectoryDataset_Close(TrajectoryDataset *dataset){
+  if (dataset == NULL) { return; }
+
+  munmap(dataset->map, dataset->size);
+  free(dataset);
+}
+
+
+
+//=============================================================================
+//
+//                     Trajectory Dataset Query Functions
+//
+//=============================================================================
+
+size_t TrajectoryDataset_GetRows(const TrajectoryDataset *dataset){
+  assert(dataset != NULL && "dataset pointer should not be NULL!");
+  return dataset->rows;
+}
+
+size_t TrajectoryDataset_GetColumnCount(const TrajectoryDataset *dataset){
+  assert(dataset != NULL && "dataset pointer should not be NULL!");
+  return dataset->columns;
+}
+
+float TrajectoryDataset_GetDt(const TrajectoryDataset *dataset){
+  assert(dataset != NULL && "dataset pointer should not be NULL!");
+  return dataset->dt;
+}
+
+const char* TrajectoryDataset_GetColumnName(const TrajectoryDataset *dataset, const size_t column){
+  assert(dataset != NULL && "dataset pointer should not be NULL!");
+  assert(column < dataset->columns && "column is out of range!");
+  return dataset->names + column * TRAJECTORY_DATASET_NAME_SIZE;
+}
+
+int TrajectoryDataset_FindColumn(const TrajectoryDataset *dataset, const char *name){
+  assert(dataset != NULL && "dataset pointer should not be NULL!");
+  assert(name != NULL && "name should not be NULL!");
+
+  for (size_t c = 0; c < dataset->columns; c++){
+    if (strncmp(dataset->names + c * TRAJECTORY_DATASET_NAME_SIZE, name, TRAJECTORY_DATASET_NAME_SIZE) == 0) { return (int)c; }
+  }
+  return -1;
+}
+
+const float* TrajectoryDataset_GetColumn(const TrajectoryDataset *dataset, const size_t column){
+  assert(dataset != NULL && "dataset pointer should not be NULL!");
+  assert(column < dataset->columns && "column is out of range!");
+  return dataset->data + column * dataset->stride;
+}
+
+Signal TrajectoryDataset_GetSignal(const TrajectoryDataset *dataset, const size_t column, const size_t first, size_t length){
+  assert(dataset != NULL && "dataset pointer should not be NULL!");
+  assert(first <= dataset->rows && "first row is out of range!");
+
+  if (length == 0) { length = dataset->rows - first; }
+  assert(first + length <= dataset->rows && "window is out of range!");
+  assert(length <= INT_MAX && "window is too long for the Signal!");
+
+  // the Signal has no const, the view is read only by the contract
+  Signal signal;
+  signal.signal = (float*)(TrajectoryDataset_GetColumn(dataset, column) + first);
+  signal.dt     = dataset->dt;
+  signal.length = (int)length;
+  return signal;
+}
+
+
+
+//=============================================================================
+//
+//                     Trajectory Dataset Evaluation Functions
+//
+//=============================================================================
+
+float TrajectoryDataset_ScoreOpenLoop(const TrajectoryDataset *dataset, const size_t wColumn, const size_t yColumn,
+                                      const size_t uColumn, float (*controller)(void*, float, float), void *context){
+  assert(dataset != NULL && "dataset pointer should not be NULL!");
+  assert(controller != NULL && "controller should not be NULL!");
+
+  const float *w = TrajectoryDataset_GetColumn(dataset, wColumn);
+  const float *y = TrajectoryDataset_GetColumn(dataset, yColumn);
+  const float *u = TrajectoryDataset_GetColumn(dataset, uColumn);
+
+  // the loop is open, the recorded y is the measurement whatever the controller gives
+  float score = 0.0f;
+  for (size_t i = 0; i < dataset->rows; i++){
+    score += fabsf(controller(context, w[i], y[i]) - u[i]);
+  }
+  return score;
+}
@@ -0,0 +1,392 @@
+/**
+ * @file cma_es.c
+ * @brief Covariance matrix adaptation evolution strategy public interface implementation.
+ *
+ * This file defines all implementations of the CMA-ES public interface
+ */
+
+#include "genetic/cma_es.h"
+
+#include "general/parallel.h"
+#include "general/sort.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @struct CmaUpdate
+ * @brief The shared state of the parallel covariance update.
+ * @ingroup CmaEs
+ */
+typedef struct CmaUpdate {
+  CmaEs *es;
+  float decay; // the factor of the old covariance
+} CmaUpdate;
+
+//=============================================================================
+//
+//                     CMA-ES Utility Helper Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup CmaEs
+ * @brief The dot product with the independent partial sums, so the loop vectorizes without the reassociation.
+ */
+static float CmaEs_Dot(const float *restrict a, const float *restrict b, const size_t count){
+  float sums[8] = {0.0f};
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8){
+    for (size_t k = 0; k < 8; k++){ sums[k] += a[i + k] * b[i + k]; }
+  }
+  for (; i < count; i++){ sums[0] += a[i] * b[i]; }
+  return ((sums[0] + sums[4]) + (sums[1] + sums[5])) + ((sums[2] + sums[6]) + (sums[3] + sums[7]));
+}
+
+/*!
+ * @ingroup CmaEs
+ * @brief Sample one row: z is standard normal, y is L z or the diagonal times z, x is the mean plus the scaled step.
+ */
+static void CmaEs_SampleRow(const size_t index, const size_t thread, void *context){
+  (void)thread;
+  CmaEs *es = context;
+  const size_t genes = es->genes;
+  float *z = es->normals + index * genes;
+  float *y = es->steps + index * genes;
+  float *x = es->current[index];
+
+  Random_FillNormal(&es->streams[index], z, genes, 0.0f, 1.0f);
+
+  if (es->covariance == CMA_FULL){
+    for (size_t j = 0; j < genes; j++){ y[j] = CmaEs_Dot(es->factor + j * genes, z, j + 1); }
+  } else{
+    for (size_t j = 0; j < genes; j++){ y[j] = es->factor[j] * z[j]; }
+  }
+
+  const float sigma = (float)es->sigma;
+  for (size_t j = 0; j < genes; j++){ x[j] = es->mean[j] + sigma * es->scale[j] * y[j]; }
+
+  if (es->min == NULL) { return; }
+
+  // the steps of the clipped rows, so the new mean is the weighted mean of the evaluated rows and stays in the bounds
+  for (size_t j = 0; j < genes; j++){
+    const float clipped = x[j] < es->min[j] ? es->min[j] : (x[j] > es->max[j] ? es->max[j] : x[j]);
+    if (clipped != x[j]) { y[j] = (clipped - es->mean[j]) / (sigma * es->scale[j]); }
+    x[j] = clipped;
+  }
+}
+
+/*!
+ * @ingroup CmaEs
+ * @brief Seed the stream of each row from the seed and the generation and sample all the rows.
+ */
+static void CmaEs_Sample(CmaEs *es){
+  for (size_t i = 0; i < es->rows; i++){
+    Random_Stream(&es->streams[i], es->seed, (uint64_t)es->generation * es->rows + i);
+  }
+  Parallel_For(es->rows, es->threads, CmaEs_SampleRow, es);
+}
+
+/*!
+ * @ingroup CmaEs
+ * @brief Update the lower triangle of one row of the full covariance by the rank one and the rank mu terms.
+ */
+static void CmaEs_UpdateRow(const size_t row, const size_t thread, void *context){
+  (void)thread;
+  const CmaUpdate *update = context;
+  const CmaEs *es = update->es;
+  const size_t genes = es->genes;
+  float *restrict c = es->matrix + row * genes;
+  const float *restrict path = es->pathC;
+
+  const float rankOne = (float)es->c1 * path[row];
+  for (size_t k = 0; k <= row; k++){ c[k] = update->decay * c[k] + rankOne * path[k]; }
+
+  for (size_t i = 0; i < es->mu; i++){
+    const float *restrict y = es->steps + (size_t)es->order[i] * genes;
+    const float rankMu = (float)(es->cmu * es->weights[i]) * y[row];
+    for (size_t k = 0; k <= row; k++){ c[k] += rankMu * y[k]; }
+  }
+}
+
+/*!
+ * @ingroup CmaEs
+ * @brief Make the Cholesky factor of the lower triangle of the covariance, the lost definiteness is repaired by the growing ridge.
+ */
+static void CmaEs_Factorize(CmaEs *es){
+  const size_t genes = es->genes;
+  float *c = es->matrix;
+  float *l = es->factor;
+
+  float largest = 0.0f;
+  for (size_t j = 0; j < genes; j++){
+    if (c[j * genes + j] > largest) { largest = c[j * genes + j]; }
+  }
+
+  float ridge = 0.0f;
+  for (int attempt = 0; attempt < 32; attempt++){
+    int positive = 1;
+    for (size_t i = 0; i < genes && positive; i++){
+      float *li = l + i * genes;
+      for (size_t j = 0; j < i; j++){
+        const float *lj = l + j * genes;
+        li[j] = (c[i * genes + j] - CmaEs_Dot(li, lj, j)) / lj[j];
+      }
+      const float pivot = c[i * genes + i] + ridge - CmaEs_Dot(li, li, i);
+      if (!(pivot > 0.0f)) { positive = 0; break; }
+      li[i] = sqrtf(pivot);
+    }
+    if (positive) { break; }
+
+    ridge = ridge > 0.0f ? 10.0f * ridge : 1e-6f * (largest > 0.0f ? largest : 1.0f);
+  }
+
+  // the covariance keeps the ridge, so it stays the matrix of its factor
+  if (ridge > 0.0f){
+    for (size_t j = 0; j < genes; j++){ c[j * genes + j] += ridge; }
+  }
+}
+
+
+
+//=============================================================================
+//
+//                     CMA-ES Lifecycle Management Functions
+//
+//=============================================================================
+
+CmaEs* CmaEs_Create(const CmaConfig *config){
+  assert(config != NULL && "config should not be NULL!");
+  assert(config->genes > 0 && "genes should be at least 1!");
+  assert((config->min == NULL) == (config->max == NULL) && "both bounds or none should be given!");
+  assert(config->sigma > 0.0f && "sigma should be positive!");
+
+  CmaEs *es = NULL;
+  es = malloc(sizeof(CmaEs));
+  if (es == NULL){ perror("Failed to allocate CMA-ES"); exit(EXIT_FAILURE); }
+
+  const size_t genes = config->genes;
+  const double n = (double)genes;
+
+  es->genes = genes;
+  es->rows = config->rows > 0 ? config->rows : 4 + (size_t)floor(3.0 * log(n));
+  assert(es->rows >= 2 && "rows should be at least 2!");
+  es->mu = es->rows / 2;
+  es->covariance = config->covariance;
+  es->threads = config->threads;
+  es->seed = config->seed;
+  es->generation = 0;
+  es->pending = 0;
+  es->sigma = config->sigma;
+
+  const size_t matrix = config->covariance == CMA_FULL ? genes * genes : genes;
+  es->memory  = malloc(es->rows * genes * sizeof(float));
+  es->current = malloc(es->rows * sizeof(float*));
+  es->fit     = malloc(es->rows * sizeof(float));
+  es->order   = malloc(es->rows * sizeof(int));
+  es->normals = malloc(es->rows * genes * sizeof(float));
+  es->steps   = malloc(es->rows * genes * sizeof(float));
+  es->mean    = malloc(genes * sizeof(float));
+  es->scale   = malloc(genes * sizeof(float));
+  es->pathC   = calloc(genes, sizeof(float));
+  es->pathS   = calloc(genes, sizeof(float));
+  es->work    = malloc(2 * genes * sizeof(float));
+  es->matrix  = calloc(matrix, sizeof(float));
+  es->factor  = calloc(matrix, sizeof(float));
+  es->weights = malloc(es->mu * sizeof(double));
+  es->streams = malloc(es->rows * sizeof(Random));
+  if (es->memory == NULL || es->current == NULL || es->fit == NULL || es->order == NULL || es->normals == NULL ||
+      es->steps == NULL || es->mean == NULL || es->scale == NULL || es->pathC == NULL || es->pathS == NULL ||
+      es->work == NULL || es->matrix == NULL || es->factor == NULL || es->weights == NULL || es->streams == NULL){
+    perror("Failed to allocate CMA-ES state");
+    exit(EXIT_FAILURE);
+  }
+
+  es->min = NULL;
+  es->max = NULL;
+  if (config->min != NULL){
+    es->min = malloc(genes * sizeof(float));
+    es->max = malloc(genes * sizeof(float));
+    if (es->min == NULL || es->max == NULL){ perror("Failed to allocate CMA-ES bounds"); exit(EXIT_FAILURE); }
+    memcpy(es->min, config->min, genes * sizeof(float));
+    memcpy(es->max, config->max, genes * sizeof(float));
+  }
+
+  for (size_t j = 0; j < genes; j++){
+    es->scale[j] = es->min != NULL ? es->max[j] - es->min[j] : 1.0f;
+    if      (config->mean != NULL) { es->mean[j] = config->mean[j]; }
+    else if (es->min != NULL)      { es->mean[j] = 0.5f * (es->min[j] + es->max[j]); }
+    else                           { es->mean[j] = 0.0f; }
+  }
+  for (size_t i = 0; i < es->rows; i++){
+    es->current[i] = es->memory + i * genes;
+    es->fit[i]     = 0.0f;
+    es->order[i]   = (int)i;
+  }
+
+  // the default weights and learning rates of Hansen's tutorial
+  double sum = 0.0;
+  double squares = 0.0;
+  for (size_t i = 0; i < es->mu; i++){
+    es->weights[i] = log((double)es->mu + 0.5) - log((double)i + 1.0);
+    sum += es->weights[i];
+  }
+  for (size_t i = 0; i < es->mu; i++){
+    es->weights[i] /= sum;
+    squares += es->weights[i] * es->weights[i];
+  }
+  es->mueff = 1.0 / squares;
+
+  es->cc    = (4.0 + es->mueff / n) / (n + 4.0 + 2.0 * es->mueff / n);
+  es->cs    = (es->mueff + 2.0) / (n + es->mueff + 5.0);
+  es->c1    = 2.0 / ((n + 1.3) * (n + 1.3) + es->mueff);
+  es->cmu   = 2.0 * (es->mueff - 2.0 + 1.0 / es->mueff) / ((n + 2.0) * (n + 2.0) + es->mueff);
+  es->damps = 1.0 + 2.0 * fmax(0.0, sqrt((es->mueff - 1.0) / (n + 1.0)) - 1.0) + es->cs;
+  es->chiN  = sqrt(n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+
+  // the diagonal has only genes free parameters, so it learns (n + 2) / 3 times faster (Ros and Hansen)
+  if (es->covariance == CMA_DIAGONAL){
+    es->c1  *= (n + 2.0) / 3.0;
+    es->cmu *= (n + 2.0) / 3.0;
+  }
+  if (es->c1 > 1.0) { es->c1 = 1.0; }
+  if (es->cmu > 1.0 - es->c1) { es->cmu = 1.0 - es->c1; }
+
+  // the factor follows the covariance lazily, it moves by c1 + cmu per generation
+  const double lazy = 1.0 / ((es->c1 + es->cmu) * n * 10.0);
+  es->decompose = lazy > 1.0 ? (size_t)lazy : 1;
+
+  if (es->covariance == CMA_FULL){
+    for (size_t j = 0; j < genes; j++){ es->matrix[j * genes + j] = es->factor[j * genes + j] = 1.0f; }
+  } else{
+    for (size_t j = 0; j < genes; j++){ es->matrix[j] = es->factor[j] = 1.0f; }
+  }
+
+  CmaEs_Sample(es);
+
+  return es;
+}
+
+void CmaEs_Destroy(CmaEs *es){
+  if (es == NULL) { return; }
+
+  free(es->memory);
+  free(es->current);
+  free(es->fit);
+  free(es->order);
+  free(es->normals);
+  free(es->steps);
+  free(es->mean);
+  free(es->scale);
+  free(es->min);
+  free(es->max);
+  free(es->pathC);
+  free(es->pathS);
+  free(es->work);
+  free(es->matrix);
+  free(es->factor);
+  free(es->weights);
+  free(es->streams);
+  free(es);
+}
+
+
+
+//=============================================================================
+//
+//                     CMA-ES Manipulation Functions
+//
+//=============================================================================
+
+void CmaEs_Step(CmaEs *es){
+  assert(es != NULL && "es should not be NULL!");
+  const size_t genes = es->genes;
+
+  for (size_t i = 0; i < es->rows; i++){ es->order[i] = (int)i; }
+  selectTopK(es->fit, es->order, (int)es->rows, (int)es->mu);
+
+  // the weighted means of the mu best steps and of their normals
+  float *yw = es->work;
+  float *zw = es->work + genes;
+  memset(es->work, 0, 2 * genes * sizeof(float));
+  for (size_t i = 0; i < es->mu; i++){
+    const float weight = (float)es->weights[i];
+    const float *y = es->steps + (size_t)es->order[i] * genes;
+    const float *z = es->normals + (size_t)es->order[i] * genes;
+    for (size_t j = 0; j < genes; j++){
+      yw[j] += weight * y[j];
+      zw[j] += weight * z[j];
+    }
+  }
+
+  const float move = (float)es->sigma;
+  for (size_t j = 0; j < genes; j++){ es->mean[j] += move * es->scale[j] * yw[j]; }
+
+  // the factor is fixed since the rows were sampled, so the whitened step C^-1/2 yw is zw
+  const float keepS = (float)(1.0 - es->cs);
+  const float pushS = (float)sqrt(es->cs * (2.0 - es->cs) * es->mueff);
+  for (size_t j = 0; j < genes; j++){ es->pathS[j] = keepS * es->pathS[j] + pushS * zw[j]; }
+  const double lengthS = sqrt((double)CmaEs_Dot(es->pathS, es->pathS, genes));
+
+  // the too long step size path holds the covariance path, so the fast growth of sigma does not stretch the covariance
+  const double fade = 1.0 - pow(1.0 - es->cs, 2.0 * (double)(es->generation + 1));
+  const int hold = lengthS / sqrt(fade) / es->chiN >= 1.4 + 2.0 / ((double)genes + 1.0);
+
+  const float keepC = (float)(1.0 - es->cc);
+  const float pushC = hold ? 0.0f : (float)sqrt(es->cc * (2.0 - es->cc) * es->mueff);
+  for (size_t j = 0; j < genes; j++){ es->pathC[j] = keepC * es->pathC[j] + pushC * yw[j]; }
+
+  const float decay = (float)(1.0 - es->c1 - es->cmu + (hold ? es->c1 * es->cc * (2.0 - es->cc) : 0.0));
+  if (es->covariance == CMA_FULL){
+    CmaUpdate update = {.es = es, .decay = decay};
+    Parallel_For(genes, es->threads, CmaEs_UpdateRow, &update);
+  } else{
+    for (size_t j = 0; j < genes; j++){ es->matrix[j] = decay * es->matrix[j] + (float)es->c1 * es->pathC[j] * es->pathC[j]; }
+    for (size_t i = 0; i < es->mu; i++){
+      const float rankMu = (float)(es->cmu * es->weights[i]);
+      const float *y = es->steps + (size_t)es->order[i] * genes;
+      for (size_t j = 0; j < genes; j++){ es->matrix[j] += rankMu * y[j] * y[j]; }
+    }
+  }
+
+  es->sigma *= exp(es->cs / es->damps * (lengthS / es->chiN - 1.0));
+
+  es->generation++;
+  es->pending++;
+  if (es->covariance == CMA_FULL){
+    if (es->pending >= es->decompose){
+      CmaEs_Factorize(es);
+      es->pending = 0;
+    }
+  } else{
+    for (size_t j = 0; j < genes; j++){ es->factor[j] = sqrtf(es->matrix[j]); }
+  }
+
+  CmaEs_Sample(es);
+}
+
+
+
+//=============================================================================
+//
+//                     CMA-ES Query Functions
+//
+//=============================================================================
+
+size_t CmaEs_GetBest(const CmaEs *es){
+  assert(es != NULL && "es should not be NULL!");
+
+  size_t best = 0;
+  for (size_t i = 1; i < es->rows; i++){
+    if (es->fit[i] < es->fit[best]) { best = i; }
+  }
+  return best;
+}
+
+double CmaEs_GetSigma(const CmaEs *es){
+  assert(es != NULL && "es should not be NULL!");
+  return es->sigma;
+}
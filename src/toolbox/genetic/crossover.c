@@ -0,0 +1,186 @@
+/**
+ * @file crossover.c
+ * @brief In place crossover of the flat genome rows public interface implementation.
+ *
+ * This file defines all implementations of the Crossover public interface
+ */
+
+#include "genetic/crossover.h"
+
+#include "general/parallel.h"
+
+#include <assert.h>
+#include <string.h>
+
+// the floats of the stack scratch of the segment swap and of the uniform mask, one random word per block
+#define CROSSOVER_BLOCK 64
+
+/**
+ * @struct CrossoverTask
+ * @brief The context of the pair tasks of Crossover_Rows.
+ * @ingroup Crossover
+ */
+typedef struct CrossoverTask {
+  const Crossover *crossover;
+  Random *streams;
+  float **rows;
+  size_t genes;
+  const float *min;
+  const float *max;
+} CrossoverTask;
+
+//=============================================================================
+//
+//                     Crossover Utility Helper Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup Crossover
+ * @brief Swap the two ranges by the blocks of the stack scratch.
+ */
+static void Crossover_Swap(float *first, float *second, size_t length){
+  float scratch[CROSSOVER_BLOCK];
+  while (length > 0){
+    const size_t block = length < CROSSOVER_BLOCK ? length : CROSSOVER_BLOCK;
+    memcpy(scratch, first, block * sizeof(float));
+    memcpy(first, second, block * sizeof(float));
+    memcpy(second, scratch, block * sizeof(float));
+
+    first += block;
+    second += block;
+    length -= block;
+  }
+}
+
+/*!
+ * @ingroup Crossover
+ * @brief Swap each gene with the chance 1/2, the bits of one random word are the mask of the block.
+ */
+static void Crossover_Uniform(Random *random, float *first, float *second, const size_t genes){
+  int mask[CROSSOVER_BLOCK];
+  for (size_t start = 0; start < genes; start += CROSSOVER_BLOCK){
+    const size_t block = genes - start < CROSSOVER_BLOCK ? genes - start : CROSSOVER_BLOCK;
+    const uint64_t bits = Random_Next(random);
+    for (size_t i = 0; i < block; i++){ mask[i] = (int)((bits >> i) & 1); }
+
+    // the select by the mask has no branch, so the loop is vectorized to the blends and the genes are exact copies
+    float *a = first + start;
+    float *b = second + start;
+    for (size_t i = 0; i < block; i++){
+      const float x = a[i];
+      const float y = b[i];
+      a[i] = mask[i] ? y : x;
+      b[i] = mask[i] ? x : y;
+    }
+  }
+}
+
+/*!
+ * @ingroup Crossover
+ * @brief The two mixes of the parents by one random weight.
+ */
+static void Crossover_Arithmetic(Random *random, float *first, float *second, const size_t genes){
+  const float weight = Random_Float(random);
+  for (size_t i = 0; i < genes; i++){
+    const float a = first[i];
+    const float b = second[i];
+    first[i]  = weight * a + (1.0f - weight) * b;
+    second[i] = (1.0f - weight) * a + weight * b;
+  }
+}
+
+/*!
+ * @ingroup Crossover
+ * @brief The two children uniform in the extended interval of the parents of each gene.
+ */
+static void Crossover_Blend(Random *random, float *first, float *second, const size_t genes, const float alpha,
+                            const float *min, const float *max){
+  for (size_t i = 0; i < genes; i++){
+    const float low  = first[i] < second[i] ? first[i] : second[i];
+    const float high = first[i] < second[i] ? second[i] : first[i];
+    const float extension = alpha * (high - low);
+
+    float from = low - extension;
+    float to = high + extension;
+    if (from < min[i]) { from = min[i]; }
+    if (to > max[i])   { to = max[i]; }
+
+    first[i]  = Random_Uniform(random, from, to);
+    second[i] = Random_Uniform(random, from, to);
+  }
+}
+
+/*!
+ * @ingroup Crossover
+ * @brief The ascending random points of the pair, sorted by the insertion as there are few of them.
+ */
+static void Crossover_RandomPoints(Random *random, int *points, const size_t count, const size_t genes){
+  for (size_t i = 0; i < count; i++){
+    const int point = (int)Random_Bounded(random, (uint32_t)genes + 1);
+    size_t j = i;
+    for (; j > 0 && points[j - 1] > point; j--){ points[j] = points[j - 1]; }
+    points[j] = point;
+  }
+}
+
+static void Crossover_PairTask(const size_t index, const size_t thread, void *context){
+  (void)thread;
+  const CrossoverTask *task = context;
+  Crossover_Pair(task->crossover, &task->streams[2 * index], task->rows[2 * index], task->rows[2 * index + 1], task->genes, task->min, task->max);
+}
+
+
+
+//=============================================================================
+//
+//                     Crossover Manipulation Functions
+//
+//=============================================================================
+
+void Crossover_Segments(float *first, float *second, const int *points, const size_t count, const size_t genes){
+  assert(first != NULL && second != NULL && (count == 0 || points != NULL) && "rows and points should not be NULL!");
+
+  for (size_t i = 0; i < count; i += 2){
+    const int start = points[i];
+    const int end = i + 1 < count ? points[i + 1] : (int)genes;
+    assert(start >= 0 && start <= end && (size_t)end <= genes && "crossover points should be ascending in the genes!");
+
+    Crossover_Swap(first + start, second + start, (size_t)(end - start));
+  }
+}
+
+void Crossover_Pair(const Crossover *crossover, Random *random, float *first, float *second, const size_t genes,
+                    const float *min, const float *max){
+  assert(crossover != NULL && random != NULL && "crossover and random should not be NULL!");
+  assert(crossover->pointsCount <= CROSSOVER_MAX_POINTS && "crossover points are out of range!");
+
+  int points[CROSSOVER_MAX_POINTS];
+  switch (crossover->kind){
+    case CROSSOVER_POINTS:
+      Crossover_Segments(first, second, crossover->points, crossover->pointsCount, genes);
+      break;
+    case CROSSOVER_RANDOM_POINTS:
+      Crossover_RandomPoints(random, points, crossover->pointsCount, genes);
+      Crossover_Segments(first, second, points, crossover->pointsCount, genes);
+      break;
+    case CROSSOVER_UNIFORM:
+      Crossover_Uniform(random, first, second, genes);
+      break;
+    case CROSSOVER_ARITHMETIC:
+      Crossover_Arithmetic(random, first, second, genes);
+      break;
+    case CROSSOVER_BLX:
+      assert(min != NULL && max != NULL && "blend crossover needs the bounds!");
+      Crossover_Blend(random, first, second, genes, crossover->alpha, min, max);
+      break;
+  }
+}
+
+void Crossover_Rows(const Crossover *crossover, Random *streams, float **rows, const size_t count, const size_t genes,
+                    const float *min, const float *max, const size_t threads){
+  assert(streams != NULL && rows != NULL && "streams and rows should not be NULL!");
+
+  CrossoverTask task = {crossover, streams, rows, genes, min, max};
+  Parallel_For(count / 2, threads, Crossover_PairTask, &task);
+}
@@ -0,0 +1,569 @@
+/**
+ * @file experiment_runner.c
+ * @brief Headless batch experiment runner public interface implementation.
+ *
+ * This file defines all implementations of the Experiment Runner public interface
+ */
+
+// the thread affinity and the monotonic clock are not in C99
+#define _GNU_SOURCE
+
+#include "genetic/experiment_runner.h"
+
+#include "general/parallel.h"
+#include "general/pid_batch.h"
+#include "general/pid_controller.h"
+#include "general/process_pool.h"
+#include "genetic/cma_es.h"
+#include "genetic/generation_engine.h"
+#include "genetic/island_model.h"
+#include "genetic/steady_state.h"
+
+#include <assert.h>
+#include <ctype.h>
+#include <float.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// the longest line of the config file
+#define EXPERIMENT_LINE_SIZE 512
+
+/**
+ * @struct ExperimentTask
+ * @brief The argument of the thread of one experiment.
+ * @ingroup ExperimentRunner
+ */
+typedef struct ExperimentTask {
+  const ExperimentConfig *config;
+  ExperimentResult *result;
+  PID *pid; // the pid made before the threads start, prepareSystem is not thread safe
+} ExperimentTask;
+
+//=============================================================================
+//
+//                     Experiment Runner Utility Helper Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup ExperimentRunner
+ * @brief The wall time in seconds.
+ */
+static double ExperimentRunner_Now(void){
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/*!
+ * @ingroup ExperimentRunner
+ * @brief Remove the white space around the text in place.
+ */
+static char* ExperimentRunner_Trim(char *text){
+  while (isspace((unsigned char)*text)) { text++; }
+
+  char *end = text + strlen(text);
+  while (end > text && isspace((unsigned char)end[-1])) { end--; }
+  *end = '\0';
+  return text;
+}
+
+/*!
+ * @ingroup ExperimentRunner
+ * @brief Read the list of the floats separated by the white space.
+ * @return The number of floats read, 0 if the value is not valid.
+ */
+static size_t ExperimentRunner_ParseFloats(const char *value, float *output, const size_t capacity){
+  size_t count = 0;
+  char *end = NULL;
+
+  for (float x = strtof(value, &end); end != value; x = strtof(value, &end)){
+    if (count == capacity) { return 0; }
+    output[count++] = x;
+    value = end;
+  }
+  return *ExperimentRunner_Trim((char*)value) == '\0' ? count : 0;
+}
+
+/*!
+ * @ingroup ExperimentRunner
+ * @brief Set one key of the config.
+ * @return 1 if the key and value are valid, 0 otherwise.
+ */
+static int ExperimentRunner_SetKey(ExperimentConfig *config, const char *key, const char *value){
+  char *end = NULL;
+
+  if (strcmp(key, "name") == 0){
+    snprintf(config->name, EXPERIMENT_NAME_SIZE, "%s", value);
+    return 1;
+  }
+  if (strcmp(key, "controller") == 0){
+    if (strcmp(value, "pid") != 0) { return 0; }
+    config->controller = EXPERIMENT_PID;
+    return 1;
+  }
+  if (strcmp(key, "mode") == 0){
+    if      (strcmp(value, "generational") == 0) { config->mode = EXPERIMENT_GENERATIONAL; }
+    else if (strcmp(value, "steady") == 0)       { config->mode = EXPERIMENT_STEADY_STATE; }
+    else if (strcmp(value, "islands") == 0)      { config->mode = EXPERIMENT_ISLANDS; }
+    else if (strcmp(value, "processes") == 0)    { config->mode = EXPERIMENT_PROCESSES; }
+    else if (strcmp(value, "cmaes") == 0)        { config->mode = EXPERIMENT_CMA_ES; }
+    else { return 0; }
+    return 1;
+  }
+  if (strcmp(key, "topology") == 0){
+    if      (strcmp(value, "ring") == 0)   { config->topology = ISLAND_RING; }
+    else if (strcmp(value, "random") == 0) { config->topology = ISLAND_RANDOM; }
+    else { return 0; }
+    return 1;
+  }
+  if (strcmp(key, "min") == 0) { return ExperimentRunner_ParseFloats(value, config->min, EXPERIMENT_MAX_GENES) == config->genes; }
+  if (strcmp(key, "max") == 0) { return ExperimentRunner_ParseFloats(value, config->max, EXPERIMENT_MAX_GENES) == config->genes; }
+
+  if (strcmp(key, "limit") == 0 || strcmp(key, "mutation") == 0){
+    const float number = strtof(value, &end);
+    if (end == value || *end != '\0' || number < 0.0f) { return 0; }
+
+    if (key[0] == 'l') { config->limit = number; }
+    else               { config->mutation = number; }
+    return 1;
+  }
+
+  const unsigned long long number = strtoull(value, &end, 10);
+  if (end == value || *end != '\0') { return 0; }
+
+  if      (strcmp(key, "signal") == 0)      { config->signal = (int)number; }
+  else if (strcmp(key, "system") == 0)      { config->system = (int)number; }
+  else if (strcmp(key, "metrics") == 0)     { config->metrics = (unsigned)number; }
+  else if (strcmp(key, "threads") == 0)     { config->threads = (size_t)number; }
+  else if (strcmp(key, "population") == 0) { config->population = (size_t)number; }
+  else if (strcmp(key, "generations") == 0) { config->generations = (size_t)number; }
+  else if (strcmp(key, "elite") == 0)       { config->elite = (size_t)number; }
+  else if (strcmp(key, "seed") == 0)        { config->seed = (uint64_t)number; }
+  else if (strcmp(key, "islands") == 0)     { config->islands = (size_t)number; }
+  else if (strcmp(key, "interval") == 0)    { config->interval = (size_t)number; }
+  else if (strcmp(key, "migrants") == 0)    { config->migrants = (size_t)number; }
+  else { return 0; }
+  return 1;
+}
+
+/*!
+ * @ingroup ExperimentRunner
+ * @brief Pin the calling thread to the core set, the threads it starts later inherit the set.
+ */
+static void ExperimentRunner_Pin(const size_t firstCore, const size_t cores){
+#ifdef __linux__
+  const size_t available = Parallel_GetThreadCount();
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (size_t c = 0; c < cores; c++){ CPU_SET((firstCore + c) % available, &set); }
+
+  if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0){
+    fprintf(stderr, "Failed to pin the experiment to the cores %zu-%zu\n", firstCore, firstCore + cores - 1);
+  }
+#else
+  (void)firstCore;
+  (void)cores;
+#endif
+}
+
+/*!
+ * @ingroup ExperimentRunner
+ * @brief The recipe of the generation: the elite is copied, the rest is made by the tournament, the crossover in the middle and the mutation.
+ * @return The number of slices.
+ */
+static size_t ExperimentRunner_Slices(const ExperimentConfig *config, GenerationSlice *slices){
+  const size_t genes = config->genes;
+  const GenerationSlice tournament = {.source = GENERATION_TOURNAMENT, .rows = config->population - config->elite,
+                                      .points = {(int)(genes / 2)}, .pointsCount = genes > 1 ? 1 : 0, .mutation = config->mutation};
+
+  if (config->elite == 0){
+    slices[0] = tournament;
+    return 1;
+  }
+
+  const GenerationSlice elite = {.source = GENERATION_BEST, .rows = config->elite};
+  slices[0] = elite;
+  slices[1] = tournament;
+  return 2;
+}
+
+/*!
+ * @ingroup ExperimentRunner
+ * @brief The evaluator of the worker process, made from the copy of the PID after the fork.
+ */
+static void* ExperimentRunner_WorkerInit(const size_t worker, void *context){
+  (void)worker;
+  return PidBatch_Create(context, 1);
+}
+
+static void ExperimentRunner_WorkerFit(float *const *genomes, const size_t count, float *fit, void *state) { PidBatch_Evaluate(state, genomes, count, fit); }
+
+static void ExperimentRunner_WorkerRelease(void *state) { PidBatch_Destroy(state); }
+
+/*!
+ * @ingroup ExperimentRunner
+ * @brief Run the generational GA of one experiment in the calling thread, the fits by the threads or by the worker processes.
+ */
+static void ExperimentRunner_RunGenerational(const ExperimentConfig *config, PID *pid, ExperimentResult *result){
+  const size_t genes = config->genes;
+
+  GenerationSlice slices[2];
+  const size_t sliceCount = ExperimentRunner_Slices(config, slices);
+
+  GenerationEngine *engine = GenerationEngine_Create(genes, config->min, config->max, slices, sliceCount, config->seed);
+  ProcessPool *pool = NULL;
+  PidBatch *batch = NULL;
+  if (config->mode == EXPERIMENT_PROCESSES){
+    pool = ProcessPool_Create(engine->rows, genes, config->threads, 1, ExperimentRunner_WorkerInit, ExperimentRunner_WorkerFit,
+                              ExperimentRunner_WorkerRelease, pid);
+  } else{
+    batch = PidBatch_Create(pid, config->threads);
+  }
+
+  result->bestFit = FLT_MAX;
+
+  for (size_t generation = 0; generation < config->generations; generation++){
+    if (pool != NULL) { ProcessPool_Evaluate(pool, engine->current, engine->rows, engine->fit); }
+    else              { PidBatch_Evaluate(batch, engine->current, engine->rows, engine->fit); }
+
+    const size_t best = GenerationEngine_GetBest(engine);
+    if (engine->fit[best] < result->bestFit){
+      result->bestFit = engine->fit[best];
+      memcpy(result->best, engine->current[best], genes * sizeof(float));
+    }
+
+    GenerationEngine_Step(engine);
+  }
+
+  result->evaluations = engine->rows * config->generations;
+
+  ProcessPool_Destroy(pool);
+  PidBatch_Destroy(batch);
+  GenerationEngine_Destroy(engine);
+}
+
+/*!
+ * @ingroup ExperimentRunner
+ * @brief The fit of one genome of the steady state, each worker thread has its own batch.
+ */
+static float ExperimentRunner_SteadyFit(float *genome, const size_t thread, void *context){
+  PidBatch **batches = context;
+
+  float fit;
+  PidBatch_Evaluate(batches[thread], &genome, 1, &fit);
+  return fit;
+}
+
+/*!
+ * @ingroup ExperimentRunner
+ * @brief Run the steady state GA of one experiment in the calling thread.
+ */
+static void ExperimentRunner_RunSteadyState(const ExperimentConfig *config, PID *pid, ExperimentResult *result){
+  PidBatch **batches = malloc(config->threads * sizeof(PidBatch*));
+  if (batches == NULL){ perror("Failed to allocate experiment batches"); exit(EXIT_FAILURE); }
+  for (size_t t = 0; t < config->threads; t++){ batches[t] = PidBatch_Create(pid, 1); }
+
+  // the same number of evaluations as the generational run
+  const SteadyStateConfig steady = {
+    .genes = config->genes, .min = config->min, .max = config->max,
+    .population = config->population, .evaluations = config->population * (config->generations > 0 ? config->generations - 1 : 0),
+    .threads = config->threads, .point = config->genes / 2, .mutation = config->mutation, .seed = config->seed
+  };
+
+  SteadyStateResult outcome;
+  SteadyState_Run(&steady, ExperimentRunner_SteadyFit, batches, result->best, &outcome);
+  result->bestFit = outcome.bestFit;
+  result->evaluations = outcome.evaluations;
+
+  for (size_t t = 0; t < config->threads; t++){ PidBatch_Destroy(batches[t]); }
+  free(batches);
+}
+
+/*!
+ * @ingroup ExperimentRunner
+ * @brief The fit of the rows of one island, each island has its own batch.
+ */
+static void ExperimentRunner_IslandFit(float *const *genomes, const size_t count, float *fit, const size_t island, void *context){
+  PidBatch **batches = context;
+  PidBatch_Evaluate(batches[island], genomes, count, fit);
+}
+
+/*!
+ * @ingroup ExperimentRunner
+ * @brief Run the island model GA of one experiment, the islands are the threads on the cores of the experiment.
+ */
+static void ExperimentRunner_RunIslands(const ExperimentConfig *config, PID *pid, ExperimentResult *result){
+  PidBatch **batches = malloc(config->islands * sizeof(PidBatch*));
+  if (batches == NULL){ perror("Failed to allocate experiment batches"); exit(EXIT_FAILURE); }
+  for (size_t i = 0; i < config->islands; i++){ batches[i] = PidBatch_Create(pid, 1); }
+
+  GenerationSlice slices[2];
+  const IslandConfig islands = {
+    .islands = config->islands, .genes = config->genes, .min = config->min, .max = config->max,
+    .slices = slices, .sliceCount = ExperimentRunner_Slices(config, slices), .generations = config->generations,
+    .topology = config->topology, .interval = config->interval, .migrants = config->migrants, .seed = config->seed
+  };
+
+  IslandResult outcome;
+  IslandModel_Run(&islands, ExperimentRunner_IslandFit, batches, result->best, &outcome);
+  result->bestFit = outcome.bestFit;
+  result->evaluations = outcome.evaluations;
+
+  for (size_t i = 0; i < config->islands; i++){ PidBatch_Destroy(batches[i]); }
+  free(batches);
+}
+
+/*!
+ * @ingroup ExperimentRunner
+ * @brief Run the CMA-ES of one experiment in the calling thread, the population is the number of rows per generation.
+ */
+static void ExperimentRunner_RunCmaEs(const ExperimentConfig *config, PID *pid, ExperimentResult *result){
+  const CmaConfig cma = {
+    .genes = config->genes, .rows = config->population, .covariance = CMA_FULL, .sigma = 0.3f,
+    .min = config->min, .max = config->max, .threads = config->threads, .seed = config->seed
+  };
+  CmaEs *es = CmaEs_Create(&cma);
+  PidBatch *batch = PidBatch_Create(pid, config->threads);
+
+  result->bestFit = FLT_MAX;
+
+  for (size_t generation = 0; generation < config->generations; generation++){
+    PidBatch_Evaluate(batch, es->current, es->rows, es->fit);
+
+    const size_t best = CmaEs_GetBest(es);
+    if (es->fit[best] < result->bestFit){
+      result->bestFit = es->fit[best];
+      memcpy(result->best, es->current[best], config->genes * sizeof(float));
+    }
+
+    CmaEs_Step(es);
+  }
+
+  result->evaluations = es->rows * config->generations;
+
+  PidBatch_Destroy(batch);
+  CmaEs_Destroy(es);
+}
+
+/*!
+ * @ingroup ExperimentRunner
+ * @brief Run the GA of one experiment in the calling thread and measure it.
+ */
+static void ExperimentRunner_RunPid(const ExperimentConfig *config, PID *pid, ExperimentResult *result){
+  const double start = ExperimentRunner_Now();
+
+  if      (config->mode == EXPERIMENT_STEADY_STATE) { ExperimentRunner_RunSteadyState(config, pid, result); }
+  else if (config->mode == EXPERIMENT_ISLANDS)      { ExperimentRunner_RunIslands(config, pid, result); }
+  else if (config->mode == EXPERIMENT_CMA_ES)       { ExperimentRunner_RunCmaEs(config, pid, result); }
+  else                                              { ExperimentRunner_RunGenerational(config, pid, result); }
+
+  result->seconds = ExperimentRunner_Now() - start;
+  result->plantSteps = (double)result->evaluations * (double)(pid->signal->length - 2);
+}
+
+/*!
+ * @ingroup ExperimentRunner
+ * @brief The thread of one experiment.
+ */
+static void* ExperimentRunner_Thread(void *argument){
+  ExperimentTask *task = argument;
+
+  ExperimentRunner_Pin(task->result->firstCore, task->result->cores);
+  ExperimentRunner_RunPid(task->config, task->pid, task->result);
+  return NULL;
+}
+
+
+
+//=============================================================================
+//
+//                     Experiment Runner Lifecycle Management Functions
+//
+//=============================================================================
+
+void ExperimentRunner_Defaults(ExperimentConfig *config, const size_t index){
+  assert(config != NULL && "config pointer should not be NULL!");
+
+  memset(config, 0, sizeof(ExperimentConfig));
+  snprintf(config->name, EXPERIMENT_NAME_SIZE, "experiment%zu", index);
+
+  config->controller = EXPERIMENT_PID;
+  config->mode       = EXPERIMENT_GENERATIONAL;
+  config->signal  = 1;
+  config->system  = 4;
+  config->limit   = 60.0f;
+  config->metrics = 0;
+
+  config->threads     = 1;
+  config->population  = 100;
+  config->generations = 100;
+  config->elite       = 4;
+  config->mutation    = 0.1f;
+  config->seed        = 1;
+
+  config->islands  = 4;
+  config->topology = ISLAND_RING;
+  config->interval = 10;
+  config->migrants = 2;
+
+  // the same bounds of Kp, Ki, Kd, tauD as the full PID run
+  const float min[] = {0.0f, 0.0f, 0.0f, 0.01f};
+  const float max[] = {100.0f, 100.0f, 100.0f, 1.0f};
+  config->genes = 4;
+  memcpy(config->min, min, sizeof(min));
+  memcpy(config->max, max, sizeof(max));
+}
+
+int ExperimentRunner_Load(const char *path, ExperimentConfig *configs, const size_t capacity){
+  assert(path != NULL && configs != NULL && "path and configs should not be NULL!");
+
+  FILE *file = fopen(path, "r");
+  if (file == NULL) { return -1; }
+
+  char buffer[EXPERIMENT_LINE_SIZE];
+  int count = 0;
+  int number = 0;
+
+  while (fgets(buffer, sizeof(buffer), file) != NULL){
+    number++;
+    char *line = ExperimentRunner_Trim(buffer);
+    if (*line == '\0' || *line == '#' || *line == ';') { continue; }
+
+    if (strcmp(line, "[experiment]") == 0){
+      if ((size_t)count == capacity){
+        fprintf(stderr, "%s:%d: too many experiments, the limit is %zu\n", path, number, capacity);
+        fclose(file);
+        return -1;
+      }
+      ExperimentRunner_Defaults(&configs[count], (size_t)count);
+      count++;
+      continue;
+    }
+
+    char *separator = strchr(line, '=');
+    if (count == 0 || separator == NULL){
+      fprintf(stderr, "%s:%d: expected key = value inside the [experiment]\n", path, number);
+      fclose(file);
+      return -1;
+    }
+
+    *separator = '\0';
+    const char *key = ExperimentRunner_Trim(line);
+    const char *value = ExperimentRunner_Trim(separator + 1);
+    if (!ExperimentRunner_SetKey(&configs[count - 1], key, value)){
+      fprintf(stderr, "%s:%d: unknown key or wrong value of %s\n", path, number, key);
+      fclose(file);
+      return -1;
+    }
+  }
+
+  fclose(file);
+
+  for (int i = 0; i < count; i++){
+    const ExperimentConfig *config = &configs[i];
+    if (config->threads == 0 || config->population < 2 || config->elite >= config->population){
+      fprintf(stderr, "%s: experiment %s needs threads > 0 and population > elite\n", path, config->name);
+      return -1;
+    }
+    if (config->mode == EXPERIMENT_ISLANDS && (config->islands == 0 || config->migrants > config->population)){
+      fprintf(stderr, "%s: experiment %s needs islands > 0 and migrants <= population\n", path, config->name);
+      return -1;
+    }
+  }
+  return count;
+}
+
+
+
+//=============================================================================
+//
+//                     Experiment Runner Manipulation Functions
+//
+//=============================================================================
+
+void ExperimentRunner_RunAll(const ExperimentConfig *configs, const size_t count, ExperimentResult *results){
+  assert(configs != NULL && results != NULL && "configs and results should not be NULL!");
+  if (count == 0) { return; }
+
+  ExperimentTask *tasks = calloc(count, sizeof(ExperimentTask));
+  pthread_t *threads = malloc(count * sizeof(pthread_t));
+  int *started = calloc(count, sizeof(int));
+  if (tasks == NULL || threads == NULL || started == NULL){ perror("Failed to allocate experiment threads"); exit(EXIT_FAILURE); }
+
+  const size_t available = Parallel_GetThreadCount();
+  size_t nextCore = 0;
+
+  // the systems are prepared here one by one, the threads only read them
+  for (size_t i = 0; i < count; i++){
+    ExperimentResult *result = &results[i];
+    memset(result, 0, sizeof(ExperimentResult));
+    snprintf(result->name, EXPERIMENT_NAME_SIZE, "%s", configs[i].name);
+
+    PID *pid = malloc(sizeof(PID));
+    if (pid == NULL){ perror("Failed to allocate experiment PID"); exit(EXIT_FAILURE); }
+    if (createPidControllerByChoice(pid, configs[i].signal, configs[i].system) == 0){
+      fprintf(stderr, "Experiment %s has unknown signal %d or system %d\n", configs[i].name, configs[i].signal, configs[i].system);
+      free(pid);
+      continue;
+    }
+
+    pid->limMax    =  configs[i].limit;
+    pid->limMin    = -configs[i].limit;
+    pid->limMaxInt =  configs[i].limit / 2.0f;
+    pid->limMinInt = -configs[i].limit / 2.0f;
+    ControlMetrics_Init(&pid->metrics, configs[i].metrics, NULL, pid->signal->dt);
+
+    tasks[i].config = &configs[i];
+    tasks[i].result = result;
+    tasks[i].pid    = pid;
+    result->valid   = 1;
+
+    result->firstCore = nextCore % available;
+    result->cores     = configs[i].threads;
+    nextCore += configs[i].threads;
+  }
+
+  if (nextCore > available){
+    fprintf(stderr, "Experiments need %zu cores, only %zu are available, the core sets are shared\n", nextCore, available);
+  }
+
+  for (size_t i = 0; i < count; i++){
+    if (tasks[i].pid == NULL) { continue; }
+    if (pthread_create(&threads[i], NULL, ExperimentRunner_Thread, &tasks[i]) != 0){ perror("Failed to start experiment thread"); exit(EXIT_FAILURE); }
+    started[i] = 1;
+  }
+
+  for (size_t i = 0; i < count; i++){
+    if (started[i]) { pthread_join(threads[i], NULL); }
+    if (tasks[i].pid != NULL) { deletePid(tasks[i].pid); }
+  }
+
+  free(tasks);
+  free(threads);
+  free(started);
+}
+
+void ExperimentRunner_Report(FILE *file, const ExperimentResult *results, const size_t count){
+  assert(file != NULL && results != NULL && "file and results should not be NULL!");
+
+  fprintf(file, "%-24s %-9s %14s %14s %14s %10s\n", "experiment", "cores", "best fit", "evals/s", "steps/s", "seconds");
+  for (size_t i = 0; i < count; i++){
+    const ExperimentResult *result = &results[i];
+    if (!result->valid){
+      fprintf(file, "%-24s not run\n", result->name);
+      continue;
+    }
+
+    char cores[32];
+    snprintf(cores, sizeof(cores), "%zu-%zu", result->firstCore, result->firstCore + result->cores - 1);
+
+    const double seconds = result->seconds > 0.0 ? result->seconds : 1e-9;
+    fprintf(file, "%-24s %-9s %14g %14.0f %14.3g %10.3f\n", result->name, cores, result->bestFit,
+            (double)result->evaluations / seconds, result->plantSteps / seconds, result->seconds);
+  }
+}
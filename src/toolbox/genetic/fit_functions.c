@@ -2,54 +2,103 @@
 
 #include "genetic/population.h"
 #include "general/pid_controller.h"
+#include "general/pid_batch.h"
 #include "general/signal_designer.h"
 #include "neural/model_system.h"
 #include "neural/neural_network.h"
+#include "neural/closed_loop_kernel.h"
+#include "general/parallel.h"
+#include "general/systems_builder.h"
 
+#include <assert.h>
+#include <float.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 
 void pidFitFunction(struct Pop *population, float *fit, struct PID *pid){
-  int csv = 0;
-  FILE *trash;
-
-  for(int i=0; i<population->rows; i++){
-    // clear system memory before running
-    for(int j=0; j<pid->sizeDataSystem; j++){
-      pid->dataSystem[j] = 0.0;
-    }
+  // all individuals share the signal and the plant, so they are simulated together in the lane groups
+  PidBatch *batch = PidBatch_Create(pid, 0);
+  PidBatch_Evaluate(batch, population->pop, (size_t)population->rows, fit);
+  PidBatch_Destroy(batch);
+}
 
-    // first set the coeficients
-    pid->Kp   = population->pop[i][0];
-    pid->Ki   = population->pop[i][1];
-    pid->Kd   = population->pop[i][2];
-    pid->tauD = population->pop[i][3];
+// the context of the parallel nn evaluation with the fused kernel
+typedef struct NNKernelContext {
+  struct Pop *population;
+  float *fit;
+  const ClosedLoopLayout *layout;
+  const Signal *signal;
+  ClosedLoopState **states; // one state block per thread
+  ControlMetrics *metrics;  // one copy of the metrics per thread
+}NNKernelContext;
 
-    makeSimulationOfSignal(pid, trash, csv);
+static void nnKernelTask(const size_t index, const size_t thread, void *context){
+  NNKernelContext *data = context;
 
-    fit[i] = pid->fit;
-    
-  }
+  data->fit[index] = ClosedLoopKernel_Simulate(data->layout, data->states[thread], data->population->pop[index],
+                                               data->signal->signal, data->signal->length, &data->metrics[thread]);
 }
 
 void nnFitFunction(struct Pop *population, float *fit, struct SystemNN *systemNN){
-  FILE *trash;
+  // the fused kernel reads the weights from the rows, each thread has its own state block
+  const size_t threads = Parallel_GetThreadCount();
+  ClosedLoopLayout *layout = createClosedLoopLayout(systemNN);
 
-  for(int i=0; i<population->rows; i++){
-    // clear system memory before running
-    for(int j=0; j<systemNN->sizeDataSystem; j++){
-      systemNN->dataSystem[j] = 0.0;
-    }
+  ClosedLoopState **states = malloc(threads * sizeof(ClosedLoopState*));
+  ControlMetrics *metrics = malloc(threads * sizeof(ControlMetrics));
+  if(states == NULL || metrics == NULL){ perror("Failed to allocate kernel states"); exit(EXIT_FAILURE); }
 
-    // first set the NN wages
-    fillMatrixesNN(systemNN->neuralNetwork, population->pop[i]);
+  for(size_t t=0; t<threads; t++){
+    states[t]  = ClosedLoopKernel_CreateState(layout);
+    metrics[t] = systemNN->metrics;
+  }
 
-    // now model is simulated
-    makeSimulationOfSignalNN(systemNN, trash, 0);
+  NNKernelContext context = {population, fit, layout, systemNN->signal, states, metrics};
+  Parallel_For(population->rows, threads, nnKernelTask, &context);
 
-    fit[i] = systemNN->fit;
-    
+  for(size_t t=0; t<threads; t++){
+    ClosedLoopKernel_DestroyState(states[t]);
   }
+  free(states);
+  free(metrics);
+  ClosedLoopKernel_DestroyLayout(layout);
 }
 
+void pidScenarioFitFunction(struct Pop *population, float *fit, struct PID *pid, ScenarioSet *set){
+  evaluatePidScenarios(set, pid, population->pop, population->rows, fit);
+}
+
+void nnScenarioFitFunction(struct Pop *population, float *fit, struct SystemNN *systemNN, ScenarioSet *set){
+  assert(set != NULL && set->count > 0 && "scenario set should not be empty!");
+
+  // each scenario gets its own layout, the plant, its memory size and the gain are in the layout
+  ClosedLoopLayout **layouts = malloc(set->count * sizeof(ClosedLoopLayout*));
+  if(layouts == NULL){ perror("Failed to allocate scenario layouts"); exit(EXIT_FAILURE); }
+
+  Signal *signal = systemNN->signal;
+  float (*func_system)(float*) = systemNN->func_system;
+  const int sizeDataSystem = systemNN->sizeDataSystem;
+  const float plantGain = systemNN->plantGain;
+
+  for(int s=0; s<set->count; s++){
+    // the layout reads only the dt of the signal, the generated scenarios have the same dt as the system signal
+    systemNN->signal         = set->scenarios[s].signal != NULL ? set->scenarios[s].signal : signal;
+    systemNN->func_system    = set->scenarios[s].func_system;
+    systemNN->sizeDataSystem = set->scenarios[s].sizeDataSystem;
+    systemNN->plantGain      = set->scenarios[s].plantGain;
+    layouts[s] = createClosedLoopLayout(systemNN);
+  }
+
+  systemNN->signal         = signal;
+  systemNN->func_system    = func_system;
+  systemNN->sizeDataSystem = sizeDataSystem;
+  systemNN->plantGain      = plantGain;
+
+  evaluateKernelScenarios(set, layouts, &systemNN->metrics, population->pop, population->rows, fit);
+
+  for(int s=0; s<set->count; s++){
+    ClosedLoopKernel_DestroyLayout(layouts[s]);
+  }
+  free(layouts);
+}
@@ -0,0 +1,265 @@
+/**
+ * @file generation_engine.c
+ * @brief Double buffered GA generation engine public interface implementation.
+ *
+ * This file defines all implementations of the Generation Engine public interface
+ */
+
+#include "genetic/generation_engine.h"
+
+#include "genetic/crossover.h"
+#include "genetic/mutation.h"
+#include "general/sort.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//=============================================================================
+//
+//                     Generation Engine Utility Helper Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup GenerationEngine
+ * @brief Seed the stream of each row from the seed and the generation, so each row has the same numbers regardless of the order of the rows.
+ */
+static void GenerationEngine_SeedStreams(GenerationEngine *engine){
+  for (size_t i = 0; i < engine->rows; i++){
+    Random_Stream(&engine->streams[i], engine->seed, (uint64_t)engine->generation * engine->rows + i);
+  }
+}
+
+/*!
+ * @ingroup GenerationEngine
+ * @brief Copy the ranked best rows into the slice.
+ */
+static void GenerationEngine_Best(const GenerationEngine *engine, const GenerationSlice *slice, float **rows){
+  const size_t size = engine->genes * sizeof(float);
+
+  if (slice->repeatsCount == 0){
+    for (size_t i = 0; i < slice->rows; i++){ memcpy(rows[i], engine->current[engine->order[i]], size); }
+    return;
+  }
+
+  size_t row = 0;
+  for (size_t rank = 0; rank < slice->repeatsCount; rank++){
+    for (int copy = 0; copy < slice->repeats[rank]; copy++){ memcpy(rows[row++], engine->current[engine->order[rank]], size); }
+  }
+}
+
+/*!
+ * @ingroup GenerationEngine
+ * @brief Fill the slice with the winners of the two row tournaments.
+ */
+static void GenerationEngine_Tournament(const GenerationEngine *engine, const GenerationSlice *slice, float **rows, Random *streams){
+  for (size_t i = 0; i < slice->rows; i++){
+    const size_t j = Random_Bounded(&streams[i], (uint32_t)engine->rows);
+    const size_t k = Random_Bounded(&streams[i], (uint32_t)engine->rows);
+    memcpy(rows[i], engine->current[engine->fit[j] <= engine->fit[k] ? j : k], engine->genes * sizeof(float));
+  }
+}
+
+/*!
+ * @ingroup GenerationEngine
+ * @brief Fill the slice with the random rows between the bounds or around the best row.
+ */
+static void GenerationEngine_FillRandom(const GenerationEngine *engine, const GenerationSlice *slice, float **rows, Random *streams,
+                                        const float *center){
+  for (size_t i = 0; i < slice->rows; i++){
+    for (size_t g = 0; g < engine->genes; g++){
+      float low = engine->min[g];
+      float high = engine->max[g];
+      if (center != NULL){
+        if (center[g] - slice->radius > low)  { low  = center[g] - slice->radius; }
+        if (center[g] + slice->radius < high) { high = center[g] + slice->radius; }
+      }
+      rows[i][g] = Random_Uniform(&streams[i], low, high);
+    }
+  }
+}
+
+/*!
+ * @ingroup GenerationEngine
+ * @brief Cross each pair of the slice rows in place, each pair by the stream of its first row.
+ */
+static void GenerationEngine_Crossover(const GenerationEngine *engine, const GenerationSlice *slice, float **rows, Random *streams){
+  Crossover crossover = {.kind = slice->crossoverKind, .pointsCount = slice->pointsCount, .alpha = slice->alpha};
+  memcpy(crossover.points, slice->points, slice->pointsCount * sizeof(int));
+
+  for (size_t index = 0; index + 1 < slice->rows; index += 2){
+    Crossover_Pair(&crossover, &streams[index], rows[index], rows[index + 1], engine->genes, engine->min, engine->max);
+  }
+}
+
+/*!
+ * @ingroup GenerationEngine
+ * @brief Mutate the rows of the slice by the skip sampling, each row by its own stream.
+ */
+static void GenerationEngine_Mutate(const GenerationEngine *engine, const GenerationSlice *slice, float **rows, Random *streams){
+  const Mutation mutation = {.kind = slice->mutationKind, .chance = slice->mutation, .sigma = slice->sigma};
+  for (size_t i = 0; i < slice->rows; i++){
+    Mutation_Apply(&mutation, &streams[i], rows[i], engine->genes, engine->genes, engine->min, engine->max);
+  }
+}
+
+
+
+//=============================================================================
+//
+//                     Generation Engine Lifecycle Management Functions
+//
+//=============================================================================
+
+GenerationEngine* GenerationEngine_Create(const size_t genes, const float *min, const float *max,
+                                          const GenerationSlice *slices, const size_t sliceCount, const uint64_t seed){
+  assert(genes > 0 && "genes should be at least 1!");
+  assert(min != NULL && max != NULL && "bounds should not be NULL!");
+  assert(slices != NULL && sliceCount > 0 && sliceCount <= GENERATION_MAX_SLICES && "slices count is out of range!");
+
+  GenerationEngine *engine = NULL;
+  engine = malloc(sizeof(GenerationEngine));
+  if (engine == NULL){ perror("Failed to allocate Generation Engine"); exit(EXIT_FAILURE); }
+
+  engine->rows = 0;
+  for (size_t s = 0; s < sliceCount; s++){
+    const GenerationSlice *slice = &slices[s];
+    assert(slice->repeatsCount <= GENERATION_MAX_POINTS && slice->pointsCount <= GENERATION_MAX_POINTS && "slice points are out of range!");
+
+    size_t repeats = 0;
+    for (size_t r = 0; r < slice->repeatsCount; r++){ repeats += (size_t)slice->repeats[r]; }
+    assert((slice->repeatsCount == 0 || repeats == slice->rows) && "repeats should sum to the slice rows!");
+
+    for (size_t p = 0; p < slice->pointsCount; p++){
+      assert(slice->points[p] >= 0 && (size_t)slice->points[p] <= genes && "crossover point is out of the genes!");
+      assert((p == 0 || slice->points[p] >= slice->points[p - 1]) && "crossover points should be ascending!");
+    }
+    engine->rows += slice->rows;
+  }
+  assert(engine->rows > 0 && "population should have at least 1 row!");
+
+  engine->genes = genes;
+  engine->sliceCount = sliceCount;
+  memcpy(engine->slices, slices, sliceCount * sizeof(GenerationSlice));
+  engine->seed = seed;
+  engine->generation = 0;
+
+  engine->memory  = malloc(2 * engine->rows * genes * sizeof(float));
+  engine->current = malloc(engine->rows * sizeof(float*));
+  engine->next    = malloc(engine->rows * sizeof(float*));
+  engine->min     = malloc(genes * sizeof(float));
+  engine->max     = malloc(genes * sizeof(float));
+  engine->fit     = malloc(engine->rows * sizeof(float));
+  engine->order   = malloc(engine->rows * sizeof(int));
+  engine->streams = malloc(engine->rows * sizeof(Random));
+  if (engine->memory == NULL || engine->current == NULL || engine->next == NULL || engine->min == NULL ||
+      engine->max == NULL || engine->fit == NULL || engine->order == NULL || engine->streams == NULL){
+    perror("Failed to allocate Generation Engine populations");
+    exit(EXIT_FAILURE);
+  }
+
+  memcpy(engine->min, min, genes * sizeof(float));
+  memcpy(engine->max, max, genes * sizeof(float));
+
+  for (size_t i = 0; i < engine->rows; i++){
+    engine->current[i] = engine->memory + i * genes;
+    engine->next[i]    = engine->memory + (engine->rows + i) * genes;
+    engine->fit[i]     = 0.0f;
+    engine->order[i]   = (int)i;
+  }
+
+  const GenerationSlice all = {.source = GENERATION_RANDOM, .rows = engine->rows};
+  GenerationEngine_SeedStreams(engine);
+  GenerationEngine_FillRandom(engine, &all, engine->current, engine->streams, NULL);
+
+  return engine;
+}
+
+void GenerationEngine_Destroy(GenerationEngine *engine){
+  if (engine == NULL) { return; }
+
+  free(engine->memory);
+  free(engine->current);
+  free(engine->next);
+  free(engine->min);
+  free(engine->max);
+  free(engine->fit);
+  free(engine->order);
+  free(engine->streams);
+  free(engine);
+}
+
+
+
+//=============================================================================
+//
+//                     Generation Engine Manipulation Functions
+//
+//=============================================================================
+
+void GenerationEngine_Step(GenerationEngine *engine){
+  assert(engine != NULL && "engine should not be NULL!");
+
+  // the best slices need only the few first ranks, the close random needs only the best row
+  size_t ranks = 0;
+  for (size_t s = 0; s < engine->sliceCount; s++){
+    const GenerationSlice *slice = &engine->slices[s];
+    if (slice->source != GENERATION_BEST) { continue; }
+
+    const size_t needed = slice->repeatsCount > 0 ? slice->repeatsCount : slice->rows;
+    if (needed > ranks) { ranks = needed; }
+  }
+  const int ranked = ranks > 0;
+  if (ranked){
+    for (size_t i = 0; i < engine->rows; i++){ engine->order[i] = (int)i; }
+    selectTopK(engine->fit, engine->order, (int)engine->rows, (int)ranks);
+  }
+  const float *best = engine->current[ranked ? (size_t)engine->order[0] : GenerationEngine_GetBest(engine)];
+
+  // each slice writes only into its own rows of the next population, each row with its own stream
+  engine->generation++;
+  GenerationEngine_SeedStreams(engine);
+
+  size_t offset = 0;
+  for (size_t s = 0; s < engine->sliceCount; s++){
+    const GenerationSlice *slice = &engine->slices[s];
+    float **rows = engine->next + offset;
+    Random *streams = engine->streams + offset;
+
+    switch (slice->source){
+      case GENERATION_BEST:         GenerationEngine_Best(engine, slice, rows); break;
+      case GENERATION_TOURNAMENT:   GenerationEngine_Tournament(engine, slice, rows, streams); break;
+      case GENERATION_RANDOM:       GenerationEngine_FillRandom(engine, slice, rows, streams, NULL); break;
+      case GENERATION_CLOSE_RANDOM: GenerationEngine_FillRandom(engine, slice, rows, streams, best); break;
+    }
+
+    if (slice->pointsCount > 0 || slice->crossoverKind != CROSSOVER_POINTS) { GenerationEngine_Crossover(engine, slice, rows, streams); }
+    if (slice->mutation > 0.0f) { GenerationEngine_Mutate(engine, slice, rows, streams); }
+
+    offset += slice->rows;
+  }
+
+  float **swap = engine->current;
+  engine->current = engine->next;
+  engine->next = swap;
+}
+
+
+
+//=============================================================================
+//
+//                     Generation Engine Query Functions
+//
+//=============================================================================
+
+size_t GenerationEngine_GetBest(const GenerationEngine *engine){
+  assert(engine != NULL && "engine should not be NULL!");
+
+  size_t best = 0;
+  for (size_t i = 1; i < engine->rows; i++){
+    if (engine->fit[i] < engine->fit[best]) { best = i; }
+  }
+  return best;
+}
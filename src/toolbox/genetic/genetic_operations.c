@@ -3,12 +3,14 @@
 #include "genetic/population.h"
 #include "general/sort.h"
 #include "general/general_math.h"
+#include "genetic/crossover.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 #include <string.h>
 #include <assert.h>
+#include <math.h>
 
 // this code is a C implementation of the code created by prof. Ivan Sekaj STU 2002 using Matlab
 
@@ -71,7 +73,7 @@ Population* selectRandom(const Population *population, const int rows){
   Population *newPopulation = createFilledPopulationWithSizeMatrix(population->minMaxMatrix, rows, population->populationMatrix->cols);
 
   for(int i=0; i<rows; i++){
-    const int index  = rand() % population->populationMatrix->rows;
+    const int index  = createRandomIndex(population->populationMatrix->rows);
     memcpy(newPopulation->populationMatrix->matrix[i], population->populationMatrix->matrix[index], population->populationMatrix->cols * sizeof(float));
   }
 
@@ -92,8 +94,8 @@ Population* selectTournament(const Population *population, const float* fit, con
   Population *newPopulation = createFilledPopulationWithSizeMatrix(population->minMaxMatrix, rows, population->populationMatrix->cols);
   
   for(int i=0; i<rows; i++){
-    const int j = rand() % population->populationMatrix->rows;
-    const int k = rand() % population->populationMatrix->rows;
+    const int j = createRandomIndex(population->populationMatrix->rows);
+    const int k = createRandomIndex(population->populationMatrix->rows);
 
     if(j == k){
       memcpy(newPopulation->populationMatrix->matrix[i], population->populationMatrix->matrix[j], population->populationMatrix->cols * sizeof(float));
@@ -109,63 +111,44 @@ Population* selectTournament(const Population *population, const float* fit, con
 
 void crossover(const Population *population, int *selects, int selectsLength){
   /*
-  * const int start - index of the start of current frame
-  * const int end - index of the end of current frame
-  * float *additionalSaving - array for the temporary storing of the frame
-  * int globalIndex - index for the frame going through additionalSaving
+  * the segments are swapped in place by Crossover_Segments, the odd number of selects is closed by the cols
   */
 
   assert(population != NULL); // check if the population exists
   assert(selectsLength > 0); // check if there are frames
 
-  // add one more index in case the number is odd
-  if(selectsLength % 2 != 0){
-    selects = (int *)realloc(selects, (selectsLength + 1) * sizeof(int));
-    selects[selectsLength] = population->populationMatrix->cols;
-    selectsLength++;
-  }
-
   for(int index = 0; index < population->populationMatrix->rows - 1; index += 2){
-    
-    for(int i = 0; i<selectsLength; i+=2){
-      const int start = selects[i];
-      const int end   = selects[i + 1];
-
-      float *additionalSaving = malloc((end - start) * sizeof(float));
-      int globalIndex = 0;
-
-      for(int x = start; x<end; x++){
-        additionalSaving[globalIndex]  = population->populationMatrix->matrix[index][x];
-        globalIndex++;
-      }
-      globalIndex = 0;
-
-      for(int x = start; x<end; x++){
-        population->populationMatrix->matrix[index][x]   = population->populationMatrix->matrix[index+1][x];
-        population->populationMatrix->matrix[index+1][x] = additionalSaving[globalIndex];
-        globalIndex++;
-      }
-      free(additionalSaving);
-    }
+    Crossover_Segments(population->populationMatrix->matrix[index], population->populationMatrix->matrix[index+1], selects, selectsLength, population->populationMatrix->cols);
   }
   free(selects);
 }
 
 void mutx(const Population *population, const float chance){
   /*
-  * float randomFloat - the value which is a modified chromosome
+  * int genes - number of genes of the whole population, the rows are walked as one flat array
+  * double scale - the scale of the log of the uniform value to the geometric gap, 1 / log(1 - chance)
+  * int index - the flat index of the next mutated gene
   */
   assert(population != NULL); // check if the population exists
   assert(chance > 0); // check if the chance of mutation exists
 
-  for(int x=0; x<population->populationMatrix->rows; x++){
-    for(int y=0; y<population->populationMatrix->cols; y++){
-      float randomFloat = (float)rand() / RAND_MAX;
-      if(randomFloat < chance){
-        randomFloat = createRandomFloat(population->minMaxMatrix->matrix[1][y], population->minMaxMatrix->matrix[0][y]);
-        population->populationMatrix->matrix[x][y] = randomFloat;
-      }
+  const int cols = population->populationMatrix->cols;
+  const int genes = population->populationMatrix->rows * cols;
+  const double scale = chance < 1.0f ? 1.0 / log1p(-(double)chance) : 0.0;
+
+  // the gap to the next mutated gene is drawn instead of the random value for every gene
+  for(long index = 0; ; index++){
+    if(chance < 1.0f){
+      const double unit = 1.0 - (double)createRandomFloat(0.0f, 1.0f);
+      index += (long)(log(unit) * scale);
     }
+    if(index >= genes){
+      break;
+    }
+
+    const int x = (int)(index / cols);
+    const int y = (int)(index % cols);
+    population->populationMatrix->matrix[x][y] = createRandomFloat(population->minMaxMatrix->matrix[1][y], population->minMaxMatrix->matrix[0][y]);
   }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,229 @@
+/**
+ * @file island_model.c
+ * @brief Island model GA across threads public interface implementation.
+ *
+ * This file defines all implementations of the Island Model public interface
+ */
+
+#include "genetic/island_model.h"
+
+#include "general/parallel.h"
+#include "general/random.h"
+#include "general/sort.h"
+
+#include <assert.h>
+#include <float.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @struct IslandSlot
+ * @brief The mailbox slot of one sender and one receiver, the flag is aligned to its own cache line.
+ * @ingroup IslandModel
+ */
+typedef struct IslandSlot {
+  _Alignas(64) atomic_int full; // 0: written only by the sender, 1: read only by the receiver
+  float *genomes;               // migrants * genes floats
+  float *fit;                   // the fit of each migrant
+} IslandSlot;
+
+/**
+ * @struct Island
+ * @brief The state of one island, touched only by its own thread.
+ * @ingroup IslandModel
+ */
+typedef struct Island {
+  GenerationEngine *engine;
+  Random random; // the stream of the random topology
+  int *order;    // the ranking of the best rows to be sent
+
+  float bestFit;
+  float *best;
+  size_t sent;
+  size_t dropped;
+} Island;
+
+/**
+ * @struct IslandRun
+ * @brief The state shared by the island threads.
+ * @ingroup IslandModel
+ */
+typedef struct IslandRun {
+  const IslandConfig *config;
+  IslandFit fit;
+  void *context;
+
+  Island *islands;
+  IslandSlot *slots; // the slot of the sender s in the mailbox of the receiver r is r * islands + s
+} IslandRun;
+
+//=============================================================================
+//
+//                     Island Model Utility Helper Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup IslandModel
+ * @brief Put the copies of the best rows into the mailbox of the next island, the full slot drops the migration.
+ */
+static void IslandModel_Send(IslandRun *run, const size_t index){
+  const IslandConfig *config = run->config;
+  Island *island = &run->islands[index];
+  GenerationEngine *engine = island->engine;
+
+  size_t target = (index + 1) % config->islands;
+  if (config->topology == ISLAND_RANDOM){
+    target = Random_Bounded(&island->random, (uint32_t)config->islands - 1);
+    if (target >= index) { target++; }
+  }
+
+  IslandSlot *slot = &run->slots[target * config->islands + index];
+  if (atomic_load_explicit(&slot->full, memory_order_acquire)){
+    island->dropped++;
+    return;
+  }
+
+  for (size_t i = 0; i < engine->rows; i++){ island->order[i] = (int)i; }
+  selectTopK(engine->fit, island->order, (int)engine->rows, (int)config->migrants);
+  for (size_t m = 0; m < config->migrants; m++){
+    memcpy(slot->genomes + m * config->genes, engine->current[island->order[m]], config->genes * sizeof(float));
+    slot->fit[m] = engine->fit[island->order[m]];
+  }
+
+  atomic_store_explicit(&slot->full, 1, memory_order_release);
+  island->sent++;
+}
+
+/*!
+ * @ingroup IslandModel
+ * @brief Replace the worst rows by the better migrants of the full slots of the mailbox and empty the slots.
+ */
+static void IslandModel_Receive(IslandRun *run, const size_t index){
+  const IslandConfig *config = run->config;
+  GenerationEngine *engine = run->islands[index].engine;
+
+  for (size_t sender = 0; sender < config->islands; sender++){
+    IslandSlot *slot = &run->slots[index * config->islands + sender];
+    if (!atomic_load_explicit(&slot->full, memory_order_acquire)) { continue; }
+
+    for (size_t m = 0; m < config->migrants; m++){
+      size_t worst = 0;
+      for (size_t i = 1; i < engine->rows; i++){
+        if (engine->fit[i] > engine->fit[worst]) { worst = i; }
+      }
+      if (slot->fit[m] >= engine->fit[worst]) { continue; }
+
+      memcpy(engine->current[worst], slot->genomes + m * config->genes, config->genes * sizeof(float));
+      engine->fit[worst] = slot->fit[m];
+    }
+
+    atomic_store_explicit(&slot->full, 0, memory_order_release);
+  }
+}
+
+/*!
+ * @ingroup IslandModel
+ * @brief Run all the generations of one island.
+ */
+static void IslandModel_Island(const size_t index, const size_t thread, void *context){
+  (void)thread;
+  IslandRun *run = context;
+  const IslandConfig *config = run->config;
+  Island *island = &run->islands[index];
+  GenerationEngine *engine = island->engine;
+
+  for (size_t generation = 0; generation < config->generations; generation++){
+    run->fit(engine->current, engine->rows, engine->fit, index, run->context);
+
+    const size_t best = GenerationEngine_GetBest(engine);
+    if (engine->fit[best] < island->bestFit){
+      island->bestFit = engine->fit[best];
+      memcpy(island->best, engine->current[best], config->genes * sizeof(float));
+    }
+
+    // the last generation is not stepped, so its migration would be lost
+    if (generation + 1 == config->generations) { break; }
+
+    if (config->islands > 1 && config->migrants > 0 && config->interval > 0 && (generation + 1) % config->interval == 0){
+      IslandModel_Send(run, index);
+    }
+    if (config->islands > 1) { IslandModel_Receive(run, index); }
+
+    GenerationEngine_Step(engine);
+  }
+}
+
+
+
+//=============================================================================
+//
+//                     Island Model Manipulation Functions
+//
+//=============================================================================
+
+void IslandModel_Run(const IslandConfig *config, IslandFit fit, void *context, float *best, IslandResult *result){
+  assert(config != NULL && fit != NULL && best != NULL && result != NULL && "config, fit, best and result should not be NULL!");
+  assert(config->islands > 0 && config->genes > 0 && "islands and genes should be at least 1!");
+
+  IslandRun run;
+  run.config = config;
+  run.fit = fit;
+  run.context = context;
+  run.islands = calloc(config->islands, sizeof(Island));
+  run.slots = aligned_alloc(_Alignof(IslandSlot), config->islands * config->islands * sizeof(IslandSlot));
+  if (run.islands == NULL || run.slots == NULL){ perror("Failed to allocate Island Model islands"); exit(EXIT_FAILURE); }
+
+  for (size_t i = 0; i < config->islands; i++){
+    Island *island = &run.islands[i];
+
+    // the stream of the island gives both the engine seed and the topology numbers
+    Random_Stream(&island->random, config->seed, i);
+    island->engine = GenerationEngine_Create(config->genes, config->min, config->max, config->slices, config->sliceCount,
+                                             Random_Next(&island->random));
+    assert(config->migrants <= island->engine->rows && "migrants should not be more than the island rows!");
+
+    island->order = malloc(island->engine->rows * sizeof(int));
+    island->best = malloc(config->genes * sizeof(float));
+    if (island->order == NULL || island->best == NULL){ perror("Failed to allocate Island Model island"); exit(EXIT_FAILURE); }
+    island->bestFit = FLT_MAX;
+  }
+
+  for (size_t s = 0; s < config->islands * config->islands; s++){
+    IslandSlot *slot = &run.slots[s];
+    atomic_init(&slot->full, 0);
+    slot->genomes = malloc((config->migrants * config->genes + 1) * sizeof(float));
+    slot->fit = malloc((config->migrants + 1) * sizeof(float));
+    if (slot->genomes == NULL || slot->fit == NULL){ perror("Failed to allocate Island Model mailbox"); exit(EXIT_FAILURE); }
+  }
+
+  // one thread per island, the islands never wait for each other
+  Parallel_For(config->islands, config->islands, IslandModel_Island, &run);
+
+  memset(result, 0, sizeof(IslandResult));
+  result->bestFit = FLT_MAX;
+  for (size_t i = 0; i < config->islands; i++){
+    const Island *island = &run.islands[i];
+    if (island->bestFit < result->bestFit){
+      result->bestFit = island->bestFit;
+      result->island = i;
+      memcpy(best, island->best, config->genes * sizeof(float));
+    }
+    result->evaluations += island->engine->rows * config->generations;
+    result->sent += island->sent;
+    result->dropped += island->dropped;
+
+    GenerationEngine_Destroy(island->engine);
+    free(island->order);
+    free(island->best);
+  }
+
+  for (size_t s = 0; s < config->islands * config->islands; s++){
+    free(run.slots[s].genomes);
+    free(run.slots[s].fit);
+  }
+  free(run.slots);
+  free(run.islands);
+}
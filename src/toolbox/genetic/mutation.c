@@ -0,0 +1,82 @@
+/**
+ * @file mutation.c
+ * @brief Skip sampling mutation of the flat genome buffers public interface implementation.
+ *
+ * This file defines all implementations of the Mutation public interface
+ */
+
+#include "genetic/mutation.h"
+
+#include <assert.h>
+#include <math.h>
+
+//=============================================================================
+//
+//                     Mutation Utility Helper Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup Mutation
+ * @brief The number of the genes skipped before the next mutated one, the geometric distribution by the inversion.
+ * @details The uniform number has 53 bits and is in (0, 1], so the log is finite and the long gaps of the small chance are exact.
+ */
+static size_t Mutation_Gap(Random *random, const double scale){
+  const double unit = (double)((Random_Next(random) >> 11) + 1) * (1.0 / 9007199254740992.0);
+  const double gap = log(unit) * scale;
+  return gap < (double)SIZE_MAX ? (size_t)gap : SIZE_MAX;
+}
+
+/*!
+ * @ingroup Mutation
+ * @brief The new value of the mutated gene.
+ */
+static float Mutation_Value(const Mutation *mutation, Random *random, const float gene, const float min, const float max){
+  if (mutation->kind == MUTATION_UNIFORM) { return Random_Uniform(random, min, max); }
+
+  const float value = gene + mutation->sigma * (max - min) * Random_Normal(random);
+  if (value < min) { return min; }
+  if (value > max) { return max; }
+  return value;
+}
+
+
+
+//=============================================================================
+//
+//                     Mutation Manipulation Functions
+//
+//=============================================================================
+
+size_t Mutation_Apply(const Mutation *mutation, Random *random, float *genes, const size_t count, const size_t width,
+                      const float *min, const float *max){
+  assert(mutation != NULL && random != NULL && "mutation and random should not be NULL!");
+  assert((count == 0 || (genes != NULL && min != NULL && max != NULL && width > 0)) && "genes and bounds should not be NULL!");
+
+  if (mutation->chance <= 0.0f || count == 0) { return 0; }
+
+  // the sure mutation of each gene has no gaps
+  if (mutation->chance >= 1.0f){
+    for (size_t i = 0; i < count; i++){
+      const size_t g = i % width;
+      genes[i] = Mutation_Value(mutation, random, genes[i], min[g], max[g]);
+    }
+    return count;
+  }
+
+  // log(u) / log(1 - p) is the number of the genes which are not mutated before the next mutation
+  const double scale = 1.0 / log1p(-(double)mutation->chance);
+  size_t mutations = 0;
+
+  size_t i = Mutation_Gap(random, scale);
+  while (i < count){
+    const size_t g = i % width;
+    genes[i] = Mutation_Value(mutation, random, genes[i], min[g], max[g]);
+    mutations++;
+
+    const size_t gap = Mutation_Gap(random, scale);
+    if (gap >= count - i) { break; }
+    i += gap + 1;
+  }
+  return mutations;
+}
@@ -0,0 +1,326 @@
+/**
+ * @file scenario_set.c
+ * @brief Evaluation of the controllers over the set of scenarios public interface implementation.
+ *
+ * This file defines all implementations of the Scenario Set public interface
+ */
+
+#include "genetic/scenario_set.h"
+
+#include "general/parallel.h"
+#include "general/systems_builder.h"
+
+#include <assert.h>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+ScenarioSet* createScenarioSet(ScenarioReduction reduction){
+  ScenarioSet *set = malloc(sizeof(ScenarioSet));
+  if(set == NULL){ perror("Failed to allocate Scenario Set"); exit(EXIT_FAILURE); }
+
+  set->scenarios = NULL;
+  set->count     = 0;
+  set->capacity  = 0;
+
+  set->reduction = reduction;
+  set->threads   = 0;
+
+  set->fits             = NULL;
+  set->fitsSize         = 0;
+  set->workerMemory     = NULL;
+  set->workerMemorySize = 0;
+
+  set->kernelStates       = NULL;
+  set->kernelStatesCount  = 0;
+  set->kernelStateSize    = 0;
+  set->kernelMetrics      = NULL;
+  set->kernelMetricsCount = 0;
+
+  return set;
+}
+
+void deleteScenarioSet(ScenarioSet *set){
+  if(set == NULL){ return; }
+
+  free(set->scenarios);
+  free(set->fits);
+  free(set->workerMemory);
+
+  for(int t=0; t<set->kernelStatesCount; t++){
+    ClosedLoopKernel_DestroyState(set->kernelStates[t]);
+  }
+  free(set->kernelStates);
+  free(set->kernelMetrics);
+  free(set);
+}
+
+// the sampling time and the length of the scenario reference
+static float scenarioDt(const Scenario *scenario){
+  return scenario->signal != NULL ? scenario->signal->dt : scenario->generator.dt;
+}
+
+static int scenarioLength(const Scenario *scenario){
+  return scenario->signal != NULL ? scenario->signal->length : (int)scenario->generator.length;
+}
+
+static Scenario* appendScenario(ScenarioSet *set, float (*func_system)(float*), int sizeDataSystem, float plantGain, float weight){
+  if(set->count == set->capacity){
+    const int capacity = set->capacity == 0 ? 4 : set->capacity * 2;
+    Scenario *scenarios = realloc(set->scenarios, capacity * sizeof(Scenario));
+    if(scenarios == NULL){ perror("Failed to allocate scenarios"); exit(EXIT_FAILURE); }
+
+    set->scenarios = scenarios;
+    set->capacity  = capacity;
+  }
+
+  Scenario *scenario = &set->scenarios[set->count];
+  scenario->signal         = NULL;
+  scenario->func_system    = func_system;
+  scenario->sizeDataSystem = sizeDataSystem;
+  scenario->plantGain      = plantGain;
+  scenario->weight         = weight;
+  set->count++;
+  return scenario;
+}
+
+void addScenario(ScenarioSet *set, Signal *signal, float (*func_system)(float*), int sizeDataSystem, float plantGain, float weight){
+  assert(set != NULL && "scenario set should not be NULL!");
+  assert(signal != NULL && func_system != NULL && "scenario signal and system should not be NULL!");
+  assert((set->count == 0 || scenarioDt(&set->scenarios[0]) == signal->dt) && "all scenarios should have the same dt!");
+
+  Scenario *scenario = appendScenario(set, func_system, sizeDataSystem, plantGain, weight);
+  scenario->signal = signal;
+
+  // the discretization is made here, the parallel runs only read the plant
+  prepareSystem(func_system, signal->dt);
+}
+
+void addGeneratedScenario(ScenarioSet *set, const SignalGenerator *generator, float (*func_system)(float*),
+                          int sizeDataSystem, float plantGain, float weight){
+  assert(set != NULL && "scenario set should not be NULL!");
+  assert(generator != NULL && func_system != NULL && "scenario generator and system should not be NULL!");
+  assert((set->count == 0 || scenarioDt(&set->scenarios[0]) == generator->dt) && "all scenarios should have the same dt!");
+
+  // the generator has no pointers, the set keeps its own copy and each task rewinds a copy of it
+  Scenario *scenario = appendScenario(set, func_system, sizeDataSystem, plantGain, weight);
+  scenario->generator = *generator;
+
+  prepareSystem(func_system, generator->dt);
+}
+
+float reduceScenarioFits(const ScenarioSet *set, const float *fits){
+  float result = 0.0;
+
+  for(int s=0; s<set->count; s++){
+    // the failed run (FLT_MAX) stays failed in all the reductions
+    if(fits[s] == FLT_MAX){ return FLT_MAX; }
+
+    switch(set->reduction){
+      case SCENARIO_SUM:      result += fits[s]; break;
+      case SCENARIO_MAX:      if(fits[s] > result){ result = fits[s]; } break;
+      case SCENARIO_WEIGHTED: result += set->scenarios[s].weight * fits[s]; break;
+    }
+  }
+  return result;
+}
+
+// the longest reference signal of the set, the worker output should fit it
+static int scenarioMaxLength(const ScenarioSet *set){
+  int length = 0;
+  for(int s=0; s<set->count; s++){
+    if(scenarioLength(&set->scenarios[s]) > length){ length = scenarioLength(&set->scenarios[s]); }
+  }
+  return length;
+}
+
+// the size of the memory needed by one worker: the longest output and the biggest plant memory
+static int scenarioWorkerStride(const ScenarioSet *set){
+  int data = 0;
+  for(int s=0; s<set->count; s++){
+    if(set->scenarios[s].sizeDataSystem > data){ data = set->scenarios[s].sizeDataSystem; }
+  }
+  return scenarioMaxLength(set) + data;
+}
+
+// grow the shared buffers only when the population or the scenarios get bigger
+static void reserveScenarioBuffers(ScenarioSet *set, int individuals, int workers){
+  const int fitsSize = individuals * set->count;
+  if(fitsSize > set->fitsSize){
+    free(set->fits);
+    set->fits = malloc(fitsSize * sizeof(float));
+    if(set->fits == NULL){ perror("Failed to allocate scenario fits"); exit(EXIT_FAILURE); }
+    set->fitsSize = fitsSize;
+  }
+
+  const int memorySize = workers * scenarioWorkerStride(set);
+  if(memorySize > set->workerMemorySize){
+    free(set->workerMemory);
+    set->workerMemory = malloc(memorySize * sizeof(float));
+    if(set->workerMemory == NULL){ perror("Failed to allocate scenario worker memory"); exit(EXIT_FAILURE); }
+    set->workerMemorySize = memorySize;
+  }
+}
+
+// the context of the parallel pid evaluation
+typedef struct PidScenarioContext {
+  float **rows; // the genomes [Kp, Ki, Kd, tauD]
+  ScenarioSet *set;
+  PID *workers; // one copy of the pid for each thread
+}PidScenarioContext;
+
+// one task is one individual on one scenario
+static void pidScenarioTask(const size_t index, const size_t thread, void *context){
+  PidScenarioContext *data = context;
+  ScenarioSet *set = data->set;
+
+  const int individual = (int)index / set->count;
+  const Scenario *scenario = &set->scenarios[index % set->count];
+
+  PID *worker = &data->workers[thread];
+  worker->Kp   = data->rows[individual][0];
+  worker->Ki   = data->rows[individual][1];
+  worker->Kd   = data->rows[individual][2];
+  worker->tauD = data->rows[individual][3];
+
+  worker->signal         = scenario->signal;
+  worker->output->length = scenario->signal->length;
+  worker->func_system    = scenario->func_system;
+  worker->sizeDataSystem = scenario->sizeDataSystem;
+  worker->plantGain      = scenario->plantGain;
+
+  makeSimulationOfSignal(worker, NULL, 0);
+
+  set->fits[index] = worker->fit;
+}
+
+void evaluatePidScenarios(ScenarioSet *set, PID *pid, float **rows, const int individuals, float *fit){
+  assert(set != NULL && set->count > 0 && "scenario set should not be empty!");
+  for(int s=0; s<set->count; s++){
+    assert(set->scenarios[s].signal != NULL && "the pid needs the signal array, the generated scenarios are kernel only!");
+  }
+
+  const size_t tasks = (size_t)individuals * set->count;
+  size_t threads = set->threads > 0 ? (size_t)set->threads : Parallel_GetThreadCount();
+  if(threads > tasks){ threads = tasks; }
+
+  reserveScenarioBuffers(set, individuals, (int)threads);
+
+  // each worker is the copy of the pid limits with own output and plant memory from the shared buffer
+  const int stride = scenarioWorkerStride(set);
+  const int length = scenarioMaxLength(set);
+  PID *workers = malloc(threads * sizeof(PID));
+  Signal *outputs = malloc(threads * sizeof(Signal));
+  if(workers == NULL || outputs == NULL){ perror("Failed to allocate scenario workers"); exit(EXIT_FAILURE); }
+
+  for(size_t t=0; t<threads; t++){
+    workers[t] = *pid;
+    workers[t].trace = NULL;
+
+    outputs[t].signal = set->workerMemory + t * stride;
+    outputs[t].dt     = set->scenarios[0].signal->dt;
+    workers[t].output = &outputs[t];
+    workers[t].dataSystem = outputs[t].signal + length;
+  }
+
+  PidScenarioContext context = {rows, set, workers};
+  Parallel_For(tasks, threads, pidScenarioTask, &context);
+
+  for(int i=0; i<individuals; i++){
+    fit[i] = reduceScenarioFits(set, set->fits + i * set->count);
+  }
+
+  free(workers);
+  free(outputs);
+}
+
+// grow the kernel states only when there are more threads or the biggest layout needs the bigger state
+static void reserveKernelStates(ScenarioSet *set, const ClosedLoopLayout *biggest, int workers, int useMetrics){
+  if(workers > set->kernelStatesCount || biggest->stateSize > set->kernelStateSize){
+    for(int t=0; t<set->kernelStatesCount; t++){
+      ClosedLoopKernel_DestroyState(set->kernelStates[t]);
+    }
+    free(set->kernelStates);
+
+    const int count = workers > set->kernelStatesCount ? workers : set->kernelStatesCount;
+    set->kernelStates = malloc(count * sizeof(ClosedLoopState*));
+    if(set->kernelStates == NULL){ perror("Failed to allocate kernel states"); exit(EXIT_FAILURE); }
+
+    for(int t=0; t<count; t++){
+      set->kernelStates[t] = ClosedLoopKernel_CreateState(biggest);
+    }
+    set->kernelStatesCount = count;
+    set->kernelStateSize   = biggest->stateSize;
+  }
+
+  if(useMetrics && workers > set->kernelMetricsCount){
+    free(set->kernelMetrics);
+    set->kernelMetrics = malloc(workers * sizeof(ControlMetrics));
+    if(set->kernelMetrics == NULL){ perror("Failed to allocate kernel metrics"); exit(EXIT_FAILURE); }
+    set->kernelMetricsCount = workers;
+  }
+}
+
+// the context of the parallel evaluation of the kernel scenarios
+typedef struct KernelScenarioContext {
+  float **rows;
+  ScenarioSet *set;
+  ClosedLoopLayout *const *layouts; // one layout per scenario
+  ClosedLoopState **states;         // one state block per thread, big enough for all the layouts
+  ControlMetrics *metrics;          // one copy of the metrics per thread
+}KernelScenarioContext;
+
+// one task is one individual on one scenario
+static void kernelScenarioTask(const size_t index, const size_t thread, void *context){
+  KernelScenarioContext *data = context;
+  ScenarioSet *set = data->set;
+
+  const int individual = (int)index / set->count;
+  const int s = (int)index % set->count;
+
+  const Scenario *scenario = &set->scenarios[s];
+  ControlMetrics *metrics = data->metrics != NULL ? &data->metrics[thread] : NULL;
+
+  if(scenario->signal != NULL){
+    set->fits[index] = ClosedLoopKernel_Simulate(data->layouts[s], data->states[thread], data->rows[individual],
+                                                 scenario->signal->signal, scenario->signal->length, metrics);
+  } else {
+    // the copy keeps the position of this task, the shared generator of the scenario is only read
+    SignalGenerator generator = scenario->generator;
+    set->fits[index] = ClosedLoopKernel_SimulateStream(data->layouts[s], data->states[thread], data->rows[individual],
+                                                       &generator, metrics);
+  }
+}
+
+void evaluateKernelScenarios(ScenarioSet *set, ClosedLoopLayout *const *layouts, const ControlMetrics *metrics,
+                             float **rows, const int individuals, float *fit){
+  assert(set != NULL && set->count > 0 && "scenario set should not be empty!");
+  assert(layouts != NULL && "scenario layouts should not be NULL!");
+
+  const size_t tasks = (size_t)individuals * set->count;
+  size_t threads = set->threads > 0 ? (size_t)set->threads : Parallel_GetThreadCount();
+  if(threads > tasks){ threads = tasks; }
+
+  reserveScenarioBuffers(set, individuals, 0);
+
+  // the plants of the scenarios differ in the memory size, so the state of each thread fits the biggest layout
+  const ClosedLoopLayout *biggest = layouts[0];
+  for(int s=1; s<set->count; s++){
+    if(layouts[s]->stateSize > biggest->stateSize){ biggest = layouts[s]; }
+  }
+
+  reserveKernelStates(set, biggest, (int)threads, metrics != NULL);
+
+  // the metrics keep the running sums, so each thread gets its own copy of the current set up
+  ControlMetrics *copies = metrics != NULL ? set->kernelMetrics : NULL;
+  for(size_t t=0; copies != NULL && t<threads; t++){
+    copies[t] = *metrics;
+  }
+
+  KernelScenarioContext context = {rows, set, layouts, set->kernelStates, copies};
+  Parallel_For(tasks, threads, kernelScenarioTask, &context);
+
+  for(int i=0; i<individuals; i++){
+    fit[i] = reduceScenarioFits(set, set->fits + i * set->count);
+  }
+}
@@ -0,0 +1,185 @@
+/**
+ * @file seed_population.c
+ * @brief Seed compressed population public interface implementation.
+ *
+ * This file defines all implementations of the Seed Population public interface
+ */
+
+#include "genetic/seed_population.h"
+
+#include "general/sort.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*!
+ * @ingroup SeedPopulation
+ * @brief The size of the stack scratch of the noise, the weights of any size are perturbed by the chunks of it.
+ */
+#define SEED_POPULATION_CHUNK 64
+
+
+
+//=============================================================================
+//
+//                     Seed Population Lifecycle Management Functions
+//
+//=============================================================================
+
+SeedPopulation* SeedPopulation_Create(const size_t rows, const size_t genes, const size_t generations, const float initial,
+                                      const float sigma, const size_t truncation, const size_t elite, const uint64_t seed){
+  assert(rows > 0 && genes > 0 && "rows and genes should be at least 1!");
+  assert(truncation > 0 && truncation <= rows && "truncation should be between 1 and rows!");
+  assert(elite <= rows && "elite should not be more than rows!");
+
+  SeedPopulation *population = NULL;
+  population = malloc(sizeof(SeedPopulation));
+  if (population == NULL){ perror("Failed to allocate Seed Population"); exit(EXIT_FAILURE); }
+
+  population->rows = rows;
+  population->genes = genes;
+  population->capacity = generations + 1;
+  population->elite = elite;
+  population->truncation = truncation;
+  population->initial = initial;
+  population->sigma = sigma;
+  population->generation = 0;
+  Random_Seed(&population->random, seed);
+
+  population->memory      = malloc(2 * rows * population->capacity * sizeof(SeedStep));
+  population->lengths     = malloc(rows * sizeof(size_t));
+  population->nextLengths = malloc(rows * sizeof(size_t));
+  population->fit         = malloc(rows * sizeof(float));
+  population->order       = malloc(rows * sizeof(int));
+  population->parents     = malloc(rows * sizeof(int));
+  if (population->memory == NULL || population->lengths == NULL || population->nextLengths == NULL ||
+      population->fit == NULL || population->order == NULL || population->parents == NULL){
+    perror("Failed to allocate Seed Population steps");
+    exit(EXIT_FAILURE);
+  }
+
+  population->current = population->memory;
+  population->next = population->memory + rows * population->capacity;
+
+  for (size_t i = 0; i < rows; i++){
+    const SeedStep first = {.seed = Random_Next(&population->random), .scale = initial};
+    population->current[i * population->capacity] = first;
+    population->lengths[i] = 1;
+    population->fit[i]     = 0.0f;
+    population->order[i]   = (int)i;
+    population->parents[i] = (int)i;
+  }
+
+  return population;
+}
+
+void SeedPopulation_Destroy(SeedPopulation *population){
+  if (population == NULL) { return; }
+
+  free(population->memory);
+  free(population->lengths);
+  free(population->nextLengths);
+  free(population->fit);
+  free(population->order);
+  free(population->parents);
+  free(population);
+}
+
+
+
+//=============================================================================
+//
+//                     Seed Population Manipulation Functions
+//
+//=============================================================================
+
+void SeedPopulation_Step(SeedPopulation *population){
+  assert(population != NULL && "population should not be NULL!");
+  assert(population->generation + 1 < population->capacity && "population has no room for more generations!");
+
+  const size_t rows = population->rows;
+  const size_t capacity = population->capacity;
+  const size_t ranks = population->truncation > population->elite ? population->truncation : population->elite;
+
+  for (size_t i = 0; i < rows; i++){ population->order[i] = (int)i; }
+  selectTopK(population->fit, population->order, (int)rows, (int)ranks);
+
+  // the lists are only the seeds, so copying the whole list of the parent is still much less than its weights
+  for (size_t i = 0; i < rows; i++){
+    const size_t parent = i < population->elite
+                          ? (size_t)population->order[i]
+                          : (size_t)population->order[Random_Bounded(&population->random, (uint32_t)population->truncation)];
+    const size_t length = population->lengths[parent];
+
+    memcpy(population->next + i * capacity, population->current + parent * capacity, length * sizeof(SeedStep));
+    population->nextLengths[i] = length;
+    population->parents[i] = (int)parent;
+
+    if (i >= population->elite){
+      const SeedStep step = {.seed = Random_Next(&population->random), .scale = population->sigma};
+      population->next[i * capacity + length] = step;
+      population->nextLengths[i] = length + 1;
+    }
+  }
+
+  SeedStep *swap = population->current;
+  population->current = population->next;
+  population->next = swap;
+
+  size_t *lengths = population->lengths;
+  population->lengths = population->nextLengths;
+  population->nextLengths = lengths;
+
+  population->generation++;
+}
+
+void SeedPopulation_Decode(const SeedPopulation *population, const size_t row, float *weights){
+  assert(population != NULL && weights != NULL && "population and weights should not be NULL!");
+  assert(row < population->rows && "row is out of the population!");
+
+  memset(weights, 0, population->genes * sizeof(float));
+
+  const SeedStep *steps = population->current + row * population->capacity;
+  for (size_t s = 0; s < population->lengths[row]; s++){ SeedPopulation_Perturb(&steps[s], weights, population->genes); }
+}
+
+void SeedPopulation_Perturb(const SeedStep *step, float *weights, const size_t genes){
+  assert(step != NULL && weights != NULL && "step and weights should not be NULL!");
+
+  Random random;
+  Random_Seed(&random, step->seed);
+
+  float noise[SEED_POPULATION_CHUNK];
+  for (size_t offset = 0; offset < genes; offset += SEED_POPULATION_CHUNK){
+    const size_t count = genes - offset < SEED_POPULATION_CHUNK ? genes - offset : SEED_POPULATION_CHUNK;
+    Random_FillNormal(&random, noise, count, 0.0f, step->scale);
+    for (size_t j = 0; j < count; j++){ weights[offset + j] += noise[j]; }
+  }
+}
+
+
+
+//=============================================================================
+//
+//                     Seed Population Query Functions
+//
+//=============================================================================
+
+size_t SeedPopulation_GetBest(const SeedPopulation *population){
+  assert(population != NULL && "population should not be NULL!");
+
+  size_t best = 0;
+  for (size_t i = 1; i < population->rows; i++){
+    if (population->fit[i] < population->fit[best]) { best = i; }
+  }
+  return best;
+}
+
+const SeedStep* SeedPopulation_GetLastStep(const SeedPopulation *population, const size_t row){
+  assert(population != NULL && "population should not be NULL!");
+  assert(row < population->rows && "row is out of the population!");
+
+  return &population->current[row * population->capacity + population->lengths[row] - 1];
+}
@@ -0,0 +1,164 @@
+/**
+ * @file steady_state.c
+ * @brief Steady state GA on the Chromosome Heap public interface implementation.
+ *
+ * This file defines all implementations of the Steady State public interface
+ */
+
+#include "genetic/steady_state.h"
+
+#include "genetic/mutation.h"
+#include "data_structures/chromosome_heap.h"
+#include "general/parallel.h"
+#include "general/random.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @struct SteadyStateRun
+ * @brief The state shared by the worker threads, the heap is guarded by the lock.
+ * @ingroup SteadyState
+ */
+typedef struct SteadyStateRun {
+  const SteadyStateConfig *config;
+  SteadyStateFit fit;
+  void *context;
+
+  Chromosome **chromosomes; // the first population
+  Chromosome **spares;      // the child of each thread, swapped with the replaced worst
+  ChromosomeHeap *heap;
+
+  pthread_mutex_t lock;
+  size_t replacements;
+} SteadyStateRun;
+
+//=============================================================================
+//
+//                     Steady State Utility Helper Functions
+//
+//=============================================================================
+
+static float* SteadyState_Genome(const Chromosome *chromosome) { return ArrayFloat_GetArray(Chromosome_GetWeights(chromosome)); }
+
+/*!
+ * @ingroup SteadyState
+ * @brief The better of the two random chromosomes of the heap, the heap should be locked.
+ */
+static const float* SteadyState_Tournament(const ChromosomeHeap *heap, Random *random){
+  const uint32_t size = (uint32_t)ChromosomeHeap_GetSize(heap);
+  const size_t j = Random_Bounded(random, size);
+  const size_t k = Random_Bounded(random, size);
+  return SteadyState_Genome(ChromosomeHeap_GetChromosome(heap, ChromosomeHeap_GetFit(heap, j) <= ChromosomeHeap_GetFit(heap, k) ? j : k));
+}
+
+/*!
+ * @ingroup SteadyState
+ * @brief Make and evaluate the random chromosome of the first population.
+ */
+static void SteadyState_First(const size_t index, const size_t thread, void *context){
+  SteadyStateRun *run = context;
+  const SteadyStateConfig *config = run->config;
+
+  Random random;
+  Random_Stream(&random, config->seed, index);
+  float *genome = SteadyState_Genome(run->chromosomes[index]);
+  for (size_t g = 0; g < config->genes; g++){ genome[g] = Random_Uniform(&random, config->min[g], config->max[g]); }
+
+  Chromosome_SetFit(run->chromosomes[index], run->fit(genome, thread, run->context));
+}
+
+/*!
+ * @ingroup SteadyState
+ * @brief Make one child from the heap, evaluate it and replace the worst chromosome if the child is better.
+ */
+static void SteadyState_Child(const size_t index, const size_t thread, void *context){
+  SteadyStateRun *run = context;
+  const SteadyStateConfig *config = run->config;
+
+  // each child has its own stream, the same child gets the same numbers on any thread
+  Random random;
+  Random_Stream(&random, config->seed, config->population + index);
+  Chromosome *child = run->spares[thread];
+  float *genome = SteadyState_Genome(child);
+
+  // the parents are copied under the lock, the replaced chromosome is written by the other thread afterwards
+  pthread_mutex_lock(&run->lock);
+  const float *first = SteadyState_Tournament(run->heap, &random);
+  const float *second = SteadyState_Tournament(run->heap, &random);
+  memcpy(genome, first, config->point * sizeof(float));
+  memcpy(genome + config->point, (config->point > 0 ? second : first) + config->point, (config->genes - config->point) * sizeof(float));
+  pthread_mutex_unlock(&run->lock);
+
+  const Mutation mutation = {.kind = MUTATION_UNIFORM, .chance = config->mutation};
+  Mutation_Apply(&mutation, &random, genome, config->genes, config->genes, config->min, config->max);
+
+  Chromosome_SetFit(child, run->fit(genome, thread, run->context));
+
+  pthread_mutex_lock(&run->lock);
+  if (Chromosome_GetFit(child) < Chromosome_GetFit(ChromosomeHeap_PeekWorst(run->heap))){
+    run->spares[thread] = ChromosomeHeap_ReplaceWorst(run->heap, child);
+    run->replacements++;
+  }
+  pthread_mutex_unlock(&run->lock);
+}
+
+
+
+//=============================================================================
+//
+//                     Steady State Manipulation Functions
+//
+//=============================================================================
+
+void SteadyState_Run(const SteadyStateConfig *config, SteadyStateFit fit, void *context, float *best, SteadyStateResult *result){
+  assert(config != NULL && fit != NULL && best != NULL && result != NULL && "config, fit, best and result should not be NULL!");
+  assert(config->genes > 0 && config->population > 0 && "genes and population should be at least 1!");
+  assert(config->point < config->genes && "crossover point is out of the genes!");
+
+  const size_t threads = config->threads > 0 ? config->threads : Parallel_GetThreadCount();
+
+  SteadyStateRun run;
+  run.config = config;
+  run.fit = fit;
+  run.context = context;
+  run.replacements = 0;
+  run.chromosomes = malloc(config->population * sizeof(Chromosome*));
+  run.spares = malloc(threads * sizeof(Chromosome*));
+  if (run.chromosomes == NULL || run.spares == NULL){ perror("Failed to allocate Steady State chromosomes"); exit(EXIT_FAILURE); }
+
+  for (size_t i = 0; i < config->population + threads; i++){
+    Chromosome *chromosome = Chromosome_Create(config->genes);
+    if (chromosome == NULL){ exit(EXIT_FAILURE); }
+
+    if (i < config->population) { run.chromosomes[i] = chromosome; }
+    else                        { run.spares[i - config->population] = chromosome; }
+  }
+
+  run.heap = ChromosomeHeap_Create(config->population);
+  if (pthread_mutex_init(&run.lock, NULL) != 0){ perror("Failed to create Steady State lock"); exit(EXIT_FAILURE); }
+
+  // the first population is the only barrier of the run
+  Parallel_For(config->population, threads, SteadyState_First, &run);
+  for (size_t i = 0; i < config->population; i++){ ChromosomeHeap_Insert(run.heap, run.chromosomes[i]); }
+
+  Parallel_For(config->evaluations, threads, SteadyState_Child, &run);
+
+  const Chromosome *winner = ChromosomeHeap_PeekBest(run.heap);
+  memcpy(best, SteadyState_Genome(winner), config->genes * sizeof(float));
+  result->bestFit = Chromosome_GetFit(winner);
+  result->evaluations = config->population + config->evaluations;
+  result->replacements = run.replacements;
+
+  // the replaced chromosomes moved between the heap and the spares, so the both are destroyed
+  for (size_t i = 0; i < config->population; i++){ Chromosome_Destroy(ChromosomeHeap_GetChromosome(run.heap, i)); }
+  for (size_t t = 0; t < threads; t++){ Chromosome_Destroy(run.spares[t]); }
+
+  pthread_mutex_destroy(&run.lock);
+  ChromosomeHeap_Destroy(run.heap);
+  free(run.chromosomes);
+  free(run.spares);
+}
@@ -20,14 +20,21 @@ void selectSigmActivationFunction(float (**func_ptr)(float)){
     *func_ptr = sigmoid;
 }
 
+int selectActivationFunctionByChoice(float (**func_ptr)(float), int choice){
+    if (choice == 1) {
+        *func_ptr = tangenth;
+    } else if (choice == 2) {
+        *func_ptr = sigmoid;
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
 void selectActivationFunction(float (**func_ptr)(float)){
     printf("Please select the AF:\n1 - tanh\n2 - sigmoid\nSelect: ");
     int userChoice;
     scanf("%d", &userChoice);
 
-    if (userChoice == 1) {
-        *func_ptr = tangenth;
-    } else if (userChoice == 2) {
-        *func_ptr = sigmoid;
-    }
+    selectActivationFunctionByChoice(func_ptr, userChoice);
 }
\ No newline at end of file
@@ -0,0 +1,409 @@
+/**
+ * @file closed_loop_kernel.c
+ * @brief Fused closed loop step of the NN controller public interface implementation.
+ *
+ * This file defines all implementations of the Closed Loop Kernel public interface
+ */
+
+#include "neural/closed_loop_kernel.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//=============================================================================
+//
+//                     Closed Loop Kernel Utility Helper Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup ClosedLoopKernel
+ * @brief Allocate and copy the float array.
+ */
+static float* ClosedLoopKernel_CopyArray(const float *source, const size_t size){
+  float *output = malloc(size * sizeof(float));
+  if (output == NULL){ perror("Failed to allocate Closed Loop Layout array"); exit(EXIT_FAILURE); }
+
+  memcpy(output, source, size * sizeof(float));
+  return output;
+}
+
+/*!
+ * @ingroup ClosedLoopKernel
+ * @brief Run the NN on the features of the state, the same math as oneCalculation.
+ * @param layout the layout.
+ * @param state the state.
+ * @return The de-normalized first output of the network.
+ */
+static float ClosedLoopKernel_Forward(const ClosedLoopLayout *layout, ClosedLoopState *state){
+  const ClosedLoopConfig *config = &layout->config;
+
+  const float *features = state->data + layout->featureOffset + config->featureStart;
+  float *input  = state->data + layout->bufferOffset;
+  float *output = input + layout->maxNeurons;
+  float *memory = state->data + layout->memoryOffset;
+
+  // the inputs are normalized to [-1, 1]
+  for (size_t i = 0; i < layout->neurons[0]; i++){
+    const float value = (features[i] - layout->inputMin[i]) / (layout->inputMax[i] - layout->inputMin[i]) * 2.0f - 1.0f;
+    input[i] = fminf(1.0f, fmaxf(-1.0f, value));
+  }
+
+  for (size_t l = 0; l + 1 < config->layers; l++){
+    const size_t rows = layout->neurons[l + 1];
+    const size_t cols = layout->neurons[l];
+    const float *weights = state->weights + layout->weightOffset[l];
+    const float *bias    = (l + 2 < config->layers) ? state->weights + layout->biasOffset[l] : NULL;
+
+    // activation(W * input - bias), the last layer has no bias
+    for (size_t r = 0; r < rows; r++){
+      const float *row = weights + r * cols;
+      float sum = 0.0f;
+      for (size_t c = 0; c < cols; c++){ sum += row[c] * input[c]; }
+      if (bias != NULL) { sum -= bias[r]; }
+      output[r] = config->activation(sum);
+    }
+
+    // the S neurons integrate their output, the D neurons subtract their previous input
+    if (layout->sdLayer[l + 1]){
+      const unsigned char *types = layout->sdTypes + layout->sdOffset[l + 1];
+      float *layerMemory = memory + layout->sdOffset[l + 1];
+
+      for (size_t r = 0; r < rows; r++){
+        const float value = output[r] + layerMemory[r];
+        if (types[r] == 2)      { layerMemory[r] = -output[r]; }
+        else if (types[r] == 1) { layerMemory[r] = value; }
+        output[r] = value;
+      }
+    }
+
+    float *swap = input;
+    input  = output;
+    output = swap;
+  }
+
+  const float value = (input[0] + 1.0f) / 2.0f * (config->outputMax - config->outputMin) + config->outputMin;
+  return fminf(config->outputMax, fmaxf(config->outputMin, value));
+}
+
+/*!
+ * @ingroup ClosedLoopKernel
+ * @brief Compare the values with their snapshot of the previous step, the snapshot is updated.
+ * @param values the current values.
+ * @param previous the snapshot of the values.
+ * @param count the number of values.
+ * @param tolerance the relative tolerance.
+ * @return 1 if no value changed by more than the relative tolerance.
+ */
+static int ClosedLoopKernel_CompareRange(const float *values, float *previous, const size_t count, const float tolerance){
+  int converged = 1;
+  for (size_t i = 0; i < count; i++){
+    converged &= fabsf(values[i] - previous[i]) <= tolerance * (1.0f + fabsf(values[i]));
+    previous[i] = values[i];
+  }
+  return converged;
+}
+
+/*!
+ * @ingroup ClosedLoopKernel
+ * @brief Compare the loop state with the snapshot of the previous step, the snapshot is updated.
+ * @details
+ * Only the plant u and states, the NN inputs and the SD memory are compared. The rest of the plant memory holds
+ * e.g. the step size and counters of the integrator, and the rest of the features memory is the private history
+ * of the input system, e.g. the ring head of the feature engine. They change every step of the converged loop.
+ * @param layout the layout.
+ * @param state the state.
+ * @return 1 if no value changed by more than the relative tolerance.
+ */
+static int ClosedLoopKernel_Converged(const ClosedLoopLayout *layout, ClosedLoopState *state){
+  const float tolerance = layout->config.steadyTolerance;
+  const size_t plantStates = layout->config.plantStates;
+  const size_t inputs = layout->neurons[0];
+  const size_t sdTotal = layout->steadyOffset - layout->memoryOffset;
+  float *previous = state->data + layout->steadyOffset;
+
+  int converged = ClosedLoopKernel_CompareRange(state->data, previous, 1, tolerance);
+  converged &= ClosedLoopKernel_CompareRange(state->data + 2, previous + 1, plantStates, tolerance);
+  converged &= ClosedLoopKernel_CompareRange(state->data + layout->featureOffset + layout->config.featureStart,
+                                             previous + 1 + plantStates, inputs, tolerance);
+  converged &= ClosedLoopKernel_CompareRange(state->data + layout->memoryOffset,
+                                             previous + 1 + plantStates + inputs, sdTotal, tolerance);
+  return converged;
+}
+
+
+
+/**
+ * @struct ClosedLoopSource
+ * @brief The reference of the run, the whole array or the chunks pulled from the generator.
+ * @ingroup ClosedLoopKernel
+ */
+typedef struct ClosedLoopSource {
+  const float *samples;       // the array or the chunk
+  size_t count;               // the number of samples in the array or the chunk
+  size_t position;            // the next sample
+  SignalGenerator *generator; // NULL for the array
+  float *chunk;               // the buffer filled from the generator
+} ClosedLoopSource;
+
+/*!
+ * @ingroup ClosedLoopKernel
+ * @brief Look at the next reference sample, the next chunk is pulled when the current one is used up.
+ * @param source the reference.
+ * @param value the next sample.
+ * @return 0 at the end of the reference.
+ */
+static int ClosedLoopKernel_Peek(ClosedLoopSource *source, float *value){
+  if (source->position == source->count){
+    if (source->generator == NULL) { return 0; }
+
+    // the consumed samples are not needed any more, the whole chunk is overwritten
+    source->count = SignalGenerator_Fill(source->generator, source->chunk, CLOSED_LOOP_CHUNK);
+    source->position = 0;
+    if (source->count == 0) { return 0; }
+  }
+  *value = source->samples[source->position];
+  return 1;
+}
+
+/*!
+ * @ingroup ClosedLoopKernel
+ * @brief Run the whole reference from the sample 1, see ClosedLoopKernel_Simulate.
+ * @param layout the layout.
+ * @param state the state.
+ * @param weights the population row of the individual.
+ * @param source the reference.
+ * @param metrics the streaming metrics, NULL or the mask 0 skips them.
+ * @return The fit.
+ */
+static float ClosedLoopKernel_Run(const ClosedLoopLayout *layout, ClosedLoopState *state, const float *weights,
+                                  ClosedLoopSource *source, ControlMetrics *metrics){
+  ClosedLoopKernel_Reset(layout, state, weights);
+
+  const int useMetrics = metrics != NULL && metrics->mask != 0;
+  if (useMetrics) { ControlMetrics_Reset(metrics); }
+
+  // the sample 0 only starts the loop, the same as makeSimulationOfSignalNN
+  float previous, reference;
+  if (!ClosedLoopKernel_Peek(source, &previous)){ return state->fit; }
+  source->position++;
+
+  size_t steadySteps = 0; // consecutive converged steps
+  while (ClosedLoopKernel_Peek(source, &reference)){
+    source->position++;
+
+    const int clamped = state->maxCounter;
+    const float output = ClosedLoopKernel_Step(layout, state, reference);
+    if (useMetrics) { ControlMetrics_Update(metrics, reference, output, state->data[0]); }
+
+    if (!layout->config.fastForward) { continue; }
+
+    // the converged loop repeats the same step until the reference changes, so the rest of the segment is added at once
+    const int converged = ClosedLoopKernel_Converged(layout, state);
+    steadySteps = (converged && state->maxCounter == clamped && reference == previous) ? steadySteps + 1 : 0;
+    previous = reference;
+    if (steadySteps < CLOSED_LOOP_STEADY_STEPS) { continue; }
+
+    size_t count = 0;
+    float next;
+    while (ClosedLoopKernel_Peek(source, &next) && next == reference){
+      source->position++;
+      count++;
+    }
+
+    state->fit += fabsf(reference - output) * (float)count;
+    if (useMetrics) { ControlMetrics_UpdateConstant(metrics, reference, output, state->data[0], count); }
+
+    // the step keeps counting the skipped steps, so the decimation stays in phase
+    state->step += count;
+    state->skipped += count;
+    steadySteps = 0;
+  }
+
+  if (useMetrics){
+    ControlMetrics_Finish(metrics);
+    return ControlMetrics_Fitness(metrics);
+  }
+  return state->fit;
+}
+
+
+
+//=============================================================================
+//
+//                     Closed Loop Kernel Lifecycle Management Functions
+//
+//=============================================================================
+
+ClosedLoopLayout* ClosedLoopKernel_CreateLayout(const ClosedLoopConfig *config){
+  assert(config != NULL && "config should not be NULL!");
+  assert(config->layers >= 2 && config->layers <= CLOSED_LOOP_MAX_LAYERS && "layers count is out of range!");
+  assert(config->neurons != NULL && config->layerTypes != NULL && "network description should not be NULL!");
+  assert(config->inputMin != NULL && config->inputMax != NULL && "normalization should not be NULL!");
+  assert(config->activation != NULL && config->features != NULL && config->plant != NULL && "functions should not be NULL!");
+  assert(config->plantSize >= 2 && config->featureSize >= 4 && "plant and features memory is too small!");
+  assert(2 + config->plantStates <= config->plantSize && "plant states are out of the plant memory!");
+  assert(config->decimation >= 1 && "decimation should be at least 1!");
+
+  ClosedLoopLayout *layout = NULL;
+  layout = malloc(sizeof(ClosedLoopLayout));
+  if (layout == NULL){ perror("Failed to allocate Closed Loop Layout"); exit(EXIT_FAILURE); }
+
+  layout->config = *config;
+  layout->config.neurons    = NULL;
+  layout->config.layerTypes = NULL;
+  layout->config.inputMin   = NULL;
+  layout->config.inputMax   = NULL;
+
+  // the offsets follow fillMatrixesNN: AW of the layer row by row, then BW except the last layer
+  size_t offset = 0;
+  size_t sdTotal = 0;
+  layout->maxNeurons = 0;
+  for (size_t l = 0; l < config->layers; l++){
+    layout->neurons[l] = (size_t)config->neurons[l];
+    layout->sdLayer[l] = config->layerTypes[l] == 1;
+    layout->sdOffset[l] = sdTotal;
+    if (layout->sdLayer[l]) { sdTotal += layout->neurons[l]; }
+    if (layout->neurons[l] > layout->maxNeurons) { layout->maxNeurons = layout->neurons[l]; }
+
+    if (l + 1 < config->layers){
+      layout->weightOffset[l] = offset;
+      offset += (size_t)config->neurons[l + 1] * (size_t)config->neurons[l];
+      layout->biasOffset[l] = offset;
+      if (l + 2 < config->layers) { offset += (size_t)config->neurons[l + 1]; }
+    }
+  }
+  layout->weightCount = offset;
+  assert(config->featureStart + layout->neurons[0] <= config->featureSize && "NN inputs are out of the features!");
+
+  // the same split as createNeuralNetwork: 50 % straight, 25 % S and 25 % D neurons
+  layout->sdTypes = calloc(sdTotal > 0 ? sdTotal : 1, sizeof(unsigned char));
+  if (layout->sdTypes == NULL){ perror("Failed to allocate Closed Loop Layout SD types"); exit(EXIT_FAILURE); }
+
+  for (size_t l = 0; l < config->layers; l++){
+    if (!layout->sdLayer[l]) { continue; }
+
+    const size_t size = layout->neurons[l];
+    const size_t middle = size / 2 + (size - size / 2) / 2;
+    unsigned char *types = layout->sdTypes + layout->sdOffset[l];
+    for (size_t j = size / 2; j < size; j++){ types[j] = j < middle ? 1 : 2; }
+  }
+
+  layout->inputMin = ClosedLoopKernel_CopyArray(config->inputMin, layout->neurons[0]);
+  layout->inputMax = ClosedLoopKernel_CopyArray(config->inputMax, layout->neurons[0]);
+
+  layout->featureOffset = config->plantSize;
+  layout->bufferOffset  = layout->featureOffset + config->featureSize;
+  layout->memoryOffset  = layout->bufferOffset + 2 * layout->maxNeurons;
+  layout->steadyOffset  = layout->memoryOffset + sdTotal;
+  layout->stateSize     = layout->steadyOffset + (config->fastForward ? 1 + config->plantStates + layout->neurons[0] + sdTotal : 0);
+
+  return layout;
+}
+
+void ClosedLoopKernel_DestroyLayout(ClosedLoopLayout *layout){
+  if (layout == NULL) { return; }
+
+  free(layout->sdTypes);
+  free(layout->inputMin);
+  free(layout->inputMax);
+  free(layout);
+}
+
+ClosedLoopState* ClosedLoopKernel_CreateState(const ClosedLoopLayout *layout){
+  assert(layout != NULL && "layout should not be NULL!");
+
+  ClosedLoopState *state = NULL;
+  state = malloc(sizeof(ClosedLoopState) + layout->stateSize * sizeof(float));
+  if (state == NULL){ perror("Failed to allocate Closed Loop State"); exit(EXIT_FAILURE); }
+
+  state->weights = NULL;
+  return state;
+}
+
+void ClosedLoopKernel_DestroyState(ClosedLoopState *state){
+  free(state);
+}
+
+void ClosedLoopKernel_Reset(const ClosedLoopLayout *layout, ClosedLoopState *state, const float *weights){
+  assert(layout != NULL && state != NULL && "layout and state should not be NULL!");
+  assert(weights != NULL && "weights should not be NULL!");
+
+  memset(state->data, 0, layout->stateSize * sizeof(float));
+
+  // the plant gets its step, the features get the controller step
+  state->data[1] = layout->config.dt;
+  state->data[layout->featureOffset] = layout->config.dt * (float)layout->config.decimation;
+
+  state->weights = weights;
+  state->step = 0;
+  state->skipped = 0;
+  state->u = 0.0f;
+  state->y = 0.0f;
+
+  state->fit = 0.0f;
+  state->maxCounter = 0;
+  state->steadyRiseCheck = 0;
+}
+
+
+
+//=============================================================================
+//
+//                     Closed Loop Kernel Manipulation Functions
+//
+//=============================================================================
+
+float ClosedLoopKernel_Step(const ClosedLoopLayout *layout, ClosedLoopState *state, const float reference){
+  const ClosedLoopConfig *config = &layout->config;
+  float *plant = state->data;
+
+  if (state->step % (size_t)config->decimation == 0){
+    float *features = state->data + layout->featureOffset;
+    features[1] = reference - state->y; // e
+    features[2] = state->u;             // u
+    features[3] = state->y;             // y
+    config->features(features, config->featureContext);
+
+    state->u = ClosedLoopKernel_Forward(layout, state);
+  }
+  plant[0] = config->plantGain * state->u;
+
+  float output = config->plant(plant);
+  if (output > config->maxOutput){
+    output = config->maxOutput;
+    state->maxCounter++;
+  } else if (output < config->minOutput){
+    output = config->minOutput;
+    state->maxCounter++;
+  }
+
+  state->fit += fabsf(reference - output);
+  if (state->y > output) { state->steadyRiseCheck++; }
+
+  state->y = output;
+  state->step++;
+  return output;
+}
+
+float ClosedLoopKernel_Simulate(const ClosedLoopLayout *layout, ClosedLoopState *state, const float *weights,
+                                const float *reference, const size_t length, ControlMetrics *metrics){
+  assert(reference != NULL && "reference should not be NULL!");
+
+  ClosedLoopSource source = {reference, length, 0, NULL, NULL};
+  return ClosedLoopKernel_Run(layout, state, weights, &source, metrics);
+}
+
+float ClosedLoopKernel_SimulateStream(const ClosedLoopLayout *layout, ClosedLoopState *state, const float *weights,
+                                      SignalGenerator *generator, ControlMetrics *metrics){
+  assert(generator != NULL && "generator should not be NULL!");
+
+  float chunk[CLOSED_LOOP_CHUNK];
+  SignalGenerator_Reset(generator);
+
+  ClosedLoopSource source = {chunk, 0, 0, generator, chunk};
+  return ClosedLoopKernel_Run(layout, state, weights, &source, metrics);
+}
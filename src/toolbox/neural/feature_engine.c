@@ -0,0 +1,174 @@
+/**
+ * @file feature_engine.c
+ * @brief Ring buffer feature pipeline of the NN inputs public interface implementation.
+ *
+ * This file defines all implementations of the Feature Engine public interface
+ */
+
+#include "neural/feature_engine.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//=============================================================================
+//
+//                     Feature Engine Utility Helper Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup FeatureEngine
+ * @brief Get the lanes of the sample lag steps back in the ring of the source.
+ */
+static const float* FeatureEngine_Sample(const FeatureEngine *engine, const float *history, const FeatureSource source,
+                                         const size_t head, const size_t lag){
+  const size_t slot = (head - lag) & engine->mask;
+  return history + engine->ringOffset + ((size_t)engine->ringIndex[source] * engine->capacity + slot) * engine->batch;
+}
+
+
+
+//=============================================================================
+//
+//                     Feature Engine Lifecycle Management Functions
+//
+//=============================================================================
+
+FeatureEngine* FeatureEngine_Create(const FeatureSpec *specs, const size_t count, const size_t batch){
+  assert(specs != NULL && "specs should not be NULL!");
+  assert(count > 0 && count <= FEATURE_ENGINE_MAX_FEATURES && "features count is out of range!");
+  assert(batch > 0 && "batch should be at least 1!");
+
+  FeatureEngine *engine = NULL;
+  engine = malloc(sizeof(FeatureEngine));
+  if (engine == NULL){ perror("Failed to allocate Feature Engine"); exit(EXIT_FAILURE); }
+
+  memcpy(engine->specs, specs, count * sizeof(FeatureSpec));
+  engine->count = count;
+  engine->batch = batch;
+
+  // the ring should hold the deepest sample: the lag of the value, 1 for the derivative, 2 for the second one
+  size_t depth = 0;
+  int ringNeeded[FEATURE_SOURCES] = {0};
+  int integralNeeded[FEATURE_SOURCES] = {0};
+  for (size_t i = 0; i < count; i++){
+    assert(specs[i].source >= 0 && specs[i].source < FEATURE_SOURCES && "feature source is out of range!");
+    assert(specs[i].lag >= 0 && "feature lag should not be negative!");
+
+    size_t needed = 0;
+    switch (specs[i].kind){
+      case FEATURE_VALUE:             needed = (size_t)specs[i].lag; break;
+      case FEATURE_DERIVATIVE:        needed = 1; break;
+      case FEATURE_SECOND_DERIVATIVE: needed = 2; break;
+      case FEATURE_INTEGRAL:          integralNeeded[specs[i].source] = 1; continue;
+    }
+    ringNeeded[specs[i].source] = 1;
+    if (needed > depth) { depth = needed; }
+  }
+
+  engine->capacity = 1;
+  while (engine->capacity <= depth) { engine->capacity <<= 1; }
+  engine->mask = engine->capacity - 1;
+
+  int rings = 0, integrals = 0;
+  for (int s = 0; s < FEATURE_SOURCES; s++){
+    engine->ringIndex[s]     = ringNeeded[s]     ? rings++     : -1;
+    engine->integralIndex[s] = integralNeeded[s] ? integrals++ : -1;
+  }
+
+  // the first float is the ring head, shared by all the lanes as they are stepped together
+  engine->ringOffset     = 1;
+  engine->integralOffset = engine->ringOffset + (size_t)rings * engine->capacity * batch;
+  engine->historySize    = engine->integralOffset + (size_t)integrals * batch;
+
+  return engine;
+}
+
+void FeatureEngine_Destroy(FeatureEngine *engine){
+  free(engine);
+}
+
+void FeatureEngine_Reset(const FeatureEngine *engine, float *history){
+  assert(engine != NULL && history != NULL && "engine and history should not be NULL!");
+
+  memset(history, 0, engine->historySize * sizeof(float));
+}
+
+
+
+//=============================================================================
+//
+//                     Feature Engine Manipulation Functions
+//
+//=============================================================================
+
+void FeatureEngine_Push(const FeatureEngine *engine, float *history, const float dt,
+                        const float *e, const float *u, const float *y, float *features){
+  assert(engine != NULL && history != NULL && "engine and history should not be NULL!");
+  assert(features != NULL && "features should not be NULL!");
+
+  const size_t batch = engine->batch;
+  const float *sources[FEATURE_SOURCES] = {e, u, y};
+
+  // the head is the small integer, so it is exact in the float of the history
+  const size_t head = ((size_t)history[0] + 1) & engine->mask;
+  history[0] = (float)head;
+
+  for (int s = 0; s < FEATURE_SOURCES; s++){
+    if (engine->ringIndex[s] >= 0){
+      float *slot = history + engine->ringOffset + ((size_t)engine->ringIndex[s] * engine->capacity + head) * batch;
+      memcpy(slot, sources[s], batch * sizeof(float));
+    }
+    if (engine->integralIndex[s] >= 0){
+      float *integral = history + engine->integralOffset + (size_t)engine->integralIndex[s] * batch;
+      for (size_t b = 0; b < batch; b++){ integral[b] += sources[s][b]; }
+    }
+  }
+
+  for (size_t i = 0; i < engine->count; i++){
+    const FeatureSpec *spec = &engine->specs[i];
+    float *output = features + i * batch;
+
+    switch (spec->kind){
+      case FEATURE_VALUE: {
+        memcpy(output, FeatureEngine_Sample(engine, history, spec->source, head, (size_t)spec->lag), batch * sizeof(float));
+        break;
+      }
+      case FEATURE_DERIVATIVE: {
+        const float *x0 = FeatureEngine_Sample(engine, history, spec->source, head, 0);
+        const float *x1 = FeatureEngine_Sample(engine, history, spec->source, head, 1);
+        for (size_t b = 0; b < batch; b++){ output[b] = (x0[b] - x1[b]) / dt; }
+        break;
+      }
+      case FEATURE_SECOND_DERIVATIVE: {
+        const float *x0 = FeatureEngine_Sample(engine, history, spec->source, head, 0);
+        const float *x1 = FeatureEngine_Sample(engine, history, spec->source, head, 1);
+        const float *x2 = FeatureEngine_Sample(engine, history, spec->source, head, 2);
+        for (size_t b = 0; b < batch; b++){ output[b] = ((x0[b] - x1[b]) / dt - (x1[b] - x2[b]) / dt) / dt; }
+        break;
+      }
+      case FEATURE_INTEGRAL: {
+        memcpy(output, history + engine->integralOffset + (size_t)engine->integralIndex[spec->source] * batch, batch * sizeof(float));
+        break;
+      }
+    }
+  }
+}
+
+
+
+//=============================================================================
+//
+//                     Feature Engine Query Functions
+//
+//=============================================================================
+
+int FeatureEngine_NormalizationType(const FeatureSpec *spec){
+  assert(spec != NULL && "spec should not be NULL!");
+
+  // the generic types: 0 - e, 1 - u, 2 - y, then d, dd, i of e (3..5), u (6..8) and y (9..11)
+  if (spec->kind == FEATURE_VALUE) { return (int)spec->source; }
+  return 3 + 3 * (int)spec->source + (int)spec->kind - 1;
+}
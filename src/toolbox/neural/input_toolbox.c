@@ -1,14 +1,16 @@
 #include "neural/input_toolbox.h"
 
 #include "neural/model_system.h"
+#include "neural/feature_engine.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
 
-void typeOne(float *data) {
+void typeOne(float *data, const void *context) {
+  (void)context;
 
-  // data[0] - dt
+  // data[0] - dt of the controller (signal dt * decimation), the function is called only at the controller steps
 
   // data[1] - e[t]
   // data[2] - u[t]
@@ -41,7 +43,8 @@ void typeOne(float *data) {
   data[12] =  data[6];
 }
 
-void typeTwo(float *data) {
+void typeTwo(float *data, const void *context) {
+  (void)context;
 
   // data[0] - dt
 
@@ -51,6 +54,52 @@ void typeTwo(float *data) {
 
 }
 
+// the first feature of the lag input system, data[1..3] are the e, u, y of the step
+#define LAG_FEATURES_START 4
+
+void typeLags(float *data, const void *context) {
+
+  // context - the feature engine of the system, read only, so the threads share it
+  // data[0] - dt of the controller
+  // data[1..3] - e[t], u[t], y[t]
+  // data[4..4+count) - the features selected by the engine
+  // data[4+count..] - the ring buffer history of the engine
+
+  const FeatureEngine *engine = context;
+  FeatureEngine_Push(engine, data + LAG_FEATURES_START + engine->count, data[0], &data[1], &data[2], &data[3], data + LAG_FEATURES_START);
+}
+
+static void makeInputDataSystemLags(struct SystemNN *systemNN, int lags){
+  // e[t], ..., e[t-lags], y[t], ..., y[t-lags] and u[t]
+  FeatureSpec specs[FEATURE_ENGINE_MAX_FEATURES];
+  int size = 0;
+  for(int k=0; k<=lags; k++){
+    specs[size++] = (FeatureSpec){FEATURE_E, FEATURE_VALUE, k};
+  }
+  for(int k=0; k<=lags; k++){
+    specs[size++] = (FeatureSpec){FEATURE_Y, FEATURE_VALUE, k};
+  }
+  specs[size++] = (FeatureSpec){FEATURE_U, FEATURE_VALUE, 0};
+
+  // each system has its own engine, so the systems with the different lags do not change each other
+  FeatureEngine_Destroy(systemNN->featureEngine);
+  systemNN->featureEngine = FeatureEngine_Create(specs, size, 1);
+
+  const int full = LAG_FEATURES_START + size + (int)systemNN->featureEngine->historySize;
+  systemNN->inputData = (float*)calloc(full, sizeof(float));
+
+  systemNN->inputDataSize = (int*)malloc(3 * sizeof(int));
+  systemNN->inputDataSize[0] = full;
+  systemNN->inputDataSize[1] = LAG_FEATURES_START;
+  systemNN->inputDataSize[2] = LAG_FEATURES_START + size;
+
+  // the lagged value is normalized the same way as the value
+  systemNN->inputTypes = (int*)malloc(size * sizeof(int));
+  for(int i=0; i<size; i++){
+    systemNN->inputTypes[i] = FeatureEngine_NormalizationType(&specs[i]);
+  }
+}
+
 static void makeInputDataSystem(struct SystemNN *systemNN, int size, int full){
   systemNN->inputData = (float*)malloc(full * sizeof(float));
   for(int i=0; i<full; i++){
@@ -90,18 +139,42 @@ static void makeInputDataSystemTwo(struct SystemNN *systemNN, int size, int full
   systemNN->inputTypes[2] = 2;  // y
 }
 
-void selectInputNNFunction(void (**func_ptr)(float*), struct SystemNN *systemNN){
+int selectInputNNFunctionByChoice(void (**func_ptr)(float*, const void*), struct SystemNN *systemNN, int choice, int lags){
+    if (choice == 1) {
+        *func_ptr = typeOne;
+        makeInputDataSystem(systemNN, 8, 13);
+    } else if(choice == 2){
+      *func_ptr = typeTwo;
+      makeInputDataSystemTwo(systemNN, 3, 4);
+    } else if(choice == 3){
+      if(lags < 0 || 2 * (lags + 1) + 1 > FEATURE_ENGINE_MAX_FEATURES){
+        return 0;
+      }
+
+      *func_ptr = typeLags;
+      makeInputDataSystemLags(systemNN, lags);
+    } else {
+      return 0;
+    }
+    return 1;
+}
+
+void selectInputNNFunction(void (**func_ptr)(float*, const void*), struct SystemNN *systemNN){
     printf("Please select the AF:\n1 - typeOne\n");
     printf("2 - typeTwo (SD)\n");
+    printf("3 - typeLags (e, y with N past samples)\n");
     printf("Select: ");
     int userChoice;
     scanf("%d", &userChoice);
 
-    if (userChoice == 1) {
-        *func_ptr = typeOne;
-        makeInputDataSystem(systemNN, 8, 13);
-    } else if(userChoice == 2){
-      *func_ptr = typeTwo;
-      makeInputDataSystemTwo(systemNN, 3, 4);
+    int lags = 0;
+    if(userChoice == 3){
+      printf("Number of past samples: ");
+      scanf("%d", &lags);
     }
-}
\ No newline at end of file
+
+    // the wrong number of the past samples falls back to one
+    if(selectInputNNFunctionByChoice(func_ptr, systemNN, userChoice, lags) == 0 && userChoice == 3){
+      selectInputNNFunctionByChoice(func_ptr, systemNN, userChoice, 1);
+    }
+}
@@ -3,17 +3,22 @@
 #include "neural/neural_network.h"
 #include "general/signal_designer.h"
 #include "general/matrix_math.h"
+#include "general/parallel.h"
+#include "general/state_space.h"
+#include "neural/normalization_cache.h"
 
 
 #include <float.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
 #include <unistd.h>
 
 void createNNSystem(struct SystemNN *systemNN, struct NNInput *input){
 
   // input system 
+  systemNN->featureEngine = NULL;
   selectInputNNFunction(&systemNN->input_sys, systemNN);
 
   // make input size be the same as the input system needs
@@ -39,6 +44,7 @@ void createNNSystem(struct SystemNN *systemNN, struct NNInput *input){
   cliSignalSelector(systemNN->signal);
 
   int size = selectSystem(&systemNN->func_system);
+  prepareSystem(systemNN->func_system, systemNN->signal->dt);
     
   systemNN->dataSystem = (float*)malloc(size * sizeof(float));
   for(int i=0; i<size; i++){
@@ -52,7 +58,15 @@ void createNNSystem(struct SystemNN *systemNN, struct NNInput *input){
   systemNN->output->dt = systemNN->signal->dt;
   systemNN->output->signal = (float*)malloc(systemNN->signal->length * sizeof(float));
 
-  
+  systemNN->recalibrate = 0;
+  systemNN->plantGain = 1.0;
+  systemNN->decimation = 1;
+  systemNN->trace = NULL;
+
+  systemNN->fastForward = 0;
+  systemNN->steadyTolerance = 1e-5;
+
+  ControlMetrics_Init(&systemNN->metrics, 0, NULL, systemNN->signal->dt);
 }
 
 void clearNNSystem(struct SystemNN *systemNN){
@@ -64,30 +78,56 @@ void clearNNSystem(struct SystemNN *systemNN){
   free(systemNN->dataSystem);
   free(systemNN->inputData);
   free(systemNN->inputDataSize);
+  FeatureEngine_Destroy(systemNN->featureEngine);
+
+  // the rest of the buffered records is written here
+  TraceWriter_Destroy(systemNN->trace);
 
   free(systemNN);
 }
 
-static void cleanNNSystem(struct SystemNN *systemNN){
-  // clear output and system data
-  for(int i=0; i < systemNN->signal->length; i++){
-      systemNN->output->signal[i] = 0.0;
-  }
-  for(int i=0; i<systemNN->sizeDataSystem; i++){
-      systemNN->dataSystem[i] = 0.0;
-  }
-  systemNN->dataSystem[1] = systemNN->signal->dt;
+ClosedLoopLayout* createClosedLoopLayout(struct SystemNN *systemNN){
+  struct NN *neuralNetwork = systemNN->neuralNetwork;
 
-  // clear input data
-  for(int i=0; i<systemNN->inputDataSize[0]; i++){
-      systemNN->inputData[i] = 0.0;
-  }
-  systemNN->inputData[0] = systemNN->signal->dt;
+  ClosedLoopConfig config;
+  config.layers     = neuralNetwork->layerNumber;
+  config.neurons    = neuralNetwork->neuronsSize;
+  config.layerTypes = neuralNetwork->layerType;
+
+  config.inputMin   = neuralNetwork->normalizationMatrix[1];
+  config.inputMax   = neuralNetwork->normalizationMatrix[0];
+  config.outputMin  = neuralNetwork->denormalizationMatrix[1][0];
+  config.outputMax  = neuralNetwork->denormalizationMatrix[0][0];
+  config.activation = neuralNetwork->func_ptr;
+
+  config.features       = systemNN->input_sys;
+  config.featureContext = systemNN->featureEngine;
+  config.featureSize  = systemNN->inputDataSize[0];
+  config.featureStart = systemNN->inputDataSize[1];
 
-  systemNN->steadyRiseCheck = 0;
-  systemNN->maxCounter = 0;
+  config.plant     = systemNN->func_system;
+  config.plantSize = systemNN->sizeDataSystem;
+  config.plantStates = (size_t)getSystemStateCount(systemNN->func_system, systemNN->sizeDataSystem);
+  config.plantGain = systemNN->plantGain;
+  config.minOutput = systemNN->minSys;
+  config.maxOutput = systemNN->maxSys;
 
-  systemNN->fit = 0.0;
+  config.dt         = systemNN->signal->dt;
+  config.decimation = systemNN->decimation;
+
+  config.fastForward     = systemNN->fastForward;
+  config.steadyTolerance = systemNN->steadyTolerance;
+
+  return ClosedLoopKernel_CreateLayout(&config);
+}
+
+void openNNSystemTrace(struct SystemNN *systemNN, const char *path){
+  // the same columns as the legacy CSV "CV, RV, System Output, Corrected Output", the kernel output is already
+  // limited, so the corrected output equals y
+  static const char *const columns[] = {"y", "w", "u", "y_corrected"};
+
+  TraceWriter_Destroy(systemNN->trace);
+  systemNN->trace = TraceWriter_Create(path, columns, 4, 0);
 }
 
 static void getMaxMinSignalValues(struct Signal *signal, float *max, float *min){
@@ -103,71 +143,76 @@ static void getMaxMinSignalValues(struct Signal *signal, float *max, float *min)
   }
 }
 
-static void findUOneRound(struct SystemNN *systemNN, float *forValues, float *Data){
-  float analyzedValue, maxY, maxDDY, maxE, maxDY; 
-  float finValue, sysOutput, dy, ddy, iy, preY, preDY;
-  float du, ddu, iu, preU, preDU, min, penalty;
-  float de, dde, ie, preE, preDE, maxDE, maxDDE, sum;
+// the calibration searches the constant u which brings the open loop output to the signal maximum
+#define CALIBRATION_PENALTY        50000.0f // the penalty of the output leaving [minSys, maxSys]
+#define CALIBRATION_MAX_EXPANSIONS 24       // the bracket tries u = 2^k for k < 24, so u up to ~8.4e6 is reachable
+#define CALIBRATION_TOLERANCE      1e-4f    // the relative width of the bracket to stop the search
+
+// the result of one open loop simulation with the constant u
+typedef struct CalibrationRun {
+  float u;          // the tested input
+  float finalValue; // mean of the output in the last second
+  int   penalty;    // 1 if the output left the [minSys, maxSys]
+  float data[12];   // the maxima of all generic inputs in the order of the normalization
+} CalibrationRun;
+
+// the shared data of the parallel batch of calibration runs
+typedef struct CalibrationBatch {
+  struct SystemNN *systemNN;
+  float maxSig;
+  float *dataSystems;   // one system memory per thread
+  CalibrationRun *runs; // one run per candidate
+} CalibrationBatch;
+
+static void simulateOpenLoop(const struct SystemNN *systemNN, float *dataSystem, const float maxSig, CalibrationRun *run){
+  float maxY, maxDY, maxDDY, maxE, maxDE, maxDDE;
+  float sysOutput, dy, ddy, de, dde, preY, preDY, preE, preDE;
+  float iy, iu, ie, sum;
   int count;
 
-  float maxSig, minSig;
+  const float dt = systemNN->signal->dt;
+  const float curValue = run->u;
 
-  min = FLT_MAX;
-  getMaxMinSignalValues(systemNN->signal, &maxSig, &minSig);
+  // the features are sampled at the controller rate, the same way the NN sees them
+  const int decimation = systemNN->decimation;
+  const float controlDt = dt * decimation;
 
-  for(float curValue = forValues[0]; curValue < forValues[1]; curValue += forValues[2]){
-    // get all max values set
-    maxY   = 0;
-    maxDY  = 0;
-    maxDDY = 0;
+  // the open loop runs for the signal length in seconds, the last second is the steady state
+  const int steps = (int)(systemNN->signal->length / dt);
 
-    maxE   = 0;
-    maxDE  = 0;
-    maxDDE = 0;
+  maxY = 0; maxDY = 0; maxDDY = 0;
+  maxE = 0; maxDE = 0; maxDDE = 0;
 
-    // all aditional 
-    count = 0;
-    preY  = 0;
-    preDY = 0;
-    iy    = 0;
+  preY = 0; preDY = 0;
+  preE = 0; preDE = 0;
 
-    preU  = 0;
-    preDU = 0;
-    iu    = 0;
+  iy = 0; iu = 0; ie = 0;
+  sum = 0; count = 0;
 
-    preE  = 0;
-    preDE = 0;
-    ie    = 0;
+  run->penalty = 0;
 
-    penalty = 0;
-    sum = 0;
+  // first the data of the system is reseted
+  for(int j=0; j<systemNN->sizeDataSystem; j++){
+    dataSystem[j] = 0.0;
+  }
+  dataSystem[1] = dt;
 
-    // first the data of the system is reseted
-    for(int j=0; j<systemNN->sizeDataSystem; j++){
-        systemNN->dataSystem[j] = 0.0;
-    }
-    systemNN->dataSystem[1] = systemNN->signal->dt;
-
-    // now the idea is to simulate 0.5s with the u set to curValue, finnal value is then analyzed
-    for(float j=0.0; j< systemNN->signal->length; j += systemNN->signal->dt){
-      if(j < 1.0){
-        systemNN->dataSystem[0] = 0;
-      } else {
-        systemNN->dataSystem[0] = curValue;
-      }
-      sysOutput = systemNN->func_system(systemNN->dataSystem);
+  for(int k=0; k<steps; k++){
+    const float j = k * dt;
 
-      if(sysOutput > systemNN->maxSys){
-        penalty = 50000;
-      } else if(sysOutput < systemNN->minSys){
-        penalty = 50000;
-      }
+    dataSystem[0] = (j < 1.0) ? 0 : curValue;
+    sysOutput = systemNN->func_system(dataSystem);
+
+    if(sysOutput > systemNN->maxSys || sysOutput < systemNN->minSys){
+      run->penalty = 1;
+    }
 
-      dy  = (sysOutput - preY ) / systemNN->output->dt;
-      ddy = (dy        - preDY) / systemNN->output->dt;
+    if(k % decimation == 0){
+      dy  = (sysOutput - preY ) / controlDt;
+      ddy = (dy        - preDY) / controlDt;
 
-      de  = (maxSig - sysOutput  - preE ) / systemNN->output->dt;
-      dde = (de                  - preDE) / systemNN->output->dt;   
+      de  = (maxSig - sysOutput - preE ) / controlDt;
+      dde = (de                 - preDE) / controlDt;
 
       preY  = sysOutput;
       preDY = dy;
@@ -175,68 +220,183 @@ static void findUOneRound(struct SystemNN *systemNN, float *forValues, float *Da
       preE  = maxSig - sysOutput;
       preDE = de;
 
-      if(sysOutput > maxY  ) { maxY   = sysOutput; } 
-      if(preE      > maxE  ) { maxE   = preE;      } 
-      if(dy        > maxDY ) { maxDY  = dy;        } 
+      if(sysOutput > maxY  ) { maxY   = sysOutput; }
+      if(preE      > maxE  ) { maxE   = preE;      }
+      if(dy        > maxDY ) { maxDY  = dy;        }
       if(ddy       > maxDDY) { maxDDY = ddy;       }
       if(de        > maxDE ) { maxDE  = de;        }
       if(dde       > maxDDE) { maxDDE = dde;       }
-  
+
+      // the integral of the applied u at the controller samples, the same as the NN input sees
       iy += sysOutput;
-      iu += curValue;
+      iu += dataSystem[0];
       ie += preE;
-
-      if(j>systemNN->signal->length - 1.0){
-        sum += sysOutput;
-        count++;
-      }
-      
-    }
-    analyzedValue = maxSig - (sum / count) + penalty;
-    if(analyzedValue < 0){
-      analyzedValue *= (-1);
     }
 
-    if(iy < 0){
-      iy *= (-1);
-    } if(iu < 0){
-      iu *= (-1);
-    } if(ie < 0){
-      ie *= (-1);
+    if(j > systemNN->signal->length - 1.0){
+      sum += sysOutput;
+      count++;
     }
+  }
+  run->finalValue = count > 0 ? sum / count : sysOutput;
 
-    if(analyzedValue < min){
-      min = analyzedValue;
+  run->data[0] = maxE;
+  run->data[1] = curValue;
+  run->data[2] = maxY;
 
-      Data[0] = maxE;
-      Data[1] = curValue;
-      Data[2] = maxY;
+  run->data[3] = maxDE;
+  run->data[4] = maxDDE;
+  run->data[5] = fabsf(ie);
 
-      Data[3] = maxDE;
-      Data[4] = maxDDE;
-      Data[5] = ie;
+  // the u jumps from 0 to curValue in one controller sample, the second derivative is the jump of the first one
+  run->data[6] = curValue / controlDt;
+  run->data[7] = run->data[6] / controlDt;
+  run->data[8] = fabsf(iu);
 
-      Data[6] = curValue / systemNN->output->dt;
-      Data[7] = Data[7]  / systemNN->output->dt;
-      Data[8] = iu;
+  run->data[9]  = maxDY;
+  run->data[10] = maxDDY;
+  run->data[11] = fabsf(iy);
+}
 
-      Data[9]  = maxDY;
-      Data[10] = maxDDY;
-      Data[11] = iy;
+static float calibrationScore(const CalibrationRun *run, const float maxSig){
+  // same criteria as the former grid search: distance of the steady state from the maximum plus penalty
+  return fabsf(maxSig - run->finalValue + (run->penalty ? CALIBRATION_PENALTY : 0.0f));
+}
+
+static int calibrationIsAbove(const CalibrationRun *run, const float maxSig){
+  return run->penalty || run->finalValue >= maxSig;
+}
+
+static void calibrationTask(const size_t index, const size_t thread, void *context){
+  CalibrationBatch *batch = context;
+  float *dataSystem = &batch->dataSystems[thread * batch->systemNN->sizeDataSystem];
+
+  simulateOpenLoop(batch->systemNN, dataSystem, batch->maxSig, &batch->runs[index]);
+}
+
+static void keepBestRun(const CalibrationBatch *batch, const size_t count, CalibrationRun *best){
+  for(size_t i=0; i<count; i++){
+    if(calibrationScore(&batch->runs[i], batch->maxSig) < calibrationScore(best, batch->maxSig)){
+      *best = batch->runs[i];
     }
   }
 }
 
 static void findUForSystemAndSignal(struct SystemNN *systemNN, float *Data){
+  float maxSig, minSig, gain;
+  float low = 0.0;
+  float high = 0.0;
+  int found = 0;
+
+  getMaxMinSignalValues(systemNN->signal, &maxSig, &minSig);
 
-  float forValueOne[]  = {0.0, 10000.0, 1000.0};
-  findUOneRound(systemNN, &forValueOne, Data);
+  const size_t threads = Parallel_GetThreadCount();
+
+  CalibrationBatch batch;
+  batch.systemNN    = systemNN;
+  batch.maxSig      = maxSig;
+  batch.dataSystems = (float*)malloc(threads * systemNN->sizeDataSystem * sizeof(float));
+  batch.runs        = (CalibrationRun*)malloc(threads * sizeof(CalibrationRun));
+
+  CalibrationRun best;
+  best.u = 0.0;
+  best.finalValue = 0.0;
+  best.penalty = 1;
+
+  // the state space plants have the steady state in closed form, so one run is needed for the maxima
+  StateSpace *plant = getSystemStateSpace(systemNN->func_system, systemNN->signal->dt);
+  if(plant != NULL && plant->inputs == 1 && plant->outputs == 1 && StateSpace_DcGain(plant, &gain) && gain > 0.0){
+    batch.runs[0].u = maxSig / gain;
+    calibrationTask(0, 0, &batch);
+    best = batch.runs[0];
+
+    if(best.penalty == 0){
+      memcpy(Data, best.data, 12 * sizeof(float));
+      free(batch.dataSystems);
+      free(batch.runs);
+      return;
+    }
+    // the output leaves the limits on the way, so the search is made under the analytic value
+    high  = best.u;
+    found = 1;
+  }
+
+  // bracketing: u = 1, 2, 4, ... until the steady state reaches the maximum of signal, the count of the tried u is
+  // capped for all the threads together, so u stays finite for any number of threads
+  float next = 1.0;
+  int expansions = 0;
+  while(found == 0 && expansions < CALIBRATION_MAX_EXPANSIONS){
+    size_t count = 0;
+    while(count < threads && expansions < CALIBRATION_MAX_EXPANSIONS){
+      batch.runs[count++].u = next;
+      next *= 2.0;
+      expansions++;
+    }
+    Parallel_For(count, count, calibrationTask, &batch);
+    keepBestRun(&batch, count, &best);
+
+    for(size_t i=0; i<count; i++){
+      if(calibrationIsAbove(&batch.runs[i], maxSig)){
+        high  = batch.runs[i].u;
+        found = 1;
+        break;
+      }
+      low = batch.runs[i].u;
+    }
+  }
+
+  // k-section: all threads test points inside the bracket, the bracket shrinks (threads + 1) times per round
+  while(found == 1 && high - low > CALIBRATION_TOLERANCE * high){
+    const float width = high - low;
+    for(size_t i=0; i<threads; i++){
+      batch.runs[i].u = low + width * (float)(i + 1) / (float)(threads + 1);
+    }
+    Parallel_For(threads, threads, calibrationTask, &batch);
+    keepBestRun(&batch, threads, &best);
+
+    float newLow  = low;
+    float newHigh = high;
+    for(size_t i=0; i<threads; i++){
+      if(calibrationIsAbove(&batch.runs[i], maxSig)){
+        newHigh = batch.runs[i].u;
+        break;
+      }
+      newLow = batch.runs[i].u;
+    }
+    low  = newLow;
+    high = newHigh;
+  }
+
+  memcpy(Data, best.data, 12 * sizeof(float));
+
+  free(batch.dataSystems);
+  free(batch.runs);
+}
+
+static uint64_t makeNormalizationKey(struct SystemNN *systemNN){
+  // the calibration depends only on the plant, the signal, the controller rate and the limits
+  uint64_t key = NormalizationCache_HashStart();
+
+  const int systemId = getSystemId(systemNN->func_system);
+  key = NormalizationCache_HashBytes(key, &systemId, sizeof(systemId));
+  key = NormalizationCache_HashBytes(key, &systemNN->sizeDataSystem, sizeof(systemNN->sizeDataSystem));
+
+  StateSpace *plant = getSystemStateSpace(systemNN->func_system, systemNN->signal->dt);
+  if(plant != NULL){
+    key = NormalizationCache_HashBytes(key, plant->A, plant->states  * plant->states * sizeof(float));
+    key = NormalizationCache_HashBytes(key, plant->B, plant->states  * plant->inputs * sizeof(float));
+    key = NormalizationCache_HashBytes(key, plant->C, plant->outputs * plant->states * sizeof(float));
+    key = NormalizationCache_HashBytes(key, plant->D, plant->outputs * plant->inputs * sizeof(float));
+  }
 
-  float forValueTwo[]  = {Data[1] - 100.0, Data[1] + 100.0, 10.0};
-  findUOneRound(systemNN, &forValueTwo, Data);
+  key = NormalizationCache_HashBytes(key, &systemNN->signal->dt, sizeof(systemNN->signal->dt));
+  key = NormalizationCache_HashBytes(key, &systemNN->decimation, sizeof(systemNN->decimation));
+  key = NormalizationCache_HashBytes(key, &systemNN->signal->length, sizeof(systemNN->signal->length));
+  key = NormalizationCache_HashBytes(key, systemNN->signal->signal, systemNN->signal->length * sizeof(float));
 
-  float forValueThree[] = {Data[1] - 10.0, Data[1] + 10.0, 1.0};
-  findUOneRound(systemNN, &forValueThree, Data);
+  key = NormalizationCache_HashBytes(key, &systemNN->maxSys, sizeof(systemNN->maxSys));
+  key = NormalizationCache_HashBytes(key, &systemNN->minSys, sizeof(systemNN->minSys));
+  return key;
 }
 
 static float makeDerivation(float *x, float *x_t, float *dt){
@@ -255,67 +415,76 @@ void createDeNormalization(struct SystemNN *systemNN){
   // get min and max of function
   float *Data = (float*)malloc(12 * sizeof(float));
 
-  findUForSystemAndSignal(systemNN, Data);
+  // the calibration is made only for the new set up or when it is forced
+  const uint64_t key = makeNormalizationKey(systemNN);
+  int verbose = 0;
+  if(systemNN->recalibrate == 1 || NormalizationCache_Load(NORMALIZATION_CACHE_FILE, key, Data) == 0){
+    findUForSystemAndSignal(systemNN, Data);
+    NormalizationCache_Save(NORMALIZATION_CACHE_FILE, key, Data);
+    verbose = 1;
+  } else {
+    printf("Normalization loaded from cache %016llx\n", (unsigned long long)key);
+  }
 
   // e 
   normalization[0][0]  = Data[0];
   normalization[1][0]  = Data[0] * (-1);
-  printf("E - %f\n", Data[0]);
+  if(verbose) { printf("E - %f\n", Data[0]); }
 
   // u
   normalization[0][1]  = Data[1];
   normalization[1][1]  = Data[1] * (-1);
-  printf("U - %f\n", Data[1]);
+  if(verbose) { printf("U - %f\n", Data[1]); }
 
   // y
   normalization[0][2]  = Data[2];
   normalization[1][2]  = Data[2] * (-1);
-  printf("Y - %f\n", Data[2]);
+  if(verbose) { printf("Y - %f\n", Data[2]); }
 
   // de 
   normalization[0][3]  = Data[3];        // bigest possible result
   normalization[1][3]  = Data[3] * (-1); // smallest possible result
-  printf("dE - %f\n", Data[3]);
+  if(verbose) { printf("dE - %f\n", Data[3]); }
 
   // dde 
   normalization[0][4]  = Data[4];        // bigest possible result
   normalization[1][4]  = Data[4] * (-1); // smallest possible result
-  printf("dE2 - %f\n", Data[4]);
+  if(verbose) { printf("dE2 - %f\n", Data[4]); }
 
   // ie
   normalization[0][5]  = Data[5];        
   normalization[1][5]  = Data[5] * (-1); 
-  printf("iE - %f\n", Data[5]);
+  if(verbose) { printf("iE - %f\n", Data[5]); }
 
   // du 
   normalization[0][6]  = Data[6];        // bigest possible result
   normalization[1][6]  = Data[6] * (-1); // smallest possible result
-  printf("dU - %f\n", Data[6]);
+  if(verbose) { printf("dU - %f\n", Data[6]); }
 
   // ddu 
   normalization[0][7]  = Data[7];        // bigest possible result
   normalization[1][7]  = Data[7] * (-1); // smallest possible result
-  printf("dU2 - %f\n", Data[7]);
+  if(verbose) { printf("dU2 - %f\n", Data[7]); }
 
   // iu
   normalization[0][8]  = Data[8];        
   normalization[1][8]  = Data[8] * (-1); 
-  printf("iU - %f\n", Data[8]);
+  if(verbose) { printf("iU - %f\n", Data[8]); }
 
   // dy
   normalization[0][9]  = Data[9];        // bigest possible result
   normalization[1][9]  = Data[9] * (-1); // smallest possible result
-  printf("dY - %f\n", Data[9]);
+  if(verbose) { printf("dY - %f\n", Data[9]); }
 
   // ddy 
   normalization[0][10] = Data[10];        // bigest possible result
   normalization[1][10] = Data[10] * (-1); // smallest possible result
-  printf("dY2 - %f\n", Data[10]);
+  if(verbose) { printf("dY2 - %f\n", Data[10]); }
 
   // iy
   normalization[0][11] = Data[11];        
   normalization[1][11] = Data[11] * (-1); 
-  printf("iY - %f\n", Data[11]);
+  if(verbose) { printf("iY - %f\n", Data[11]); }
 
   // 10 * e
   // for(int i=0; i<12; i++){
@@ -334,7 +503,7 @@ void createDeNormalization(struct SystemNN *systemNN){
   for(int i = 0; i < systemNN->inputDataSize[2] - 1; i++){
     systemNN->neuralNetwork->normalizationMatrix[0][i] = normalization[0][systemNN->inputTypes[i]];
     systemNN->neuralNetwork->normalizationMatrix[1][i] = normalization[1][systemNN->inputTypes[i]];
-    printf("%d - MAX: %f MIN: %f\n", i, systemNN->neuralNetwork->normalizationMatrix[0][i], systemNN->neuralNetwork->normalizationMatrix[1][i]);
+    if(verbose) { printf("%d - MAX: %f MIN: %f\n", i, systemNN->neuralNetwork->normalizationMatrix[0][i], systemNN->neuralNetwork->normalizationMatrix[1][i]); }
   }
 
   systemNN->neuralNetwork->denormalizationMatrix[0][0] = normalization[0][1];
@@ -349,81 +518,64 @@ void createDeNormalization(struct SystemNN *systemNN){
   free(systemNN->inputTypes);
 }
 
-void makeSimulationOfSignalNN(struct SystemNN *systemNN, FILE *csvFile, int csv){
-  cleanNNSystem(systemNN);
-  clearSDMemory(systemNN->neuralNetwork);
-  
-  float error, diff;
-  float neuralOutput = 0.0;
-  float systemOutput = 0.0;
+void makeSimulationOfSignalNN(struct SystemNN *systemNN, const float *weights, FILE *csvFile, int csv){
+  // the run is made by the same kernel as nnFitFunction, so the replayed fit is the fit seen by the GA and the
+  // decimation and the zero-order hold are the tested ones. The trace needs all the steps, so no fast forward here
+  const int fastForward = systemNN->fastForward;
+  systemNN->fastForward = 0;
+  ClosedLoopLayout *layout = createClosedLoopLayout(systemNN);
+  systemNN->fastForward = fastForward;
+
+  ClosedLoopState *state = ClosedLoopKernel_CreateState(layout);
+  ClosedLoopKernel_Reset(layout, state, weights);
 
-  int matrixIndex;
+  const int useMetrics = systemNN->metrics.mask != 0;
+  if(useMetrics){ ControlMetrics_Reset(&systemNN->metrics); }
 
   float max = 0.0;
 
+  systemNN->output->signal[0] = 0.0;
   for(int i=1; i<systemNN->signal->length; i++){
+    systemNN->output->signal[i] = ClosedLoopKernel_Step(layout, state, systemNN->signal->signal[i]);
 
-    error = systemNN->signal->signal[i] - systemNN->output->signal[i-1];
-
-    // now the input for the NN is generated
-    systemNN->inputData[1] = error;        // e
-    systemNN->inputData[2] = neuralOutput; // u
-    systemNN->inputData[3] = systemOutput; // y
-
-    systemNN->input_sys(systemNN->inputData);
-
-    // now the input matrix is created and filled
-    struct Matrix *inputMatrix  = (struct Matrix*)malloc(sizeof(struct Matrix));
-    struct Matrix *outputMatrix = (struct Matrix*)malloc(sizeof(struct Matrix));
-
-    int *inputSize = (int *)malloc(2 * sizeof(int));
-    inputSize[0] = systemNN->neuralNetwork->neuronsSize[0];
-    inputSize[1] = 1;
-
-    createMatrix(inputMatrix, inputSize);
-
-    matrixIndex = 0;
-    for(int j=systemNN->inputDataSize[1]; j<systemNN->inputDataSize[2]; j++){
-      inputMatrix->matrix[matrixIndex][0] = systemNN->inputData[j];
-      matrixIndex++;
+    // state->u is the NN output before the plant gain, held between the controller steps
+    if(state->u > max){
+      max = state->u;
     }
-    // now the matrix calculation can be made
-    oneCalculation(systemNN->neuralNetwork, inputMatrix, outputMatrix);
 
-    if(outputMatrix->matrix[0][0] > max){
-      max = outputMatrix->matrix[0][0];
+    if(csv == 1 && systemNN->trace != NULL){
+      const float record[4] = {systemNN->output->signal[i], systemNN->signal->signal[i], state->u, systemNN->output->signal[i]};
+      TraceWriter_Append(systemNN->trace, record);
+    } else if(csv == 1){
+      fprintf(csvFile, "%f,%f,%f,%f\n", systemNN->output->signal[i], systemNN->signal->signal[i], state->u, systemNN->output->signal[i]);
     }
 
-    systemNN->dataSystem[0] = outputMatrix->matrix[0][0]; // the values of the calculation
-    neuralOutput = systemNN->dataSystem[0]; // the next round u is set for input
-
-    // set data and pass to system
-    systemNN->output->signal[i] = systemNN->func_system(systemNN->dataSystem);
-
-    if(systemNN->output->signal[i] > systemNN->maxSys){
-        systemNN->output->signal[i] = systemNN->maxSys;
-        systemNN->maxCounter++;
-    } else if(systemNN->output->signal[i] < systemNN->minSys){
-        systemNN->output->signal[i] = systemNN->minSys;
-        systemNN->maxCounter++;
+    if(useMetrics){
+      ControlMetrics_Update(&systemNN->metrics, systemNN->signal->signal[i], systemNN->output->signal[i], state->data[0]);
     }
-    systemOutput = systemNN->output->signal[i]; // y is set for next round input
-
-    if(csv == 1){
-      fprintf(csvFile, "%f,%f,%f,%f\n", systemNN->output->signal[i], systemNN->signal->signal[i], outputMatrix->matrix[0][0], systemNN->output->signal[i]);
-    } 
+  }
 
-    diff = fabs(systemNN->signal->signal[i] - systemNN->output->signal[i]);
-    systemNN->fit += diff;
+  systemNN->fit = state->fit;
+  if(useMetrics){
+    ControlMetrics_Finish(&systemNN->metrics);
+    systemNN->fit = ControlMetrics_Fitness(&systemNN->metrics);
+  }
+  systemNN->maxCounter = state->maxCounter;
+  systemNN->steadyRiseCheck = state->steadyRiseCheck;
 
-    if(systemNN->output->signal[i-1] > systemNN->output->signal[i]){
-        systemNN->steadyRiseCheck++;
-    }
+  // the plant memory is the first part of the state, it is kept for the cost counters of the adaptive plants
+  memcpy(systemNN->dataSystem, state->data, systemNN->sizeDataSystem * sizeof(float));
 
-    matrixDelete(outputMatrix);
-  }
   if(csv == 1){
     printf("%f\n", max);
+
+    // the adaptive plants report the cost against the fixed Euler step per sample
+    OdeStats stats;
+    if(getSystemStepStats(systemNN->func_system, systemNN->dataSystem, &stats)){
+      OdeIntegrator_PrintStats(&stats, 1);
+    }
   }
 
-}
\ No newline at end of file
+  ClosedLoopKernel_DestroyState(state);
+  ClosedLoopKernel_DestroyLayout(layout);
+}
@@ -280,6 +280,7 @@ static void makeSDLayerAction(struct NN *neuralNetwork, struct Matrix *input, in
   for(int i=0; i<neuralNetwork->neuronsSize[layerIndex]; i++){
     if(neuralNetwork->sdNeuronsTypes[sdIndex][i] == 2){
       neuralNetwork->SDMemory[sdIndex]->matrix[i][0] = DSDMemory[indexD];
+      indexD++;
     }
   }
   
@@ -0,0 +1,178 @@
+/**
+ * @file normalization_cache.c
+ * @brief On-disk cache of the normalization calibration public interface implementation.
+ *
+ * The file is a header followed by fixed size records:
+ * [magic 8B][version 4B][count 4B] then count times [key 8B][table 12 * 4B]
+ */
+
+// flock, mkstemp and fchmod are not in C
+#define _GNU_SOURCE
+
+#include "neural/normalization_cache.h"
+
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define NORMALIZATION_CACHE_VERSION 1u
+#define NORMALIZATION_CACHE_MAX_RECORDS 256u
+
+static const char NORMALIZATION_CACHE_MAGIC[8] = {'N', 'N', 'G', 'A', 'N', 'O', 'R', 'M'};
+
+/**
+ * @struct NormalizationRecord
+ * @brief One saved calibration.
+ * @ingroup NormalizationCache
+ */
+typedef struct NormalizationRecord {
+  uint64_t key;                              // hash of the set up
+  float table[NORMALIZATION_CACHE_ENTRIES];  // the calibration table
+} NormalizationRecord;
+
+//=============================================================================
+//
+//                     Normalization Cache Utility Helper Functions
+//
+//=============================================================================
+
+/*!
+ * @ingroup NormalizationCache
+ * @brief Read all records of the cache file.
+ * @param path the cache file.
+ * @param records the output array of NORMALIZATION_CACHE_MAX_RECORDS records.
+ * @return The number of records read, 0 for missing or invalid file.
+ */
+static uint32_t NormalizationCache_ReadAll(const char *path, NormalizationRecord *records){
+  FILE *file = fopen(path, "rb");
+  if (file == NULL) { return 0; }
+
+  char magic[8];
+  uint32_t version = 0;
+  uint32_t count = 0;
+
+  if (fread(magic, sizeof(magic), 1, file) != 1 || memcmp(magic, NORMALIZATION_CACHE_MAGIC, sizeof(magic)) != 0 ||
+      fread(&version, sizeof(version), 1, file) != 1 || version != NORMALIZATION_CACHE_VERSION ||
+      fread(&count, sizeof(count), 1, file) != 1 || count > NORMALIZATION_CACHE_MAX_RECORDS){
+    fclose(file);
+    return 0;
+  }
+
+  if (fread(records, sizeof(NormalizationRecord), count, file) != count) { count = 0; }
+
+  fclose(file);
+  return count;
+}
+
+
+
+//=============================================================================
+//
+//                     Normalization Cache Key Functions
+//
+//=============================================================================
+
+uint64_t NormalizationCache_HashStart(void){ return 1469598103934665603ull; }
+
+uint64_t NormalizationCache_HashBytes(uint64_t hash, const void *data, const size_t size){
+  assert((data != NULL || size == 0) && "data pointer should not be NULL!");
+
+  const unsigned char *bytes = data;
+  for (size_t i = 0; i < size; i++){
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+
+
+//=============================================================================
+//
+//                     Normalization Cache Storage Functions
+//
+//=============================================================================
+
+int NormalizationCache_Load(const char *path, const uint64_t key, float *table){
+  assert(path  != NULL && "path should not be NULL!");
+  assert(table != NULL && "table should not be NULL!");
+
+  NormalizationRecord *records = malloc(NORMALIZATION_CACHE_MAX_RECORDS * sizeof(NormalizationRecord));
+  if (records == NULL){ perror("Failed to allocate Normalization Cache records"); exit(EXIT_FAILURE); }
+
+  const uint32_t count = NormalizationCache_ReadAll(path, records);
+
+  int found = 0;
+  for (uint32_t i = 0; i < count && found == 0; i++){
+    if (records[i].key == key){
+      memcpy(table, records[i].table, sizeof(records[i].table));
+      found = 1;
+    }
+  }
+
+  free(records);
+  return found;
+}
+
+int NormalizationCache_Save(const char *path, const uint64_t key, const float *table){
+  assert(path  != NULL && "path should not be NULL!");
+  assert(table != NULL && "table should not be NULL!");
+
+  // the read, merge and rename are made under the lock, so the record of the concurrent run is not lost. The lock
+  // is taken on the side file, the cache itself is replaced by the rename and the lock on it would stay on the old file
+  char name[1024];
+  snprintf(name, sizeof(name), "%s.lock", path);
+
+  const int lock = open(name, O_RDWR | O_CREAT, 0644);
+  if (lock < 0) { return 0; }
+  if (flock(lock, LOCK_EX) != 0) { close(lock); return 0; }
+
+  NormalizationRecord *records = malloc(NORMALIZATION_CACHE_MAX_RECORDS * sizeof(NormalizationRecord));
+  if (records == NULL){ perror("Failed to allocate Normalization Cache records"); exit(EXIT_FAILURE); }
+
+  uint32_t count = NormalizationCache_ReadAll(path, records);
+
+  // the record of the key is replaced, new key is added, the oldest record drops out of the full cache
+  uint32_t index = count;
+  for (uint32_t i = 0; i < count; i++){
+    if (records[i].key == key) { index = i; }
+  }
+  if (index == NORMALIZATION_CACHE_MAX_RECORDS){
+    memmove(records, records + 1, (NORMALIZATION_CACHE_MAX_RECORDS - 1) * sizeof(NormalizationRecord));
+    index = NORMALIZATION_CACHE_MAX_RECORDS - 1;
+  }
+  if (index == count) { count++; }
+
+  records[index].key = key;
+  memcpy(records[index].table, table, sizeof(records[index].table));
+
+  // the file is written aside with the unique name in the same directory and renamed, so the readers without the
+  // lock never see half written cache
+  snprintf(name, sizeof(name), "%s.XXXXXX", path);
+
+  int written = 0;
+  const int descriptor = mkstemp(name);
+  FILE *file = descriptor < 0 ? NULL : fdopen(descriptor, "wb");
+  if (file != NULL){
+    const uint32_t version = NORMALIZATION_CACHE_VERSION;
+    written = fchmod(descriptor, 0644) == 0 &&
+              fwrite(NORMALIZATION_CACHE_MAGIC, sizeof(NORMALIZATION_CACHE_MAGIC), 1, file) == 1 &&
+              fwrite(&version, sizeof(version), 1, file) == 1 &&
+              fwrite(&count, sizeof(count), 1, file) == 1 &&
+              fwrite(records, sizeof(NormalizationRecord), count, file) == count;
+    written = fclose(file) == 0 && written && rename(name, path) == 0;
+  } else if (descriptor >= 0){
+    close(descriptor);
+  }
+  if (descriptor >= 0 && written == 0) { remove(name); }
+
+  free(records);
+  flock(lock, LOCK_UN);
+  close(lock);
+  return written;
+}
@@ -0,0 +1,96 @@
+//
+// The tests of the min-max Chromosome Heap
+//
+#include "chromosome_heap.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "unity/unity.h"
+
+#define CHROMOSOMES 200
+
+Chromosome *chromosomes[CHROMOSOMES];
+ChromosomeHeap *usedHeap;
+
+static float randomFit(void){
+  return (float)(rand() % 1000) / 10.0f;
+}
+
+// the brute force best and worst of the heap
+static void assertBestAndWorst(void){
+  float best = ChromosomeHeap_GetFit(usedHeap, 0);
+  float worst = best;
+  for (size_t i = 0; i < ChromosomeHeap_GetSize(usedHeap); i++){
+    const float fit = ChromosomeHeap_GetFit(usedHeap, i);
+    TEST_ASSERT_EQUAL_FLOAT(fit, Chromosome_GetFit(ChromosomeHeap_GetChromosome(usedHeap, i)));
+    if (fit < best)  { best = fit; }
+    if (fit > worst) { worst = fit; }
+  }
+
+  TEST_ASSERT_EQUAL_FLOAT(best,  Chromosome_GetFit(ChromosomeHeap_PeekBest(usedHeap)));
+  TEST_ASSERT_EQUAL_FLOAT(worst, Chromosome_GetFit(ChromosomeHeap_PeekWorst(usedHeap)));
+}
+
+void setUp(void){
+  srand(3);
+  for (int i = 0; i < CHROMOSOMES; i++){
+    chromosomes[i] = Chromosome_Create(2);
+    Chromosome_SetFit(chromosomes[i], randomFit());
+  }
+  usedHeap = ChromosomeHeap_Create(CHROMOSOMES / 2);
+}
+
+void tearDown(void){
+  ChromosomeHeap_Destroy(usedHeap);
+  for (int i = 0; i < CHROMOSOMES; i++){ Chromosome_Destroy(chromosomes[i]); }
+}
+
+// the heap grows over its capacity and keeps the best and the worst on each insert
+void testChromosomeHeap_Insert(void){
+  for (int i = 0; i < CHROMOSOMES; i++){
+    ChromosomeHeap_Insert(usedHeap, chromosomes[i]);
+    TEST_ASSERT_EQUAL(ChromosomeHeap_GetSize(usedHeap), i + 1);
+    assertBestAndWorst();
+  }
+}
+
+// the removed chromosome is the worst one, it is reused with the new fit as the steady state GA does
+void testChromosomeHeap_ReplaceWorst(void){
+  for (int i = 0; i < CHROMOSOMES / 2; i++){ ChromosomeHeap_Insert(usedHeap, chromosomes[i]); }
+
+  Chromosome *spare = chromosomes[CHROMOSOMES / 2];
+  for (int i = 0; i < 1000; i++){
+    const float worst = Chromosome_GetFit(ChromosomeHeap_PeekWorst(usedHeap));
+
+    Chromosome_SetFit(spare, randomFit());
+    spare = ChromosomeHeap_ReplaceWorst(usedHeap, spare);
+
+    TEST_ASSERT_EQUAL_FLOAT(worst, Chromosome_GetFit(spare));
+    TEST_ASSERT_EQUAL(ChromosomeHeap_GetSize(usedHeap), CHROMOSOMES / 2);
+    assertBestAndWorst();
+  }
+}
+
+void testChromosomeHeap_Small(void){
+  ChromosomeHeap_Insert(usedHeap, chromosomes[0]);
+  TEST_ASSERT_EQUAL_PTR(chromosomes[0], ChromosomeHeap_PeekBest(usedHeap));
+  TEST_ASSERT_EQUAL_PTR(chromosomes[0], ChromosomeHeap_PeekWorst(usedHeap));
+
+  TEST_ASSERT_EQUAL_PTR(chromosomes[0], ChromosomeHeap_ReplaceWorst(usedHeap, chromosomes[1]));
+  TEST_ASSERT_EQUAL_PTR(chromosomes[1], ChromosomeHeap_PeekBest(usedHeap));
+
+  Chromosome_SetFit(chromosomes[2], Chromosome_GetFit(chromosomes[1]) + 1.0f);
+  ChromosomeHeap_Insert(usedHeap, chromosomes[2]);
+  TEST_ASSERT_EQUAL_PTR(chromosomes[1], ChromosomeHeap_PeekBest(usedHeap));
+  TEST_ASSERT_EQUAL_PTR(chromosomes[2], ChromosomeHeap_PeekWorst(usedHeap));
+}
+
+int main(void){
+  UNITY_BEGIN();
+
+  RUN_TEST(testChromosomeHeap_Insert);
+  RUN_TEST(testChromosomeHeap_ReplaceWorst);
+  RUN_TEST(testChromosomeHeap_Small);
+
+  return UNITY_END();
+}
@@ -0,0 +1,82 @@
+#include "general/control_metrics.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "unity/unity.h"
+
+#define DT 0.001f
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// first order response to the unit step at t = 1 with the time constant tau, the u is the constant 1
+static void feedFirstOrder(ControlMetrics *metrics, const float tau, const int steps){
+  for (int k = 0; k < steps; k++){
+    const float t = k * DT;
+    const float reference = t < 1.0f ? 0.0f : 1.0f;
+    const float output = t < 1.0f ? 0.0f : 1.0f - expf(-(t - 1.0f) / tau);
+    ControlMetrics_Update(metrics, reference, output, 1.0f);
+  }
+}
+
+void testControlMetrics_FirstOrderStep(void){
+  ControlMetrics metrics;
+  ControlMetrics_Init(&metrics, CONTROL_METRIC_ALL, NULL, DT);
+
+  feedFirstOrder(&metrics, 0.5f, 6000);
+  ControlMetrics_Finish(&metrics);
+
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.5f, metrics.values[CONTROL_METRIC_IAE]);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.25f, metrics.values[CONTROL_METRIC_ISE]);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.0f, metrics.values[CONTROL_METRIC_OVERSHOOT]);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.5f * logf(9.0f), metrics.values[CONTROL_METRIC_RISE]);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.5f * logf(50.0f), metrics.values[CONTROL_METRIC_SETTLING]);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 6.0f, metrics.values[CONTROL_METRIC_EFFORT]);
+}
+
+void testControlMetrics_OvershootAndMask(void){
+  const float weights[CONTROL_METRIC_COUNT] = {0, 0, 0, 10.0f, 0, 0, 0};
+
+  ControlMetrics metrics;
+  ControlMetrics_Init(&metrics, CONTROL_METRIC_BIT(CONTROL_METRIC_OVERSHOOT) | CONTROL_METRIC_BIT(CONTROL_METRIC_IAE), weights, DT);
+
+  // the step from 2 to 4 with the 25 % overshoot
+  for (int k = 0; k < 1000; k++){ ControlMetrics_Update(&metrics, 2.0f, 2.0f, 0.0f); }
+  for (int k = 0; k < 1000; k++){ ControlMetrics_Update(&metrics, 4.0f, k < 500 ? 4.5f : 4.0f, 0.0f); }
+  ControlMetrics_Finish(&metrics);
+
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.25f, metrics.values[CONTROL_METRIC_OVERSHOOT]);
+  TEST_ASSERT_FLOAT_WITHIN(1e-4f, 2.5f, ControlMetrics_Fitness(&metrics));
+}
+
+void testControlMetrics_ConstantMatchesUpdates(void){
+  ControlMetrics repeated;
+  ControlMetrics constant;
+  ControlMetrics_Init(&repeated, CONTROL_METRIC_ALL, NULL, DT);
+  ControlMetrics_Init(&constant, CONTROL_METRIC_ALL, NULL, DT);
+
+  feedFirstOrder(&repeated, 0.2f, 2000);
+  feedFirstOrder(&constant, 0.2f, 2000);
+
+  for (int k = 0; k < 3000; k++){ ControlMetrics_Update(&repeated, 1.0f, 0.9f, 2.0f); }
+  ControlMetrics_UpdateConstant(&constant, 1.0f, 0.9f, 2.0f, 3000);
+
+  ControlMetrics_Finish(&repeated);
+  ControlMetrics_Finish(&constant);
+
+  for (int i = 0; i < CONTROL_METRIC_COUNT; i++){
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f * (1.0f + fabsf(repeated.values[i])), repeated.values[i], constant.values[i]);
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(testControlMetrics_FirstOrderStep);
+  RUN_TEST(testControlMetrics_OvershootAndMask);
+  RUN_TEST(testControlMetrics_ConstantMatchesUpdates);
+
+  return UNITY_END();
+}
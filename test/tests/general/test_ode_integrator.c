@@ -0,0 +1,67 @@
+#include "general/ode_integrator.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "unity/unity.h"
+
+OdeIntegrator *integrator;
+
+static void decay(const float t, const float *x, const float u, float *dx, void *context){
+  (void)t; (void)context;
+  dx[0] = u - x[0];
+}
+
+static void oscillator(const float t, const float *x, const float u, float *dx, void *context){
+  (void)t; (void)u; (void)context;
+  dx[0] =  x[1];
+  dx[1] = -x[0];
+}
+
+void setUp(void){ integrator = NULL; }
+void tearDown(void){ OdeIntegrator_Destroy(integrator); }
+
+void testOdeIntegrator_Decay(void){
+  integrator = OdeIntegrator_Create(decay, NULL, 1, 1e-6f, 1e-8f);
+
+  float x = 1.0f;
+  for (int i = 0; i < 10; i++){ OdeIntegrator_Integrate(integrator, &x, 0.0f, 0.1f); }
+
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, expf(-1.0f), x);
+  TEST_ASSERT_EQUAL(10, integrator->stats.intervals);
+}
+
+void testOdeIntegrator_ZeroOrderHoldInput(void){
+  integrator = OdeIntegrator_Create(decay, NULL, 1, 1e-6f, 1e-8f);
+
+  float x = 0.0f;
+  OdeIntegrator_Integrate(integrator, &x, 2.0f, 1.0f);
+
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, 2.0f * (1.0f - expf(-1.0f)), x);
+}
+
+void testOdeIntegrator_FewStepsForSmoothDynamics(void){
+  integrator = OdeIntegrator_Create(oscillator, NULL, 2, 1e-5f, 1e-7f);
+
+  float x[] = {1.0f, 0.0f};
+  const int intervals = 10;
+  for (int i = 0; i < intervals; i++){ OdeIntegrator_Integrate(integrator, x, 0.0f, 0.6283185f); }
+
+  // one full period brings the oscillator back
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, 1.0f, x[0]);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, 0.0f, x[1]);
+
+  // Euler would need thousands of steps for this accuracy
+  TEST_ASSERT_TRUE(integrator->stats.acceptedSteps < 100);
+}
+
+int main(void){
+  UNITY_BEGIN();
+
+  RUN_TEST(testOdeIntegrator_Decay);
+  RUN_TEST(testOdeIntegrator_ZeroOrderHoldInput);
+  RUN_TEST(testOdeIntegrator_FewStepsForSmoothDynamics);
+
+  return UNITY_END();
+}
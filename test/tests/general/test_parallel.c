@@ -0,0 +1,43 @@
+#include "general/parallel.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "unity/unity.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void squareTask(const size_t index, const size_t thread, void *context){
+  (void)thread;
+  int *values = context;
+  values[index] = (int)(index * index);
+}
+
+void testParallel_ForVisitsAllIndexes(void){
+  const size_t count = 1000;
+  int *values = calloc(count, sizeof(int));
+
+  Parallel_For(count, 4, squareTask, values);
+
+  for (size_t i = 0; i < count; i++){ TEST_ASSERT_EQUAL_INT((int)(i * i), values[i]); }
+  free(values);
+}
+
+void testParallel_ForSingleThread(void){
+  int values[3] = {-1, -1, -1};
+
+  Parallel_For(3, 1, squareTask, values);
+
+  const int correct[] = {0, 1, 4};
+  TEST_ASSERT_EQUAL_INT_ARRAY(correct, values, 3);
+}
+
+int main(void){
+  UNITY_BEGIN();
+
+  RUN_TEST(testParallel_ForVisitsAllIndexes);
+  RUN_TEST(testParallel_ForSingleThread);
+
+  return UNITY_END();
+}
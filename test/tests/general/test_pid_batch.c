@@ -0,0 +1,146 @@
+#include "general/pid_batch.h"
+#include "general/pid_controller.h"
+#include "general/signal_generator.h"
+#include "general/systems_builder.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "unity/unity.h"
+
+#define GENOMES 37
+#define DT 0.01f
+
+static Signal reference;
+static Signal output;
+static float dataSystem[64];
+static PID pid;
+
+static float genomeData[GENOMES][4];
+static float *genomes[GENOMES];
+
+// the plant without the state space model, stepped for each lane
+static float secondOrder(float *data){
+  data[3] += data[1] * (data[0] - data[2] - 0.5f * data[3]);
+  data[2] += data[1] * data[3];
+  return data[2];
+}
+
+// build the pid by hand, createNewPidController asks the CLI
+static void preparePid(float (*func_system)(float*), const int sizeDataSystem){
+  prepareSystem(func_system, DT);
+
+  pid.signal         = &reference;
+  pid.output         = &output;
+  pid.func_system    = func_system;
+  pid.sizeDataSystem = sizeDataSystem;
+  pid.dataSystem     = dataSystem;
+
+  pid.tauI = 1;
+  pid.limMax = 10;
+  pid.limMin = -10;
+  pid.limMaxInt = 5;
+  pid.limMinInt = -5;
+  pid.plantGain = 1;
+  pid.trace = NULL;
+
+  ControlMetrics_Init(&pid.metrics, 0, NULL, DT);
+}
+
+// the fits of the batch should be the same bits as the one by one simulation
+static void assertSameAsPid(void){
+  float fit[GENOMES];
+  PidBatch *batch = PidBatch_Create(&pid, 3);
+  PidBatch_Evaluate(batch, genomes, GENOMES, fit);
+  PidBatch_Destroy(batch);
+
+  for (int i = 0; i < GENOMES; i++){
+    pid.Kp   = genomes[i][0];
+    pid.Ki   = genomes[i][1];
+    pid.Kd   = genomes[i][2];
+    pid.tauD = genomes[i][3];
+    makeSimulationOfSignal(&pid, NULL, 0);
+
+    TEST_ASSERT_EQUAL_MEMORY(&pid.fit, &fit[i], sizeof(float));
+  }
+}
+
+void setUp(void) {
+  const float map[3][3] = {{0.0f, 2.0f, 1.0f}, {2.0f, 4.0f, -0.5f}, {4.0f, 6.0f, 2.0f}};
+  SignalGenerator generator;
+  SignalGenerator_InitSteps(&generator, map, 3, DT);
+  SignalGenerator_Materialize(&generator, &reference);
+
+  output.dt = DT;
+  output.length = reference.length;
+  output.signal = malloc(reference.length * sizeof(float));
+
+  // a mix of good, oscillating and lazy controllers
+  for (int i = 0; i < GENOMES; i++){
+    genomeData[i][0] = 0.5f + 0.37f * (float)(i % 11);
+    genomeData[i][1] = 0.2f * (float)(i % 7);
+    genomeData[i][2] = 0.05f * (float)(i % 5);
+    genomeData[i][3] = 0.01f + 0.1f * (float)(i % 3);
+    genomes[i] = genomeData[i];
+  }
+}
+
+void tearDown(void) {
+  free(reference.signal);
+  free(output.signal);
+  releaseSystems();
+}
+
+void testPidBatch_StateSpacePlant(void){
+  preparePid(complexYDddotStateSpace, 5);
+  assertSameAsPid();
+}
+
+void testPidBatch_LanePlant(void){
+  preparePid(secondOrder, 4);
+  assertSameAsPid();
+}
+
+void testPidBatch_Metrics(void){
+  preparePid(complexYDddotStateSpace, 5);
+  const float weights[CONTROL_METRIC_COUNT] = {1, 2, 0.5f, 3, 1, 1, 0.01f};
+  ControlMetrics_Init(&pid.metrics, CONTROL_METRIC_ALL, weights, DT);
+  pid.plantGain = 0.8f;
+  assertSameAsPid();
+}
+
+// the plant prepared for the second dt keeps its own model, the runs with the first dt are not changed
+void testPidBatch_TwoSampleTimes(void){
+  preparePid(complexYDddotStateSpace, 5);
+  prepareSystem(complexYDddotStateSpace, 2 * DT);
+
+  const StateSpace *first = getSystemStateSpace(complexYDddotStateSpace, DT);
+  const StateSpace *second = getSystemStateSpace(complexYDddotStateSpace, 2 * DT);
+  TEST_ASSERT_NOT_NULL(first);
+  TEST_ASSERT_NOT_NULL(second);
+  TEST_ASSERT_EQUAL_FLOAT(DT, first->dt);
+  TEST_ASSERT_EQUAL_FLOAT(2 * DT, second->dt);
+
+  // two steps of dt are one step of 2 dt for the constant input
+  float fine[5] = {1.0f, DT, 0.0f, 0.0f, 0.0f};
+  float coarse[5] = {1.0f, 2 * DT, 0.0f, 0.0f, 0.0f};
+  for (int k = 0; k < 100; k++){
+    complexYDddotStateSpace(fine);
+    complexYDddotStateSpace(fine);
+    complexYDddotStateSpace(coarse);
+  }
+  TEST_ASSERT_FLOAT_WITHIN(1e-4f, fine[2], coarse[2]);
+
+  assertSameAsPid();
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(testPidBatch_StateSpacePlant);
+  RUN_TEST(testPidBatch_LanePlant);
+  RUN_TEST(testPidBatch_Metrics);
+  RUN_TEST(testPidBatch_TwoSampleTimes);
+
+  return UNITY_END();
+}
@@ -0,0 +1,184 @@
+#include "general/process_pool.h"
+
+#include <float.h>
+#include <dirent.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+#include "unity/unity.h"
+
+#define GENES 4
+#define ROWS 203
+
+static float memory[ROWS * GENES];
+static float *genomes[ROWS];
+static float fit[ROWS];
+
+// the state of the worker is made after the fork, it is the offset added to each fit
+static void* makeOffset(const size_t worker, void *context){
+  (void)worker;
+  float *offset = malloc(sizeof(float));
+  *offset = *(float*)context;
+  return offset;
+}
+
+static void sphere(float *const *rows, const size_t count, float *output, void *state){
+  for (size_t i = 0; i < count; i++){
+    output[i] = *(float*)state;
+    for (int g = 0; g < GENES; g++){ output[i] += rows[i][g] * rows[i][g]; }
+  }
+}
+
+// the row with the first gene 666 kills its worker in the middle of the chunk
+static void crashingSphere(float *const *rows, const size_t count, float *output, void *state){
+  for (size_t i = 0; i < count; i++){
+    if (rows[i][0] == 666.0f) { raise(SIGKILL); }
+  }
+  sphere(rows, count, output, state);
+}
+
+// the same crash, but the forked helper still holds the channel of the worker, so only its exit tells the crash
+static void orphaningSphere(float *const *rows, const size_t count, float *output, void *state){
+  for (size_t i = 0; i < count; i++){
+    if (rows[i][0] != 666.0f) { continue; }
+    if (fork() == 0){
+      close(STDOUT_FILENO);
+      close(STDERR_FILENO);
+      sleep(5);
+      _exit(EXIT_SUCCESS);
+    }
+    raise(SIGKILL);
+  }
+  sphere(rows, count, output, state);
+}
+
+static float expected(const int row, const float offset){
+  float value = offset;
+  for (int g = 0; g < GENES; g++){ value += genomes[row][g] * genomes[row][g]; }
+  return value;
+}
+
+void setUp(void){
+  for (int i = 0; i < ROWS; i++){
+    genomes[i] = memory + i * GENES;
+    for (int g = 0; g < GENES; g++){ genomes[i][g] = (float)(i % 17) - (float)g; }
+  }
+}
+void tearDown(void){}
+
+// the workers claim all the rows of each round, also the round smaller than the pool
+void testProcessPoolEvaluate(void){
+  float offset = 0.5f;
+  ProcessPool *pool = ProcessPool_Create(ROWS, GENES, 3, 8, makeOffset, sphere, free, &offset);
+  TEST_ASSERT_EQUAL_size_t(3, ProcessPool_GetWorkers(pool));
+
+  for (int round = 0; round < 5; round++){
+    const size_t count = round == 4 ? 10 : ROWS;
+    TEST_ASSERT_EQUAL_size_t(0, ProcessPool_Evaluate(pool, genomes, count, fit));
+    for (size_t i = 0; i < count; i++){ TEST_ASSERT_EQUAL_FLOAT(expected((int)i, offset), fit[i]); }
+  }
+
+  ProcessPool_Destroy(pool);
+}
+
+// the rows written into the shared memory are evaluated in place
+void testProcessPoolShared(void){
+  float offset = 0.0f;
+  ProcessPool *pool = ProcessPool_Create(ROWS, GENES, 2, 0, makeOffset, sphere, free, &offset);
+
+  float *shared = ProcessPool_GetGenomes(pool);
+  for (int i = 0; i < ROWS; i++){
+    for (int g = 0; g < GENES; g++){ shared[i * GENES + g] = genomes[i][g]; }
+  }
+
+  TEST_ASSERT_EQUAL_size_t(0, ProcessPool_EvaluateShared(pool, ROWS));
+  for (int i = 0; i < ROWS; i++){ TEST_ASSERT_EQUAL_FLOAT(expected(i, 0.0f), ProcessPool_GetFit(pool)[i]); }
+
+  ProcessPool_Destroy(pool);
+}
+
+// the crashed worker loses only its rows, the next round has all the workers again
+void testProcessPoolCrash(void){
+  float offset = 0.0f;
+  ProcessPool *pool = ProcessPool_Create(ROWS, GENES, 2, 4, makeOffset, crashingSphere, free, &offset);
+
+  genomes[50][0] = 666.0f;
+  const size_t failed = ProcessPool_Evaluate(pool, genomes, ROWS, fit);
+  TEST_ASSERT_TRUE(failed >= 1 && failed <= 4);
+  TEST_ASSERT_EQUAL_FLOAT(FLT_MAX, fit[50]);
+
+  size_t maxed = 0;
+  for (int i = 0; i < ROWS; i++){
+    if (fit[i] == FLT_MAX) { maxed++; }
+    else                   { TEST_ASSERT_EQUAL_FLOAT(expected(i, 0.0f), fit[i]); }
+  }
+  TEST_ASSERT_EQUAL_size_t(failed, maxed);
+
+  genomes[50][0] = 1.0f;
+  TEST_ASSERT_EQUAL_size_t(0, ProcessPool_Evaluate(pool, genomes, ROWS, fit));
+  TEST_ASSERT_EQUAL_FLOAT(expected(50, 0.0f), fit[50]);
+
+  ProcessPool_Destroy(pool);
+}
+
+// the workers do not hold the descriptors of the master, so the other channel still sees its end, and the
+// segment is not left in /dev/shm
+void testProcessPoolDescriptors(void){
+  int pair[2];
+  TEST_ASSERT_EQUAL_INT(0, socketpair(AF_UNIX, SOCK_STREAM, 0, pair));
+  const struct timeval timeout = {2, 0};
+  TEST_ASSERT_EQUAL_INT(0, setsockopt(pair[0], SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)));
+
+  float offset = 0.0f;
+  ProcessPool *pool = ProcessPool_Create(ROWS, GENES, 2, 0, makeOffset, sphere, free, &offset);
+
+  close(pair[1]);
+  char byte;
+  TEST_ASSERT_EQUAL_INT(0, (int)recv(pair[0], &byte, 1, 0));
+  close(pair[0]);
+
+  char prefix[64];
+  snprintf(prefix, sizeof(prefix), "ga_toolbox_%ld_", (long)getpid());
+  DIR *directory = opendir("/dev/shm");
+  if (directory != NULL){
+    for (struct dirent *entry = readdir(directory); entry != NULL; entry = readdir(directory)){
+      TEST_ASSERT_FALSE(strncmp(entry->d_name, prefix, strlen(prefix)) == 0);
+    }
+    closedir(directory);
+  }
+
+  TEST_ASSERT_EQUAL_size_t(0, ProcessPool_Evaluate(pool, genomes, ROWS, fit));
+  ProcessPool_Destroy(pool);
+}
+
+// the worker which died while its channel is held by the other process is found by the timeout of the master
+void testProcessPoolHeldChannel(void){
+  float offset = 0.0f;
+  ProcessPool *pool = ProcessPool_Create(ROWS, GENES, 2, 4, makeOffset, orphaningSphere, free, &offset);
+
+  genomes[50][0] = 666.0f;
+  const time_t start = time(NULL);
+  const size_t failed = ProcessPool_Evaluate(pool, genomes, ROWS, fit);
+  TEST_ASSERT_TRUE(time(NULL) - start < 4);
+  TEST_ASSERT_TRUE(failed >= 1 && failed <= 4);
+  TEST_ASSERT_EQUAL_FLOAT(FLT_MAX, fit[50]);
+
+  ProcessPool_Destroy(pool);
+}
+
+int main(void){
+  UNITY_BEGIN();
+
+  RUN_TEST(testProcessPoolEvaluate);
+  RUN_TEST(testProcessPoolShared);
+  RUN_TEST(testProcessPoolCrash);
+  RUN_TEST(testProcessPoolDescriptors);
+  RUN_TEST(testProcessPoolHeldChannel);
+
+  return UNITY_END();
+}
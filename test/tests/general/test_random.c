@@ -0,0 +1,135 @@
+#include "general/random.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include "unity/unity.h"
+
+#define SAMPLES 200000
+
+static float buffer[SAMPLES];
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// the same seed and stream give the same numbers, the other stream gives the other numbers
+void testRandomStreams(void){
+  Random a, b, c;
+  Random_Stream(&a, 42, 7);
+  Random_Stream(&b, 42, 7);
+  Random_Stream(&c, 42, 8);
+
+  int same = 0;
+  for (int i = 0; i < 1000; i++){
+    const uint64_t x = Random_Next(&a);
+    TEST_ASSERT_EQUAL_UINT64(x, Random_Next(&b));
+    if (x == Random_Next(&c)) { same++; }
+  }
+  TEST_ASSERT_EQUAL_INT(0, same);
+}
+
+// the seed and the stream are not interchangeable, and the seed equal to the stream does not give one state
+void testRandomStreamsAsymmetric(void){
+  Random a, b;
+  Random_Stream(&a, 1, 2);
+  Random_Stream(&b, 2, 1);
+  uint64_t x = Random_Next(&a);
+  uint64_t y = Random_Next(&b);
+  TEST_ASSERT_TRUE(x != y);
+
+  for (uint64_t i = 0; i < 16; i++){
+    Random_Stream(&a, i, i);
+    Random_Stream(&b, i + 1, i + 1);
+    x = Random_Next(&a);
+    y = Random_Next(&b);
+    TEST_ASSERT_TRUE(x != y);
+  }
+}
+
+// the xoshiro256++ reference output of the state {1, 2, 3, 4}
+void testRandomReference(void){
+  Random random = {{1, 2, 3, 4}};
+  const uint64_t expected[] = {41943041ULL, 58720359ULL, 3588806011781223ULL, 3591011842654386ULL};
+
+  for (int i = 0; i < 4; i++){ TEST_ASSERT_EQUAL_UINT64(expected[i], Random_Next(&random)); }
+}
+
+// the jumped copy does not repeat the numbers of the original stream
+void testRandomJump(void){
+  Random a, b;
+  Random_Seed(&a, 5);
+  b = a;
+  Random_Jump(&b);
+
+  for (int i = 0; i < 1000; i++){ TEST_ASSERT_TRUE(Random_Next(&a) != Random_Next(&b)); }
+}
+
+// the floats stay in the range and the bulk fill is the same as the single calls
+void testRandomUniform(void){
+  Random a, b;
+  Random_Seed(&a, 9);
+  Random_Seed(&b, 9);
+
+  Random_FillUniform(&a, buffer, SAMPLES, -2.0f, 3.0f);
+  double mean = 0.0;
+  for (int i = 0; i < SAMPLES; i++){
+    const float single = Random_Uniform(&b, -2.0f, 3.0f);
+    TEST_ASSERT_EQUAL_FLOAT(single, buffer[i]);
+    TEST_ASSERT_TRUE(buffer[i] >= -2.0f && buffer[i] < 3.0f);
+    mean += buffer[i];
+  }
+  TEST_ASSERT_FLOAT_WITHIN(0.02f, 0.5f, (float)(mean / SAMPLES));
+}
+
+// every index is hit about the same number of times, also for the bound which is not a power of two
+void testRandomBounded(void){
+  enum { BOUND = 7 };
+  int hits[BOUND] = {0};
+  Random random;
+  Random_Seed(&random, 3);
+
+  for (int i = 0; i < SAMPLES; i++){
+    const uint32_t index = Random_Bounded(&random, BOUND);
+    TEST_ASSERT_TRUE(index < BOUND);
+    hits[index]++;
+  }
+  for (int i = 0; i < BOUND; i++){ TEST_ASSERT_INT_WITHIN(SAMPLES / BOUND / 20, SAMPLES / BOUND, hits[i]); }
+
+  TEST_ASSERT_EQUAL_UINT32(0, Random_Bounded(&random, 1));
+}
+
+// the mean and the deviation of the normal fill, the odd count fills the last float too
+void testRandomNormal(void){
+  Random random;
+  Random_Seed(&random, 17);
+
+  buffer[SAMPLES - 1] = NAN;
+  Random_FillNormal(&random, buffer, SAMPLES - 1, 1.0f, 2.0f);
+  TEST_ASSERT_TRUE(isnan(buffer[SAMPLES - 1]));
+
+  double mean = 0.0, square = 0.0;
+  for (int i = 0; i < SAMPLES - 1; i++){
+    TEST_ASSERT_TRUE(isfinite(buffer[i]));
+    mean += buffer[i];
+    square += (double)buffer[i] * buffer[i];
+  }
+  mean /= SAMPLES - 1;
+  const double deviation = sqrt(square / (SAMPLES - 1) - mean * mean);
+
+  TEST_ASSERT_FLOAT_WITHIN(0.03f, 1.0f, (float)mean);
+  TEST_ASSERT_FLOAT_WITHIN(0.03f, 2.0f, (float)deviation);
+}
+
+int main(void){
+  UNITY_BEGIN();
+
+  RUN_TEST(testRandomStreams);
+  RUN_TEST(testRandomStreamsAsymmetric);
+  RUN_TEST(testRandomReference);
+  RUN_TEST(testRandomJump);
+  RUN_TEST(testRandomUniform);
+  RUN_TEST(testRandomBounded);
+  RUN_TEST(testRandomNormal);
+
+  return UNITY_END();
+}
@@ -0,0 +1,107 @@
+#include "general/signal_generator.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "unity/unity.h"
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void testSignalGenerator_StepsFollowMap(void){
+  const float map[2][3] = {
+      {0,  1, 0},
+      {1, 10, 1}};
+
+  SignalGenerator generator;
+  SignalGenerator_InitSteps(&generator, map, 2, 0.01f);
+  TEST_ASSERT_EQUAL_size_t(1000, generator.length);
+
+  float chunk[64];
+  size_t index = 0;
+  size_t produced;
+  while ((produced = SignalGenerator_Fill(&generator, chunk, 64)) > 0){
+    for (size_t i = 0; i < produced; i++, index++){
+      TEST_ASSERT_EQUAL_FLOAT(index < 100 ? 0.0f : 1.0f, chunk[i]);
+    }
+  }
+  TEST_ASSERT_EQUAL_size_t(1000, index);
+}
+
+void testSignalGenerator_RampEnds(void){
+  SignalGenerator generator;
+  SignalGenerator_InitRamp(&generator, 1.0f, 3.0f, 1.0f, 2.0f, 4.0f, 0.5f);
+  TEST_ASSERT_EQUAL_size_t(8, generator.length);
+
+  const float expected[8] = {1.0f, 1.0f, 1.0f, 2.0f, 3.0f, 3.0f, 3.0f, 3.0f};
+  for (size_t i = 0; i < 8; i++){ TEST_ASSERT_EQUAL_FLOAT(expected[i], SignalGenerator_Next(&generator)); }
+}
+
+void testSignalGenerator_RandomStepsRepeatAfterReset(void){
+  SignalGenerator generator;
+  SignalGenerator_InitRandomSteps(&generator, -2.0f, 2.0f, 0.1f, 0.5f, 20.0f, 0.01f, 42);
+
+  float first[2000];
+  SignalGenerator_Fill(&generator, first, 2000);
+
+  SignalGenerator_Reset(&generator);
+  size_t changes = 0;
+  for (size_t i = 0; i < 2000; i++){
+    const float value = SignalGenerator_Next(&generator);
+    TEST_ASSERT_EQUAL_FLOAT(first[i], value);
+    TEST_ASSERT_TRUE(value >= -2.0f && value <= 2.0f);
+    if (i > 0 && first[i] != first[i - 1]) { changes++; }
+  }
+
+  // the holds are from 10 to 50 samples
+  TEST_ASSERT_TRUE(changes >= 2000 / 50 - 1 && changes <= 2000 / 10);
+}
+
+void testSignalGenerator_PrbsLevelsAndBits(void){
+  SignalGenerator generator;
+  SignalGenerator_InitPrbs(&generator, 0.0f, 1.0f, 0.05f, 10.0f, 0.01f, 7);
+
+  size_t high = 0;
+  float previous = 0.0f;
+  for (size_t i = 0; i < generator.length; i++){
+    const float value = SignalGenerator_Next(&generator);
+    TEST_ASSERT_TRUE(value == 0.0f || value == 1.0f);
+
+    // the level can change only at the start of the bit
+    if (i % 5 != 0) { TEST_ASSERT_EQUAL_FLOAT(previous, value); }
+    previous = value;
+    high += value == 1.0f;
+  }
+
+  // the maximal length sequence is balanced
+  TEST_ASSERT_TRUE(high > generator.length / 3 && high < 2 * generator.length / 3);
+}
+
+void testSignalGenerator_Materialize(void){
+  SignalGenerator generator;
+  SignalGenerator_InitChirp(&generator, 0.5f, 0.5f, 0.1f, 2.0f, 5.0f, 0.01f);
+  SignalGenerator_Next(&generator);
+
+  Signal *signal = malloc(sizeof(Signal));
+  SignalGenerator_Materialize(&generator, signal);
+
+  TEST_ASSERT_EQUAL_INT(500, signal->length);
+  TEST_ASSERT_EQUAL_FLOAT(0.01f, signal->dt);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.5f, signal->signal[0]);
+  for (int i = 0; i < signal->length; i++){ TEST_ASSERT_TRUE(signal->signal[i] >= -1e-6f && signal->signal[i] <= 1.0f + 1e-6f); }
+
+  free(signal->signal);
+  free(signal);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(testSignalGenerator_StepsFollowMap);
+  RUN_TEST(testSignalGenerator_RampEnds);
+  RUN_TEST(testSignalGenerator_RandomStepsRepeatAfterReset);
+  RUN_TEST(testSignalGenerator_PrbsLevelsAndBits);
+  RUN_TEST(testSignalGenerator_Materialize);
+
+  return UNITY_END();
+}
@@ -2,6 +2,8 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <float.h>
+#include <math.h>
 
 #include "../../../external/unity/unity.h"
 #include "unity/unity.h"
@@ -26,10 +28,136 @@ void testQuicksort(void){
   free(result);
 }
 
+// the fits with the negative values, the repeats, the zeros and the infinity
+static float* makeFit(const int length){
+  float *fit = malloc(length * sizeof(float));
+  srand(7);
+  for(int i=0; i<length; i++){
+    fit[i] = (float)(rand() % 2001 - 1000) / 7.0f;
+  }
+  fit[0] = INFINITY;
+  fit[1] = -0.0f;
+  fit[2] = 0.0f;
+  return fit;
+}
+
+static int* makeIndexes(const int length){
+  int *result = malloc(length * sizeof(int));
+  for(int i=0; i<length; i++){
+    result[i] = i;
+  }
+  return result;
+}
+
+static void assertSorted(const float *fit, const int *result, const int length){
+  for(int i=1; i<length; i++){
+    TEST_ASSERT_TRUE(fit[result[i - 1]] <= fit[result[i]]);
+  }
+}
+
+void testQuicksortLarge(void){
+  const int length = 20000;
+  float *fit = makeFit(length);
+  int *result = makeIndexes(length);
+
+  quickSort(fit, result, length);
+  assertSorted(fit, result, length);
+
+  // the sorted input and the same values should not be a problem
+  quickSort(fit, result, length);
+  assertSorted(fit, result, length);
+  for(int i=0; i<length; i++){ fit[i] = 1.0f; }
+  quickSort(fit, result, length);
+
+  free(fit);
+  free(result);
+}
+
+// the radix sort is stable, the equal fits keep the order of the indexes
+void testRadixArgSort(void){
+  const int length = 20000;
+  float *fit = makeFit(length);
+  int *result = makeIndexes(length);
+  int *scratch = malloc(length * sizeof(int));
+
+  radixArgSort(fit, result, length, scratch);
+  assertSorted(fit, result, length);
+  TEST_ASSERT_EQUAL_INT(0, result[length - 1]);
+
+  for(int i=1; i<length; i++){
+    if(fit[result[i - 1]] == fit[result[i]] && result[i - 1] != 1 && result[i] != 2){ TEST_ASSERT_TRUE(result[i - 1] < result[i]); }
+  }
+
+  free(fit);
+  free(result);
+  free(scratch);
+}
+
+void testSelectTopK(void){
+  const int length = 20000;
+  const int k = 37;
+  float *fit = makeFit(length);
+  int *result = makeIndexes(length);
+  int *sorted = makeIndexes(length);
+  int *scratch = malloc(length * sizeof(int));
+
+  radixArgSort(fit, sorted, length, scratch);
+  selectTopK(fit, result, length, k);
+
+  for(int i=0; i<k; i++){
+    TEST_ASSERT_EQUAL_FLOAT(fit[sorted[i]], fit[result[i]]);
+  }
+
+  // the rest is still the permutation of all the indexes
+  int *seen = calloc(length, sizeof(int));
+  for(int i=0; i<length; i++){ seen[result[i]]++; }
+  for(int i=0; i<length; i++){ TEST_ASSERT_EQUAL_INT(1, seen[i]); }
+
+  // k bigger than the small array sorts all of it
+  const float small[] = {9.6, 3.4, 10, 4.6, 0.4};
+  int smallResult[] = {0, 1, 2, 3, 4};
+  const int smallCorrect[] = {4, 1, 3, 0, 2};
+  selectTopK(small, smallResult, 5, 5);
+  TEST_ASSERT_EQUAL_INT_ARRAY(smallCorrect, smallResult, 5);
+
+  free(fit);
+  free(result);
+  free(sorted);
+  free(scratch);
+  free(seen);
+}
+
+// the most fits are the same rejected FLT_MAX, k is more than the number of the distinct low fits
+void testSelectTopKDuplicates(void){
+  const int length = 1000;
+  const int k = 200;
+  float *fit = malloc(length * sizeof(float));
+  int *result = makeIndexes(length);
+  for(int i=0; i<length; i++){ fit[i] = i % 10 == 0 ? (float)(i % 7) : FLT_MAX; }
+
+  selectTopK(fit, result, length, k);
+
+  assertSorted(fit, result, k);
+  for(int i=0; i<100; i++){ TEST_ASSERT_TRUE(fit[result[i]] < FLT_MAX); }
+  for(int i=100; i<k; i++){ TEST_ASSERT_EQUAL_FLOAT(FLT_MAX, fit[result[i]]); }
+
+  int *seen = calloc(length, sizeof(int));
+  for(int i=0; i<length; i++){ seen[result[i]]++; }
+  for(int i=0; i<length; i++){ TEST_ASSERT_EQUAL_INT(1, seen[i]); }
+
+  free(fit);
+  free(result);
+  free(seen);
+}
+
 int main(void) {
   UNITY_BEGIN();
 
   RUN_TEST(testQuicksort);
+  RUN_TEST(testQuicksortLarge);
+  RUN_TEST(testRadixArgSort);
+  RUN_TEST(testSelectTopK);
+  RUN_TEST(testSelectTopKDuplicates);
 
   return UNITY_END();
 }
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "general/state_space.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "unity/unity.h"
+
+StateSpace *firstOrder;
+StateSpace *thirdOrder;
+
+void setUp(void){
+  // dot_x = -2x + 3u, y = x
+  const float A[] = {-2.0f};
+  const float B[] = { 3.0f};
+  const float C[] = { 1.0f};
+  firstOrder = StateSpace_Create(A, B, C, NULL, 1, 1, 1);
+
+  // dddot_y + 2 * ddot_y + 3 * dot_y + 4 * y = u
+  const float A3[] = { 0.0f,  1.0f,  0.0f,
+                       0.0f,  0.0f,  1.0f,
+                      -4.0f, -3.0f, -2.0f};
+  const float B3[] = {0.0f, 0.0f, 1.0f};
+  const float C3[] = {1.0f, 0.0f, 0.0f};
+  thirdOrder = StateSpace_Create(A3, B3, C3, NULL, 3, 1, 1);
+}
+
+void tearDown(void){
+  StateSpace_Destroy(firstOrder);
+  StateSpace_Destroy(thirdOrder);
+}
+
+void testStateSpace_DiscretizeFirstOrder(void){
+  const float dt = 0.1f;
+  StateSpace_Discretize(firstOrder, dt);
+
+  // exact values for the scalar plant
+  const float ad = expf(-2.0f * dt);
+  const float bd = 3.0f * (1.0f - ad) / 2.0f;
+
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, ad, firstOrder->Ad[0]);
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, bd, firstOrder->Bd[0]);
+}
+
+void testStateSpace_StepMatchesAnalytic(void){
+  // big step is still exact for the constant input
+  const float dt = 0.5f;
+  StateSpace_Discretize(firstOrder, dt);
+
+  float x = 0.0f;
+  float y = 0.0f;
+  const float u = 1.0f;
+  for (int i = 0; i < 10; i++){ StateSpace_Step(firstOrder, &x, &u, &y); }
+
+  const float expected = 1.5f * (1.0f - expf(-2.0f * dt * 10));
+  TEST_ASSERT_FLOAT_WITHIN(1e-5f, expected, y);
+}
+
+void testStateSpace_ThirdOrderSteadyState(void){
+  StateSpace_Discretize(thirdOrder, 0.05f);
+
+  float x[] = {0.0f, 0.0f, 0.0f};
+  float y = 0.0f;
+  const float u = 8.0f;
+  for (int i = 0; i < 2000; i++){ StateSpace_Step(thirdOrder, x, &u, &y); }
+
+  // the DC gain of the plant is 1/4
+  TEST_ASSERT_FLOAT_WITHIN(1e-4f, 2.0f, y);
+}
+
+void testStateSpace_DcGain(void){
+  float gain = 0.0f;
+
+  TEST_ASSERT_EQUAL(1, StateSpace_DcGain(firstOrder, &gain));
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 1.5f, gain);
+
+  TEST_ASSERT_EQUAL(1, StateSpace_DcGain(thirdOrder, &gain));
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.25f, gain);
+}
+
+void testStateSpace_DcGainOfIntegrator(void){
+  const float A[] = {0.0f};
+  const float B[] = {1.0f};
+  const float C[] = {1.0f};
+  StateSpace *integrator = StateSpace_Create(A, B, C, NULL, 1, 1, 1);
+
+  float gain = 0.0f;
+  TEST_ASSERT_EQUAL(0, StateSpace_DcGain(integrator, &gain));
+
+  StateSpace_Destroy(integrator);
+}
+
+int main(void){
+  UNITY_BEGIN();
+
+  RUN_TEST(testStateSpace_DiscretizeFirstOrder);
+  RUN_TEST(testStateSpace_StepMatchesAnalytic);
+  RUN_TEST(testStateSpace_ThirdOrderSteadyState);
+  RUN_TEST(testStateSpace_DcGain);
+  RUN_TEST(testStateSpace_DcGainOfIntegrator);
+
+  return UNITY_END();
+}
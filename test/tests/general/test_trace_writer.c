@@ -0,0 +1,79 @@
+#include "general/trace_writer.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "unity/unity.h"
+
+#define TRACE_FILE "test_trace_writer.bin"
+#define CSV_FILE   "test_trace_writer.csv"
+
+static const char *const columns[] = {"y", "w", "u"};
+
+void setUp(void) {}
+void tearDown(void) {
+  remove(TRACE_FILE);
+  remove(CSV_FILE);
+}
+
+void testTraceWriter_TranscodeMatchesRecords(void){
+  // the small buffer makes a few handovers to the thread and one partial block
+  TraceWriter *writer = TraceWriter_Create(TRACE_FILE, columns, 3, 4);
+  TEST_ASSERT_NOT_NULL(writer);
+
+  for (int i = 0; i < 10; i++){
+    const float record[3] = {(float)i, (float)(2 * i), (float)(-i)};
+    TraceWriter_Append(writer, record);
+  }
+  TraceWriter_Destroy(writer);
+
+  TEST_ASSERT_EQUAL_INT(10, TraceWriter_TranscodeToCsv(TRACE_FILE, CSV_FILE));
+
+  FILE *csv = fopen(CSV_FILE, "r");
+  TEST_ASSERT_NOT_NULL(csv);
+
+  char line[128];
+  TEST_ASSERT_NOT_NULL(fgets(line, sizeof(line), csv));
+  TEST_ASSERT_EQUAL_STRING("y,w,u\n", line);
+
+  for (int i = 0; i < 10; i++){
+    float y, w, u;
+    TEST_ASSERT_EQUAL_INT(3, fscanf(csv, "%f,%f,%f\n", &y, &w, &u));
+    TEST_ASSERT_EQUAL_FLOAT((float)i, y);
+    TEST_ASSERT_EQUAL_FLOAT((float)(2 * i), w);
+    TEST_ASSERT_EQUAL_FLOAT((float)(-i), u);
+  }
+  fclose(csv);
+}
+
+void testTraceWriter_FlushKeepsWriting(void){
+  TraceWriter *writer = TraceWriter_Create(TRACE_FILE, columns, 3, 0);
+
+  const float record[3] = {1.0f, 2.0f, 3.0f};
+  TraceWriter_Append(writer, record);
+  TraceWriter_Flush(writer);
+  TraceWriter_Append(writer, record);
+  TraceWriter_Destroy(writer);
+
+  TEST_ASSERT_EQUAL_INT(2, TraceWriter_TranscodeToCsv(TRACE_FILE, CSV_FILE));
+}
+
+void testTraceWriter_RejectsForeignFile(void){
+  FILE *file = fopen(TRACE_FILE, "wb");
+  fputs("y,w,u\n1,2,3\n", file);
+  fclose(file);
+
+  TEST_ASSERT_EQUAL_INT(-1, TraceWriter_TranscodeToCsv(TRACE_FILE, CSV_FILE));
+  TEST_ASSERT_EQUAL_INT(-1, TraceWriter_TranscodeToCsv("missing_trace.bin", CSV_FILE));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(testTraceWriter_TranscodeMatchesRecords);
+  RUN_TEST(testTraceWriter_FlushKeepsWriting);
+  RUN_TEST(testTraceWriter_RejectsForeignFile);
+
+  return UNITY_END();
+}
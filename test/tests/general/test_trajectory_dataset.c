@@ -0,0 +1,140 @@
+#include "general/trajectory_dataset.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity/unity.h"
+
+#define CSV_PATH    "test_trajectory_dataset.csv"
+#define BINARY_PATH "test_trajectory_dataset.bin"
+#define ROWS 1000
+
+void setUp(void) {
+  // the recorded run with the time column, the reference, the output and the control
+  FILE *csv = fopen(CSV_PATH, "w");
+  fprintf(csv, "time, w, y, \"u\"\r\n");
+  for (int i = 0; i < ROWS; i++){
+    fprintf(csv, "%f,%f,%f,%f\r\n", (float)i * 0.01f, i < 100 ? 0.0f : 1.0f, (float)i / ROWS, -(float)i);
+  }
+  fprintf(csv, "\n");
+  fclose(csv);
+}
+
+void tearDown(void) {
+  remove(CSV_PATH);
+  remove(BINARY_PATH);
+}
+
+void testTrajectoryDataset_ConvertAndView(void){
+  TEST_ASSERT_EQUAL_INT32(ROWS, TrajectoryDataset_ConvertCsv(CSV_PATH, BINARY_PATH, 0.0f));
+
+  TrajectoryDataset *dataset = TrajectoryDataset_Open(BINARY_PATH);
+  TEST_ASSERT_NOT_NULL(dataset);
+
+  TEST_ASSERT_EQUAL_size_t(ROWS, TrajectoryDataset_GetRows(dataset));
+  TEST_ASSERT_EQUAL_size_t(4, TrajectoryDataset_GetColumnCount(dataset));
+  TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.01f, TrajectoryDataset_GetDt(dataset));
+  TEST_ASSERT_EQUAL_STRING("time", TrajectoryDataset_GetColumnName(dataset, 0));
+  TEST_ASSERT_EQUAL_STRING("u", TrajectoryDataset_GetColumnName(dataset, 3));
+  TEST_ASSERT_EQUAL_INT(2, TrajectoryDataset_FindColumn(dataset, "y"));
+  TEST_ASSERT_EQUAL_INT(-1, TrajectoryDataset_FindColumn(dataset, "e"));
+
+  // each column starts at the cache line
+  for (size_t c = 0; c < 4; c++){
+    TEST_ASSERT_EQUAL_UINT64(0, (uintptr_t)TrajectoryDataset_GetColumn(dataset, c) % 64);
+  }
+
+  // the view is the window of the mapped column, no copy
+  const Signal reference = TrajectoryDataset_GetSignal(dataset, 1, 0, 0);
+  TEST_ASSERT_EQUAL_INT(ROWS, reference.length);
+  TEST_ASSERT_EQUAL_PTR(TrajectoryDataset_GetColumn(dataset, 1), reference.signal);
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, reference.signal[99]);
+  TEST_ASSERT_EQUAL_FLOAT(1.0f, reference.signal[100]);
+
+  const Signal control = TrajectoryDataset_GetSignal(dataset, 3, 500, 10);
+  TEST_ASSERT_EQUAL_INT(10, control.length);
+  TEST_ASSERT_EQUAL_FLOAT(-500.0f, control.signal[0]);
+  TEST_ASSERT_EQUAL_FLOAT(-509.0f, control.signal[9]);
+
+  TrajectoryDataset_Close(dataset);
+}
+
+void testTrajectoryDataset_MalformedCsv(void){
+  FILE *csv = fopen(CSV_PATH, "a");
+  fprintf(csv, "1.0,2.0,3.0\n");
+  fclose(csv);
+
+  TEST_ASSERT_EQUAL_INT32(-1, TrajectoryDataset_ConvertCsv(CSV_PATH, BINARY_PATH, 0.01f));
+  TEST_ASSERT_NULL(TrajectoryDataset_Open(BINARY_PATH));
+}
+
+void testTrajectoryDataset_NotDataset(void){
+  // the csv itself is not the binary dataset
+  TEST_ASSERT_NULL(TrajectoryDataset_Open(CSV_PATH));
+}
+
+// the header with the huge row count wraps the file size around, it is not the valid dataset
+void testTrajectoryDataset_HugeRows(void){
+  TEST_ASSERT_EQUAL_INT32(ROWS, TrajectoryDataset_ConvertCsv(CSV_PATH, BINARY_PATH, 0.0f));
+
+  // the rows are at the offset 16 of the header, 4 columns of 2^62 floats are 2^66 bytes
+  FILE *binary = fopen(BINARY_PATH, "r+b");
+  const uint64_t rows = (uint64_t)1 << 62;
+  fseek(binary, 16, SEEK_SET);
+  fwrite(&rows, sizeof(rows), 1, binary);
+  fclose(binary);
+
+  TEST_ASSERT_NULL(TrajectoryDataset_Open(BINARY_PATH));
+}
+
+// the controller context counts the calls and sums the inputs
+typedef struct ReplayController {
+  int calls;
+  float sumW;
+  float sumY;
+  float offset;
+} ReplayController;
+
+// the recorded u of the test run is -i, the replay gives it back with the offset
+static float replayController(void *context, float w, float y){
+  ReplayController *controller = context;
+  controller->sumW += w;
+  controller->sumY += y;
+  return -(float)controller->calls++ + controller->offset;
+}
+
+void testTrajectoryDataset_ScoreOpenLoop(void){
+  TEST_ASSERT_EQUAL_INT32(ROWS, TrajectoryDataset_ConvertCsv(CSV_PATH, BINARY_PATH, 0.0f));
+  TrajectoryDataset *dataset = TrajectoryDataset_Open(BINARY_PATH);
+  TEST_ASSERT_NOT_NULL(dataset);
+
+  ReplayController controller;
+  memset(&controller, 0, sizeof(controller));
+  float score = TrajectoryDataset_ScoreOpenLoop(dataset, 1, 2, 3, replayController, &controller);
+
+  // each row is fed once in order, the exact replay has no error
+  TEST_ASSERT_EQUAL_INT(ROWS, controller.calls);
+  TEST_ASSERT_EQUAL_FLOAT(900.0f, controller.sumW);
+  TEST_ASSERT_FLOAT_WITHIN(1e-2f, 499.5f, controller.sumY);
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, score);
+
+  memset(&controller, 0, sizeof(controller));
+  controller.offset = 0.5f;
+  score = TrajectoryDataset_ScoreOpenLoop(dataset, 1, 2, 3, replayController, &controller);
+  TEST_ASSERT_FLOAT_WITHIN(1e-2f, 0.5f * ROWS, score);
+
+  TrajectoryDataset_Close(dataset);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(testTrajectoryDataset_ConvertAndView);
+  RUN_TEST(testTrajectoryDataset_MalformedCsv);
+  RUN_TEST(testTrajectoryDataset_NotDataset);
+  RUN_TEST(testTrajectoryDataset_HugeRows);
+  RUN_TEST(testTrajectoryDataset_ScoreOpenLoop);
+
+  return UNITY_END();
+}
@@ -0,0 +1,114 @@
+#include "genetic/cma_es.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "unity/unity.h"
+
+void setUp(void){}
+void tearDown(void){}
+
+static float sphere(const float *x, const size_t genes){
+  float sum = 0.0f;
+  for (size_t j = 0; j < genes; j++){ sum += (x[j] - 1.0f) * (x[j] - 1.0f); }
+  return sum;
+}
+
+static float rosenbrock(const float *x, const size_t genes){
+  float sum = 0.0f;
+  for (size_t j = 0; j + 1 < genes; j++){
+    const float a = x[j + 1] - x[j] * x[j];
+    const float b = 1.0f - x[j];
+    sum += 100.0f * a * a + b * b;
+  }
+  return sum;
+}
+
+// the axis parallel ellipsoid with the condition 10^4
+static float ellipsoid(const float *x, const size_t genes){
+  float sum = 0.0f;
+  for (size_t j = 0; j < genes; j++){ sum += powf(100.0f, (float)j / (float)(genes - 1)) * x[j] * x[j]; }
+  return sum;
+}
+
+// run the engine and return the best fit of all generations
+static float run(CmaEs *es, float (*fit)(const float*, size_t), const size_t generations){
+  float best = INFINITY;
+  for (size_t g = 0; g < generations; g++){
+    for (size_t i = 0; i < es->rows; i++){ es->fit[i] = fit(es->current[i], es->genes); }
+    const float generationBest = es->fit[CmaEs_GetBest(es)];
+    if (generationBest < best) { best = generationBest; }
+    CmaEs_Step(es);
+  }
+  return best;
+}
+
+// the sphere is solved by both covariance models
+void testCmaEsSphere(void){
+  const CmaCovariance models[] = {CMA_FULL, CMA_DIAGONAL};
+  for (int m = 0; m < 2; m++){
+    const CmaConfig config = {.genes = 10, .covariance = models[m], .sigma = 0.5f, .threads = 1, .seed = 1};
+    CmaEs *es = CmaEs_Create(&config);
+    TEST_ASSERT_EQUAL_size_t(10, es->rows);
+
+    TEST_ASSERT_TRUE(run(es, sphere, 300) < 1e-6f);
+    for (size_t j = 0; j < 10; j++){ TEST_ASSERT_FLOAT_WITHIN(1e-2f, 1.0f, es->mean[j]); }
+    CmaEs_Destroy(es);
+  }
+}
+
+// the full covariance learns the curved valley of the Rosenbrock function
+void testCmaEsRosenbrock(void){
+  const CmaConfig config = {.genes = 5, .covariance = CMA_FULL, .sigma = 0.5f, .threads = 2, .seed = 2};
+  CmaEs *es = CmaEs_Create(&config);
+
+  TEST_ASSERT_TRUE(run(es, rosenbrock, 1500) < 1e-4f);
+  CmaEs_Destroy(es);
+}
+
+// the diagonal learns the scales of the genes of the big genome and the rows stay in the bounds
+void testCmaEsDiagonalBounds(void){
+  enum { GENES = 200 };
+  float min[GENES], max[GENES];
+  for (int j = 0; j < GENES; j++){ min[j] = -5.0f; max[j] = 3.0f; }
+
+  const CmaConfig config = {.genes = GENES, .covariance = CMA_DIAGONAL, .sigma = 0.3f, .min = min, .max = max,
+                            .threads = 1, .seed = 3};
+  CmaEs *es = CmaEs_Create(&config);
+  for (size_t i = 0; i < es->rows; i++){
+    for (int j = 0; j < GENES; j++){ TEST_ASSERT_TRUE(es->current[i][j] >= -5.0f && es->current[i][j] <= 3.0f); }
+  }
+
+  TEST_ASSERT_TRUE(run(es, ellipsoid, 2000) < 1e-3f);
+  TEST_ASSERT_TRUE(CmaEs_GetSigma(es) < 0.3);
+  CmaEs_Destroy(es);
+}
+
+// each row has its own stream and each covariance row is made by one thread, so the threads give the same run
+void testCmaEsThreads(void){
+  CmaEs *es[2];
+  for (int t = 0; t < 2; t++){
+    const CmaConfig config = {.genes = 40, .rows = 16, .covariance = CMA_FULL, .sigma = 0.5f, .threads = t == 0 ? 1 : 4, .seed = 4};
+    es[t] = CmaEs_Create(&config);
+    run(es[t], rosenbrock, 40);
+  }
+
+  TEST_ASSERT_EQUAL_FLOAT_ARRAY(es[0]->mean, es[1]->mean, 40);
+  TEST_ASSERT_EQUAL_FLOAT_ARRAY(es[0]->matrix, es[1]->matrix, 40 * 40);
+  TEST_ASSERT_EQUAL_FLOAT_ARRAY(es[0]->memory, es[1]->memory, 16 * 40);
+
+  CmaEs_Destroy(es[0]);
+  CmaEs_Destroy(es[1]);
+}
+
+int main(void){
+  UNITY_BEGIN();
+
+  RUN_TEST(testCmaEsSphere);
+  RUN_TEST(testCmaEsRosenbrock);
+  RUN_TEST(testCmaEsDiagonalBounds);
+  RUN_TEST(testCmaEsThreads);
+
+  return UNITY_END();
+}
@@ -0,0 +1,118 @@
+#include "genetic/crossover.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "unity/unity.h"
+
+#define GENES 150
+#define ROWS 64
+
+static float memory[2][ROWS * GENES];
+static float *rows[2][ROWS];
+static float min[GENES];
+static float max[GENES];
+
+// the row r has the genes r * 1000 + g, so each gene tells its parent and its place
+static void fillRows(void){
+  for (int copy = 0; copy < 2; copy++){
+    for (int r = 0; r < ROWS; r++){
+      rows[copy][r] = memory[copy] + r * GENES;
+      for (int g = 0; g < GENES; g++){ rows[copy][r][g] = (float)(r * 1000 + g); }
+    }
+  }
+}
+
+static void assertSwappedOrKept(const float *first, const float *second, const int pair){
+  for (int g = 0; g < GENES; g++){
+    const float a = (float)(2 * pair * 1000 + g);
+    const float b = (float)((2 * pair + 1) * 1000 + g);
+    TEST_ASSERT_TRUE((first[g] == a && second[g] == b) || (first[g] == b && second[g] == a));
+  }
+}
+
+void setUp(void){
+  for (int g = 0; g < GENES; g++){ min[g] = 0.0f; max[g] = (float)(ROWS * 1000); }
+  fillRows();
+}
+void tearDown(void){}
+
+// the segments bigger than the scratch are swapped, the odd point count goes to the end of the row
+void testCrossoverSegments(void){
+  const int points[] = {10, 140, 145};
+  Crossover_Segments(rows[0][0], rows[0][1], points, 3, GENES);
+
+  for (int g = 0; g < GENES; g++){
+    const int swapped = (g >= 10 && g < 140) || g >= 145;
+    TEST_ASSERT_EQUAL_FLOAT((float)((swapped ? 1000 : 0) + g), rows[0][0][g]);
+    TEST_ASSERT_EQUAL_FLOAT((float)((swapped ? 0 : 1000) + g), rows[0][1][g]);
+  }
+}
+
+// the uniform and the random points kinds only exchange the genes on their places
+void testCrossoverExchangeKinds(void){
+  const CrossoverKind kinds[] = {CROSSOVER_UNIFORM, CROSSOVER_RANDOM_POINTS};
+  for (int k = 0; k < 2; k++){
+    fillRows();
+    const Crossover crossover = {.kind = kinds[k], .pointsCount = 3};
+    Random random;
+    Random_Seed(&random, 5);
+
+    Crossover_Pair(&crossover, &random, rows[0][0], rows[0][1], GENES, min, max);
+    assertSwappedOrKept(rows[0][0], rows[0][1], 0);
+
+    int swapped = 0;
+    for (int g = 0; g < GENES; g++){ swapped += rows[0][0][g] != (float)g; }
+    TEST_ASSERT_TRUE(swapped > 0 && swapped < GENES);
+  }
+}
+
+// the arithmetic children keep the sum of the parents, the blend children stay in the bounds
+void testCrossoverMixKinds(void){
+  Random random;
+  Random_Seed(&random, 6);
+
+  const Crossover arithmetic = {.kind = CROSSOVER_ARITHMETIC};
+  Crossover_Pair(&arithmetic, &random, rows[0][0], rows[0][1], GENES, min, max);
+  for (int g = 0; g < GENES; g++){
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, (float)(1000 + 2 * g), rows[0][0][g] + rows[0][1][g]);
+    TEST_ASSERT_TRUE(rows[0][0][g] >= (float)g && rows[0][0][g] <= (float)(1000 + g));
+  }
+
+  // the interval of the parents is 1000, so the alpha 0.5 children are in [-500, 1500] clipped to [0, 1200]
+  const Crossover blend = {.kind = CROSSOVER_BLX, .alpha = 0.5f};
+  for (int g = 0; g < GENES; g++){ max[g] = 1200.0f; }
+  fillRows();
+  Crossover_Pair(&blend, &random, rows[0][0], rows[0][1], GENES, min, max);
+  for (int g = 0; g < GENES; g++){
+    TEST_ASSERT_TRUE(rows[0][0][g] >= 0.0f && rows[0][0][g] <= 1200.0f);
+    TEST_ASSERT_TRUE(rows[0][1][g] >= 0.0f && rows[0][1][g] <= 1200.0f);
+  }
+}
+
+// the pairs use only their own streams, so the threads give the same rows as one thread
+void testCrossoverRowsThreads(void){
+  const Crossover crossover = {.kind = CROSSOVER_UNIFORM};
+  Random streams[2][ROWS];
+  for (int r = 0; r < ROWS; r++){
+    Random_Stream(&streams[0][r], 3, r);
+    Random_Stream(&streams[1][r], 3, r);
+  }
+
+  Crossover_Rows(&crossover, streams[0], rows[0], ROWS, GENES, min, max, 1);
+  Crossover_Rows(&crossover, streams[1], rows[1], ROWS, GENES, min, max, 4);
+
+  TEST_ASSERT_EQUAL_FLOAT_ARRAY(memory[0], memory[1], ROWS * GENES);
+  for (int pair = 0; pair < ROWS / 2; pair++){ assertSwappedOrKept(rows[1][2 * pair], rows[1][2 * pair + 1], pair); }
+}
+
+int main(void){
+  UNITY_BEGIN();
+
+  RUN_TEST(testCrossoverSegments);
+  RUN_TEST(testCrossoverExchangeKinds);
+  RUN_TEST(testCrossoverMixKinds);
+  RUN_TEST(testCrossoverRowsThreads);
+
+  return UNITY_END();
+}
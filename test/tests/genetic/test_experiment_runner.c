@@ -0,0 +1,195 @@
+#include "genetic/experiment_runner.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "unity/unity.h"
+
+#define CONFIG_PATH "test_experiment_runner.ini"
+
+static ExperimentConfig configs[4];
+
+static void writeConfig(const char *text){
+  FILE *file = fopen(CONFIG_PATH, "w");
+  TEST_ASSERT_NOT_NULL(file);
+  fputs(text, file);
+  fclose(file);
+}
+
+void setUp(void){}
+
+void tearDown(void){
+  remove(CONFIG_PATH);
+}
+
+// the keys not in the file keep the defaults
+void testLoadConfig(void){
+  writeConfig("# two experiments\n"
+              "[experiment]\n"
+              "name = first\n"
+              "population = 50\n"
+              "mutation = 0.25\n"
+              "min = 1 2 3 0.1\n"
+              "\n"
+              "[experiment]\n"
+              "; the controller after the mode keeps the mode\n"
+              "seed = 42\n"
+              "mode = steady\n"
+              "controller = pid\n"
+              "topology = random\n");
+
+  TEST_ASSERT_EQUAL_INT(2, ExperimentRunner_Load(CONFIG_PATH, configs, 4));
+
+  TEST_ASSERT_EQUAL_STRING("first", configs[0].name);
+  TEST_ASSERT_EQUAL_size_t(50, configs[0].population);
+  TEST_ASSERT_EQUAL_FLOAT(0.25f, configs[0].mutation);
+  TEST_ASSERT_EQUAL_FLOAT(3.0f, configs[0].min[2]);
+  TEST_ASSERT_EQUAL_FLOAT(100.0f, configs[0].max[0]);
+
+  TEST_ASSERT_EQUAL_STRING("experiment1", configs[1].name);
+  TEST_ASSERT_EQUAL_UINT64(42, configs[1].seed);
+  TEST_ASSERT_EQUAL_size_t(100, configs[1].population);
+  TEST_ASSERT_EQUAL_INT(4, configs[1].system);
+  TEST_ASSERT_EQUAL_INT(EXPERIMENT_GENERATIONAL, configs[0].mode);
+  TEST_ASSERT_EQUAL_INT(EXPERIMENT_STEADY_STATE, configs[1].mode);
+  TEST_ASSERT_EQUAL_INT(ISLAND_RANDOM, configs[1].topology);
+  TEST_ASSERT_EQUAL_size_t(4, configs[1].islands);
+}
+
+void testLoadWrongConfig(void){
+  writeConfig("[experiment]\nspeed = 3\n");
+  TEST_ASSERT_EQUAL_INT(-1, ExperimentRunner_Load(CONFIG_PATH, configs, 4));
+
+  writeConfig("[experiment]\nmin = 1 2\n");
+  TEST_ASSERT_EQUAL_INT(-1, ExperimentRunner_Load(CONFIG_PATH, configs, 4));
+
+  writeConfig("[experiment]\nmode = islands\nmigrants = 500\n");
+  TEST_ASSERT_EQUAL_INT(-1, ExperimentRunner_Load(CONFIG_PATH, configs, 4));
+
+  writeConfig("[experiment]\nmode = fast\n");
+  TEST_ASSERT_EQUAL_INT(-1, ExperimentRunner_Load(CONFIG_PATH, configs, 4));
+
+  writeConfig("[experiment]\nelite = 100\n");
+  TEST_ASSERT_EQUAL_INT(-1, ExperimentRunner_Load(CONFIG_PATH, configs, 4));
+
+  writeConfig("[experiment]\n[experiment]\n");
+  TEST_ASSERT_EQUAL_INT(-1, ExperimentRunner_Load(CONFIG_PATH, configs, 1));
+
+  TEST_ASSERT_EQUAL_INT(-1, ExperimentRunner_Load("missing_experiment.ini", configs, 4));
+}
+
+// two small concurrent runs, the same seed gives the same result, the unknown system is not run
+void testRunAll(void){
+  ExperimentResult results[3];
+  for (size_t i = 0; i < 3; i++){
+    ExperimentRunner_Defaults(&configs[i], i);
+    configs[i].population  = 16;
+    configs[i].generations = 3;
+  }
+  configs[2].system = 99;
+
+  ExperimentRunner_RunAll(configs, 3, results);
+
+  for (int i = 0; i < 2; i++){
+    TEST_ASSERT_TRUE(results[i].valid);
+    TEST_ASSERT_EQUAL_size_t(48, results[i].evaluations);
+    TEST_ASSERT_TRUE(results[i].plantSteps > 0.0);
+    TEST_ASSERT_TRUE(results[i].bestFit >= 0.0f);
+    for (size_t g = 0; g < configs[i].genes; g++){
+      TEST_ASSERT_TRUE(results[i].best[g] >= configs[i].min[g] && results[i].best[g] <= configs[i].max[g]);
+    }
+  }
+  TEST_ASSERT_EQUAL_FLOAT(results[0].bestFit, results[1].bestFit);
+  TEST_ASSERT_EQUAL_FLOAT_ARRAY(results[0].best, results[1].best, 4);
+  TEST_ASSERT_FALSE(results[2].valid);
+  TEST_ASSERT_EQUAL_size_t(1, results[1].cores);
+
+  ExperimentRunner_Report(stdout, results, 3);
+}
+
+// the steady state makes the same number of evaluations as the generations
+void testRunSteadyState(void){
+  ExperimentResult result;
+  ExperimentRunner_Defaults(&configs[0], 0);
+  configs[0].mode        = EXPERIMENT_STEADY_STATE;
+  configs[0].population  = 16;
+  configs[0].generations = 3;
+  configs[0].threads     = 2;
+
+  ExperimentRunner_RunAll(configs, 1, &result);
+
+  TEST_ASSERT_TRUE(result.valid);
+  TEST_ASSERT_EQUAL_size_t(48, result.evaluations);
+  TEST_ASSERT_TRUE(result.bestFit >= 0.0f);
+}
+
+// each island makes all its generations
+void testRunIslands(void){
+  ExperimentResult result;
+  ExperimentRunner_Defaults(&configs[0], 0);
+  configs[0].mode        = EXPERIMENT_ISLANDS;
+  configs[0].population  = 16;
+  configs[0].generations = 6;
+  configs[0].islands     = 3;
+  configs[0].interval    = 2;
+  configs[0].threads     = 2;
+
+  ExperimentRunner_RunAll(configs, 1, &result);
+
+  TEST_ASSERT_TRUE(result.valid);
+  TEST_ASSERT_EQUAL_size_t(3 * 16 * 6, result.evaluations);
+  TEST_ASSERT_TRUE(result.bestFit >= 0.0f);
+}
+
+// the worker processes give the same fits as the threads, so the same seed gives the same best
+void testRunProcesses(void){
+  ExperimentResult results[2];
+  for (int i = 0; i < 2; i++){
+    ExperimentRunner_Defaults(&configs[i], i);
+    configs[i].mode        = i == 0 ? EXPERIMENT_GENERATIONAL : EXPERIMENT_PROCESSES;
+    configs[i].population  = 16;
+    configs[i].generations = 3;
+    configs[i].threads     = 2;
+    configs[i].seed        = 11;
+  }
+
+  ExperimentRunner_RunAll(configs, 2, results);
+
+  TEST_ASSERT_TRUE(results[1].valid);
+  TEST_ASSERT_EQUAL_size_t(48, results[1].evaluations);
+  TEST_ASSERT_EQUAL_FLOAT(results[0].bestFit, results[1].bestFit);
+  TEST_ASSERT_EQUAL_FLOAT_ARRAY(results[0].best, results[1].best, 4);
+}
+
+// the CMA-ES evaluates population rows per generation and stays in the bounds
+void testRunCmaEs(void){
+  ExperimentResult result;
+  ExperimentRunner_Defaults(&configs[0], 0);
+  configs[0].mode        = EXPERIMENT_CMA_ES;
+  configs[0].population  = 8;
+  configs[0].generations = 5;
+  configs[0].threads     = 2;
+
+  ExperimentRunner_RunAll(configs, 1, &result);
+
+  TEST_ASSERT_TRUE(result.valid);
+  TEST_ASSERT_EQUAL_size_t(40, result.evaluations);
+  TEST_ASSERT_TRUE(result.bestFit >= 0.0f);
+  for (size_t j = 0; j < configs[0].genes; j++){
+    TEST_ASSERT_TRUE(result.best[j] >= configs[0].min[j] && result.best[j] <= configs[0].max[j]);
+  }
+}
+
+int main(){
+  UNITY_BEGIN();
+
+  RUN_TEST(testLoadConfig);
+  RUN_TEST(testLoadWrongConfig);
+  RUN_TEST(testRunAll);
+  RUN_TEST(testRunSteadyState);
+  RUN_TEST(testRunIslands);
+  RUN_TEST(testRunProcesses);
+  RUN_TEST(testRunCmaEs);
+
+  return UNITY_END();
+}
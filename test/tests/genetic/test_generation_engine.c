@@ -0,0 +1,148 @@
+#include "genetic/generation_engine.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "unity/unity.h"
+
+#define GENES 4
+
+static const float min[GENES] = {0.0f, -1.0f, 10.0f, 0.0f};
+static const float max[GENES] = {1.0f,  1.0f, 20.0f, 100.0f};
+
+static GenerationEngine *engine;
+
+// the row i has all genes i and fit i, so the row 0 is the best
+static void fillRowsByIndex(void){
+  for (size_t i = 0; i < engine->rows; i++){
+    for (size_t g = 0; g < GENES; g++){ engine->current[i][g] = (float)i; }
+    engine->fit[i] = (float)i;
+  }
+}
+
+void setUp(void){
+  engine = NULL;
+}
+
+void tearDown(void){
+  GenerationEngine_Destroy(engine);
+}
+
+// the first population is random in the bounds, the step swaps the two buffers without new memory
+void testCreateAndSwap(void){
+  const GenerationSlice slices[] = {
+    {.source = GENERATION_BEST, .rows = 3},
+    {.source = GENERATION_RANDOM, .rows = 7}
+  };
+  engine = GenerationEngine_Create(GENES, min, max, slices, 2, 1);
+
+  TEST_ASSERT_EQUAL_size_t(10, engine->rows);
+  for (size_t i = 0; i < engine->rows; i++){
+    for (size_t g = 0; g < GENES; g++){
+      TEST_ASSERT_TRUE(engine->current[i][g] >= min[g] && engine->current[i][g] <= max[g]);
+    }
+  }
+
+  float **current = engine->current;
+  float **next = engine->next;
+  float *memory = engine->memory;
+
+  GenerationEngine_Step(engine);
+  TEST_ASSERT_EQUAL_PTR(next, engine->current);
+  TEST_ASSERT_EQUAL_PTR(current, engine->next);
+  TEST_ASSERT_EQUAL_PTR(memory, engine->memory);
+}
+
+// the best slice copies the ranked rows with the repeats of selectBest
+void testBestRepeats(void){
+  const GenerationSlice slices[] = {
+    {.source = GENERATION_BEST, .rows = 5, .repeats = {3, 0, 2}, .repeatsCount = 3},
+    {.source = GENERATION_RANDOM, .rows = 3}
+  };
+  engine = GenerationEngine_Create(GENES, min, max, slices, 2, 2);
+  fillRowsByIndex();
+  engine->fit[0] = 5.0f; // the row 1 is now the best, then 2 and 3
+
+  GenerationEngine_Step(engine);
+
+  const float expected[] = {1, 1, 1, 3, 3};
+  for (size_t i = 0; i < 5; i++){ TEST_ASSERT_EQUAL_FLOAT(expected[i], engine->current[i][0]); }
+}
+
+// the crossover swaps the genes between the points of each pair
+void testTournamentCrossover(void){
+  const GenerationSlice slices[] = {
+    {.source = GENERATION_TOURNAMENT, .rows = 64, .points = {1, 3}, .pointsCount = 2}
+  };
+  engine = GenerationEngine_Create(GENES, min, max, slices, 1, 3);
+  fillRowsByIndex();
+
+  GenerationEngine_Step(engine);
+
+  int crossed = 0;
+  for (size_t i = 0; i < engine->rows; i += 2){
+    float *first = engine->current[i];
+    float *second = engine->current[i + 1];
+
+    TEST_ASSERT_EQUAL_FLOAT(first[0], first[3]);
+    TEST_ASSERT_EQUAL_FLOAT(first[1], first[2]);
+    TEST_ASSERT_EQUAL_FLOAT(first[0], second[1]);
+    TEST_ASSERT_EQUAL_FLOAT(second[0], first[1]);
+    crossed += first[0] != first[1];
+  }
+  TEST_ASSERT_TRUE(crossed > 0);
+}
+
+// the mutated genes and the close random rows stay in the bounds
+void testMutationAndCloseRandom(void){
+  const GenerationSlice slices[] = {
+    {.source = GENERATION_BEST, .rows = 8, .mutation = 1.0f},
+    {.source = GENERATION_CLOSE_RANDOM, .rows = 8, .radius = 0.5f}
+  };
+  engine = GenerationEngine_Create(GENES, min, max, slices, 2, 4);
+  const float best[GENES] = {0.9f, 0.0f, 15.0f, 50.0f};
+  memcpy(engine->current[5], best, sizeof(best));
+  for (size_t i = 0; i < engine->rows; i++){ engine->fit[i] = i == 5 ? 0.0f : 1.0f; }
+
+  GenerationEngine_Step(engine);
+
+  for (size_t i = 0; i < engine->rows; i++){
+    for (size_t g = 0; g < GENES; g++){
+      TEST_ASSERT_TRUE(engine->current[i][g] >= min[g] && engine->current[i][g] <= max[g]);
+      if (i >= 8) { TEST_ASSERT_FLOAT_WITHIN(0.5f, best[g], engine->current[i][g]); }
+    }
+  }
+}
+
+// the same seed gives the same generations
+void testSameSeed(void){
+  const GenerationSlice slices[] = {
+    {.source = GENERATION_BEST, .rows = 2},
+    {.source = GENERATION_TOURNAMENT, .rows = 20, .points = {2}, .pointsCount = 1, .mutation = 0.2f}
+  };
+  engine = GenerationEngine_Create(GENES, min, max, slices, 2, 9);
+  GenerationEngine *other = GenerationEngine_Create(GENES, min, max, slices, 2, 9);
+
+  for (int generation = 0; generation < 5; generation++){
+    for (size_t i = 0; i < engine->rows; i++){
+      engine->fit[i] = other->fit[i] = engine->current[i][0] + engine->current[i][3];
+    }
+    GenerationEngine_Step(engine);
+    GenerationEngine_Step(other);
+  }
+
+  for (size_t i = 0; i < engine->rows; i++){ TEST_ASSERT_EQUAL_FLOAT_ARRAY(other->current[i], engine->current[i], GENES); }
+  GenerationEngine_Destroy(other);
+}
+
+int main(){
+  UNITY_BEGIN();
+
+  RUN_TEST(testCreateAndSwap);
+  RUN_TEST(testBestRepeats);
+  RUN_TEST(testTournamentCrossover);
+  RUN_TEST(testMutationAndCloseRandom);
+  RUN_TEST(testSameSeed);
+
+  return UNITY_END();
+}
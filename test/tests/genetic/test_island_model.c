@@ -0,0 +1,103 @@
+#include "genetic/island_model.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "unity/unity.h"
+
+#define GENES 6
+#define ISLANDS 4
+
+static const float min[GENES] = {-5, -5, -5, -5, -5, -5};
+static const float max[GENES] = { 5,  5,  5,  5,  5,  5};
+
+static size_t calls[ISLANDS];
+
+// the sum of squares, the best is 0 in the middle of the bounds, each island counts its own rows
+static void sphere(float *const *genomes, const size_t count, float *fit, const size_t island, void *context){
+  (void)context;
+  calls[island] += count;
+
+  for (size_t i = 0; i < count; i++){
+    fit[i] = 0.0f;
+    for (int g = 0; g < GENES; g++){ fit[i] += genomes[i][g] * genomes[i][g]; }
+  }
+}
+
+static const GenerationSlice slices[] = {
+  {.source = GENERATION_BEST, .rows = 2},
+  {.source = GENERATION_TOURNAMENT, .rows = 28, .points = {GENES / 2}, .pointsCount = 1, .mutation = 0.1f}
+};
+
+static IslandConfig makeConfig(const IslandTopology topology){
+  const IslandConfig config = {
+    .islands = ISLANDS, .genes = GENES, .min = min, .max = max,
+    .slices = slices, .sliceCount = 2, .generations = 150,
+    .topology = topology, .interval = 5, .migrants = 2, .seed = 21
+  };
+  return config;
+}
+
+void setUp(void){
+  for (int i = 0; i < ISLANDS; i++){ calls[i] = 0; }
+}
+void tearDown(void){}
+
+// each island evaluates all its generations and the migrations reach the mailboxes
+void testIslandModelRing(void){
+  const IslandConfig config = makeConfig(ISLAND_RING);
+  float best[GENES];
+  IslandResult result;
+
+  IslandModel_Run(&config, sphere, NULL, best, &result);
+
+  for (int i = 0; i < ISLANDS; i++){ TEST_ASSERT_EQUAL_size_t(30 * 150, calls[i]); }
+  TEST_ASSERT_EQUAL_size_t(ISLANDS * 30 * 150, result.evaluations);
+  TEST_ASSERT_EQUAL_size_t(ISLANDS * ((150 - 1) / 5), result.sent + result.dropped);
+  TEST_ASSERT_TRUE(result.sent > 0);
+  TEST_ASSERT_TRUE(result.bestFit < 0.5f);
+  TEST_ASSERT_TRUE(result.island < ISLANDS);
+
+  float fit;
+  float *genome = best;
+  sphere(&genome, 1, &fit, 0, NULL);
+  TEST_ASSERT_EQUAL_FLOAT(result.bestFit, fit);
+}
+
+// the random topology converges the same way and keeps the genes in the bounds
+void testIslandModelRandom(void){
+  const IslandConfig config = makeConfig(ISLAND_RANDOM);
+  float best[GENES];
+  IslandResult result;
+
+  IslandModel_Run(&config, sphere, NULL, best, &result);
+
+  TEST_ASSERT_TRUE(result.sent > 0);
+  TEST_ASSERT_TRUE(result.bestFit < 0.5f);
+  for (int g = 0; g < GENES; g++){ TEST_ASSERT_TRUE(best[g] >= min[g] && best[g] <= max[g]); }
+}
+
+// without the migration the islands are independent, so the run is repeatable
+void testIslandModelNoMigration(void){
+  IslandConfig config = makeConfig(ISLAND_RING);
+  config.interval = 0;
+  float first[GENES], second[GENES];
+  IslandResult a, b;
+
+  IslandModel_Run(&config, sphere, NULL, first, &a);
+  IslandModel_Run(&config, sphere, NULL, second, &b);
+
+  TEST_ASSERT_EQUAL_size_t(0, a.sent + a.dropped);
+  TEST_ASSERT_EQUAL_FLOAT(a.bestFit, b.bestFit);
+  TEST_ASSERT_EQUAL_size_t(a.island, b.island);
+  TEST_ASSERT_EQUAL_FLOAT_ARRAY(first, second, GENES);
+}
+
+int main(){
+  UNITY_BEGIN();
+
+  RUN_TEST(testIslandModelRing);
+  RUN_TEST(testIslandModelRandom);
+  RUN_TEST(testIslandModelNoMigration);
+
+  return UNITY_END();
+}
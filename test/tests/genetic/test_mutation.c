@@ -0,0 +1,107 @@
+#include "genetic/mutation.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "unity/unity.h"
+
+#define WIDTH 3
+#define ROWS 100000
+#define COUNT (WIDTH * ROWS)
+
+static const float min[WIDTH] = {-1.0f, 0.0f, 10.0f};
+static const float max[WIDTH] = { 1.0f, 5.0f, 20.0f};
+
+static float genes[COUNT];
+static float original[COUNT];
+
+// the rows in the middle of the bounds, the mutated genes are the changed ones
+static void fillMiddle(void){
+  for (size_t i = 0; i < COUNT; i++){ genes[i] = original[i] = 0.5f * (min[i % WIDTH] + max[i % WIDTH]); }
+}
+
+static size_t countChanged(void){
+  size_t changed = 0;
+  for (size_t i = 0; i < COUNT; i++){
+    TEST_ASSERT_TRUE(genes[i] >= min[i % WIDTH] && genes[i] <= max[i % WIDTH]);
+    changed += genes[i] != original[i];
+  }
+  return changed;
+}
+
+void setUp(void){ fillMiddle(); }
+void tearDown(void){}
+
+// the number of mutations follows the chance, the gaps cover the whole flat buffer
+void testMutationUniformChance(void){
+  const Mutation mutation = {.kind = MUTATION_UNIFORM, .chance = 0.01f};
+  Random random;
+  Random_Seed(&random, 1);
+
+  const size_t mutations = Mutation_Apply(&mutation, &random, genes, COUNT, WIDTH, min, max);
+
+  TEST_ASSERT_INT_WITHIN(COUNT / 100 / 10, COUNT / 100, (int)mutations);
+  TEST_ASSERT_EQUAL_size_t(mutations, countChanged());
+
+  size_t last = 0;
+  for (size_t i = 0; i < COUNT; i++){ if (genes[i] != original[i]) { last = i; } }
+  TEST_ASSERT_TRUE(last > COUNT - COUNT / 50);
+}
+
+// the chance 0 keeps the genes, the chance 1 mutates each of them
+void testMutationEdgeChances(void){
+  Mutation mutation = {.kind = MUTATION_UNIFORM, .chance = 0.0f};
+  Random random;
+  Random_Seed(&random, 2);
+
+  TEST_ASSERT_EQUAL_size_t(0, Mutation_Apply(&mutation, &random, genes, COUNT, WIDTH, min, max));
+  TEST_ASSERT_EQUAL_FLOAT_ARRAY(original, genes, COUNT);
+
+  mutation.chance = 1.0f;
+  TEST_ASSERT_EQUAL_size_t(COUNT, Mutation_Apply(&mutation, &random, genes, COUNT, WIDTH, min, max));
+  TEST_ASSERT_TRUE(countChanged() > COUNT - 10);
+}
+
+// the Gaussian steps are small relative to the range and clipped to the bounds
+void testMutationGaussian(void){
+  const Mutation mutation = {.kind = MUTATION_GAUSSIAN, .chance = 0.05f, .sigma = 0.01f};
+  Random random;
+  Random_Seed(&random, 3);
+
+  const size_t mutations = Mutation_Apply(&mutation, &random, genes, COUNT, WIDTH, min, max);
+  TEST_ASSERT_EQUAL_size_t(mutations, countChanged());
+
+  for (size_t i = 0; i < COUNT; i++){
+    const size_t g = i % WIDTH;
+    TEST_ASSERT_FLOAT_WITHIN(0.06f * (max[g] - min[g]), original[i], genes[i]);
+  }
+
+  // the big steps from the bound stay on the bound
+  const Mutation wide = {.kind = MUTATION_GAUSSIAN, .chance = 1.0f, .sigma = 10.0f};
+  for (size_t i = 0; i < COUNT; i++){ genes[i] = original[i] = max[i % WIDTH]; }
+  Mutation_Apply(&wide, &random, genes, COUNT, WIDTH, min, max);
+  countChanged();
+}
+
+// the same stream gives the same mutations
+void testMutationRepeatable(void){
+  const Mutation mutation = {.kind = MUTATION_GAUSSIAN, .chance = 0.001f, .sigma = 0.1f};
+  Random first, second;
+  Random_Stream(&first, 7, 3);
+  Random_Stream(&second, 7, 3);
+
+  Mutation_Apply(&mutation, &first, genes, COUNT, WIDTH, min, max);
+  Mutation_Apply(&mutation, &second, original, COUNT, WIDTH, min, max);
+  TEST_ASSERT_EQUAL_FLOAT_ARRAY(original, genes, COUNT);
+}
+
+int main(void){
+  UNITY_BEGIN();
+
+  RUN_TEST(testMutationUniformChance);
+  RUN_TEST(testMutationEdgeChances);
+  RUN_TEST(testMutationGaussian);
+  RUN_TEST(testMutationRepeatable);
+
+  return UNITY_END();
+}
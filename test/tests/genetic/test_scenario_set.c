@@ -0,0 +1,280 @@
+#include "genetic/scenario_set.h"
+#include "general/pid_controller.h"
+#include "general/signal_generator.h"
+#include "general/systems_builder.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "unity/unity.h"
+
+#define DT 0.01f
+#define ROWS 13
+
+static Signal reference;
+static Signal slow;
+static SignalGenerator slowGenerator;
+static float outputMemory[4096];
+static float dataSystem[64];
+
+static float rowData[ROWS][20];
+static float *rows[ROWS];
+
+static const int neurons[3]    = {3, 4, 1};
+static const int layerTypes[3] = {0, 1, 0};
+static const float inputMin[3] = {-2.0f, -5.0f, -2.0f};
+static const float inputMax[3] = { 2.0f,  5.0f,  2.0f};
+
+static float hyperbolic(float x){ return tanhf(x); }
+static void plainFeatures(float *data, const void *context){ (void)data; (void)context; }
+
+// first order plant y' = u - y with the Euler step, data is [u, dt, y]
+static float firstOrder(float *data){
+  data[2] += data[1] * (data[0] - data[2]);
+  return data[2];
+}
+
+// build the pid by hand, createNewPidController asks the CLI
+static void preparePid(PID *pid, Signal *output){
+  output->signal = outputMemory;
+  output->dt     = DT;
+  output->length = reference.length;
+
+  pid->signal         = &reference;
+  pid->output         = output;
+  pid->func_system    = complexYDddotStateSpace;
+  pid->sizeDataSystem = 5;
+  pid->dataSystem     = dataSystem;
+
+  pid->tauI = 1;
+  pid->limMax = 10;
+  pid->limMin = -10;
+  pid->limMaxInt = 5;
+  pid->limMinInt = -5;
+  pid->plantGain = 1;
+  pid->trace = NULL;
+
+  ControlMetrics_Init(&pid->metrics, 0, NULL, DT);
+}
+
+static ClosedLoopLayout* createLayout(const float plantGain){
+  ClosedLoopConfig config;
+  config.layers     = 3;
+  config.neurons    = neurons;
+  config.layerTypes = layerTypes;
+  config.inputMin   = inputMin;
+  config.inputMax   = inputMax;
+  config.outputMin  = -5.0f;
+  config.outputMax  =  5.0f;
+  config.activation = hyperbolic;
+  config.features     = plainFeatures;
+  config.featureContext = NULL;
+  config.featureSize  = 4;
+  config.featureStart = 1;
+  config.plant     = firstOrder;
+  config.plantSize = 3;
+  config.plantStates = 1;
+  config.plantGain = plantGain;
+  config.minOutput = -10.0f;
+  config.maxOutput =  10.0f;
+  config.dt = DT;
+  config.decimation = 1;
+  config.fastForward = 0;
+  config.steadyTolerance = 1e-5f;
+  return ClosedLoopKernel_CreateLayout(&config);
+}
+
+void setUp(void) {
+  const float map[3][3] = {{0.0f, 2.0f, 1.0f}, {2.0f, 4.0f, -0.5f}, {4.0f, 6.0f, 2.0f}};
+  SignalGenerator generator;
+  SignalGenerator_InitSteps(&generator, map, 3, DT);
+  SignalGenerator_Materialize(&generator, &reference);
+
+  const float slowMap[1][3] = {{0.0f, 3.0f, 1.5f}};
+  SignalGenerator_InitSteps(&slowGenerator, slowMap, 1, DT);
+  SignalGenerator_Materialize(&slowGenerator, &slow);
+
+  // a mix of good, oscillating and lazy controllers, the NN rows are small weights
+  for (int i = 0; i < ROWS; i++){
+    rowData[i][0] = 0.5f + 0.37f * (float)(i % 11);
+    rowData[i][1] = 0.2f * (float)(i % 7);
+    rowData[i][2] = 0.05f * (float)(i % 5);
+    rowData[i][3] = 0.01f + 0.1f * (float)(i % 3);
+    for (int j = 4; j < 20; j++){ rowData[i][j] = 0.3f * sinf(1.7f * (float)(j + i) + 0.4f); }
+    rows[i] = rowData[i];
+  }
+}
+
+void tearDown(void) {
+  free(reference.signal);
+  free(slow.signal);
+  releaseSystems();
+}
+
+void testAddScenario(void){
+  ScenarioSet *set = createScenarioSet(SCENARIO_SUM);
+
+  for (int s = 0; s < 5; s++){
+    addScenario(set, &reference, complexYDddotStateSpace, 5, 1.0f + 0.1f * (float)s, (float)s);
+  }
+
+  TEST_ASSERT_EQUAL_INT(5, set->count);
+  TEST_ASSERT_EQUAL_INT(8, set->capacity);
+  TEST_ASSERT_EQUAL_PTR(&reference, set->scenarios[4].signal);
+  TEST_ASSERT_EQUAL_INT(5, set->scenarios[4].sizeDataSystem);
+  TEST_ASSERT_EQUAL_FLOAT(1.4f, set->scenarios[4].plantGain);
+  TEST_ASSERT_EQUAL_FLOAT(4.0f, set->scenarios[4].weight);
+
+  // the plant is discretized by the set for the dt of its signals
+  TEST_ASSERT_NOT_NULL(getSystemStateSpace(complexYDddotStateSpace, DT));
+
+  deleteScenarioSet(set);
+}
+
+void testReduceScenarioFits(void){
+  ScenarioSet *set = createScenarioSet(SCENARIO_SUM);
+  addScenario(set, &reference, complexYDddotStateSpace, 5, 1.0f, 0.5f);
+  addScenario(set, &reference, complexYDddotStateSpace, 5, 1.2f, 2.0f);
+  addScenario(set, &reference, complexYDddotStateSpace, 5, 0.8f, 1.0f);
+
+  const float fits[3] = {1.0f, 4.0f, 2.0f};
+  const float failed[3] = {1.0f, FLT_MAX, 2.0f};
+
+  float result = reduceScenarioFits(set, fits);
+  TEST_ASSERT_EQUAL_FLOAT(7.0f, result);
+  result = reduceScenarioFits(set, failed);
+  TEST_ASSERT_EQUAL_FLOAT(FLT_MAX, result);
+
+  set->reduction = SCENARIO_MAX;
+  result = reduceScenarioFits(set, fits);
+  TEST_ASSERT_EQUAL_FLOAT(4.0f, result);
+  result = reduceScenarioFits(set, failed);
+  TEST_ASSERT_EQUAL_FLOAT(FLT_MAX, result);
+
+  set->reduction = SCENARIO_WEIGHTED;
+  result = reduceScenarioFits(set, fits);
+  TEST_ASSERT_EQUAL_FLOAT(0.5f + 8.0f + 2.0f, result);
+  result = reduceScenarioFits(set, failed);
+  TEST_ASSERT_EQUAL_FLOAT(FLT_MAX, result);
+
+  deleteScenarioSet(set);
+}
+
+// the parallel pass gives the same fits as the one by one simulation of each scenario
+void testEvaluatePidScenarios(void){
+  PID pid;
+  Signal output;
+  preparePid(&pid, &output);
+
+  ScenarioSet *set = createScenarioSet(SCENARIO_WEIGHTED);
+  set->threads = 3;
+  addScenario(set, &reference, complexYDddotStateSpace, 5, 1.0f, 1.0f);
+  addScenario(set, &slow, complexYDddotStateSpace, 5, 0.7f, 0.5f);
+
+  float fit[ROWS];
+  evaluatePidScenarios(set, &pid, rows, ROWS, fit);
+
+  for (int i = 0; i < ROWS; i++){
+    float fits[2];
+    for (int s = 0; s < 2; s++){
+      pid.Kp   = rows[i][0];
+      pid.Ki   = rows[i][1];
+      pid.Kd   = rows[i][2];
+      pid.tauD = rows[i][3];
+      pid.signal         = set->scenarios[s].signal;
+      pid.output->length = set->scenarios[s].signal->length;
+      pid.plantGain      = set->scenarios[s].plantGain;
+      makeSimulationOfSignal(&pid, NULL, 0);
+      fits[s] = pid.fit;
+    }
+    const float expected = reduceScenarioFits(set, fits);
+    TEST_ASSERT_EQUAL_MEMORY(&expected, &fit[i], sizeof(float));
+  }
+
+  deleteScenarioSet(set);
+}
+
+// each scenario runs on its own layout, the shared states of the threads fit all of them and are kept by the set
+void testEvaluateKernelScenarios(void){
+  ScenarioSet *set = createScenarioSet(SCENARIO_MAX);
+  set->threads = 4;
+  addScenario(set, &reference, firstOrder, 3, 1.0f, 1.0f);
+  addScenario(set, &slow, firstOrder, 3, 0.6f, 1.0f);
+
+  ClosedLoopLayout *layouts[2] = {createLayout(1.0f), createLayout(0.6f)};
+  ClosedLoopState *state = ClosedLoopKernel_CreateState(layouts[0]);
+
+  float fit[ROWS];
+  evaluateKernelScenarios(set, layouts, NULL, rows, ROWS, fit);
+
+  for (int i = 0; i < ROWS; i++){
+    float fits[2];
+    for (int s = 0; s < 2; s++){
+      const Signal *signal = set->scenarios[s].signal;
+      fits[s] = ClosedLoopKernel_Simulate(layouts[s], state, rows[i], signal->signal, (size_t)signal->length, NULL);
+    }
+    const float expected = reduceScenarioFits(set, fits);
+    TEST_ASSERT_EQUAL_MEMORY(&expected, &fit[i], sizeof(float));
+  }
+
+  // the states of the threads are allocated once and reused by the next generation
+  ClosedLoopState **states = set->kernelStates;
+  TEST_ASSERT_EQUAL_INT(4, set->kernelStatesCount);
+
+  float again[ROWS];
+  evaluateKernelScenarios(set, layouts, NULL, rows, ROWS, again);
+  TEST_ASSERT_EQUAL_PTR(states, set->kernelStates);
+  TEST_ASSERT_EQUAL_MEMORY(fit, again, sizeof(fit));
+
+  // more threads grow the states
+  set->threads = 6;
+  evaluateKernelScenarios(set, layouts, NULL, rows, ROWS, again);
+  TEST_ASSERT_EQUAL_INT(6, set->kernelStatesCount);
+  TEST_ASSERT_EQUAL_MEMORY(fit, again, sizeof(fit));
+
+  ClosedLoopKernel_DestroyState(state);
+  ClosedLoopKernel_DestroyLayout(layouts[0]);
+  ClosedLoopKernel_DestroyLayout(layouts[1]);
+  deleteScenarioSet(set);
+}
+
+// the generated scenario is streamed by the kernel and gives the same fits as its materialized signal
+void testEvaluateGeneratedScenarios(void){
+  ScenarioSet *streamed = createScenarioSet(SCENARIO_SUM);
+  ScenarioSet *materialized = createScenarioSet(SCENARIO_SUM);
+  streamed->threads = 3;
+  materialized->threads = 3;
+
+  addScenario(streamed, &reference, firstOrder, 3, 1.0f, 1.0f);
+  addGeneratedScenario(streamed, &slowGenerator, firstOrder, 3, 0.6f, 1.0f);
+  addScenario(materialized, &reference, firstOrder, 3, 1.0f, 1.0f);
+  addScenario(materialized, &slow, firstOrder, 3, 0.6f, 1.0f);
+
+  TEST_ASSERT_NULL(streamed->scenarios[1].signal);
+  TEST_ASSERT_EQUAL_size_t((size_t)slow.length, streamed->scenarios[1].generator.length);
+
+  ClosedLoopLayout *layouts[2] = {createLayout(1.0f), createLayout(0.6f)};
+
+  float fit[ROWS], expected[ROWS];
+  evaluateKernelScenarios(streamed, layouts, NULL, rows, ROWS, fit);
+  evaluateKernelScenarios(materialized, layouts, NULL, rows, ROWS, expected);
+  TEST_ASSERT_EQUAL_MEMORY(expected, fit, sizeof(fit));
+
+  ClosedLoopKernel_DestroyLayout(layouts[0]);
+  ClosedLoopKernel_DestroyLayout(layouts[1]);
+  deleteScenarioSet(streamed);
+  deleteScenarioSet(materialized);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(testAddScenario);
+  RUN_TEST(testReduceScenarioFits);
+  RUN_TEST(testEvaluatePidScenarios);
+  RUN_TEST(testEvaluateKernelScenarios);
+  RUN_TEST(testEvaluateGeneratedScenarios);
+
+  return UNITY_END();
+}
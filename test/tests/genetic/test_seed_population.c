@@ -0,0 +1,101 @@
+#include "genetic/seed_population.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "unity/unity.h"
+
+#define ROWS 20
+#define GENES 100
+#define GENERATIONS 60
+
+static float weights[ROWS][GENES];
+static float previous[ROWS][GENES];
+
+void setUp(void){}
+void tearDown(void){}
+
+// the weights should reach 0.5, so the fit is the squared distance from it
+static float distance(const float *x){
+  float sum = 0.0f;
+  for (int j = 0; j < GENES; j++){ sum += (x[j] - 0.5f) * (x[j] - 0.5f); }
+  return sum;
+}
+
+// the decoding is repeatable and the first step is the noise of the initial deviation
+void testSeedPopulationDecode(void){
+  SeedPopulation *population = SeedPopulation_Create(ROWS, GENES, GENERATIONS, 2.0f, 0.1f, 5, 1, 1);
+
+  SeedPopulation_Decode(population, 3, weights[0]);
+  SeedPopulation_Decode(population, 3, weights[1]);
+  TEST_ASSERT_EQUAL_FLOAT_ARRAY(weights[0], weights[1], GENES);
+
+  double squares = 0.0;
+  for (int j = 0; j < GENES; j++){ squares += weights[0][j] * weights[0][j]; }
+  TEST_ASSERT_FLOAT_WITHIN(1.0f, 4.0f, (float)(squares / GENES));
+
+  SeedPopulation_Decode(population, 4, weights[1]);
+  TEST_ASSERT_FALSE(memcmp(weights[0], weights[1], sizeof(weights[0])) == 0);
+
+  SeedPopulation_Destroy(population);
+}
+
+// the elite rows keep the list of the best row, the children have one step more than their parent
+void testSeedPopulationStep(void){
+  SeedPopulation *population = SeedPopulation_Create(ROWS, GENES, GENERATIONS, 1.0f, 0.1f, 5, 2, 2);
+  for (int i = 0; i < ROWS; i++){ population->fit[i] = (float)(ROWS - i); }
+
+  SeedPopulation_Step(population);
+
+  TEST_ASSERT_EQUAL_INT(ROWS - 1, population->parents[0]);
+  TEST_ASSERT_EQUAL_INT(ROWS - 2, population->parents[1]);
+  TEST_ASSERT_EQUAL_size_t(1, population->lengths[0]);
+  for (int i = 2; i < ROWS; i++){
+    TEST_ASSERT_TRUE(population->parents[i] >= ROWS - 5);
+    TEST_ASSERT_EQUAL_size_t(2, population->lengths[i]);
+    TEST_ASSERT_EQUAL_FLOAT(0.1f, SeedPopulation_GetLastStep(population, i)->scale);
+  }
+
+  SeedPopulation_Destroy(population);
+}
+
+// the child made from the weights of its parent by its last step is the same as the whole decoding, and the run
+// improves the fit while it stores only the steps
+void testSeedPopulationRun(void){
+  SeedPopulation *population = SeedPopulation_Create(ROWS, GENES, GENERATIONS, 1.0f, 0.05f, 5, 1, 3);
+  for (int i = 0; i < ROWS; i++){ SeedPopulation_Decode(population, i, weights[i]); }
+
+  float first = 0.0f;
+  for (int g = 0; g < GENERATIONS; g++){
+    for (int i = 0; i < ROWS; i++){ population->fit[i] = distance(weights[i]); }
+    if (g == 0) { first = population->fit[SeedPopulation_GetBest(population)]; }
+
+    SeedPopulation_Step(population);
+
+    memcpy(previous, weights, sizeof(weights));
+    for (int i = 0; i < ROWS; i++){
+      const size_t parent = (size_t)population->parents[i];
+      memcpy(weights[i], previous[parent], sizeof(weights[i]));
+      if (i >= 1) { SeedPopulation_Perturb(SeedPopulation_GetLastStep(population, i), weights[i], GENES); }
+    }
+  }
+  for (int i = 0; i < ROWS; i++){ population->fit[i] = distance(weights[i]); }
+  const size_t best = SeedPopulation_GetBest(population);
+
+  SeedPopulation_Decode(population, best, previous[0]);
+  TEST_ASSERT_EQUAL_FLOAT_ARRAY(previous[0], weights[best], GENES);
+  TEST_ASSERT_TRUE(population->fit[best] < 0.8f * first);
+  TEST_ASSERT_TRUE(population->lengths[best] <= GENERATIONS + 1);
+
+  SeedPopulation_Destroy(population);
+}
+
+int main(void){
+  UNITY_BEGIN();
+
+  RUN_TEST(testSeedPopulationDecode);
+  RUN_TEST(testSeedPopulationStep);
+  RUN_TEST(testSeedPopulationRun);
+
+  return UNITY_END();
+}
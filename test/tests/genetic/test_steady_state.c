@@ -0,0 +1,89 @@
+#include "genetic/steady_state.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include "unity/unity.h"
+
+#define GENES 6
+
+static const float min[GENES] = {-5, -5, -5, -5, -5, -5};
+static const float max[GENES] = { 5,  5,  5,  5,  5,  5};
+
+// the sum of squares, the best is 0 in the middle of the bounds
+static float sphere(float *genome, const size_t thread, void *context){
+  (void)thread;
+  size_t *calls = context;
+  __atomic_add_fetch(calls, 1, __ATOMIC_RELAXED);
+
+  float fit = 0.0f;
+  for (int g = 0; g < GENES; g++){ fit += genome[g] * genome[g]; }
+  return fit;
+}
+
+static SteadyStateConfig makeConfig(const size_t threads){
+  const SteadyStateConfig config = {
+    .genes = GENES, .min = min, .max = max,
+    .population = 40, .evaluations = 4000, .threads = threads,
+    .point = GENES / 2, .mutation = 0.15f, .seed = 11
+  };
+  return config;
+}
+
+void setUp(void){}
+void tearDown(void){}
+
+// every child is evaluated once and the good ones replace the worst
+void testSteadyStateSingleThread(void){
+  const SteadyStateConfig config = makeConfig(1);
+  float best[GENES];
+  size_t calls = 0;
+  SteadyStateResult result;
+
+  SteadyState_Run(&config, sphere, &calls, best, &result);
+
+  TEST_ASSERT_EQUAL_size_t(4040, calls);
+  TEST_ASSERT_EQUAL_size_t(4040, result.evaluations);
+  TEST_ASSERT_TRUE(result.replacements > 0 && result.replacements < 4000);
+  TEST_ASSERT_TRUE(result.bestFit < 0.5f);
+
+  float *genome = best;
+  TEST_ASSERT_EQUAL_FLOAT(result.bestFit, sphere(genome, 0, &calls));
+}
+
+// one worker thread gives the same run for the same seed
+void testSteadyStateRepeatable(void){
+  const SteadyStateConfig config = makeConfig(1);
+  float first[GENES], second[GENES];
+  size_t calls = 0;
+  SteadyStateResult a, b;
+
+  SteadyState_Run(&config, sphere, &calls, first, &a);
+  SteadyState_Run(&config, sphere, &calls, second, &b);
+
+  TEST_ASSERT_EQUAL_FLOAT_ARRAY(first, second, GENES);
+  TEST_ASSERT_EQUAL_size_t(a.replacements, b.replacements);
+}
+
+// the workers without the barrier still make all the evaluations and converge
+void testSteadyStateThreads(void){
+  const SteadyStateConfig config = makeConfig(4);
+  float best[GENES];
+  size_t calls = 0;
+  SteadyStateResult result;
+
+  SteadyState_Run(&config, sphere, &calls, best, &result);
+
+  TEST_ASSERT_EQUAL_size_t(4040, calls);
+  TEST_ASSERT_TRUE(result.bestFit < 0.5f);
+  for (int g = 0; g < GENES; g++){ TEST_ASSERT_TRUE(best[g] >= min[g] && best[g] <= max[g]); }
+}
+
+int main(){
+  UNITY_BEGIN();
+
+  RUN_TEST(testSteadyStateSingleThread);
+  RUN_TEST(testSteadyStateRepeatable);
+  RUN_TEST(testSteadyStateThreads);
+
+  return UNITY_END();
+}
@@ -0,0 +1,444 @@
+#include "neural/closed_loop_kernel.h"
+#include "neural/feature_engine.h"
+#include "general/systems_builder.h"
+#include "general/signal_generator.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "unity/unity.h"
+
+#define DT 0.01f
+
+static const int neurons[3]    = {3, 4, 1};
+static const int layerTypes[3] = {0, 1, 0};
+static const float inputMin[3] = {-2.0f, -5.0f, -2.0f};
+static const float inputMax[3] = { 2.0f,  5.0f,  2.0f};
+
+static float identity(float x){ return x; }
+static float hyperbolic(float x){ return tanhf(x); }
+
+// the features are e, u, y as they are
+static void plainFeatures(float *data, const void *context){ (void)data; (void)context; }
+
+// first order plant y' = u - y with the Euler step
+static float firstOrder(float *data){
+  data[2] += data[1] * (data[0] - data[2]);
+  return data[2];
+}
+
+// the third NN input is dy/dt at the controller rate, data[4] keeps the previous y
+static void derivativeFeatures(float *data, const void *context){
+  (void)context;
+  const float y = data[3];
+  data[3] = (y - data[4]) / data[0];
+  data[4] = y;
+}
+
+// the features of the engine in the context, the same layout as typeLags: data[4..7) features, then the history
+static void engineFeatures(float *data, const void *context){
+  const FeatureEngine *engine = context;
+  FeatureEngine_Push(engine, data + 4 + engine->count, data[0], &data[1], &data[2], &data[3], data + 4);
+}
+
+static ClosedLoopConfig makeConfig(float (*activation)(float), const int decimation){
+  ClosedLoopConfig config;
+  config.layers     = 3;
+  config.neurons    = neurons;
+  config.layerTypes = layerTypes;
+  config.inputMin   = inputMin;
+  config.inputMax   = inputMax;
+  config.outputMin  = -5.0f;
+  config.outputMax  =  5.0f;
+  config.activation = activation;
+  config.features     = plainFeatures;
+  config.featureContext = NULL;
+  config.featureSize  = 4;
+  config.featureStart = 1;
+  config.plant     = firstOrder;
+  config.plantSize = 3;
+  config.plantStates = 1;
+  config.plantGain = 1.0f;
+  config.minOutput = -10.0f;
+  config.maxOutput =  10.0f;
+  config.dt = DT;
+  config.decimation = decimation;
+  config.fastForward = 0;
+  config.steadyTolerance = 1e-5f;
+  return config;
+}
+
+// the straight forward network with the same math as oneCalculation, the SD layer has types {0, 0, 1, 2}
+static float referenceForward(const float *weights, const float *features, float *memory, float (*activation)(float)){
+  float input[3], hidden[4];
+  for (int i = 0; i < 3; i++){
+    const float value = (features[i] - inputMin[i]) / (inputMax[i] - inputMin[i]) * 2.0f - 1.0f;
+    input[i] = value > 1.0f ? 1.0f : (value < -1.0f ? -1.0f : value);
+  }
+  for (int r = 0; r < 4; r++){
+    float sum = -weights[12 + r];
+    for (int c = 0; c < 3; c++){ sum += weights[r * 3 + c] * input[c]; }
+    hidden[r] = activation(sum);
+  }
+  // the D neuron saves -input, the S neuron saves its output
+  const float dInput = hidden[3];
+  for (int r = 0; r < 4; r++){ hidden[r] += memory[r]; }
+  memory[2] = hidden[2];
+  memory[3] = -dInput;
+
+  float sum = 0.0f;
+  for (int c = 0; c < 4; c++){ sum += weights[16 + c] * hidden[c]; }
+  const float value = (activation(sum) + 1.0f) / 2.0f * 10.0f - 5.0f;
+  return value > 5.0f ? 5.0f : (value < -5.0f ? -5.0f : value);
+}
+
+static void fillWeights(float *weights){
+  for (int i = 0; i < 20; i++){ weights[i] = 0.3f * sinf(1.7f * (float)i + 0.4f); }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void testClosedLoopKernel_Layout(void){
+  const ClosedLoopConfig config = makeConfig(identity, 1);
+  ClosedLoopLayout *layout = ClosedLoopKernel_CreateLayout(&config);
+
+  TEST_ASSERT_EQUAL_size_t(20, layout->weightCount);
+  TEST_ASSERT_EQUAL_size_t(0, layout->weightOffset[0]);
+  TEST_ASSERT_EQUAL_size_t(12, layout->biasOffset[0]);
+  TEST_ASSERT_EQUAL_size_t(16, layout->weightOffset[1]);
+  TEST_ASSERT_EQUAL_UINT8(1, layout->sdTypes[2]);
+  TEST_ASSERT_EQUAL_UINT8(2, layout->sdTypes[3]);
+  TEST_ASSERT_EQUAL_size_t(3 + 4 + 2 * 4 + 4, layout->stateSize);
+
+  ClosedLoopKernel_DestroyLayout(layout);
+}
+
+void testClosedLoopKernel_MatchesReference(void){
+  const ClosedLoopConfig config = makeConfig(hyperbolic, 1);
+  ClosedLoopLayout *layout = ClosedLoopKernel_CreateLayout(&config);
+  ClosedLoopState *state = ClosedLoopKernel_CreateState(layout);
+
+  float weights[20];
+  fillWeights(weights);
+  ClosedLoopKernel_Reset(layout, state, weights);
+
+  float memory[4] = {0};
+  float plant[3] = {0, DT, 0};
+  float u = 0.0f, y = 0.0f;
+
+  for (int k = 0; k < 200; k++){
+    const float reference = k < 50 ? 0.0f : 1.0f;
+
+    const float features[3] = {reference - y, u, y};
+    u = referenceForward(weights, features, memory, hyperbolic);
+    plant[0] = u;
+    y = firstOrder(plant);
+
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, y, ClosedLoopKernel_Step(layout, state, reference));
+  }
+
+  ClosedLoopKernel_DestroyState(state);
+  ClosedLoopKernel_DestroyLayout(layout);
+}
+
+void testClosedLoopKernel_DecimationHoldsU(void){
+  const ClosedLoopConfig config = makeConfig(hyperbolic, 3);
+  ClosedLoopLayout *layout = ClosedLoopKernel_CreateLayout(&config);
+  ClosedLoopState *state = ClosedLoopKernel_CreateState(layout);
+
+  float weights[20];
+  fillWeights(weights);
+  ClosedLoopKernel_Reset(layout, state, weights);
+
+  // the features get the controller step
+  TEST_ASSERT_EQUAL_FLOAT(3 * DT, state->data[layout->featureOffset]);
+
+  float held = 0.0f;
+  for (int k = 0; k < 30; k++){
+    ClosedLoopKernel_Step(layout, state, 1.0f);
+    if (k % 3 == 0) { held = state->data[0]; }
+    TEST_ASSERT_EQUAL_FLOAT(held, state->data[0]);
+  }
+
+  ClosedLoopKernel_DestroyState(state);
+  ClosedLoopKernel_DestroyLayout(layout);
+}
+
+// the NN runs on the steps 0, k, 2k... with the features made at the controller step, the plant holds u between
+void testClosedLoopKernel_DecimationMatchesReference(void){
+  ClosedLoopConfig config = makeConfig(hyperbolic, 3);
+  config.features = derivativeFeatures;
+  config.featureSize = 5;
+  ClosedLoopLayout *layout = ClosedLoopKernel_CreateLayout(&config);
+  ClosedLoopState *state = ClosedLoopKernel_CreateState(layout);
+
+  float weights[20];
+  fillWeights(weights);
+  ClosedLoopKernel_Reset(layout, state, weights);
+
+  float memory[4] = {0};
+  float plant[3] = {0, DT, 0};
+  float u = 0.0f, y = 0.0f, previous = 0.0f;
+
+  for (int k = 0; k < 200; k++){
+    const float reference = k < 50 ? 0.0f : 1.0f;
+
+    if (k % 3 == 0){
+      const float features[3] = {reference - y, u, (y - previous) / (3 * DT)};
+      previous = y;
+      u = referenceForward(weights, features, memory, hyperbolic);
+    }
+    plant[0] = u;
+    y = firstOrder(plant);
+
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, y, ClosedLoopKernel_Step(layout, state, reference));
+  }
+
+  ClosedLoopKernel_DestroyState(state);
+  ClosedLoopKernel_DestroyLayout(layout);
+}
+
+// the systems with the different engines run side by side, each layout passes its own engine to the features
+void testClosedLoopKernel_FeatureContext(void){
+  const FeatureSpec shortSpecs[3] = {{FEATURE_E, FEATURE_VALUE, 0}, {FEATURE_E, FEATURE_VALUE, 1}, {FEATURE_Y, FEATURE_VALUE, 0}};
+  const FeatureSpec longSpecs[3]  = {{FEATURE_E, FEATURE_VALUE, 0}, {FEATURE_E, FEATURE_VALUE, 6}, {FEATURE_Y, FEATURE_VALUE, 0}};
+  FeatureEngine *engines[2] = {FeatureEngine_Create(shortSpecs, 3, 1), FeatureEngine_Create(longSpecs, 3, 1)};
+
+  ClosedLoopLayout *layouts[2];
+  ClosedLoopState *states[2];
+  float alone[2][100];
+
+  float weights[20];
+  fillWeights(weights);
+
+  for (int n = 0; n < 2; n++){
+    ClosedLoopConfig config = makeConfig(hyperbolic, 1);
+    config.features = engineFeatures;
+    config.featureContext = engines[n];
+    config.featureSize = 4 + 3 + engines[n]->historySize;
+    config.featureStart = 4;
+    layouts[n] = ClosedLoopKernel_CreateLayout(&config);
+    states[n] = ClosedLoopKernel_CreateState(layouts[n]);
+
+    ClosedLoopKernel_Reset(layouts[n], states[n], weights);
+    for (int k = 0; k < 100; k++){ alone[n][k] = ClosedLoopKernel_Step(layouts[n], states[n], k < 20 ? 0.0f : 1.0f); }
+  }
+
+  // the lag changes the run, and the interleaved steps give the same outputs as the runs alone
+  TEST_ASSERT_TRUE(alone[0][99] != alone[1][99]);
+
+  ClosedLoopKernel_Reset(layouts[0], states[0], weights);
+  ClosedLoopKernel_Reset(layouts[1], states[1], weights);
+  for (int k = 0; k < 100; k++){
+    const float reference = k < 20 ? 0.0f : 1.0f;
+    for (int n = 0; n < 2; n++){
+      const float output = ClosedLoopKernel_Step(layouts[n], states[n], reference);
+      TEST_ASSERT_EQUAL_FLOAT(alone[n][k], output);
+    }
+  }
+
+  for (int n = 0; n < 2; n++){
+    ClosedLoopKernel_DestroyState(states[n]);
+    ClosedLoopKernel_DestroyLayout(layouts[n]);
+    FeatureEngine_Destroy(engines[n]);
+  }
+}
+
+void testClosedLoopKernel_SimulateFit(void){
+  const ClosedLoopConfig config = makeConfig(identity, 1);
+  ClosedLoopLayout *layout = ClosedLoopKernel_CreateLayout(&config);
+  ClosedLoopState *state = ClosedLoopKernel_CreateState(layout);
+
+  float weights[20];
+  fillWeights(weights);
+
+  float reference[100];
+  for (int i = 0; i < 100; i++){ reference[i] = i < 10 ? 0.0f : 1.0f; }
+
+  const float fit = ClosedLoopKernel_Simulate(layout, state, weights, reference, 100, NULL);
+
+  // the second run of the same individual gives the same fit
+  TEST_ASSERT_EQUAL_FLOAT(fit, ClosedLoopKernel_Simulate(layout, state, weights, reference, 100, NULL));
+  TEST_ASSERT_EQUAL_size_t(99, state->step);
+  TEST_ASSERT_TRUE(fit > 0.0f);
+
+  ClosedLoopKernel_DestroyState(state);
+  ClosedLoopKernel_DestroyLayout(layout);
+}
+
+// the fast forward skips the converged part of each step and its fit stays the fit of the full run
+void testClosedLoopKernel_FastForward(void){
+  static const int feedForward[3] = {0, 0, 0};
+  static float reference[3000];
+  for (int i = 0; i < 3000; i++){ reference[i] = i < 10 ? 0.0f : (i < 1500 ? 1.0f : 0.5f); }
+
+  ClosedLoopConfig config = makeConfig(hyperbolic, 2);
+  config.layerTypes = feedForward;
+  ClosedLoopLayout *fullLayout = ClosedLoopKernel_CreateLayout(&config);
+  config.fastForward = 1;
+  ClosedLoopLayout *fastLayout = ClosedLoopKernel_CreateLayout(&config);
+
+  ClosedLoopState *fullState = ClosedLoopKernel_CreateState(fullLayout);
+  ClosedLoopState *fastState = ClosedLoopKernel_CreateState(fastLayout);
+
+  float weights[20];
+  fillWeights(weights);
+
+  const float full = ClosedLoopKernel_Simulate(fullLayout, fullState, weights, reference, 3000, NULL);
+  const float fast = ClosedLoopKernel_Simulate(fastLayout, fastState, weights, reference, 3000, NULL);
+
+  TEST_ASSERT_EQUAL_size_t(0, fullState->skipped);
+  TEST_ASSERT_TRUE(fastState->skipped > 2000);
+  TEST_ASSERT_EQUAL_size_t(fullState->step, fastState->step);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f * full, full, fast);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, fullState->y, fastState->y);
+
+  ClosedLoopKernel_DestroyState(fullState);
+  ClosedLoopKernel_DestroyState(fastState);
+  ClosedLoopKernel_DestroyLayout(fullLayout);
+  ClosedLoopKernel_DestroyLayout(fastLayout);
+}
+
+// the history of the lag features changes every step, the fast forward compares only the NN inputs
+void testClosedLoopKernel_FastForwardLags(void){
+  static const int feedForward[3] = {0, 0, 0};
+  static float reference[3000];
+  for (int i = 0; i < 3000; i++){ reference[i] = i < 10 ? 0.0f : (i < 1500 ? 1.0f : 0.5f); }
+
+  const FeatureSpec specs[3] = {{FEATURE_E, FEATURE_VALUE, 0}, {FEATURE_E, FEATURE_VALUE, 3}, {FEATURE_Y, FEATURE_VALUE, 0}};
+  FeatureEngine *engine = FeatureEngine_Create(specs, 3, 1);
+
+  ClosedLoopConfig config = makeConfig(hyperbolic, 1);
+  config.layerTypes = feedForward;
+  config.features = engineFeatures;
+  config.featureContext = engine;
+  config.featureSize = 4 + 3 + engine->historySize;
+  config.featureStart = 4;
+  ClosedLoopLayout *fullLayout = ClosedLoopKernel_CreateLayout(&config);
+  config.fastForward = 1;
+  ClosedLoopLayout *fastLayout = ClosedLoopKernel_CreateLayout(&config);
+
+  ClosedLoopState *fullState = ClosedLoopKernel_CreateState(fullLayout);
+  ClosedLoopState *fastState = ClosedLoopKernel_CreateState(fastLayout);
+
+  float weights[20];
+  fillWeights(weights);
+
+  const float full = ClosedLoopKernel_Simulate(fullLayout, fullState, weights, reference, 3000, NULL);
+  const float fast = ClosedLoopKernel_Simulate(fastLayout, fastState, weights, reference, 3000, NULL);
+
+  TEST_ASSERT_TRUE(fastState->skipped > 2000);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f * full, full, fast);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, fullState->y, fastState->y);
+
+  ClosedLoopKernel_DestroyState(fullState);
+  ClosedLoopKernel_DestroyState(fastState);
+  ClosedLoopKernel_DestroyLayout(fullLayout);
+  ClosedLoopKernel_DestroyLayout(fastLayout);
+  FeatureEngine_Destroy(engine);
+}
+
+// the step size and the counters of the integrator change in the converged loop, only the pendulum states are compared
+void testClosedLoopKernel_FastForwardPendulum(void){
+  static const int feedForward[3] = {0, 0, 0};
+  static float reference[8000];
+  for (int i = 0; i < 8000; i++){ reference[i] = i < 10 ? 0.0f : (i < 4000 ? 0.3f : 0.1f); }
+
+  float (*plant)(float*) = NULL;
+  const int plantSize = selectSystemByChoice(&plant, 5);
+
+  ClosedLoopConfig config = makeConfig(hyperbolic, 1);
+  config.layerTypes = feedForward;
+  config.plant = plant;
+  config.plantSize = (size_t)plantSize;
+  config.plantStates = (size_t)getSystemStateCount(plant, plantSize);
+  ClosedLoopLayout *fullLayout = ClosedLoopKernel_CreateLayout(&config);
+  config.fastForward = 1;
+  ClosedLoopLayout *fastLayout = ClosedLoopKernel_CreateLayout(&config);
+
+  ClosedLoopState *fullState = ClosedLoopKernel_CreateState(fullLayout);
+  ClosedLoopState *fastState = ClosedLoopKernel_CreateState(fastLayout);
+
+  float weights[20];
+  fillWeights(weights);
+
+  const float full = ClosedLoopKernel_Simulate(fullLayout, fullState, weights, reference, 8000, NULL);
+  const float fast = ClosedLoopKernel_Simulate(fastLayout, fastState, weights, reference, 8000, NULL);
+
+  // the counters of the integrator are exact, one interval for each plant step of the full run
+  OdeStats stats;
+  const int hasStats = getSystemStepStats(plant, fullState->data, &stats);
+  TEST_ASSERT_EQUAL_INT(1, hasStats);
+  TEST_ASSERT_EQUAL_size_t(fullState->step, stats.intervals);
+
+  TEST_ASSERT_EQUAL_size_t(2, fastLayout->config.plantStates);
+  TEST_ASSERT_TRUE(fastState->skipped > 2000);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f * full, full, fast);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, fullState->y, fastState->y);
+
+  ClosedLoopKernel_DestroyState(fullState);
+  ClosedLoopKernel_DestroyState(fastState);
+  ClosedLoopKernel_DestroyLayout(fullLayout);
+  ClosedLoopKernel_DestroyLayout(fastLayout);
+}
+
+// the reference pulled in chunks gives the same run as the materialized one, also with the fast forward over the chunks
+void testClosedLoopKernel_SimulateStream(void){
+  static const int feedForward[3] = {0, 0, 0};
+  const float map[3][3] = {{0.0f, 0.05f, 0.0f}, {0.05f, 17.0f, 1.0f}, {17.0f, 30.0f, 0.5f}};
+
+  SignalGenerator generators[2];
+  SignalGenerator_InitSteps(&generators[0], map, 3, DT);
+  SignalGenerator_InitRandomSteps(&generators[1], -1.0f, 1.0f, 1.0f, 4.0f, 30.0f, DT, 11);
+
+  float weights[20];
+  fillWeights(weights);
+
+  for (int fastForward = 0; fastForward < 2; fastForward++){
+    ClosedLoopConfig config = makeConfig(hyperbolic, 2);
+    config.layerTypes = feedForward;
+    config.fastForward = fastForward;
+    ClosedLoopLayout *layout = ClosedLoopKernel_CreateLayout(&config);
+    ClosedLoopState *state = ClosedLoopKernel_CreateState(layout);
+
+    for (int g = 0; g < 2; g++){
+      Signal reference;
+      SignalGenerator_Materialize(&generators[g], &reference);
+
+      const float whole = ClosedLoopKernel_Simulate(layout, state, weights, reference.signal, (size_t)reference.length, NULL);
+      const size_t steps = state->step;
+      const size_t skipped = state->skipped;
+      const float streamed = ClosedLoopKernel_SimulateStream(layout, state, weights, &generators[g], NULL);
+
+      TEST_ASSERT_EQUAL_FLOAT(whole, streamed);
+      TEST_ASSERT_EQUAL_size_t(steps, state->step);
+      TEST_ASSERT_EQUAL_size_t(skipped, state->skipped);
+      // the long second step of the map is skipped over the chunk borders
+      if (fastForward && g == 0) { TEST_ASSERT_TRUE(state->skipped > 2 * CLOSED_LOOP_CHUNK); }
+
+      free(reference.signal);
+    }
+
+    ClosedLoopKernel_DestroyState(state);
+    ClosedLoopKernel_DestroyLayout(layout);
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(testClosedLoopKernel_Layout);
+  RUN_TEST(testClosedLoopKernel_MatchesReference);
+  RUN_TEST(testClosedLoopKernel_DecimationHoldsU);
+  RUN_TEST(testClosedLoopKernel_DecimationMatchesReference);
+  RUN_TEST(testClosedLoopKernel_FeatureContext);
+  RUN_TEST(testClosedLoopKernel_SimulateFit);
+  RUN_TEST(testClosedLoopKernel_FastForward);
+  RUN_TEST(testClosedLoopKernel_FastForwardLags);
+  RUN_TEST(testClosedLoopKernel_FastForwardPendulum);
+  RUN_TEST(testClosedLoopKernel_SimulateStream);
+
+  return UNITY_END();
+}
@@ -0,0 +1,111 @@
+#include "neural/feature_engine.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "unity/unity.h"
+
+#define STEPS 100
+#define BATCH 5
+#define DT 0.05f
+
+static float sample(const int source, const int step, const int lane){
+  if (step < 0) { return 0.0f; } // the history starts with zeros
+  return sinf(0.3f * (float)step + (float)source + 0.7f * (float)lane) * (float)(source + 1);
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void testFeatureEngine_SameAsTypeOne(void){
+  // de, ie, dy, ddy, du with the same math as the typeOne input system
+  const FeatureSpec specs[] = {
+    {FEATURE_E, FEATURE_DERIVATIVE, 0}, {FEATURE_E, FEATURE_INTEGRAL, 0},
+    {FEATURE_Y, FEATURE_DERIVATIVE, 0}, {FEATURE_Y, FEATURE_SECOND_DERIVATIVE, 0},
+    {FEATURE_U, FEATURE_DERIVATIVE, 0}
+  };
+  FeatureEngine *engine = FeatureEngine_Create(specs, 5, 1);
+  float *history = malloc(engine->historySize * sizeof(float));
+  FeatureEngine_Reset(engine, history);
+
+  float data[13] = {DT};
+  float features[5];
+  for (int t = 0; t < STEPS; t++){
+    const float e = sample(0, t, 0), u = sample(1, t, 0), y = sample(2, t, 0);
+
+    data[1] = e; data[2] = u; data[3] = y;
+    data[4]  = (data[1] - data[9]) / data[0];
+    data[5] +=  data[1];
+    data[9]  =  data[1];
+    data[8]  = (data[2] - data[10]) / data[0];
+    data[10] =  data[2];
+    data[6]  = (data[3] - data[11]) / data[0];
+    data[7]  = (data[6] - data[12]) / data[0];
+    data[11] =  data[3];
+    data[12] =  data[6];
+
+    FeatureEngine_Push(engine, history, DT, &e, &u, &y, features);
+    TEST_ASSERT_EQUAL_FLOAT(data[4], features[0]);
+    TEST_ASSERT_EQUAL_FLOAT(data[5], features[1]);
+    TEST_ASSERT_EQUAL_FLOAT(data[6], features[2]);
+    TEST_ASSERT_EQUAL_FLOAT(data[7], features[3]);
+    TEST_ASSERT_EQUAL_FLOAT(data[8], features[4]);
+  }
+
+  free(history);
+  FeatureEngine_Destroy(engine);
+}
+
+void testFeatureEngine_LagsAndBatch(void){
+  const FeatureSpec specs[] = {{FEATURE_E, FEATURE_VALUE, 0}, {FEATURE_E, FEATURE_VALUE, 5}, {FEATURE_Y, FEATURE_VALUE, 7}};
+  FeatureEngine *engine = FeatureEngine_Create(specs, 3, BATCH);
+
+  // only e and y have the ring, the capacity is the power of two over the deepest lag
+  TEST_ASSERT_EQUAL_size_t(8, engine->capacity);
+  TEST_ASSERT_EQUAL_INT(-1, engine->ringIndex[FEATURE_U]);
+  TEST_ASSERT_EQUAL_size_t(1 + 2 * 8 * BATCH, engine->historySize);
+
+  float *history = malloc(engine->historySize * sizeof(float));
+  FeatureEngine_Reset(engine, history);
+
+  float e[BATCH], u[BATCH], y[BATCH], features[3 * BATCH];
+  for (int t = 0; t < STEPS; t++){
+    for (int b = 0; b < BATCH; b++){
+      e[b] = sample(0, t, b);
+      u[b] = sample(1, t, b);
+      y[b] = sample(2, t, b);
+    }
+    FeatureEngine_Push(engine, history, DT, e, u, y, features);
+
+    for (int b = 0; b < BATCH; b++){
+      TEST_ASSERT_EQUAL_FLOAT(sample(0, t, b),     features[0 * BATCH + b]);
+      TEST_ASSERT_EQUAL_FLOAT(sample(0, t - 5, b), features[1 * BATCH + b]);
+      TEST_ASSERT_EQUAL_FLOAT(sample(2, t - 7, b), features[2 * BATCH + b]);
+    }
+  }
+
+  free(history);
+  FeatureEngine_Destroy(engine);
+}
+
+void testFeatureEngine_NormalizationType(void){
+  const FeatureSpec lag   = {FEATURE_Y, FEATURE_VALUE, 3};
+  const FeatureSpec dde   = {FEATURE_E, FEATURE_SECOND_DERIVATIVE, 0};
+  const FeatureSpec iu    = {FEATURE_U, FEATURE_INTEGRAL, 0};
+  const FeatureSpec dy    = {FEATURE_Y, FEATURE_DERIVATIVE, 0};
+
+  TEST_ASSERT_EQUAL_INT(2, FeatureEngine_NormalizationType(&lag));
+  TEST_ASSERT_EQUAL_INT(4, FeatureEngine_NormalizationType(&dde));
+  TEST_ASSERT_EQUAL_INT(8, FeatureEngine_NormalizationType(&iu));
+  TEST_ASSERT_EQUAL_INT(9, FeatureEngine_NormalizationType(&dy));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(testFeatureEngine_SameAsTypeOne);
+  RUN_TEST(testFeatureEngine_LagsAndBatch);
+  RUN_TEST(testFeatureEngine_NormalizationType);
+
+  return UNITY_END();
+}
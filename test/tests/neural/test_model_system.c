@@ -68,7 +68,7 @@ int testSystemCreate(void){
   createFilledPopulation(inputPop, pop);
 
   fillMatrixesNN(systemNN->neuralNetwork, pop->pop[0]);
-  makeSimulationOfSignalNN(systemNN, csvFile, 1);
+  makeSimulationOfSignalNN(systemNN, pop->pop[0], csvFile, 1);
 
   FILE *csvFile2 = fopen("TOOLBOX/PYTHON/input/data_nn_fit.csv", "w");
   fprintf(csvFile2, "best\n");
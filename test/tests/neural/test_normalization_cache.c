@@ -0,0 +1,116 @@
+// fork and waitpid are POSIX
+#define _POSIX_C_SOURCE 200809L
+
+#include "neural/normalization_cache.h"
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "unity/unity.h"
+
+static const char *path = "test_normalization_cache.bin";
+
+#define WRITERS 8
+#define SAVES 20
+
+void setUp(void){ remove(path); }
+void tearDown(void){ remove(path); remove("test_normalization_cache.bin.lock"); }
+
+void testNormalizationCache_MissingFile(void){
+  float table[NORMALIZATION_CACHE_ENTRIES];
+  TEST_ASSERT_EQUAL(0, NormalizationCache_Load(path, 42u, table));
+}
+
+void testNormalizationCache_SaveLoad(void){
+  float table[NORMALIZATION_CACHE_ENTRIES];
+  float loaded[NORMALIZATION_CACHE_ENTRIES];
+  for (int i = 0; i < NORMALIZATION_CACHE_ENTRIES; i++){ table[i] = (float)i * 1.5f; }
+
+  TEST_ASSERT_EQUAL(1, NormalizationCache_Save(path, 42u, table));
+  TEST_ASSERT_EQUAL(1, NormalizationCache_Load(path, 42u, loaded));
+  TEST_ASSERT_EQUAL_FLOAT_ARRAY(table, loaded, NORMALIZATION_CACHE_ENTRIES);
+
+  TEST_ASSERT_EQUAL(0, NormalizationCache_Load(path, 43u, loaded));
+}
+
+void testNormalizationCache_ReplaceKey(void){
+  float first[NORMALIZATION_CACHE_ENTRIES]  = {1.0f};
+  float second[NORMALIZATION_CACHE_ENTRIES] = {2.0f};
+  float other[NORMALIZATION_CACHE_ENTRIES]  = {3.0f};
+  float loaded[NORMALIZATION_CACHE_ENTRIES];
+
+  NormalizationCache_Save(path, 1u, first);
+  NormalizationCache_Save(path, 2u, other);
+  NormalizationCache_Save(path, 1u, second);
+
+  TEST_ASSERT_EQUAL(1, NormalizationCache_Load(path, 1u, loaded));
+  TEST_ASSERT_EQUAL_FLOAT(2.0f, loaded[0]);
+  TEST_ASSERT_EQUAL(1, NormalizationCache_Load(path, 2u, loaded));
+  TEST_ASSERT_EQUAL_FLOAT(3.0f, loaded[0]);
+}
+
+void testNormalizationCache_HashDependsOnData(void){
+  const float signalOne[] = {0.0f, 1.0f, 1.0f};
+  const float signalTwo[] = {0.0f, 1.0f, 2.0f};
+
+  const uint64_t keyOne = NormalizationCache_HashBytes(NormalizationCache_HashStart(), signalOne, sizeof(signalOne));
+  const uint64_t keyTwo = NormalizationCache_HashBytes(NormalizationCache_HashStart(), signalTwo, sizeof(signalTwo));
+
+  TEST_ASSERT_TRUE(keyOne != keyTwo);
+}
+
+// the processes saving at once keep the records of each other and leave no temporary file
+void testNormalizationCache_ConcurrentSave(void){
+  float table[NORMALIZATION_CACHE_ENTRIES] = {0};
+
+  pid_t pids[WRITERS];
+  for (int w = 0; w < WRITERS; w++){
+    pids[w] = fork();
+    TEST_ASSERT_TRUE(pids[w] >= 0);
+    if (pids[w] == 0){
+      for (int s = 0; s < SAVES; s++){
+        table[0] = (float)(w * SAVES + s);
+        if (NormalizationCache_Save(path, (uint64_t)(w * SAVES + s), table) == 0) { _exit(1); }
+      }
+      _exit(0);
+    }
+  }
+
+  for (int w = 0; w < WRITERS; w++){
+    int status = 0;
+    waitpid(pids[w], &status, 0);
+    TEST_ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  }
+
+  for (int k = 0; k < WRITERS * SAVES; k++){
+    const int found = NormalizationCache_Load(path, (uint64_t)k, table);
+    TEST_ASSERT_EQUAL(1, found);
+    TEST_ASSERT_EQUAL_FLOAT((float)k, table[0]);
+  }
+
+  DIR *directory = opendir(".");
+  TEST_ASSERT_NOT_NULL(directory);
+  int temporary = 0;
+  for (struct dirent *entry = readdir(directory); entry != NULL; entry = readdir(directory)){
+    if (strncmp(entry->d_name, "test_normalization_cache.bin.", 29) == 0 &&
+        strcmp(entry->d_name, "test_normalization_cache.bin.lock") != 0) { temporary++; }
+  }
+  closedir(directory);
+  TEST_ASSERT_EQUAL(0, temporary);
+}
+
+int main(void){
+  UNITY_BEGIN();
+
+  RUN_TEST(testNormalizationCache_MissingFile);
+  RUN_TEST(testNormalizationCache_SaveLoad);
+  RUN_TEST(testNormalizationCache_ReplaceKey);
+  RUN_TEST(testNormalizationCache_HashDependsOnData);
+  RUN_TEST(testNormalizationCache_ConcurrentSave);
+
+  return UNITY_END();
+}
@@ -367,7 +367,7 @@ int testNNRun(){
       fillMatrixesNN(systemNN->neuralNetwork, pop->pop[bestFit]);
 
       // now model is simulated
-      makeSimulationOfSignalNN(systemNN, csvFile2, 1);
+      makeSimulationOfSignalNN(systemNN, pop->pop[bestFit], csvFile2, 1);
 
       printf("BEST NN: FIT: %f Count: %d\n", systemNN->fit, systemNN->maxCounter);
 